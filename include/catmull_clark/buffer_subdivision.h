@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include <catmull_clark/common.h>
+
+/**
+ * @brief 不持有内存的连续数组
+ */
+template<typename T>
+struct ArrayView
+{
+    T     *data = nullptr;
+    size_t size = 0;
+
+    T &operator[](size_t i) const noexcept { return data[i]; }
+};
+
+/**
+ * @brief 不持有内存的位置数组，第i个位置的x、y、z依次存放在data + i * stride字节处
+ *
+ * stride可以大于3个float，以便直接读写交错排列的顶点缓冲区；stride不得小于3个float，且data与stride均需按float对齐
+ */
+template<typename Float>
+struct StridedPositions
+{
+    Float *data   = nullptr;
+    size_t stride = 3 * sizeof(float);
+    size_t size   = 0;
+
+    Float *at(size_t i) const noexcept
+    {
+        using Byte = std::conditional_t<std::is_const_v<Float>, const unsigned char, unsigned char>;
+        return reinterpret_cast<Float*>(reinterpret_cast<Byte*>(data) + i * stride);
+    }
+};
+
+/**
+ * @brief 整数数组的元素类型
+ */
+enum class IndexFormat : uint8_t
+{
+    UInt8,
+    UInt16,
+    UInt32
+};
+
+/**
+ * @brief 不持有内存、带步长的整数数组，第i个元素位于data + i * stride字节处，类型由format确定
+ *
+ * 用于直接读取其他程序中各面的顶点数与顶点下标，不必先转换为uint32_t数组
+ */
+struct IndexView
+{
+    const void *data   = nullptr;
+    size_t      stride = sizeof(uint32_t);
+    size_t      size   = 0;
+    IndexFormat format = IndexFormat::UInt32;
+
+    uint32_t operator[](size_t i) const noexcept
+    {
+        const auto p = static_cast<const unsigned char*>(data) + i * stride;
+        switch(format)
+        {
+        case IndexFormat::UInt8:  return *p;
+        case IndexFormat::UInt16: return *reinterpret_cast<const uint16_t*>(p);
+        default:                  return *reinterpret_cast<const uint32_t*>(p);
+        }
+    }
+};
+
+using ConstPositionView = StridedPositions<const float>;
+using PositionView      = StridedPositions<float>;
+
+/**
+ * @brief 输入模型：第f个面有faceVertexCounts[f]（3或4）个顶点，各面的顶点下标在indices中依次排列
+ *
+ * 拓扑由顶点下标确定，位于同一位置的不同顶点不会被合并
+ */
+struct MeshView
+{
+    ConstPositionView         positions;
+    ArrayView<const uint8_t>  faceVertexCounts;
+    ArrayView<const uint32_t> indices;
+};
+
+/**
+ * @brief 细分结果的写入位置，细分结果中的面均为四边形
+ *
+ * 细分过程只写不读这两块内存，它们可以是映射的GPU上传缓冲区
+ */
+struct SubdivisionOutput
+{
+    PositionView        positions;
+    ArrayView<uint32_t> indices;
+};
+
+/**
+ * @brief 工作区首地址的对齐要求，operator new、malloc与std::vector<std::byte>分配的内存均满足
+ */
+constexpr size_t SUBDIVISION_WORKSPACE_ALIGNMENT = alignof(std::max_align_t);
+
+/**
+ * @brief 细分所需的缓冲区大小
+ */
+struct SubdivisionBufferSizes
+{
+    size_t vertexCount    = 0; // 输出的顶点数
+    size_t faceCount      = 0; // 输出的四边形数，输出的顶点下标为4 * faceCount个
+    size_t workspaceBytes = 0; // 工作区的字节数
+};
+
+/**
+ * @brief 计算将input细分iterationCount（至少为1）次所需的缓冲区大小
+ *
+ * 需要统计输入模型的边数，会分配与输入规模成正比的临时内存；同一拓扑的模型只需查询一次
+ */
+SubdivisionBufferSizes querySubdivisionBufferSizes(const MeshView &input, int iterationCount);
+
+/**
+ * @brief 将input细分iterationCount次，结果写入output，中间结果存放在调用者提供的workspace中
+ *
+ * 各缓冲区的大小不得小于querySubdivisionBufferSizes的结果，workspace.data需按SUBDIVISION_WORKSPACE_ALIGNMENT对齐。
+ * 默认在调用线程上执行，不分配内存；multithreaded为true时创建工作线程。
+ * 细分规则与applyCatmullClarkSubdivision相同，各层的拓扑由上一层直接推出，不需要哈希表；
+ * 由于不按位置合并顶点，输出的顶点顺序与其不同，对封闭的流形模型两者只有舍入误差。
+ * 输入的面的顶点数不是3或4、顶点下标越界、有边属于两个以上的面，缓冲区不足、工作区未对齐或位置步长无效时抛出std::runtime_error
+ */
+void applyCatmullClarkSubdivision(
+    const MeshView &input, int iterationCount, const SubdivisionOutput &output,
+    ArrayView<std::byte> workspace, bool multithreaded = false);
+
+/**
+ * @brief 预先建立的各层拓扑，控制点位置变化时只需逐层计算位置
+ *
+ * 适合拓扑不变而控制点逐帧变形的模型。拓扑检查与结果都与applyCatmullClarkSubdivision(const MeshView&, ...)相同，
+ * 占用的内存主要是最后一层的顶点下标与倒数第二层的边表
+ */
+class SubdivisionTopology : public agz::misc::uncopyable_t
+{
+public:
+
+    /**
+     * @brief 由vertexCount个控制点上的面建立细分iterationCount次所需的各层拓扑
+     */
+    SubdivisionTopology(
+        const IndexView &faceVertexCounts, const IndexView &indices,
+        size_t vertexCount, int iterationCount, bool multithreaded = false);
+
+    ~SubdivisionTopology();
+
+    int getIterationCount() const noexcept;
+
+    size_t getInputVertexCount() const noexcept;
+
+    size_t getOutputVertexCount() const noexcept;
+
+    size_t getOutputFaceCount() const noexcept;
+
+    /**
+     * @brief 细分结果中各四边形的顶点下标，共4 * getOutputFaceCount()个
+     */
+    ArrayView<const uint32_t> getOutputIndices() const noexcept;
+
+    /**
+     * @brief evaluate所需的工作区字节数，只与位置有关，小于applyCatmullClarkSubdivision所需的工作区
+     */
+    size_t getWorkspaceBytes() const noexcept;
+
+    /**
+     * @brief 各层拓扑占用的内存字节数
+     */
+    size_t getMemoryBytes() const noexcept;
+
+    /**
+     * @brief 计算控制点为input时细分结果的顶点位置，写入output
+     *
+     * workspace的要求与applyCatmullClarkSubdivision相同。默认在调用线程上执行，不分配内存；multithreaded为true时创建工作线程。
+     * 同一对象可以同时在多个线程上使用各自的工作区求值
+     */
+    void evaluate(
+        const ConstPositionView &input, const PositionView &output,
+        ArrayView<std::byte> workspace, bool multithreaded = false) const;
+
+    /**
+     * @brief 是否与由这些面建立的、细分iterationCount次的拓扑相同
+     */
+    bool matches(
+        const IndexView &faceVertexCounts, const IndexView &indices,
+        size_t vertexCount, int iterationCount) const noexcept;
+
+    /**
+     * @brief 把各层拓扑写入文件，先写入同目录下的临时文件再改名，多个进程同时写入同一文件是安全的
+     */
+    void saveToFile(const std::string &filename) const;
+
+    /**
+     * @brief 映射saveToFile写出的文件，不重新建立拓扑，各层拓扑直接位于映射的文件中
+     *
+     * 文件的格式、版本、大小或校验和不符时抛出std::runtime_error。文件只应由saveToFile在同一种平台上写出
+     */
+    static std::unique_ptr<SubdivisionTopology> loadFromFile(const std::string &filename);
+
+private:
+
+    struct LevelData;
+
+    SubdivisionTopology() = default;
+
+    int    iterationCount_    = 0;
+    size_t inputVertexCount_  = 0;
+    size_t outputVertexCount_ = 0;
+    size_t workspaceBytes_    = 0;
+
+    std::vector<std::unique_ptr<LevelData>> levels_;
+
+    ArrayView<const uint32_t> outputIndices_;
+    std::vector<uint32_t> ownedOutputIndices_;
+
+    // 从文件加载时持有映射的文件
+    std::shared_ptr<const void> storage_;
+};
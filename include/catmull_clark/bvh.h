@@ -0,0 +1,230 @@
+#pragma once
+
+#include <limits>
+#include <queue>
+
+#include <catmull_clark/hierarchy.h>
+
+/**
+ * @brief 射线 o + t * d，只考虑t位于[tMin, tMax]中的部分
+ */
+struct Ray
+{
+    Vec3 origin;
+    Vec3 direction;
+    float tMin = 0;
+    float tMax = (std::numeric_limits<float>::max)();
+};
+
+/**
+ * @brief BVH中的节点
+ */
+struct BVHNode
+{
+    Vec3 low;
+    Vec3 high;
+    uint32_t offset; // 叶节点：第一个图元的下标；内部节点：左子节点的下标，右子节点紧随其后
+    uint32_t count;  // 叶节点中的图元数量，内部节点为0
+};
+
+/**
+ * @brief 射线与网格的交点
+ *
+ * faceUV为交点在face上的参数，约定与SurfaceLocation中的四边形相同；
+ * face为三角形时，faceUV为相对第1、2个顶点的重心坐标
+ */
+struct MeshHit
+{
+    float    t = 0;
+    uint32_t face = 0;
+    Vec2     faceUV;
+    Vec3     position;
+};
+
+/**
+ * @brief 网格上的层次包围盒，用于拾取与射线求交
+ *
+ * 四边形按与RenderMesh相同的方式拆分为两个三角形。
+ * 使用分桶的SAH构建，较大的子树在多个线程上并行构建。
+ * 构建时会复制所需的顶点数据，此后与mesh无关。
+ */
+class MeshBVH : public agz::misc::uncopyable_t
+{
+public:
+
+    explicit MeshBVH(const Mesh &mesh);
+
+    /**
+     * @brief 求射线与网格的最近交点，没有交点时返回false
+     */
+    bool intersect(const Ray &ray, MeshHit &hit) const;
+
+    /**
+     * @brief 射线与网格是否有交点，找到任一交点即返回
+     */
+    bool occluded(const Ray &ray) const;
+
+    size_t getNodeCount() const noexcept;
+
+    size_t getTriangleCount() const noexcept;
+
+private:
+
+    /**
+     * @brief 预先计算了边向量的三角形
+     *
+     * half为0时三个顶点为四边形的顶点(0, 1, 2)，为1时为(0, 2, 3)，为2时face本身是三角形
+     */
+    struct Triangle
+    {
+        Vec3 a;
+        Vec3 ab;
+        Vec3 ac;
+        uint32_t face;
+        uint32_t half;
+    };
+
+    template<bool AnyHit>
+    bool traverse(const Ray &ray, MeshHit *hit) const;
+
+    std::vector<BVHNode>  nodes_;
+    std::vector<Triangle> triangles_;
+};
+
+/**
+ * @brief 射线与细分结果的交点，附带交点在原始模型上的位置
+ */
+struct SurfaceHit
+{
+    MeshHit         meshHit;
+    SurfaceLocation location;
+};
+
+/**
+ * @brief 在第level层细分结果上求射线的最近交点，并将其映射回原始模型
+ *
+ * bvh须由第level层的细分结果构建，hierarchy须由原始模型构建
+ */
+bool intersectSurface(
+    const MeshBVH &bvh, const SubdivisionHierarchy &hierarchy, int level,
+    const Ray &ray, SurfaceHit &hit);
+
+/**
+ * @brief 轴对齐包围盒
+ */
+struct BoundingBox
+{
+    Vec3 low;
+    Vec3 high;
+};
+
+/**
+ * @brief 射线进入第index个包围盒时的参数t
+ */
+struct BoxHit
+{
+    float    t = 0;
+    uint32_t index = 0;
+};
+
+/**
+ * @brief 一组包围盒上的层次包围盒，与MeshBVH使用相同的构建方式
+ *
+ * 用于在逐个处理包围盒内的内容（如细分曲面片）之前筛选出与射线相交的包围盒
+ */
+class BoxBVH : public agz::misc::uncopyable_t
+{
+public:
+
+    explicit BoxBVH(const std::vector<BoundingBox> &boxes);
+
+    /**
+     * @brief 求与射线在[ray.tMin, ray.tMax]内相交的所有包围盒，按进入距离从近到远写入hits
+     */
+    void intersect(const Ray &ray, std::vector<BoxHit> &hits) const;
+
+    /**
+     * @brief 按到point的距离从近到远访问包围盒
+     *
+     * func(index, maxDistanceSquare)处理第index个包围盒，并可以缩小maxDistanceSquare；
+     * 到point的距离的平方不小于maxDistanceSquare的包围盒及节点会被跳过
+     */
+    template<typename Func>
+    void visitNearest(const Vec3 &point, float maxDistanceSquare, const Func &func) const;
+
+private:
+
+    static float distanceSquare(const Vec3 &point, const Vec3 &low, const Vec3 &high)
+    {
+        float result = 0;
+        for(int axis = 0; axis < 3; ++axis)
+        {
+            const float d = (std::max)((std::max)(low[axis] - point[axis], point[axis] - high[axis]), 0.0f);
+            result += d * d;
+        }
+        return result;
+    }
+
+    std::vector<BVHNode>  nodes_;
+    std::vector<uint32_t> boxIndices_;
+    std::vector<BoundingBox> boxes_;
+};
+
+template<typename Func>
+void BoxBVH::visitNearest(const Vec3 &point, float maxDistanceSquare, const Func &func) const
+{
+    if(boxes_.empty())
+    {
+        return;
+    }
+
+    // 节点与包围盒放在同一个优先队列中，isBox为true时index为boxIndices_中的下标
+
+    struct Entry
+    {
+        float    distanceSquare;
+        uint32_t index;
+        bool     isBox;
+
+        bool operator<(const Entry &rhs) const
+        {
+            return distanceSquare > rhs.distanceSquare;
+        }
+    };
+
+    std::priority_queue<Entry> queue;
+    queue.push({ distanceSquare(point, nodes_[0].low, nodes_[0].high), 0, false });
+
+    while(!queue.empty())
+    {
+        const Entry entry = queue.top();
+        queue.pop();
+
+        if(entry.distanceSquare >= maxDistanceSquare)
+        {
+            break;
+        }
+
+        if(entry.isBox)
+        {
+            func(boxIndices_[entry.index], maxDistanceSquare);
+            continue;
+        }
+
+        const BVHNode &node = nodes_[entry.index];
+        if(!node.count)
+        {
+            for(uint32_t child = node.offset; child < node.offset + 2; ++child)
+            {
+                queue.push({ distanceSquare(point, nodes_[child].low, nodes_[child].high), child, false });
+            }
+            continue;
+        }
+
+        for(uint32_t i = node.offset; i < node.offset + node.count; ++i)
+        {
+            auto &box = boxes_[boxIndices_[i]];
+            queue.push({ distanceSquare(point, box.low, box.high), i, true });
+        }
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+/*
+ * 细分库的C接口，供DCC插件与其他语言的运行时调用。
+ *
+ * 所有输入都以指针加步长的形式原地读取，输出写入调用者提供的缓冲区，不需要先转换为Mesh。
+ * 拓扑与求值器以不透明句柄表示：拓扑只依赖各面的顶点数与顶点下标，建立一次后，
+ * 控制点每次变形只需以求值器逐层计算位置。
+ *
+ * 除注明的情形外，函数返回CCS_SUCCESS或错误码，失败时可以用ccsGetLastError取得当前线程上最近一次错误的描述。
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(CCS_STATIC)
+    #define CCS_API
+#elif defined(_WIN32)
+    #if defined(CCS_BUILD_SHARED)
+        #define CCS_API __declspec(dllexport)
+    #else
+        #define CCS_API __declspec(dllimport)
+    #endif
+#else
+    #define CCS_API __attribute__((visibility("default")))
+#endif
+
+/* 接口不兼容地改变时增大 */
+#define CCS_API_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum CcsResult
+{
+    CCS_SUCCESS                = 0,
+    CCS_ERROR_INVALID_ARGUMENT = 1, /* 空指针、步长过小、细分次数小于1等 */
+    CCS_ERROR_INVALID_TOPOLOGY = 2, /* 面的顶点数不是3或4、顶点下标越界、有边属于两个以上的面 */
+    CCS_ERROR_BUFFER_TOO_SMALL = 3,
+    CCS_ERROR_OUT_OF_MEMORY    = 4,
+    CCS_ERROR_UNKNOWN          = 5
+} CcsResult;
+
+typedef enum CcsIndexType
+{
+    CCS_INDEX_TYPE_UINT8  = 0,
+    CCS_INDEX_TYPE_UINT16 = 1,
+    CCS_INDEX_TYPE_UINT32 = 2
+} CcsIndexType;
+
+typedef enum CcsFlags
+{
+    CCS_FLAG_NONE            = 0,
+    CCS_FLAG_SINGLE_THREADED = 1 /* 只在调用者的线程上计算，求值时不分配任何内存 */
+} CcsFlags;
+
+/*
+ * 位置数组：第i个位置的x、y、z为依次存放在data + i * stride字节处的3个float，data需按4字节对齐。
+ * stride为0时表示紧密排列，即3 * sizeof(float)
+ */
+typedef struct CcsConstPositionBuffer
+{
+    const float *data;
+    size_t       stride;
+    size_t       count;
+} CcsConstPositionBuffer;
+
+typedef struct CcsPositionBuffer
+{
+    float *data;
+    size_t stride;
+    size_t count;
+} CcsPositionBuffer;
+
+/*
+ * 整数数组：第i个元素是位于data + i * stride字节处的type类型的整数，data需按元素大小对齐。
+ * stride为0时表示紧密排列
+ */
+typedef struct CcsConstIndexBuffer
+{
+    const void  *data;
+    size_t       stride;
+    size_t       count;
+    CcsIndexType type;
+} CcsConstIndexBuffer;
+
+typedef struct CcsIndexBuffer
+{
+    void        *data;
+    size_t       stride;
+    size_t       count;
+    CcsIndexType type;
+} CcsIndexBuffer;
+
+/* 预先建立的各层拓扑，建立后不再改变，可以同时被多个线程上的求值器使用 */
+typedef struct CcsTopology CcsTopology;
+
+/* 求值器持有求值所需的工作区，同一时刻只能被一个线程使用 */
+typedef struct CcsEvaluator CcsEvaluator;
+
+CCS_API uint32_t ccsGetApiVersion(void);
+
+/* 当前线程上最近一次失败的描述，没有失败过时为空字符串；指针在当前线程下一次调用本接口之前有效 */
+CCS_API const char *ccsGetLastError(void);
+
+/*
+ * 由vertexCount个控制点上的面建立细分iterationCount次所需的拓扑。
+ * faceVertexCounts中第f个元素为第f个面的顶点数（3或4），indices中依次为各面的顶点下标。
+ * 两个数组只在调用期间被读取
+ */
+CCS_API CcsResult ccsCreateTopology(
+    const CcsConstIndexBuffer *faceVertexCounts,
+    const CcsConstIndexBuffer *indices,
+    size_t                     vertexCount,
+    int                        iterationCount,
+    uint32_t                   flags,
+    CcsTopology              **topology);
+
+/* 已创建的求值器各自持有拓扑的引用，不受销毁拓扑的影响。topology可以为空 */
+CCS_API void ccsDestroyTopology(CcsTopology *topology);
+
+CCS_API size_t ccsGetInputVertexCount(const CcsTopology *topology);
+
+CCS_API size_t ccsGetOutputVertexCount(const CcsTopology *topology);
+
+/* 细分结果均为四边形，顶点下标共4 * ccsGetOutputFaceCount()个 */
+CCS_API size_t ccsGetOutputFaceCount(const CcsTopology *topology);
+
+/* 将细分结果中各四边形的顶点下标写入indices，type为CCS_INDEX_TYPE_UINT16时要求顶点数不超过65536 */
+CCS_API CcsResult ccsCopyOutputIndices(const CcsTopology *topology, const CcsIndexBuffer *indices);
+
+CCS_API CcsResult ccsCreateEvaluator(const CcsTopology *topology, uint32_t flags, CcsEvaluator **evaluator);
+
+/* evaluator可以为空 */
+CCS_API void ccsDestroyEvaluator(CcsEvaluator *evaluator);
+
+/*
+ * 计算控制点为input时细分结果的顶点位置，写入output。
+ * input的数量必须等于ccsGetInputVertexCount，output的数量不得小于ccsGetOutputVertexCount；output只写不读
+ */
+CCS_API CcsResult ccsEvaluate(
+    CcsEvaluator                 *evaluator,
+    const CcsConstPositionBuffer *input,
+    const CcsPositionBuffer      *output);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,3 +6,80 @@
  * @brief 在网格模型上应用指定次数的Catmull-Clark细分算法，返回细分后的新模型
  */
 Mesh applyCatmullClarkSubdivision(const Mesh &originalMesh, int iterationCount);
+
+/**
+ * @brief 同上，并将细分后模型的边表（每条边只出现一次）写入edges
+ *
+ * 边表由细分过程中已知的拓扑信息直接导出，不需要再对顶点或边做哈希去重
+ */
+Mesh applyCatmullClarkSubdivision(
+    const Mesh &originalMesh, int iterationCount, std::vector<Edge> &edges);
+
+struct SubdivisionOptions
+{
+    // 为true时先拆分非流形的顶点与边（见splitNonManifold）再细分；
+    // 为false时若存在属于两个以上面的边，在细分开始前抛出异常，而不是在细分途中
+    bool splitNonManifold = false;
+};
+
+/**
+ * @brief 同applyCatmullClarkSubdivision(originalMesh, iterationCount)，细分前先以validateMesh检查拓扑
+ *
+ * 拆分非流形元素时，结果中位于同一位置的顶点副本互不相连，面的顺序与未拆分时相同
+ */
+Mesh applyCatmullClarkSubdivision(
+    const Mesh &originalMesh, int iterationCount, const SubdivisionOptions &options);
+
+/**
+ * @brief 只细分faceMask中为true的面，其余的面保持不变
+ *
+ * 同时属于选中与未选中的面的顶点保持原位置，两侧共享的边上只插入中点，未选中的面的形状因此不变；
+ * 这些未选中的面以面中心为公共顶点剖分为三角形，与细分后的区域共享边上的所有顶点，结果仍是无缝的流形。
+ * 边界顶点（同时属于选中与未选中的面的顶点）在每一层都保持不动，其影响每细分一次向内扩展一环，
+ * 因此只有与边界顶点相隔iterationCount环以上的选中面上，结果才与整体细分相同，靠近边界处的形状与整体细分不同。
+ * faceMask全为true时与applyCatmullClarkSubdivision(originalMesh, iterationCount)完全一致
+ */
+Mesh applyCatmullClarkSubdivision(
+    const Mesh &originalMesh, int iterationCount, const std::vector<bool> &faceMask);
+
+struct ToleranceSubdivisionOptions
+{
+    // 细分结果与极限曲面之间允许的最大距离
+    float tolerance = 1e-3f;
+
+    // 非空时为每个原始面单独指定允许的最大距离，代替tolerance。
+    // 只决定何时停止：所有的面总是一起细分，误差要求较松的面也会细分到与最严格的面相同的次数
+    std::vector<float> faceTolerances;
+
+    // 最多细分的次数
+    int maxIterationCount = 6;
+};
+
+struct ToleranceSubdivisionResult
+{
+    Mesh mesh;
+
+    // 实际细分的次数
+    int iterationCount = 0;
+
+    // 细分结果与极限曲面之间距离的估计值，为faceErrorEstimates中的最大值。不是严格的上界
+    float errorEstimate = 0;
+
+    // 各原始面细分所得的部分与极限曲面之间距离的估计值
+    std::vector<float> faceErrorEstimates;
+
+    // 各原始面满足误差要求所需的细分次数，在maxIterationCount次内无法满足时为实际细分的次数
+    std::vector<int> faceIterationCounts;
+};
+
+/**
+ * @brief 不断细分，直到细分结果与极限曲面之间距离的估计值不超过给定的误差，或达到最大细分次数
+ *
+ * 每层的估计值由该层控制网格到下一层的最大位移（精确求得）按各原始面的收敛速率求和得到：
+ * 正则区域每层缩小为1/4，奇异顶点附近按其次主特征值缩小，开放边界附近按3/4估计。
+ * 收敛速率是渐近值，估计值不是严格的上界，在正则区域上与实际距离相当，在奇异顶点附近偏大。
+ * 给出faceTolerances时，所有原始面都满足各自的要求后才停止；整个模型以相同的次数细分，
+ * faceIterationCounts给出各原始面实际需要的次数，可用于之后按面选择层级（例如配合面掩码重新细分）
+ */
+ToleranceSubdivisionResult applyCatmullClarkSubdivision(
+    const Mesh &originalMesh, const ToleranceSubdivisionOptions &options);
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <catmull_clark/bvh.h>
+#include <catmull_clark/limit_patch.h>
+
+/**
+ * @brief 空间中的点在极限曲面上的投影
+ */
+struct SurfaceProjection
+{
+    SurfaceLocation location;
+    Vec3  position;
+    Vec3  normal;
+    float distance = 0;
+};
+
+/**
+ * @brief 求空间中的点到极限曲面的最近点
+ *
+ * 以曲面片包围盒构成的BVH按距离从近到远筛选曲面片，在每个候选曲面片上从粗采样得到的初值出发，
+ * 在参数空间中做带边界约束的Newton迭代。只持有table的引用，table须在查询期间保持有效。
+ * 所有查询都是只读的，可以并发调用
+ */
+class LimitSurfaceProjector : public agz::misc::uncopyable_t
+{
+public:
+
+    explicit LimitSurfaceProjector(const LimitPatchTable &table);
+
+    /**
+     * @brief 求point在极限曲面上的最近点
+     */
+    SurfaceProjection project(const Vec3 &point) const;
+
+    /**
+     * @brief 在多个线程上并行地求points中每个点的最近点，结果写入results
+     */
+    void project(const Vec3 *points, size_t count, SurfaceProjection *results) const;
+
+private:
+
+    /**
+     * @brief 在曲面片patch上求point的最近点，参数写入st，返回距离的平方
+     */
+    float projectOnPatch(uint32_t patch, const Vec3 &point, Vec2 &st) const;
+
+    const LimitPatchTable &table_;
+    BoxBVH bvh_;
+};
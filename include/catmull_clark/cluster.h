@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <catmull_clark/common.h>
+
+/**
+ * @brief 一组相邻三角形构成的簇，占据三角形索引缓冲中的一段连续区间
+ *
+ * 包围球与法线锥均位于模型空间。法线锥的判定方式为：
+ * 若dot(normalize(coneApex - cameraPosition), coneAxis) >= coneCutoff，
+ * 则簇内所有三角形均背对摄像机。coneCutoff为1时表示法线锥过宽，不做背面剔除。
+ */
+struct Cluster
+{
+    uint32_t indexOffset = 0;
+    uint32_t indexCount  = 0;
+    uint32_t vertexCount = 0;
+
+    Vec3  center;
+    float radius = 0;
+
+    Vec3  coneApex;
+    Vec3  coneAxis;
+    float coneCutoff = 1;
+};
+
+struct ClusterLimits
+{
+    int maxVertices  = 128;
+    int maxTriangles = 256;
+};
+
+/**
+ * @brief 按面的顺序将网格贪心地划分为簇，并计算各簇的包围球与法线锥
+ *
+ * 细分结果中同一个原始面产生的面总是连续、并按四叉树顺序排列，
+ * 因此按面顺序切分得到的簇在空间上是紧凑的；一个四边形的两个三角形总在同一个簇中。
+ *
+ * 三角形以fillTriangleIndices相同的顺序排列：面i的三角形紧接在面i-1之后。
+ */
+std::vector<Cluster> buildClusters(const Mesh &mesh, const ClusterLimits &limits = {});
+
+/**
+ * @brief 拓扑不变、顶点位置变化后，重新计算各簇的包围球与法线锥
+ *
+ * clusters须由buildClusters从拓扑相同的网格得到，簇的划分保持不变
+ */
+void updateClusterBounds(const Mesh &mesh, std::vector<Cluster> &clusters);
+
+/**
+ * @brief 对簇进行视锥剔除与背面剔除
+ *
+ * @param world 模型的local to world变换，须为统一缩放
+ * @param viewProj 摄像机的view * proj变换
+ * @param cameraPosition 世界空间中的摄像机位置
+ * @param visibleClusters 输出可见簇的下标，按下标递增排列
+ */
+void cullClusters(
+    const std::vector<Cluster> &clusters,
+    const Mat4                 &world,
+    const Mat4                 &viewProj,
+    const Vec3                 &cameraPosition,
+    std::vector<uint32_t>      &visibleClusters);
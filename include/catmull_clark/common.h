@@ -1,6 +1,10 @@
 #pragma once
 
-#include <agz/utility/d3d11.h>
+#include <cstdint>
+#include <vector>
+
+#include <agz/utility/math.h>
+#include <agz/utility/misc.h>
 
 using Vec2 = agz::math::vec2f;
 using Vec3 = agz::math::vec3f;
@@ -11,8 +15,6 @@ using Vec2i = agz::math::vec2i;
 using Mat4   = agz::math::mat4f_c;
 using Trans4 = Mat4::right_transform;
 
-namespace D3D = agz::d3d11;
-
 struct Vertex
 {
     Vec3 position;
@@ -26,8 +28,40 @@ struct Face
     Index indices[4];
 };
 
+struct Edge
+{
+    Face::Index vertices[2];
+};
+
 struct Mesh
 {
     std::vector<Vertex> vertices;
     std::vector<Face>   faces;
 };
+
+/**
+ * @brief 变换齐次坐标
+ *
+ * v被视为行向量，与着色器中的mul(v, M)一致
+ */
+inline Vec4 transformHomogeneous(const Vec4 &v, const Mat4 &m)
+{
+    Vec4 result;
+    for(int c = 0; c < 4; ++c)
+    {
+        result[c] = v.x * m(0, c) + v.y * m(1, c) + v.z * m(2, c) + v.w * m(3, c);
+    }
+    return result;
+}
+
+inline Vec3 transformPoint(const Vec3 &p, const Mat4 &m)
+{
+    Vec4 result = transformHomogeneous(Vec4(p.x, p.y, p.z, 1), m);
+    return Vec3(result.x, result.y, result.z);
+}
+
+inline Vec3 transformDirection(const Vec3 &d, const Mat4 &m)
+{
+    Vec4 result = transformHomogeneous(Vec4(d.x, d.y, d.z, 0), m);
+    return Vec3(result.x, result.y, result.z);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <catmull_clark/patch.h>
+#include <catmull_clark/regular_grid.h>
+
+/**
+ * @brief 原始模型上的一个面（原始三角形则为其一个子面）细分后得到的顶点网格
+ *
+ * 网格每行（列）有2^level + 1个顶点，第i行第j列的顶点为points[firstPoint + i * (2^level + 1) + j]，
+ * 位于SurfaceLocation参数(j / 2^level, i / 2^level)处。
+ * 原始四边形对应一个网格；原始三角形的三个子面各对应一个网格，其level比细分次数少1
+ */
+struct FaceGrid
+{
+    uint32_t baseFace;
+    int      subFace;
+    int      level;
+    uint32_t firstPoint;
+};
+
+struct FaceGridMesh
+{
+    std::vector<FaceGrid> grids;
+    std::vector<Vec3>     points;
+
+    // 直接由常量矩阵求得网格的原始面的数量
+    size_t regularFaceCount = 0;
+};
+
+/**
+ * @brief 将原始模型细分level次，以各个面上的顶点网格表示结果
+ *
+ * 正则的原始面不经过一般的细分流程，由其16个控制点直接乘常量矩阵得到网格（见refineRegularPatches）；
+ * 其余的面被局部细分（见refinePatch），途中变得正则的子面同样交给常量矩阵，只有奇异顶点周围的子面需要逐层细分。
+ * 相邻网格公共边上的顶点会重复出现。level的取值范围为[1, MAX_REGULAR_GRID_LEVEL]
+ */
+FaceGridMesh subdivideToFaceGrids(const Mesh &baseMesh, int level);
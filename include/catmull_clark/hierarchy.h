@@ -0,0 +1,164 @@
+#pragma once
+
+#include <catmull_clark/common.h>
+
+/**
+ * @brief 细分结果上的一点在原始模型上的位置
+ *
+ * - 原始面为四边形时，subFace为0，uv为该面上的参数，面的第0~3个顶点分别位于(0, 0)、(1, 0)、(1, 1)、(0, 1)
+ * - 原始面为三角形时，第一次细分将其分为三个四边形子面，subFace为子面下标k（对应三角形的第k个顶点），
+ *   uv为子面上的参数：顶点k位于(0, 0)，u沿边(k, k + 1)增大，v沿边(k, k - 1)增大，面中心位于(1, 1)
+ * - 在未细分的三角形上，subFace为-1，uv为相对第1、2个顶点的重心坐标
+ */
+struct SurfaceLocation
+{
+    uint32_t baseFace = 0;
+    int      subFace  = 0;
+    Vec2     uv;
+};
+
+/**
+ * @brief 子面参数到父面参数的仿射变换：p = origin + s * axisS + t * axisT
+ */
+struct UVFrame
+{
+    Vec2 origin;
+    Vec2 axisS = Vec2(1, 0);
+    Vec2 axisT = Vec2(0, 1);
+
+    Vec2 apply(const Vec2 &st) const
+    {
+        return origin + st.x * axisS + st.y * axisT;
+    }
+
+    /**
+     * @brief apply的逆变换
+     */
+    Vec2 applyInverse(const Vec2 &p) const
+    {
+        const Vec2 d = p - origin;
+        const float invDet = 1 / (axisS.x * axisT.y - axisS.y * axisT.x);
+        return Vec2(
+            (d.x * axisT.y - d.y * axisT.x) * invDet,
+            (axisS.x * d.y - axisS.y * d.x) * invDet);
+    }
+
+    /**
+     * @brief 复合上child，得到从child的参数空间到当前空间的变换
+     */
+    UVFrame compose(const UVFrame &child) const
+    {
+        return {
+            apply(child.origin),
+            child.axisS.x * axisS + child.axisS.y * axisT,
+            child.axisT.x * axisS + child.axisT.y * axisT
+        };
+    }
+};
+
+/**
+ * @brief 四边形第k个子面在父面参数空间中的坐标系
+ *
+ * 子面的顶点依次为边(k - 1, k)的中点、顶点k、边(k, k + 1)的中点与面中心
+ */
+UVFrame getQuadChildFrame(int k);
+
+/**
+ * @brief 三角形的第k个子面自身的参数(s, t)到SurfaceLocation中子面参数(u, v)的变换：u = t，v = 1 - s
+ */
+UVFrame getTriangleSubFaceFrame();
+
+/**
+ * @brief 细分结果中一层的面的连续区间[begin, end)
+ */
+struct FaceRange
+{
+    uint32_t begin = 0;
+    uint32_t end   = 0;
+};
+
+/**
+ * @brief 细分结果中的一个面在原始模型上覆盖的区域
+ *
+ * frame将该面上的参数（约定与SurfaceLocation中的四边形相同）映射到SurfaceLocation::uv，
+ * [low, high]为该面在uv空间中覆盖的正方形，可直接用于Ptex等按原始面组织的纹理查找。
+ * 第0层的三角形没有四边形参数，其subFace为-1，frame为恒等变换，[low, high]为[0, 1]^2
+ */
+struct FaceRegion
+{
+    uint32_t baseFace = 0;
+    int      subFace  = 0;
+    UVFrame  frame;
+    Vec2     low;
+    Vec2     high;
+};
+
+/**
+ * @brief 细分结果中的面与原始模型中的面之间的对应关系
+ *
+ * applyCatmullClarkSubdivision按父面的顺序输出子面，每个面的子面在输出中连续排列：
+ * 第k个子面包含父面的第k个顶点，其顶点依次为边(k - 1, k)的edge point、顶点k、边(k, k + 1)的edge point和face point。
+ * 第一次细分后所有面都是四边形，因此第L层中的面i在第L - 1层中的父面为i / 4。
+ *
+ * 利用这一顺序，只需记录第1层中每个面属于哪个原始面，即可在常数时间内（与层数呈线性关系）完成查询；
+ * 同一原始面在任一层中的所有子孙面也是连续的，父面、子面与子孙面区间都只需移位运算。
+ * 这些信息完全由原始模型的面类型决定，细分过程不需要为此额外记录任何数据。
+ *
+ * 面下标为32位，面数超过UINT32_MAX的层级无效；层级为负或无效、面下标越界时各查询抛出std::runtime_error
+ */
+class SubdivisionHierarchy
+{
+public:
+
+    explicit SubdivisionHierarchy(const Mesh &baseMesh);
+
+    size_t getBaseFaceCount() const noexcept;
+
+    /**
+     * @brief 第level层的面数，level为负或无效时抛出std::runtime_error
+     */
+    size_t getFaceCount(int level) const;
+
+    /**
+     * @brief 第level层中的面face所属的原始面
+     */
+    uint32_t getBaseFace(int level, uint32_t face) const;
+
+    /**
+     * @brief 原始面baseFace在第level层中的所有子孙面
+     */
+    FaceRange getFaceRange(int level, uint32_t baseFace) const;
+
+    /**
+     * @brief 第level层中的面face在第level - 1层中的父面，level须大于0
+     */
+    uint32_t getParent(int level, uint32_t face) const;
+
+    /**
+     * @brief 第level层中的面face在第level + 1层中的子面
+     */
+    FaceRange getChildren(int level, uint32_t face) const;
+
+    /**
+     * @brief 第level层中的面face在原始模型上覆盖的区域
+     */
+    FaceRegion locateFace(int level, uint32_t face) const;
+
+    /**
+     * @brief 求第level层中的面face上的一点在原始模型上的位置
+     *
+     * faceUV为该点在face上的参数，约定与SurfaceLocation中的四边形相同；
+     * level为0且face为三角形时，faceUV为相对第1、2个顶点的重心坐标
+     */
+    SurfaceLocation locate(int level, uint32_t face, const Vec2 &faceUV) const;
+
+private:
+
+    void checkLevel(int level) const;
+
+    void checkFace(int level, uint32_t face) const;
+
+    std::vector<bool>     isBaseQuad_;
+    std::vector<uint32_t> level1ToBase_;    // 第1层中的面所属的原始面
+    std::vector<uint32_t> baseToLevel1_;    // 原始面的第一个子面在第1层中的下标
+};
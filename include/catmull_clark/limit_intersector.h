@@ -0,0 +1,91 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include <catmull_clark/bvh.h>
+#include <catmull_clark/patch.h>
+
+struct LimitIntersectorOptions
+{
+    // 叶节点包围盒对角线的最大长度（模型空间），交点与极限曲面间的距离不超过1.02 * tolerance
+    float tolerance = 1e-3f;
+
+    // 局部细分的最大层数，不超过15
+    int maxLevel = 12;
+
+    // 缓存的细分结果数量，每个细分结果包含一个曲面片的3或4个子曲面片
+    size_t cacheCapacity = 16384;
+};
+
+/**
+ * @brief 直接与Catmull-Clark极限曲面求交，不预先细分整个模型
+ *
+ * 每个原始面及其1-ring构成一个曲面片。求交时先用原始曲面片的包围盒组成的BVH筛选，
+ * 再按需对曲面片做局部细分：包围盒（即控制点凸包的包围盒）与射线不相交的子曲面片被剔除，
+ * 包围盒的对角线长度不超过tolerance时与中心面求交，交点取在中心面上而不是极限曲面上。
+ * 为覆盖相邻叶节点间的缝隙，与中心面求交时重心坐标允许略微越界，
+ * 因此交点到极限曲面的距离不超过1.02 * tolerance；达到maxLevel后仍未满足tolerance的叶节点不保证这一误差。
+ *
+ * 局部细分的结果保存在容量固定的LRU缓存中，内存占用只与原始模型和缓存容量有关。
+ * 由于缓存的存在，intersect不是线程安全的
+ */
+class LimitSurfaceIntersector : public agz::misc::uncopyable_t
+{
+public:
+
+    explicit LimitSurfaceIntersector(const Mesh &baseMesh, const LimitIntersectorOptions &options = {});
+
+    /**
+     * @brief 求射线与极限曲面的最近交点
+     *
+     * hit.meshHit.face为原始面的下标，hit.meshHit.faceUV与hit.location.uv相同
+     */
+    bool intersect(const Ray &ray, SurfaceHit &hit);
+
+    size_t getCachedRefinementCount() const noexcept;
+
+    size_t getCacheHitCount() const noexcept;
+
+    size_t getCacheMissCount() const noexcept;
+
+private:
+
+    struct Refinement
+    {
+        LocalPatch children[4];
+        int childCount = 0;
+    };
+
+    using RefinementPtr = std::shared_ptr<const Refinement>;
+    using CacheEntry    = std::pair<uint64_t, RefinementPtr>;
+
+    struct Traversal;
+
+    /**
+     * @brief 取得键为key的曲面片的细分结果，缓存中没有时细分patch；patch为空时取出原始曲面片
+     */
+    RefinementPtr getRefinement(uint64_t key, const LocalPatch *patch);
+
+    void intersectChildren(const Refinement &refinement, uint64_t key, Traversal &traversal);
+
+    void intersectPatch(const LocalPatch &patch, uint64_t key, Traversal &traversal);
+
+    void intersectCenterFace(const LocalPatch &patch, Traversal &traversal) const;
+
+    bool isLeaf(const Vec3 &low, const Vec3 &high, int level) const;
+
+    LimitIntersectorOptions options_;
+
+    PatchTopology topology_;
+    std::unique_ptr<BoxBVH> patchBVH_;
+
+    // 最近使用的细分结果在前
+
+    std::list<CacheEntry> cache_;
+    std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> cacheIndex_;
+
+    size_t cacheHitCount_;
+    size_t cacheMissCount_;
+};
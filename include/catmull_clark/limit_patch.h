@@ -0,0 +1,169 @@
+#pragma once
+
+#include <catmull_clark/patch.h>
+
+/**
+ * @brief 极限曲面片的类型
+ *
+ * - Regular：正则四边形（四个顶点均为内部的4度顶点，1-ring中都是四边形），
+ *   对应的极限曲面恰为以1-ring中16个顶点为控制点的双三次均匀B样条曲面片
+ * - Bilinear：达到隔离层级后仍不正则的子面（邻近奇异顶点或边界），以其4个控制点做双线性近似
+ * - Gregory：达到隔离层级后仍不正则、但四个顶点都是内部顶点且周围都是四边形的子面，以Gregory曲面片近似
+ */
+enum class LimitPatchType : uint8_t
+{
+    Regular,
+    Bilinear,
+    Gregory
+};
+
+/**
+ * @brief 达到隔离层级后仍不正则的子面的近似方式
+ *
+ * - Bilinear：一律使用Bilinear曲面片
+ * - Gregory：尽可能使用Gregory曲面片，无法构造的（邻近边界）仍使用Bilinear曲面片
+ */
+enum class LimitEndCap : uint8_t
+{
+    Bilinear,
+    Gregory
+};
+
+/**
+ * @brief 极限曲面片，参数(s, t)位于[0, 1]^2，约定与SurfaceLocation中的四边形相同
+ *
+ * Regular曲面片的16个控制点按行排列，第i行第j列为points[firstPoint + 4 * i + j]，
+ * s沿列方向增大，t沿行方向增大，中心面的4个顶点位于(1, 1)、(1, 2)、(2, 2)、(2, 1)；
+ * Bilinear曲面片的4个控制点依次位于(0, 0)、(1, 0)、(1, 1)、(0, 1)。
+ *
+ * Gregory曲面片有20个控制点，中心面的第k个顶点对应points[firstPoint + 5 * k]起的5个点：
+ * 该顶点处的极限位置P、指向第k + 1个顶点的边控制点E+、指向第k - 1个顶点的边控制点E-，
+ * 以及分别靠近边(k, k + 1)与边(k, k - 1)的两个面控制点F+、F-。
+ * 曲面片内的Bézier控制点由F+与F-按到两条边的距离有理混合而成，
+ * 与相邻的Regular曲面片和同一层的Gregory曲面片之间的边界曲线完全一致。
+ *
+ * frame将(s, t)映射到SurfaceLocation::uv，[low, high]包含整个曲面片
+ */
+struct LimitPatch
+{
+    LimitPatchType type;
+    uint32_t baseFace;
+    int      subFace;
+    int      level;
+    UVFrame  frame;
+    uint32_t firstPoint;
+    Vec3     low;
+    Vec3     high;
+};
+
+/**
+ * @brief 曲面片上一点的位置及其对(s, t)的一阶、二阶偏导数
+ */
+struct PatchDerivatives
+{
+    Vec3 position;
+    Vec3 ds;
+    Vec3 dt;
+    Vec3 dss;
+    Vec3 dst;
+    Vec3 dtt;
+};
+
+struct LimitPatchOptions
+{
+    // 不正则的面最多被局部细分的次数，取值范围为[1, 15]
+    int isolationLevel = 6;
+
+    // 达到隔离层级后仍不正则的子面的近似方式
+    LimitEndCap endCap = LimitEndCap::Bilinear;
+};
+
+/**
+ * @brief 将极限曲面表示为一组可以直接求值的曲面片
+ *
+ * 正则的原始面直接成为一个Regular曲面片；其余原始面被局部细分（见refinePatch），
+ * 正则的子面成为Regular曲面片，直到隔离层级后仍不正则的子面按options.endCap成为Bilinear或Gregory曲面片。
+ * 每个奇异顶点周围每层只留下一个不正则的子面，因此曲面片数量与原始模型的面数成正比。
+ *
+ * 各原始面的细分过程组成一棵四叉树，用于从SurfaceLocation找到所在的曲面片。
+ * 构建在多个线程上并行进行，构建完成后所有查询都是只读的，可以并发调用
+ */
+class LimitPatchTable : public agz::misc::uncopyable_t
+{
+public:
+
+    explicit LimitPatchTable(const Mesh &baseMesh, const LimitPatchOptions &options = {});
+
+    size_t getBaseFaceCount() const noexcept;
+
+    size_t getPatchCount() const noexcept;
+
+    size_t getRegularPatchCount() const noexcept;
+
+    const LimitPatch &getPatch(uint32_t patch) const noexcept;
+
+    const std::vector<LimitPatch> &getPatches() const noexcept;
+
+    const std::vector<Vec3> &getControlPoints() const noexcept;
+
+    /**
+     * @brief 求location所在的曲面片，并将location在该曲面片上的参数写入st
+     */
+    uint32_t findPatch(const SurfaceLocation &location, Vec2 &st) const;
+
+    /**
+     * @brief 在曲面片patch的参数st处求位置与各阶偏导数
+     *
+     * secondOrder为false时只计算位置与一阶偏导数，二阶偏导数的值未定义。
+     * Gregory曲面片的二阶偏导数忽略了面控制点随(s, t)的变化，只是近似值
+     */
+    void evaluate(uint32_t patch, const Vec2 &st, PatchDerivatives &result, bool secondOrder = true) const;
+
+    /**
+     * @brief 在曲面片patch的参数st处求位置与单位法线
+     */
+    void evaluate(uint32_t patch, const Vec2 &st, Vec3 &position, Vec3 &normal) const;
+
+    /**
+     * @brief 在极限曲面上的location处求位置与单位法线
+     */
+    void evaluate(const SurfaceLocation &location, Vec3 &position, Vec3 &normal) const;
+
+    /**
+     * @brief 在多个线程上并行地对locations中的每个位置求值，positions与normals均可为空
+     *
+     * 例如可以只保存采样得到的SurfaceLocation，在原始模型变形后用新的曲面片表重新求值
+     */
+    void evaluate(const SurfaceLocation *locations, size_t count, Vec3 *positions, Vec3 *normals) const;
+
+    /**
+     * @brief 曲面片patch上面积元|ds × dt|的上界，对所有参数(s, t)都成立
+     *
+     * 对evaluate给出的ds、dt成立，计及了求值的浮点舍入误差。
+     * Regular与Bilinear曲面片的上界较紧；Gregory曲面片取|ds|与|dt|的上界之积，较为宽松
+     */
+    float getJacobianBound(uint32_t patch) const;
+
+private:
+
+    /**
+     * @brief 四叉树节点：childCount为0时为叶节点，index为曲面片下标；
+     *        否则子节点位于nodes_[index, index + childCount)
+     */
+    struct Node
+    {
+        uint32_t index;
+        uint32_t childCount;
+    };
+
+    struct FaceTree;
+
+    static void buildFaceTree(const LocalPatch &patch, const LimitPatchOptions &options, FaceTree &tree, uint32_t nodeIndex);
+
+    std::vector<uint32_t>   baseRoots_;
+    std::vector<Node>       nodes_;
+    std::vector<LimitPatch> patches_;
+    std::vector<Vec3>       points_;
+
+    size_t regularPatchCount_;
+};
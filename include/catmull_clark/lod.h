@@ -0,0 +1,109 @@
+#pragma once
+
+#include <memory>
+
+#include <catmull_clark/common.h>
+
+/**
+ * @brief 同一模型的一组细分层级
+ *
+ * 第0层为原始模型，第i层为在第i-1层上再细分一次的结果。
+ * 各层在首次被访问时才计算，之后一直保留。
+ */
+class LodChain
+{
+public:
+
+    LodChain(Mesh baseMesh, int maxLevel);
+
+    int getMaxLevel() const noexcept;
+
+    /**
+     * @brief 取得指定层级的模型，必要时计算该层级及其之前的所有层级
+     *
+     * level不在[0, getMaxLevel()]内时抛出std::out_of_range
+     */
+    const Mesh &getMesh(int level);
+
+    /**
+     * @brief 取得指定层级的边表，level的要求与getMesh相同
+     */
+    const std::vector<Edge> &getEdges(int level);
+
+    /**
+     * @brief 指定层级是否已经计算完毕
+     */
+    bool isLevelReady(int level) const noexcept;
+
+    /**
+     * @brief 估计指定层级在模型空间中的平均边长
+     *
+     * 每细分一次边长大约减半，因此只需统计原始模型，不会触发细分
+     */
+    float getEstimatedEdgeLength(int level) const noexcept;
+
+private:
+
+    struct Level
+    {
+        Mesh mesh;
+        std::vector<Edge> edges;
+    };
+
+    void buildLevels(int level);
+
+    int maxLevel_;
+    float baseEdgeLength_;
+
+    std::vector<std::unique_ptr<Level>> levels_;
+};
+
+/**
+ * @brief 计算模型空间中的单位长度在屏幕上投影的像素数
+ *
+ * @param objectToWorldScale 模型到世界空间的（统一）缩放系数
+ * @param cameraDistance 摄像机到模型的距离
+ * @param verticalFov 竖直方向视角（弧度）
+ * @param viewportHeight 视口高度（像素）
+ */
+float computePixelsPerUnit(
+    float objectToWorldScale, float cameraDistance, float verticalFov, float viewportHeight);
+
+struct LodSelectorParams
+{
+    // 期望的屏幕空间平均边长（像素），选取不超过该边长的最粗层级
+    float targetEdgePixels = 6;
+
+    // 切换到更粗的层级时，要求该层级的边长不超过targetEdgePixels * (1 - hysteresis)，
+    // 以避免摄像机距离在阈值附近波动时反复切换
+    float hysteresis = 0.3f;
+};
+
+/**
+ * @brief 根据屏幕空间边长逐帧选择细分层级
+ *
+ * 与绘制无关，不依赖任何图形API
+ */
+class LodSelector
+{
+public:
+
+    explicit LodSelector(const LodSelectorParams &params = {});
+
+    /**
+     * @brief 根据当前的投影尺度选择层级，返回选中的层级
+     */
+    int select(const LodChain &chain, float pixelsPerUnit);
+
+    int getCurrentLevel() const noexcept;
+
+    /**
+     * @brief 清除当前层级，下次select时不应用滞后
+     */
+    void reset() noexcept;
+
+private:
+
+    LodSelectorParams params_;
+    int currentLevel_;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+
+#include <catmull_clark/common.h>
+
+/**
+ * @brief 从指定obj文件中加载网格模型
+ *
+ * 位于同一位置的顶点会被合并，使各面共享顶点
+ */
+Mesh loadMesh(const std::string &filename);
+
+/**
+ * @brief 计算模型的轴对齐包围盒
+ */
+void computeBoundingBox(const Mesh &mesh, Vec3 &low, Vec3 &high);
+
+/**
+ * @brief 计算将模型缩放至单位立方体时使用的缩放系数
+ */
+float localToUnitCubeScale(const Mesh &mesh);
+
+/**
+ * @brief 计算将模型从本地变换到[-0.5, +0.5]^3中的变换矩阵
+ */
+Mat4 localToUnitCube(const Mesh &mesh);
+
+/**
+ * @brief localToUnitCube的逆变换
+ */
+Mat4 unitCubeToLocal(const Mesh &mesh);
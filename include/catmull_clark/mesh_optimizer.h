@@ -0,0 +1,50 @@
+#pragma once
+
+#include <catmull_clark/render_mesh.h>
+
+/**
+ * @brief 顶点缓存模拟结果
+ *
+ * - ACMR：平均每个三角形需要变换的顶点数，越接近0.5越好
+ * - ATVR：变换的顶点数与顶点总数之比，最优为1
+ */
+struct VertexCacheStatistics
+{
+    int   transformedVertexCount = 0;
+    float acmr = 0;
+    float atvr = 0;
+};
+
+/**
+ * @brief 以给定大小的FIFO顶点缓存模拟三角形列表的绘制过程
+ */
+template<typename Index>
+VertexCacheStatistics analyzeVertexCache(
+    const std::vector<Index> &indices, size_t vertexCount, int cacheSize = 16);
+
+/**
+ * @brief 使用Forsyth算法重排三角形顺序，以提高GPU顶点缓存命中率
+ *
+ * 时间复杂度与三角形数量呈线性关系
+ */
+template<typename Index>
+void optimizeVertexCache(std::vector<Index> &indices, size_t vertexCount);
+
+/**
+ * @brief 按三角形中首次被引用的顺序重排顶点，并更新三角形与线段索引
+ *
+ * 未被三角形引用的顶点排在最后，重排方式记录在mesh.vertexRemap中。须在quantizeRenderMesh之前调用
+ */
+void optimizeVertexFetch(RenderMesh &mesh);
+
+/**
+ * @brief 依次执行optimizeVertexCache和optimizeVertexFetch
+ *
+ * 若mesh中划分了簇，则只在各簇内部重排三角形，保持簇的索引区间不变
+ */
+void optimizeRenderMesh(RenderMesh &mesh);
+
+/**
+ * @brief 对RenderMesh中实际使用的三角形索引进行顶点缓存模拟
+ */
+VertexCacheStatistics analyzeVertexCache(const RenderMesh &mesh, int cacheSize = 16);
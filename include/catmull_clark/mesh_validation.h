@@ -0,0 +1,52 @@
+#pragma once
+
+#include <catmull_clark/common.h>
+
+/**
+ * @brief 网格模型的拓扑检查结果
+ *
+ * 与细分算法一致，位于同一位置的多个顶点被视为同一个顶点，报告中的顶点下标为该位置上最小的顶点下标。
+ * 各项均按下标升序排列
+ */
+struct MeshValidationReport
+{
+    // 属于两个以上面的边，细分时会导致异常
+    std::vector<Edge> nonManifoldEdges;
+
+    // 周围的面不能经由共享的边连成一片的顶点，如只共享一个顶点的两个锥
+    std::vector<Face::Index> nonManifoldVertices;
+
+    // 含有重复顶点或面积为0的面
+    std::vector<uint32_t> degenerateFaces;
+
+    // 被相邻的两个面以相同方向经过的边，即两个面的朝向不一致
+    std::vector<Edge> inconsistentEdges;
+
+    bool isManifold() const noexcept
+    {
+        return nonManifoldEdges.empty() && nonManifoldVertices.empty();
+    }
+
+    bool isValid() const noexcept
+    {
+        return isManifold() && degenerateFaces.empty() && inconsistentEdges.empty();
+    }
+};
+
+/**
+ * @brief 检查网格模型的拓扑，在多个线程上并行进行
+ *
+ * 只需要对顶点和半边各排序一次，耗时远小于一次细分，适合在细分之前调用，避免细分进行到一半时才因拓扑错误而失败
+ */
+MeshValidationReport validateMesh(const Mesh &mesh);
+
+/**
+ * @brief 拆分非流形的顶点与边，使结果可以被细分
+ *
+ * 先合并位于同一位置的顶点，再为每个顶点周围经由共享边连成一片的每组面各分配一个顶点副本；
+ * 若某条边此后仍属于两个以上的面，多余的面被分离为独立的面。结果中面的顺序与原模型相同，只含有被面引用的顶点。
+ *
+ * 顶点副本与原顶点位于同一位置，按位置合并顶点的细分会将它们重新合并，
+ * 因此应通过SubdivisionOptions::splitNonManifold细分，而不是先调用该函数再细分
+ */
+Mesh splitNonManifold(const Mesh &mesh);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 将[0, count)划分为若干连续区间，在多个线程上并行执行func(begin, end)
+ *
+ * 每个区间至少包含minGrain个元素；元素较少时直接在调用线程上执行。
+ * count不超过minGrain时不查询硬件线程数：hardware_concurrency在Linux上需要读取系统文件，
+ * 递归构建BVH等对大量小区间调用的情形中，其开销会超过区间本身的计算
+ */
+template<typename Func>
+void parallelForRange(size_t count, size_t minGrain, const Func &func)
+{
+    if(!count)
+    {
+        return;
+    }
+
+    if(count <= minGrain)
+    {
+        func(size_t(0), count);
+        return;
+    }
+
+    size_t threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+    threadCount = (std::min)(threadCount, (count + minGrain - 1) / (std::max<size_t>)(minGrain, 1));
+
+    if(threadCount <= 1)
+    {
+        func(size_t(0), count);
+        return;
+    }
+
+    const size_t rangeSize = (count + threadCount - 1) / threadCount;
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+
+    for(size_t t = 1; t < threadCount; ++t)
+    {
+        size_t begin = t * rangeSize;
+        size_t end   = (std::min)(count, begin + rangeSize);
+        if(begin < end)
+        {
+            threads.emplace_back([&func, begin, end] { func(begin, end); });
+        }
+    }
+
+    func(size_t(0), (std::min)(count, rangeSize));
+
+    for(auto &t : threads)
+    {
+        t.join();
+    }
+}
+
+/**
+ * @brief 对[0, count)中的每个下标i并行执行func(i)
+ */
+template<typename Func>
+void parallelFor(size_t count, const Func &func)
+{
+    parallelForRange(count, 1024, [&func](size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; ++i)
+        {
+            func(i);
+        }
+    });
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <catmull_clark/hierarchy.h>
+
+/**
+ * @brief 一个面及其1-ring构成的局部控制网格
+ *
+ * mesh中的第0个面为中心面，其余面均与中心面共享至少一个顶点。
+ * 中心面上任意层的细分结果乃至极限曲面都只依赖于这些控制点；
+ * 细分掩码的权重非负（边界上属于少于3个面的顶点除外），
+ * 因此中心面对应的极限曲面位于控制点的凸包内，也就位于[low, high]内。
+ *
+ * baseFace、subFace的含义与SurfaceLocation相同，frame将中心面的参数映射到SurfaceLocation::uv。
+ * 对于未细分的三角形，subFace为-1，中心面的参数即为重心坐标，frame为恒等变换
+ */
+struct LocalPatch
+{
+    Mesh     mesh;
+    uint32_t baseFace = 0;
+    int      subFace  = 0;
+    int      level    = 0;
+    UVFrame  frame;
+    Vec3     low;
+    Vec3     high;
+};
+
+/**
+ * @brief 原始模型的拓扑信息，用于按需取出各原始面的局部控制网格
+ *
+ * 与细分算法一样，位于同一位置的顶点会被合并。
+ * 只保存合并后的模型与顶点到面的邻接表，占用的内存与原始模型成正比
+ */
+class PatchTopology
+{
+public:
+
+    explicit PatchTopology(const Mesh &baseMesh);
+
+    size_t getFaceCount() const noexcept;
+
+    /**
+     * @brief 取得原始面face的局部控制网格
+     */
+    LocalPatch extractPatch(uint32_t face) const;
+
+    /**
+     * @brief 计算原始面face的局部控制网格的包围盒，不构造网格本身
+     */
+    void computePatchBounds(uint32_t face, Vec3 &low, Vec3 &high) const;
+
+private:
+
+    Mesh mesh_;
+
+    std::vector<uint32_t> vertexFaceOffsets_;
+    std::vector<uint32_t> vertexFaces_;
+};
+
+/**
+ * @brief 将局部控制网格细分一次，为中心面的每个子面构造局部控制网格
+ *
+ * 子面的顺序与applyCatmullClarkSubdivision的输出相同，返回子面数量（3或4）
+ */
+int refinePatch(const LocalPatch &patch, LocalPatch children[4]);
+
+/**
+ * @brief 若局部控制网格的中心面正则，取出其1-ring中的16个控制点
+ *
+ * 正则指中心面与其1-ring中的面都是四边形，且中心面的四个顶点均为内部的4度顶点。
+ * 控制点按4x4网格逐行排列，s沿列方向增大，t沿行方向增大，中心面的4个顶点依次位于(1, 1)、(1, 2)、(2, 2)、(2, 1)
+ */
+bool gatherRegularPatchPoints(const LocalPatch &patch, Vec3 points[16]);
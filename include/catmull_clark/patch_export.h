@@ -0,0 +1,56 @@
+#pragma once
+
+#include <catmull_clark/limit_patch.h>
+
+/**
+ * @brief 导出的曲面片在原始模型上的位置，含义与LimitPatch中的同名成员相同
+ */
+struct ExportedPatch
+{
+    uint32_t baseFace;
+    int      subFace;
+    int      level;
+    UVFrame  frame;
+};
+
+/**
+ * @brief 按类型分组的曲面片控制点，供GPU上的曲面细分管线直接使用
+ *
+ * 第i个Regular曲面片的控制点为regularPoints[16 * i, 16 * i + 16)，
+ * 第i个Gregory曲面片的控制点为gregoryPoints[20 * i, 20 * i + 20)，
+ * 第i个Bilinear曲面片的控制点为bilinearPoints[4 * i, 4 * i + 4)，排列方式均与LimitPatch相同
+ */
+struct PatchExport
+{
+    std::vector<ExportedPatch> regularPatches;
+    std::vector<Vec3>          regularPoints;
+
+    std::vector<ExportedPatch> gregoryPatches;
+    std::vector<Vec3>          gregoryPoints;
+
+    std::vector<ExportedPatch> bilinearPatches;
+    std::vector<Vec3>          bilinearPoints;
+};
+
+struct PatchExportOptions
+{
+    // 不正则的面被局部细分的次数，取值范围为[1, 15]
+    int isolationLevel = 1;
+
+    // 隔离层级上仍不正则的子面的近似方式
+    LimitEndCap endCap = LimitEndCap::Gregory;
+};
+
+/**
+ * @brief 将原始模型的极限曲面导出为曲面片
+ *
+ * 正则的原始面直接导出为16个B样条控制点；不正则的面被局部细分isolationLevel次，
+ * 其中正则的子面同样导出为B样条曲面片，其余的子面导出为Gregory曲面片（邻近边界时为Bilinear曲面片）。
+ * 每层中只有奇异顶点与边界周围的子面被继续细分，导出的曲面片数量是原始模型面数的一个较小的倍数
+ */
+PatchExport exportPatches(const Mesh &baseMesh, const PatchExportOptions &options = {});
+
+/**
+ * @brief 将已经构建的曲面片表按类型导出
+ */
+PatchExport exportPatches(const LimitPatchTable &table);
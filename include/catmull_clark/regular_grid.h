@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <catmull_clark/common.h>
+
+/**
+ * @brief 常量细分矩阵所支持的最大层级
+ */
+constexpr int MAX_REGULAR_GRID_LEVEL = 6;
+
+/**
+ * @brief 细分level次后一个面上每行（列）的顶点数
+ */
+constexpr int getRegularGridSize(int level)
+{
+    return (1 << level) + 1;
+}
+
+/**
+ * @brief 一维三次均匀B样条细分level次后，中心区间上的2^level + 1个点关于4个控制点的权重
+ *
+ * 正则四边形的Catmull-Clark细分等价于双三次B样条细分，是一维细分的张量积，
+ * 因此第level层的顶点网格等于对4x4控制点的行与列分别左乘该矩阵，不需要构造16列的稠密矩阵
+ */
+template<int Level>
+constexpr std::array<std::array<float, 4>, getRegularGridSize(Level)> computeRegularGridWeights()
+{
+    // 每层在中心区间两侧各多保留一个点，第l层共2^l + 3个点；权重都是二进分数，用double计算没有舍入误差
+
+    constexpr int MAX_COUNT = getRegularGridSize(Level) + 2;
+
+    std::array<std::array<double, 4>, MAX_COUNT> current = {};
+    for(int i = 0; i < 4; ++i)
+    {
+        current[i][i] = 1;
+    }
+
+    int count = 4;
+    for(int level = 0; level < Level; ++level)
+    {
+        // 新的点依次为edge(q0, q1)、vertex(q1)、edge(q1, q2)、...、vertex(q[count - 2])、edge(q[count - 2], q[count - 1])
+
+        std::array<std::array<double, 4>, MAX_COUNT> next = {};
+        for(int i = 0; i + 1 < count; ++i)
+        {
+            for(int k = 0; k < 4; ++k)
+            {
+                next[2 * i][k] = 0.5 * (current[i][k] + current[i + 1][k]);
+            }
+        }
+        for(int i = 1; i + 1 < count; ++i)
+        {
+            for(int k = 0; k < 4; ++k)
+            {
+                next[2 * i - 1][k] = 0.125 * (current[i - 1][k] + 6 * current[i][k] + current[i + 1][k]);
+            }
+        }
+
+        current = next;
+        count = 2 * count - 3;
+    }
+
+    std::array<std::array<float, 4>, getRegularGridSize(Level)> result = {};
+    for(int i = 0; i < getRegularGridSize(Level); ++i)
+    {
+        for(int k = 0; k < 4; ++k)
+        {
+            result[i][k] = static_cast<float>(current[i + 1][k]);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 编译期生成的第Level层细分矩阵
+ */
+template<int Level>
+struct RegularGridWeights
+{
+    static_assert(0 <= Level && Level <= MAX_REGULAR_GRID_LEVEL, "unsupported regular grid level");
+
+    static constexpr int SIZE = getRegularGridSize(Level);
+
+    static constexpr std::array<std::array<float, 4>, SIZE> WEIGHTS = computeRegularGridWeights<Level>();
+};
+
+/**
+ * @brief 细分结果的写入位置：网格第i行第j列的顶点写入origin[i * stepT + j * stepS]
+ *
+ * 步长可以为负，以便直接写入按其他方向排列的更大的网格中
+ */
+struct RegularGridTarget
+{
+    Vec3     *origin;
+    ptrdiff_t stepS;
+    ptrdiff_t stepT;
+};
+
+/**
+ * @brief 将多个正则曲面片细分level次，得到各自中心面上的(2^level + 1)^2个顶点
+ *
+ * controlPoints中每个曲面片有16个控制点，排列方式同gatherRegularPatchPoints；
+ * 网格第i行第j列的顶点位于中心面参数(j / 2^level, i / 2^level)处。
+ * level的取值范围为[0, MAX_REGULAR_GRID_LEVEL]。
+ * 曲面片每4个一组，同一组中的曲面片以SIMD并行处理，各组在多个线程上并行
+ */
+void refineRegularPatches(
+    const Vec3 *controlPoints, size_t patchCount, int level, const RegularGridTarget *targets);
+
+/**
+ * @brief 同上，第i个曲面片的网格连续写入grids[i * (2^level + 1)^2]起的位置
+ */
+void refineRegularPatches(
+    const Vec3 *controlPoints, size_t patchCount, int level, Vec3 *grids);
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <catmull_clark/cluster.h>
+
+/**
+ * @brief 用于绘制的顶点，包含位置和法线
+ */
+struct RenderVertex
+{
+    Vec3 position;
+    Vec3 normal;
+};
+
+/**
+ * @brief 量化后的绘制顶点，共12字节
+ *
+ * - position：[-1, 1]^3中的16位有符号归一化整数，第四个分量恒为1，仅用于对齐
+ * - normal：八面体映射后的16位有符号归一化整数
+ *
+ * 将position还原为模型空间位置的变换见RenderMesh::dequantizeTransform
+ */
+struct QuantizedRenderVertex
+{
+    int16_t position[4];
+    int16_t normal[2];
+};
+
+/**
+ * @brief 量化引入的最大误差
+ */
+struct QuantizationError
+{
+    float maxPositionError      = 0; // 模型空间中的距离
+    float maxNormalErrorDegrees = 0; // 法线夹角，单位为度
+};
+
+/**
+ * @brief 与平台无关的待绘制模型
+ *
+ * 所有三角形共享同一个顶点缓冲，通过索引缓冲引用顶点。
+ * 顶点数不超过65536时使用16位索引（indices16），否则使用32位索引（indices32），
+ * 两者中只有一个非空。
+ *
+ * 线框模式使用同一个顶点缓冲，线段列表的索引位宽与三角形索引相同。
+ *
+ * 量化后顶点存放在quantizedVertices中，vertices被清空；
+ * 绘制时需将dequantizeTransform左乘到local to world变换上。
+ *
+ * 若划分了簇，每个簇对应三角形索引中的一段连续区间，见buildClusters。
+ *
+ * 重排顶点顺序后（见optimizeVertexFetch），第i个绘制顶点来自网格中的第vertexRemap[i]个顶点；
+ * vertexRemap为空时两者顺序相同。
+ */
+struct RenderMesh
+{
+    std::vector<RenderVertex> vertices;
+    std::vector<uint32_t>     vertexRemap;
+
+    std::vector<QuantizedRenderVertex> quantizedVertices;
+    Mat4 dequantizeTransform;
+    QuantizationError quantizationError;
+
+    std::vector<uint16_t> indices16;
+    std::vector<uint32_t> indices32;
+
+    std::vector<uint16_t> lineIndices16;
+    std::vector<uint32_t> lineIndices32;
+
+    std::vector<Cluster> clusters;
+
+    int triangleCount = 0;
+    int quadCount     = 0;
+
+    bool isQuantized() const noexcept
+    {
+        return !quantizedVertices.empty();
+    }
+
+    size_t getVertexCount() const noexcept
+    {
+        return isQuantized() ? quantizedVertices.size() : vertices.size();
+    }
+
+    bool isIndex16() const noexcept
+    {
+        return !indices16.empty();
+    }
+
+    size_t getIndexCount() const noexcept
+    {
+        return isIndex16() ? indices16.size() : indices32.size();
+    }
+
+    size_t getLineIndexCount() const noexcept
+    {
+        return isIndex16() ? lineIndices16.size() : lineIndices32.size();
+    }
+};
+
+/**
+ * @brief 顶点法线的计算方式
+ */
+enum class NormalWeighting
+{
+    Area,  // 以面积为权重平均各面法线
+    Angle, // 以顶点处的内角为权重平均各面法线
+    Limit  // 使用Catmull-Clark极限曲面的解析法线，无法计算时退化为Area
+};
+
+struct RenderMeshOptions
+{
+    NormalWeighting normalWeighting = NormalWeighting::Area;
+
+    // 是否重排三角形与顶点顺序以提高顶点缓存命中率，见optimizeRenderMesh
+    bool optimizeIndices = false;
+
+    // 是否输出量化后的顶点，见quantizeRenderMesh
+    bool quantize = false;
+
+    // 是否将三角形划分为簇，以便在绘制前剔除不可见的簇
+    bool buildClusters = false;
+    ClusterLimits clusterLimits;
+};
+
+/**
+ * @brief 从网格模型构造带索引的待绘制模型
+ *
+ * 网格中的顶点直接作为绘制顶点（不做额外合并），四边形被拆分为两个三角形
+ */
+RenderMesh buildRenderMesh(const Mesh &mesh, const RenderMeshOptions &options = {});
+
+/**
+ * @brief 同上，并根据边表构造线框模式使用的线段列表索引
+ *
+ * 边表通常由applyCatmullClarkSubdivision一并给出
+ */
+RenderMesh buildRenderMesh(
+    const Mesh &mesh, const std::vector<Edge> &edges, const RenderMeshOptions &options = {});
+
+/**
+ * @brief 并行计算网格的顶点法线，直接写入vertices[i].normal
+ *
+ * vertices中须至少有mesh.vertices.size()个元素
+ *
+ * 使用NormalWeighting::Limit时，内部的、只被四边形包围的顶点使用极限曲面法线，
+ * 其余顶点（边界、三角形附近）使用面积加权法线
+ */
+void computeVertexNormals(
+    const Mesh &mesh, NormalWeighting weighting, RenderVertex *vertices);
+
+/**
+ * @brief 将vertices量化为quantizedVertices，同时计算dequantizeTransform与量化误差
+ *
+ * 位置以包围盒中心为原点、以最大半边长统一缩放到[-1, 1]^3，
+ * 统一缩放保证dequantizeTransform不会扭曲法线方向
+ */
+void quantizeRenderMesh(RenderMesh &mesh);
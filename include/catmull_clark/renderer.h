@@ -1,6 +1,11 @@
 #pragma once
 
-#include <catmull_clark/common.h>
+#include <agz/utility/d3d11.h>
+
+#include <catmull_clark/mesh_optimizer.h>
+#include <catmull_clark/vertex_stream.h>
+
+namespace D3D = agz::d3d11;
 
 class Renderer : public agz::misc::uncopyable_t
 {
@@ -10,8 +15,14 @@ public:
 
     /**
      * @brief 设置被绘制的模型
+     *
+     * edges为模型的边表，用于线框模式，通常由applyCatmullClarkSubdivision一并给出
+     *
+     * 若模型的拓扑、边数与选项均与上一次相同（例如只有控制网格的顶点位置发生了变化），
+     * 则保留索引缓冲与簇的划分，只重新计算并上传顶点；量化顶点总是完整重建
      */
-    void setMesh(const Mesh &mesh);
+    void setMesh(
+        const Mesh &mesh, const std::vector<Edge> &edges, const RenderMeshOptions &options = {});
 
     /**
      * @brief 设置方向光的方向
@@ -28,6 +39,11 @@ public:
      */
     void setCameraViewProj(const Mat4 &viewProj);
 
+    /**
+     * @brief 设置世界空间中的摄像机位置，用于簇的背面剔除
+     */
+    void setCameraPosition(const Vec3 &position);
+
     /**
      * @brief 绘制
      */
@@ -52,13 +68,27 @@ public:
 
     int getQuadCount() const noexcept;
 
-private:
+    /**
+     * @brief 当前模型三角形索引的顶点缓存模拟结果
+     */
+    const VertexCacheStatistics &getVertexCacheStatistics() const noexcept;
 
-    struct SolidVertex
-    {
-        Vec3 position;
-        Vec3 normal;
-    };
+    /**
+     * @brief 当前模型的量化误差，未使用量化顶点时为零
+     */
+    const QuantizationError &getQuantizationError() const noexcept;
+
+    /**
+     * @brief 模型中簇的总数，未划分簇时为零
+     */
+    int getClusterCount() const noexcept;
+
+    /**
+     * @brief 上一次绘制时通过剔除的簇的数量
+     */
+    int getVisibleClusterCount() const noexcept;
+
+private:
 
     struct SolidVSTransform
     {
@@ -77,16 +107,52 @@ private:
         Mat4 WVP;
     };
 
-    D3D::VertexBuffer<SolidVertex> solidBuffer_;
-    D3D::VertexBuffer<Vec3>   wireframeBuffer_;
+    /**
+     * @brief 能否保留索引缓冲，只更新顶点缓冲
+     */
+    bool canUpdateVertices(
+        const Mesh &mesh, const std::vector<Edge> &edges, const RenderMeshOptions &options) const;
+
+    /**
+     * @brief 重新计算顶点并写入动态顶点缓冲，须满足canUpdateVertices
+     */
+    void updateVertices(const Mesh &mesh);
+
+    void updateTransforms();
+
+    void bindVertexBuffer();
+
+    void unbindVertexBuffer();
+
+    static void drawIndexed(
+        D3D11_PRIMITIVE_TOPOLOGY topology,
+        const D3D::IndexBuffer<uint16_t> &indices16,
+        const D3D::IndexBuffer<uint32_t> &indices32);
+
+    /**
+     * @brief 剔除不可见的簇，将相邻的可见簇合并为一次绘制
+     */
+    void drawVisibleClusters();
+
+    D3D::VertexBuffer<RenderVertex>          solidBuffer_;
+    D3D::VertexBuffer<QuantizedRenderVertex> quantizedBuffer_;
+    D3D::IndexBuffer<uint16_t>               solidIndexBuffer16_;
+    D3D::IndexBuffer<uint32_t>               solidIndexBuffer32_;
+    D3D::IndexBuffer<uint16_t>               wireframeIndexBuffer16_;
+    D3D::IndexBuffer<uint32_t>               wireframeIndexBuffer32_;
 
     D3D::Shader<D3D::SS_VS, D3D::SS_PS>         solidShader_;
     D3D::UniformManager<D3D::SS_VS, D3D::SS_PS> solidUniforms_;
     D3D::InputLayout                            solidInputLayout_;
 
+    D3D::Shader<D3D::SS_VS, D3D::SS_PS>         quantizedSolidShader_;
+    D3D::UniformManager<D3D::SS_VS, D3D::SS_PS> quantizedSolidUniforms_;
+    D3D::InputLayout                            quantizedSolidInputLayout_;
+
     D3D::Shader<D3D::SS_VS, D3D::SS_PS>         wireframeShader_;
     D3D::UniformManager<D3D::SS_VS, D3D::SS_PS> wireframeUniforms_;
     D3D::InputLayout                            wireframeInputLayout_;
+    D3D::InputLayout                            quantizedWireframeInputLayout_;
 
     D3D::ConstantBuffer<SolidVSTransform> solidVSTransform_;
     D3D::ConstantBuffer<SolidPSLight>     solidPSLight_;
@@ -97,11 +163,22 @@ private:
     D3D::RasterizerState solidRasterizerState_;
     D3D::RasterizerState wireframeRasterizerState_;
 
+    Mat4 vertexTransform_; // 顶点缓冲中的坐标到模型空间的变换，用于量化顶点
     Mat4 world_;
     Mat4 viewProj_;
+    Vec3 cameraPosition_;
+
+    RenderMeshOptions   renderMeshOptions_;
+    VertexStreamUpdater vertexStream_;
+
+    std::vector<Cluster>  clusters_;
+    std::vector<uint32_t> visibleClusters_;
 
     int vertexCount_   = 0;
     int edgeCount_     = 0;
     int triangleCount_ = 0;
     int quadCount_     = 0;
+
+    VertexCacheStatistics vertexCacheStatistics_;
+    QuantizationError     quantizationError_;
 };
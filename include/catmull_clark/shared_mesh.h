@@ -0,0 +1,125 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include <catmull_clark/buffer_subdivision.h>
+
+/**
+ * @brief 共享内存中一帧细分结果的只读视图，数据直接位于映射的共享内存中
+ *
+ * 视图在写入方两次发布新的帧之后可能被覆盖，使用完毕后应以SharedMeshReader::isValid确认
+ */
+struct SharedMeshFrame
+{
+    uint64_t        sequence      = 0; // 帧号，从1开始
+    uint64_t        publishTimeNs = 0; // 发布时steady_clock的时刻，同一台机器上的进程之间可以比较
+    size_t          vertexCount   = 0;
+    size_t          faceCount     = 0;
+    const float    *positions     = nullptr; // 3 * vertexCount个float
+    const uint32_t *indices       = nullptr; // 4 * faceCount个顶点下标，面均为四边形
+};
+
+/**
+ * @brief 把细分结果写入命名的POSIX共享内存，供其他进程零拷贝地读取
+ *
+ * 共享内存中有两个槽，交替写入，读取方读取上一帧时写入方可以同时写入下一帧。
+ * 每个槽有一个原子的版本号，写入期间为奇数，写完后为帧号的两倍，读取方据此判断数据是否完整，不需要锁。
+ * 只能有一个写入方；对象析构时若该名字仍指向本对象创建的共享内存则删除名字，已经映射的读取方不受影响
+ */
+class SharedMeshWriter : public agz::misc::uncopyable_t
+{
+public:
+
+    /**
+     * @brief 创建名为name（以'/'开头）的共享内存，每帧最多maxVertexCount个顶点、maxFaceCount个四边形。
+     *        同名的共享内存已经存在时会被替换，被替换的写入方析构时不再删除该名字
+     */
+    SharedMeshWriter(const std::string &name, size_t maxVertexCount, size_t maxFaceCount);
+
+    ~SharedMeshWriter();
+
+    /**
+     * @brief 开始写入新的一帧，返回该帧在共享内存中的写入位置，可以直接作为细分的输出
+     */
+    SubdivisionOutput beginFrame(size_t vertexCount, size_t faceCount);
+
+    /**
+     * @brief 发布beginFrame开始的帧，返回其帧号
+     */
+    uint64_t publishFrame();
+
+    /**
+     * @brief 以topology细分控制点controlPoints，结果直接写入共享内存并发布，返回帧号
+     *
+     * workspace的大小不得小于topology.getWorkspaceBytes()
+     */
+    uint64_t publish(
+        const SubdivisionTopology &topology, const ConstPositionView &controlPoints,
+        ArrayView<std::byte> workspace, bool multithreaded = false);
+
+    const std::string &getName() const noexcept { return name_; }
+
+    size_t getMaxVertexCount() const noexcept { return maxVertexCount_; }
+
+    size_t getMaxFaceCount() const noexcept { return maxFaceCount_; }
+
+private:
+
+    std::string name_;
+    size_t maxVertexCount_;
+    size_t maxFaceCount_;
+
+    std::byte *data_ = nullptr;
+    size_t size_     = 0;
+
+    // 创建的共享内存的设备号与inode，析构时据此判断名字是否仍属于本对象
+    uint64_t device_ = 0;
+    uint64_t inode_  = 0;
+
+    int writingSlot_ = -1;
+};
+
+/**
+ * @brief 映射SharedMeshWriter创建的共享内存，读取其中最新的帧
+ *
+ * 只读取共享内存，不需要与写入方或其他读取方同步，任意多个进程可以同时读取
+ */
+class SharedMeshReader : public agz::misc::uncopyable_t
+{
+public:
+
+    explicit SharedMeshReader(const std::string &name);
+
+    ~SharedMeshReader();
+
+    /**
+     * @brief 最新发布的帧号，尚未发布过时为0
+     */
+    uint64_t getLatestSequence() const noexcept;
+
+    /**
+     * @brief 等待帧号大于sequence的帧发布，超时返回false。以逐渐加长的间隔轮询，不使用锁
+     */
+    bool waitForNewerThan(uint64_t sequence, std::chrono::microseconds timeout) const;
+
+    /**
+     * @brief 取得最新的完整帧，尚未发布过时返回false
+     */
+    bool acquireLatest(SharedMeshFrame &frame) const noexcept;
+
+    /**
+     * @brief frame中的数据是否仍未被覆盖。读取完frame中的数据后返回true，说明读到的是完整的一帧
+     */
+    bool isValid(const SharedMeshFrame &frame) const noexcept;
+
+    /**
+     * @brief 把最新的完整帧复制到positions与indices中，返回帧号；尚未发布过时返回0
+     */
+    uint64_t copyLatest(std::vector<float> &positions, std::vector<uint32_t> &indices) const;
+
+private:
+
+    const std::byte *data_ = nullptr;
+    size_t size_           = 0;
+};
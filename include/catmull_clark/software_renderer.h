@@ -0,0 +1,115 @@
+#pragma once
+
+#include <string>
+
+#include <catmull_clark/render_mesh.h>
+
+/**
+ * @brief 不依赖GPU的多线程软件光栅化器
+ *
+ * 接口与Renderer保持一致，光照计算与Renderer的实体/线框着色器相同。
+ * 屏幕被划分为TILE_SIZE x TILE_SIZE的块，三角形与线段先被并行地分配到所覆盖的块中，
+ * 再以块为单位并行光栅化，块内使用4路SIMD计算边函数与深度。
+ *
+ * 与近平面相交的图元会被整体丢弃，不做裁剪。
+ */
+class SoftwareRenderer : public agz::misc::uncopyable_t
+{
+public:
+
+    static constexpr int TILE_SIZE = 64;
+
+    SoftwareRenderer(int width, int height);
+
+    /**
+     * @brief 设置被绘制的模型
+     *
+     * 软件光栅化器总是使用未量化的顶点，options.quantize被忽略
+     */
+    void setMesh(
+        const Mesh &mesh, const std::vector<Edge> &edges, const RenderMeshOptions &options = {});
+
+    /**
+     * @brief 设置方向光的方向
+     */
+    void setLightDir(const Vec3 &lightDir);
+
+    /**
+     * @brief 设置模型的local to world变换矩阵
+     */
+    void setWorldTransform(const Mat4 &world);
+
+    /**
+     * @brief 设置摄像机view * proj矩阵
+     */
+    void setCameraViewProj(const Mat4 &viewProj);
+
+    /**
+     * @brief 设置是否使用线框模式
+     *
+     * 线框模式默认关闭
+     */
+    void setWireframe(bool wireframe);
+
+    /**
+     * @brief 清空颜色与深度缓冲，并绘制当前模型
+     */
+    void render();
+
+    int getWidth() const noexcept;
+
+    int getHeight() const noexcept;
+
+    /**
+     * @brief 取得颜色缓冲，按行优先存储的RGB数据，每个分量8位
+     */
+    const std::vector<uint8_t> &getColorBuffer() const noexcept;
+
+    /**
+     * @brief 将颜色缓冲保存为二进制PPM文件
+     */
+    void saveToPPM(const std::string &filename) const;
+
+private:
+
+    struct ScreenVertex
+    {
+        float x, y, z; // 屏幕空间坐标，z为[0, 1]中的深度
+        float invW;    // 1 / w，用于透视校正插值
+        bool  valid;   // 是否位于近平面之前
+        Vec3  normal;  // 世界空间中的法线
+    };
+
+    void transformVertices();
+
+    void binPrimitives();
+
+    void rasterizeTile(int tileX, int tileY);
+
+    void rasterizeTriangle(int tileX, int tileY, uint32_t triangle);
+
+    void rasterizeLine(int tileX, int tileY, uint32_t line);
+
+    template<typename Index>
+    void getPrimitive(const std::vector<Index> &indices, uint32_t primitive, int vertexCount, uint32_t *output) const;
+
+    int width_;
+    int height_;
+    int tileCountX_;
+    int tileCountY_;
+
+    RenderMesh mesh_;
+
+    Vec3 lightDir_;
+    Mat4 world_;
+    Mat4 viewProj_;
+    bool wireframe_;
+
+    std::vector<ScreenVertex> screenVertices_;
+
+    // bins_[thread][tile]：各分配线程写入自己的列表，光栅化时按线程顺序合并，结果与线程数无关
+    std::vector<std::vector<std::vector<uint32_t>>> bins_;
+
+    std::vector<uint8_t> color_;
+    std::vector<float>   depth_;
+};
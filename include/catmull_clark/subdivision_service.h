@@ -0,0 +1,267 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <string>
+#include <thread>
+
+#include <catmull_clark/topology_cache.h>
+
+/*
+ * 本地细分服务，客户端与服务端经Unix domain socket交换消息，只能在POSIX系统下使用。
+ *
+ * 请求为ServiceRequestHeader，随后依次为3 * vertexCount个float的控制点、faceCount个uint8的面顶点数、
+ * indexCount个uint32的顶点下标。回复为ServiceResponseHeader，成功时随后为3 * vertexCount个float的顶点位置与
+ * indexCount个uint32的四边形顶点下标；失败或查询统计信息时随后为messageBytes字节的文本；
+ * 设置了SERVICE_FLAG_SHARED_MEMORY时随后为messageBytes字节的共享内存名字。
+ * 所有字段均为本机字节序。一个连接上可以连续发送多个请求而不等待回复，回复按完成的顺序返回，以requestId对应
+ */
+
+constexpr uint32_t SERVICE_MAGIC = 0x44534343; // "CCSD"
+
+// 回复中不含四边形的顶点下标，适合拓扑不变、只有控制点逐帧变化的请求
+constexpr uint32_t SERVICE_FLAG_OMIT_INDICES = 1;
+
+// 结果不经socket传回，而是作为新的一帧写入服务端为该连接创建的命名共享内存（见shared_mesh.h），
+// 回复中为共享内存的名字与帧号，以SharedMeshReader读取。共享内存只保留最近两帧；
+// 输出超过其容量时服务端改用新名字的共享内存，连接关闭时删除名字
+constexpr uint32_t SERVICE_FLAG_SHARED_MEMORY = 2;
+
+enum class ServiceMessageType : uint32_t
+{
+    Subdivide = 1,
+    Stats     = 2
+};
+
+enum class ServiceStatus : uint32_t
+{
+    Success        = 0,
+    InvalidRequest = 1,
+    Failed         = 2
+};
+
+struct ServiceRequestHeader
+{
+    uint32_t magic          = SERVICE_MAGIC;
+    uint32_t type           = static_cast<uint32_t>(ServiceMessageType::Subdivide);
+    uint64_t requestId      = 0;
+    uint32_t iterationCount = 0;
+    uint32_t flags          = 0;
+    uint64_t vertexCount    = 0;
+    uint64_t faceCount      = 0;
+    uint64_t indexCount     = 0;
+};
+
+struct ServiceResponseHeader
+{
+    uint32_t magic        = SERVICE_MAGIC;
+    uint32_t status       = 0;
+    uint64_t requestId    = 0;
+    uint64_t vertexCount  = 0;
+    uint64_t faceCount    = 0;
+    uint64_t indexCount   = 0; // 随后的顶点下标数，设置了SERVICE_FLAG_OMIT_INDICES时为0
+    uint64_t messageBytes = 0;
+    uint64_t sequence     = 0; // 设置了SERVICE_FLAG_SHARED_MEMORY时为结果在共享内存中的帧号
+};
+
+static_assert(sizeof(ServiceRequestHeader) == 48);
+static_assert(sizeof(ServiceResponseHeader) == 56);
+
+struct SubdivisionServerOptions
+{
+    // 工作线程数，为0时取硬件线程数
+    size_t threadCount = 0;
+
+    // 输出顶点数小于该值的请求被视为小请求，一个工作线程一次取出若干个小请求连续处理，其输出顶点数之和不超过该值
+    size_t batchVertexBudget = 1 << 16;
+
+    // 拓扑缓存的内存上限
+    size_t cacheBytes = size_t(256) << 20;
+
+    // 拓扑的磁盘缓存目录，为空时不使用磁盘缓存
+    std::string cacheDirectory;
+
+    // 单个请求的大小上限，超过时关闭连接
+    size_t maxRequestBytes = size_t(1) << 30;
+
+    // 每个连接上已读取、尚未回复的请求数上限，达到上限时暂停读取该连接
+    size_t maxPendingRequestsPerConnection = 64;
+
+    // 所有连接上已读取、尚未回复的请求的总字节数上限，达到上限时暂停读取所有连接
+    size_t maxQueuedBytes = size_t(1) << 30;
+
+    // 写出一条回复的时间上限（毫秒），超时的连接被关闭，避免不读取回复的客户端长期占用工作线程
+    int sendTimeoutMs = 5000;
+
+    int maxIterationCount = 8;
+};
+
+struct SubdivisionServerMetrics
+{
+    uint64_t receivedRequests  = 0;
+    uint64_t completedRequests = 0;
+    uint64_t failedRequests    = 0; // 包括因写出失败或超时而未能回复的请求
+    uint64_t batches           = 0; // 工作线程取出请求的次数，completedRequests / batches为平均每批的请求数
+    uint64_t pausedReads       = 0; // 读取线程因达到请求数或字节数上限而等待的次数
+
+    size_t queueDepth      = 0;
+    size_t maxQueueDepth   = 0;
+    size_t queuedBytes     = 0; // 已读取、尚未回复的请求的总字节数
+    size_t connectionCount = 0; // 读取线程尚未返回的连接数
+
+    // 最近1024个请求从读完请求到写完回复的时间，以及其中在队列中等待的时间
+    double meanLatencyUs   = 0;
+    double p50LatencyUs    = 0;
+    double p99LatencyUs    = 0;
+    double meanQueueTimeUs = 0;
+
+    TopologyCacheStats     cache;
+    TopologyDiskCacheStats diskCache;
+
+    /**
+     * @brief 每行一项，格式为“名称 值”
+     */
+    std::string toString() const;
+};
+
+/**
+ * @brief 细分服务的服务端
+ *
+ * 每个连接由一个线程读取请求，放入公共队列；工作线程从队列中取出请求，按连接关系从TopologyCache取得拓扑，
+ * 求值后立即把结果写回对应的连接。小请求被合并为一批由同一个工作线程连续处理，减少线程切换。
+ * 未回复的请求数或字节数达到上限时暂停读取，不读取回复的客户端在写出超时后被断开
+ */
+class SubdivisionServer : public agz::misc::uncopyable_t
+{
+public:
+
+    /**
+     * @brief 在socketPath上监听，同名的文件已存在时被替换
+     */
+    explicit SubdivisionServer(const std::string &socketPath, const SubdivisionServerOptions &options = {});
+
+    /**
+     * @brief 析构前run必须已经返回
+     */
+    ~SubdivisionServer();
+
+    /**
+     * @brief 接受连接并处理请求，直到stop被调用
+     */
+    void run();
+
+    /**
+     * @brief 使run返回，可以在任意线程上调用。已开始处理的请求照常回复，队列中其余的请求回复ServiceStatus::Failed，
+     *        随后关闭所有连接的读写两端
+     */
+    void stop();
+
+    SubdivisionServerMetrics getMetrics() const;
+
+private:
+
+    struct Connection;
+    struct Job;
+
+    struct Reader
+    {
+        std::shared_ptr<Connection> connection;
+        std::thread thread;
+    };
+
+    void readRequests(std::shared_ptr<Connection> connection);
+
+    /**
+     * @brief 等待connection与服务端未回复的请求低于上限，服务端停止或连接已关闭时返回false
+     */
+    bool waitForSpace(Connection &connection);
+
+    /**
+     * @brief 回收已经返回的读取线程，只在run的线程上调用
+     */
+    void reapReaders();
+
+    void processJobs();
+
+    void processJob(Job &job, std::vector<float> &positions, std::vector<std::byte> &workspace);
+
+    /**
+     * @brief 已回复的请求不再计入所在连接与服务端的上限，唤醒等待的读取线程
+     */
+    void releaseJob(const Job &job);
+
+    std::string socketPath_;
+    SubdivisionServerOptions options_;
+
+    int listenFd_ = -1;
+    std::atomic<bool> stopping_ = false;
+
+    // 连接的序号，用于为连接的共享内存命名
+    std::atomic<uint64_t> nextConnectionId_ = 0;
+
+    std::shared_ptr<TopologyDiskCache> diskCache_;
+    TopologyCache cache_;
+
+    mutable std::mutex queueMutex_;
+    std::condition_variable queueCondition_;
+    std::deque<std::unique_ptr<Job>> queue_;
+
+    // 以下由queueMutex_保护，读取线程在spaceCondition_上等待未回复的请求减少
+    std::condition_variable spaceCondition_;
+    size_t queuedBytes_ = 0;
+
+    // 只在run的线程上访问
+    std::vector<Reader> readers_;
+
+    mutable std::mutex metricsMutex_;
+    SubdivisionServerMetrics metrics_;
+    std::vector<double> latencies_;
+    std::vector<double> queueTimes_;
+    size_t nextSample_ = 0;
+};
+
+struct ServiceResponse
+{
+    uint64_t      requestId = 0;
+    ServiceStatus status    = ServiceStatus::Success;
+
+    std::vector<float>    positions;
+    std::vector<uint32_t> indices;
+    std::string           message; // 设置了SERVICE_FLAG_SHARED_MEMORY时为共享内存的名字
+
+    uint64_t sequence = 0;
+};
+
+/**
+ * @brief 细分服务的客户端，同一时刻只能被一个线程使用
+ */
+class SubdivisionClient : public agz::misc::uncopyable_t
+{
+public:
+
+    explicit SubdivisionClient(const std::string &socketPath);
+
+    ~SubdivisionClient();
+
+    /**
+     * @brief 发送细分请求，不等待回复
+     */
+    void sendRequest(uint64_t requestId, const MeshView &mesh, int iterationCount, uint32_t flags = 0);
+
+    /**
+     * @brief 等待并接收一个回复
+     */
+    ServiceResponse receiveResponse();
+
+    /**
+     * @brief 查询服务端的统计信息，格式同SubdivisionServerMetrics::toString。不能在有未接收的回复时调用
+     */
+    std::string queryStats();
+
+private:
+
+    int fd_ = -1;
+
+    std::vector<float> packedPositions_;
+};
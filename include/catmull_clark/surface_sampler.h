@@ -0,0 +1,58 @@
+#pragma once
+
+#include <catmull_clark/limit_patch.h>
+
+/**
+ * @brief 极限曲面上的一个样本
+ */
+struct SurfaceSample
+{
+    SurfaceLocation location;
+    Vec3 position;
+    Vec3 normal;
+};
+
+/**
+ * @brief 在极限曲面上按面积均匀地采样
+ *
+ * 构造时由LimitPatchTable::getJacobianBound取得每个曲面片上面积元|ds × dt|的上界，据此建立别名表，
+ * 以O(1)的代价选取曲面片；曲面片内的参数均匀采样，再以|ds × dt|与上界之比为概率接受，抵消参数化带来的面积畸变。
+ * 上界对曲面片内的所有参数都成立，因此样本关于曲面片表所表示的曲面严格按面积均匀分布，
+ * 上界偏松只会增加被拒绝的次数。
+ * 被接受的样本的位置与法线在接受时已经求出，不需要再次求值。
+ * 曲面的总面积由各曲面片上的Gauss-Legendre积分估计。
+ *
+ * 只持有table的引用，table须在采样期间保持有效
+ */
+class LimitSurfaceSampler : public agz::misc::uncopyable_t
+{
+public:
+
+    explicit LimitSurfaceSampler(const LimitPatchTable &table);
+
+    /**
+     * @brief 极限曲面的面积估计值
+     */
+    float getSurfaceArea() const noexcept;
+
+    /**
+     * @brief 在多个线程上并行地生成count个样本
+     *
+     * 样本按固定大小分批，每批使用由seed与批次下标导出的独立随机数序列，
+     * 因此相同的seed总是给出相同的结果，与线程数无关
+     */
+    void sample(uint64_t seed, size_t count, SurfaceSample *samples) const;
+
+private:
+
+    const LimitPatchTable &table_;
+
+    float surfaceArea_;
+
+    // 别名表：落在第i列时以aliasProbability_[i]的概率选取曲面片i，否则选取aliasIndex_[i]
+    std::vector<float>    aliasProbability_;
+    std::vector<uint32_t> aliasIndex_;
+
+    // 各曲面片上|ds × dt|的上界
+    std::vector<float> maxJacobian_;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <catmull_clark/buffer_subdivision.h>
+
+/**
+ * @brief 由各面的顶点数、顶点下标与控制点数计算的64位哈希，与顶点位置无关，连接关系相同的模型哈希相同
+ */
+uint64_t hashTopology(const IndexView &faceVertexCounts, const IndexView &indices, size_t vertexCount);
+
+struct TopologyCacheStats
+{
+    uint64_t hits        = 0;
+    uint64_t misses      = 0;
+    uint64_t evictions   = 0;
+    size_t   entryCount  = 0;
+    size_t   memoryBytes = 0;
+};
+
+struct TopologyDiskCacheStats
+{
+    uint64_t hits          = 0;
+    uint64_t misses        = 0;
+    uint64_t rejected      = 0; // 文件损坏、版本不符或连接关系不同（哈希冲突）而被重新建立的拓扑
+    uint64_t writeFailures = 0;
+};
+
+/**
+ * @brief 把SubdivisionTopology按连接关系的哈希保存在目录中，供之后的进程映射使用
+ *
+ * 文件名为“哈希-细分次数.cctopo”。命中时映射文件并比较连接关系，随后只需对控制点求值；
+ * 未命中或文件无效时建立拓扑并写回。写入经临时文件改名完成，多个进程可以共享同一目录。
+ * 可以同时在多个线程上使用
+ */
+class TopologyDiskCache : public agz::misc::uncopyable_t
+{
+public:
+
+    /**
+     * @brief 目录不存在时创建
+     */
+    explicit TopologyDiskCache(std::string directory);
+
+    std::shared_ptr<const SubdivisionTopology> getOrCreate(
+        const IndexView &faceVertexCounts, const IndexView &indices, size_t vertexCount,
+        int iterationCount, bool multithreaded = true);
+
+    /**
+     * @brief 同上，topologyHash必须为hashTopology(faceVertexCounts, indices, vertexCount)
+     */
+    std::shared_ptr<const SubdivisionTopology> getOrCreate(
+        uint64_t topologyHash, const IndexView &faceVertexCounts, const IndexView &indices, size_t vertexCount,
+        int iterationCount, bool multithreaded = true);
+
+    std::string getFilename(uint64_t topologyHash, int iterationCount) const;
+
+    TopologyDiskCacheStats getStats() const;
+
+private:
+
+    std::string directory_;
+
+    std::atomic<uint64_t> hits_          = 0;
+    std::atomic<uint64_t> misses_        = 0;
+    std::atomic<uint64_t> rejected_      = 0;
+    std::atomic<uint64_t> writeFailures_ = 0;
+};
+
+/**
+ * @brief 按连接关系缓存SubdivisionTopology，总内存超过上限时淘汰最久未使用的拓扑
+ *
+ * 命中时会逐个比较顶点数与顶点下标，哈希冲突不会导致错误的结果。给定diskCache时，内存中未命中的拓扑
+ * 从diskCache中取得。可以同时在多个线程上使用
+ */
+class TopologyCache : public agz::misc::uncopyable_t
+{
+public:
+
+    explicit TopologyCache(size_t maxMemoryBytes, std::shared_ptr<TopologyDiskCache> diskCache = nullptr);
+
+    /**
+     * @brief 取得细分iterationCount次的拓扑，缓存中没有时建立
+     *
+     * 建立拓扑时不持有锁；同一拓扑同时在多个线程上未命中时可能被建立多次，只有一份被保留
+     */
+    std::shared_ptr<const SubdivisionTopology> getOrCreate(
+        const IndexView &faceVertexCounts, const IndexView &indices, size_t vertexCount, int iterationCount);
+
+    TopologyCacheStats getStats() const;
+
+private:
+
+    struct Entry
+    {
+        uint64_t key;
+        size_t   memoryBytes;
+
+        // 哈希冲突由topology->matches排除，不另外保存连接关系
+        std::shared_ptr<const SubdivisionTopology> topology;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    EntryList::iterator find(
+        uint64_t key, const IndexView &faceVertexCounts, const IndexView &indices,
+        size_t vertexCount, int iterationCount);
+
+    mutable std::mutex mutex_;
+
+    size_t maxMemoryBytes_;
+    std::shared_ptr<TopologyDiskCache> diskCache_;
+    TopologyCacheStats stats_;
+
+    // 最近使用的在前
+    EntryList entries_;
+    std::unordered_multimap<uint64_t, EntryList::iterator> keyToEntry_;
+};
+
+/**
+ * @brief 同applyCatmullClarkSubdivision(originalMesh, iterationCount)，拓扑取自cache
+ *
+ * 与逐层建立Model的细分一样先按位置合并顶点，再以合并后的连接关系查找拓扑，命中时只需对顶点位置求值。
+ * 面的顺序相同，顶点的顺序可能不同；与SubdivisionTopology一样，开放边界附近的结果与前者有差异
+ */
+Mesh applyCatmullClarkSubdivision(const Mesh &originalMesh, int iterationCount, TopologyDiskCache &cache);
+
+/**
+ * @brief 同上，拓扑取自内存中的cache
+ */
+Mesh applyCatmullClarkSubdivision(const Mesh &originalMesh, int iterationCount, TopologyCache &cache);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <catmull_clark/render_mesh.h>
+
+/**
+ * @brief 顶点数组中的区间[begin, end)
+ */
+struct VertexRange
+{
+    size_t begin = 0;
+    size_t end   = 0;
+
+    bool empty() const noexcept
+    {
+        return begin >= end;
+    }
+
+    size_t size() const noexcept
+    {
+        return empty() ? 0 : end - begin;
+    }
+};
+
+/**
+ * @brief 拓扑不变、只有顶点位置变化时，增量地更新绘制顶点
+ *
+ * 保存上一次上传的绘制顶点作为暂存数组，以及构造它时使用的拓扑。
+ * 新的网格与记录的拓扑相同时，只重新计算位置与法线，
+ * 并与暂存数组比较得到需要重新上传的顶点区间，索引与线框索引无需重建。
+ *
+ * 不依赖任何图形API；拓扑不变时暂存数组被反复复用，不会重新分配。
+ */
+class VertexStreamUpdater
+{
+public:
+
+    /**
+     * @brief 以renderMesh的绘制顶点作为暂存数组的初始内容，并记录mesh的拓扑
+     *
+     * renderMesh须由mesh构造且未经量化
+     */
+    void reset(const Mesh &mesh, const RenderMesh &renderMesh, NormalWeighting weighting);
+
+    /**
+     * @brief 清空记录的拓扑与暂存数组
+     */
+    void clear();
+
+    /**
+     * @brief mesh的顶点数与面是否与记录的拓扑完全相同
+     */
+    bool isCompatible(const Mesh &mesh) const;
+
+    /**
+     * @brief 用mesh的顶点位置重新计算绘制顶点并写入暂存数组
+     *
+     * mesh须满足isCompatible，否则抛出std::runtime_error
+     *
+     * @return 内容发生变化的绘制顶点所在的最小区间，没有变化时为空
+     */
+    VertexRange update(const Mesh &mesh);
+
+    /**
+     * @brief 暂存数组，顺序与绘制顶点相同
+     */
+    const std::vector<RenderVertex> &getVertices() const noexcept;
+
+private:
+
+    NormalWeighting weighting_ = NormalWeighting::Area;
+
+    std::vector<Face>     faces_;
+    std::vector<uint32_t> vertexRemap_;
+
+    std::vector<RenderVertex> meshOrderVertices_; // 按网格顶点顺序排列的计算结果
+    std::vector<RenderVertex> vertices_;          // 按绘制顶点顺序排列的暂存数组
+};
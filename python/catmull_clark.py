@@ -0,0 +1,242 @@
+"""
+细分库的Python接口，通过ctypes调用C接口（c_api.h）所在的动态库CatmullClarkC。
+
+NumPy数组以指针与步长的形式直接传给动态库，满足条件时不复制数据：
+位置为(n, 3)的float32数组，且每行的3个分量连续（行之间可以有间隔，如交错的顶点缓冲区中的一列）；
+各面的顶点数与顶点下标为一维的uint8、uint16、uint32或int32数组，步长任意。
+不满足条件的输入会先被转换为连续数组。ctypes在调用动态库期间释放GIL，其他Python线程可以同时运行。
+
+动态库按以下顺序查找：环境变量CATMULL_CLARK_LIBRARY、本文件所在的目录、系统的库搜索路径。
+"""
+
+import ctypes
+import ctypes.util
+import os
+import sys
+
+import numpy as np
+
+__all__ = ['SubdivisionError', 'Topology', 'Evaluator', 'subdivide']
+
+_SUCCESS = 0
+_FLAG_SINGLE_THREADED = 1
+
+_INDEX_TYPES = {
+    np.dtype(np.uint8):  0,
+    np.dtype(np.uint16): 1,
+    np.dtype(np.uint32): 2,
+    np.dtype(np.int32):  2,  # 非负的int32与uint32的内存表示相同，负数会被当作越界的下标
+}
+
+
+class _ConstPositionBuffer(ctypes.Structure):
+    _fields_ = [('data', ctypes.c_void_p), ('stride', ctypes.c_size_t), ('count', ctypes.c_size_t)]
+
+
+class _PositionBuffer(ctypes.Structure):
+    _fields_ = [('data', ctypes.c_void_p), ('stride', ctypes.c_size_t), ('count', ctypes.c_size_t)]
+
+
+class _ConstIndexBuffer(ctypes.Structure):
+    _fields_ = [('data', ctypes.c_void_p), ('stride', ctypes.c_size_t),
+                ('count', ctypes.c_size_t), ('type', ctypes.c_int)]
+
+
+class _IndexBuffer(ctypes.Structure):
+    _fields_ = [('data', ctypes.c_void_p), ('stride', ctypes.c_size_t),
+                ('count', ctypes.c_size_t), ('type', ctypes.c_int)]
+
+
+def _find_library():
+    path = os.environ.get('CATMULL_CLARK_LIBRARY')
+    if path:
+        return path
+
+    names = {'win32': ['CatmullClarkC.dll'], 'darwin': ['libCatmullClarkC.dylib']}
+    for name in names.get(sys.platform, ['libCatmullClarkC.so']):
+        path = os.path.join(os.path.dirname(os.path.abspath(__file__)), name)
+        if os.path.exists(path):
+            return path
+
+    path = ctypes.util.find_library('CatmullClarkC')
+    if path:
+        return path
+
+    raise OSError('CatmullClarkC library not found, set CATMULL_CLARK_LIBRARY to its path')
+
+
+def _load_library():
+    lib = ctypes.CDLL(_find_library())
+
+    handle = ctypes.c_void_p
+    result = ctypes.c_int
+
+    signatures = {
+        'ccsGetApiVersion':        (ctypes.c_uint32, []),
+        'ccsGetLastError':         (ctypes.c_char_p, []),
+        'ccsCreateTopology':       (result, [ctypes.POINTER(_ConstIndexBuffer), ctypes.POINTER(_ConstIndexBuffer),
+                                             ctypes.c_size_t, ctypes.c_int, ctypes.c_uint32,
+                                             ctypes.POINTER(handle)]),
+        'ccsDestroyTopology':      (None, [handle]),
+        'ccsGetInputVertexCount':  (ctypes.c_size_t, [handle]),
+        'ccsGetOutputVertexCount': (ctypes.c_size_t, [handle]),
+        'ccsGetOutputFaceCount':   (ctypes.c_size_t, [handle]),
+        'ccsCopyOutputIndices':    (result, [handle, ctypes.POINTER(_IndexBuffer)]),
+        'ccsCreateEvaluator':      (result, [handle, ctypes.c_uint32, ctypes.POINTER(handle)]),
+        'ccsDestroyEvaluator':     (None, [handle]),
+        'ccsEvaluate':             (result, [handle, ctypes.POINTER(_ConstPositionBuffer),
+                                             ctypes.POINTER(_PositionBuffer)]),
+    }
+
+    for name, (restype, argtypes) in signatures.items():
+        func = getattr(lib, name)
+        func.restype = restype
+        func.argtypes = argtypes
+
+    if lib.ccsGetApiVersion() != 1:
+        raise OSError('unsupported CatmullClarkC API version %d' % lib.ccsGetApiVersion())
+
+    return lib
+
+
+_lib = _load_library()
+
+
+class SubdivisionError(RuntimeError):
+    """C接口返回的错误，code为CcsResult"""
+
+    def __init__(self, code, message):
+        super().__init__(message)
+        self.code = code
+
+
+def _check(code):
+    if code != _SUCCESS:
+        raise SubdivisionError(code, _lib.ccsGetLastError().decode('utf-8', 'replace'))
+
+
+def _as_index_buffer(array):
+    """把一维整数数组描述为_ConstIndexBuffer，返回描述与需要在调用期间保持存活的数组"""
+    array = np.asarray(array)
+    if array.ndim != 1:
+        array = array.reshape(-1)
+
+    if array.dtype not in _INDEX_TYPES or array.strides[0] <= 0:
+        array = np.ascontiguousarray(array, dtype=np.uint32)
+
+    buffer = _ConstIndexBuffer(array.ctypes.data, array.strides[0], array.shape[0], _INDEX_TYPES[array.dtype])
+    return buffer, array
+
+
+def _as_position_buffer(array):
+    """把(n, 3)的位置数组描述为_ConstPositionBuffer，返回描述与需要在调用期间保持存活的数组"""
+    array = np.asarray(array)
+    if array.ndim != 2 or array.shape[1] != 3:
+        raise ValueError('positions must have shape (n, 3)')
+
+    if array.dtype != np.float32 or array.strides[1] != 4 or array.strides[0] < 12 \
+            or array.strides[0] % 4 or array.ctypes.data % 4:
+        array = np.ascontiguousarray(array, dtype=np.float32)
+
+    return _ConstPositionBuffer(array.ctypes.data, array.strides[0], array.shape[0]), array
+
+
+def _check_output_positions(out, count):
+    if out.dtype != np.float32 or out.ndim != 2 or out.shape[1] != 3 or out.shape[0] < count \
+            or out.strides[1] != 4 or out.strides[0] < 12 or out.strides[0] % 4 or out.ctypes.data % 4 \
+            or not out.flags.writeable:
+        raise ValueError('out must be a writeable, 4-byte aligned float32 array of shape (n >= %d, 3) '
+                         'with contiguous rows' % count)
+
+
+class Topology:
+    """
+    预先建立的各层拓扑，只依赖各面的顶点数与顶点下标。
+
+    face_vertex_counts中第f个元素为第f个面的顶点数（3或4），indices中依次为各面的顶点下标；
+    所有面顶点数相同时，indices也可以是(面数, 3)或(面数, 4)的数组。
+    建立后不再改变，可以同时被多个线程上的Evaluator使用
+    """
+
+    def __init__(self, face_vertex_counts, indices, vertex_count, iterations, multithreaded=True):
+        counts, counts_array = _as_index_buffer(face_vertex_counts)
+        index, index_array = _as_index_buffer(indices)
+
+        flags = 0 if multithreaded else _FLAG_SINGLE_THREADED
+        handle = ctypes.c_void_p()
+        _check(_lib.ccsCreateTopology(
+            ctypes.byref(counts), ctypes.byref(index), vertex_count, iterations, flags, ctypes.byref(handle)))
+
+        self._handle = handle
+        self.iterations = iterations
+        self.input_vertex_count = _lib.ccsGetInputVertexCount(handle)
+        self.output_vertex_count = _lib.ccsGetOutputVertexCount(handle)
+        self.output_face_count = _lib.ccsGetOutputFaceCount(handle)
+
+    def __del__(self):
+        # 解释器退出时模块的全局变量可能已被清空，此时动态库随进程一同释放
+        if getattr(self, '_handle', None) and _lib is not None:
+            _lib.ccsDestroyTopology(self._handle)
+            self._handle = None
+
+    def quads(self, dtype=np.uint32, out=None):
+        """细分结果中各四边形的顶点下标，形状为(面数, 4)，dtype可以为uint32或uint16"""
+        dtype = np.dtype(dtype)
+        if dtype not in (np.dtype(np.uint16), np.dtype(np.uint32)):
+            raise ValueError('dtype must be uint16 or uint32')
+
+        if out is None:
+            out = np.empty((self.output_face_count, 4), dtype=dtype)
+        elif out.dtype != dtype or out.size < 4 * self.output_face_count or not out.flags.c_contiguous:
+            raise ValueError('out must be a contiguous %s array of at least %d elements'
+                             % (dtype.name, 4 * self.output_face_count))
+
+        buffer = _IndexBuffer(out.ctypes.data, dtype.itemsize, out.size, _INDEX_TYPES[dtype])
+        _check(_lib.ccsCopyOutputIndices(self._handle, ctypes.byref(buffer)))
+        return out
+
+    def evaluator(self, multithreaded=True):
+        return Evaluator(self, multithreaded)
+
+
+class Evaluator:
+    """持有求值所需的工作区，同一时刻只能被一个线程使用"""
+
+    def __init__(self, topology, multithreaded=True):
+        flags = 0 if multithreaded else _FLAG_SINGLE_THREADED
+        handle = ctypes.c_void_p()
+        _check(_lib.ccsCreateEvaluator(topology._handle, flags, ctypes.byref(handle)))
+
+        self._handle = handle
+        self.topology = topology
+
+    def __del__(self):
+        # 解释器退出时模块的全局变量可能已被清空，此时动态库随进程一同释放
+        if getattr(self, '_handle', None) and _lib is not None:
+            _lib.ccsDestroyEvaluator(self._handle)
+            self._handle = None
+
+    def evaluate(self, positions, out=None):
+        """
+        计算控制点为positions时细分结果的顶点位置，返回(顶点数, 3)的float32数组。
+
+        给出out时结果写入out（可以是交错的顶点缓冲区中每行连续的3列），不分配新数组
+        """
+        count = self.topology.output_vertex_count
+        if out is None:
+            out = np.empty((count, 3), dtype=np.float32)
+        else:
+            _check_output_positions(out, count)
+
+        input_buffer, input_array = _as_position_buffer(positions)
+        output = _PositionBuffer(out.ctypes.data, out.strides[0], out.shape[0])
+
+        _check(_lib.ccsEvaluate(self._handle, ctypes.byref(input_buffer), ctypes.byref(output)))
+        return out
+
+
+def subdivide(positions, face_vertex_counts, indices, iterations):
+    """细分一次性的模型，返回(顶点位置, 四边形的顶点下标)；拓扑不变的模型应复用Topology与Evaluator"""
+    positions = np.asarray(positions)
+    topology = Topology(face_vertex_counts, indices, positions.shape[0], iterations)
+    return topology.evaluator().evaluate(positions), topology.quads()
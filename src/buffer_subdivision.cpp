@@ -0,0 +1,1337 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <catmull_clark/buffer_subdivision.h>
+#include <catmull_clark/parallel.h>
+
+namespace
+{
+
+    constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    /**
+     * @brief 一条边，corners为经过该边的面上该边起点所在的角，按下标升序排列，边界边的corners[1]为INVALID_INDEX
+     *
+     * 第f个面的第i个顶点称为一个角；第一层之后所有面都是四边形，第f个面的角为[4f, 4f + 4)
+     */
+    struct EdgeRecord
+    {
+        uint32_t lowVertex;
+        uint32_t highVertex;
+        uint32_t corners[2];
+    };
+
+    struct HalfEdge
+    {
+        uint64_t key;    // 两端的顶点下标，较小者在高32位
+        uint32_t corner; // 起点所在的角
+        uint32_t padding;
+    };
+
+    struct LevelSizes
+    {
+        size_t vertexCount;
+        size_t faceCount;
+        size_t edgeCount;
+        size_t cornerCount;
+    };
+
+    /**
+     * @brief 细分一次后：每个旧顶点、旧边、旧面各产生一个顶点，每个旧角产生一个四边形，
+     *        每条旧边被分为两条，每个旧角与面中心之间产生一条边
+     */
+    LevelSizes getNextLevelSizes(const LevelSizes &sizes)
+    {
+        return {
+            sizes.vertexCount + sizes.edgeCount + sizes.faceCount,
+            sizes.cornerCount,
+            2 * sizes.edgeCount + sizes.cornerCount,
+            4 * sizes.cornerCount
+        };
+    }
+
+    /**
+     * @brief 工作区中各数组的字节偏移
+     *
+     * 第l层的拓扑与位置存放在第l % 2组数组中，最后一层直接写入输出
+     */
+    struct WorkspaceLayout
+    {
+        size_t halfEdges;
+        size_t faceOffsets;
+        size_t cornerFaces;
+
+        size_t positions[2];
+        size_t indices[2];
+        size_t faceEdges[2];
+        size_t edges[2];
+
+        size_t facePoints;
+        size_t faceSums;
+        size_t midSums;
+        size_t faceCounts;
+        size_t edgeCounts;
+
+        size_t totalBytes;
+    };
+
+    LevelSizes getFinalSizes(const LevelSizes &baseSizes, int iterationCount)
+    {
+        LevelSizes sizes = baseSizes;
+        for(int level = 0; level < iterationCount; ++level)
+        {
+            sizes = getNextLevelSizes(sizes);
+        }
+
+        if(sizes.vertexCount > UINT32_MAX || sizes.cornerCount > UINT32_MAX)
+        {
+            throw std::runtime_error("applyCatmullClarkSubdivision: result exceeds 32-bit indices");
+        }
+
+        return sizes;
+    }
+
+    /**
+     * @brief withTopology为false时只包含逐层计算位置所需的数组，用于拓扑已预先建立的情形
+     */
+    WorkspaceLayout computeWorkspaceLayout(const LevelSizes &baseSizes, int iterationCount, bool withTopology = true)
+    {
+        // 各数组的大小取第[0, iterationCount)层中的最大值
+
+        LevelSizes maxSizes = baseSizes;
+        LevelSizes sizes = baseSizes;
+        for(int level = 1; level < iterationCount; ++level)
+        {
+            sizes = getNextLevelSizes(sizes);
+            maxSizes = sizes;
+        }
+
+        WorkspaceLayout layout = {};
+        size_t offset = 0;
+
+        auto allocate = [&](size_t bytes)
+        {
+            const size_t result = offset;
+            offset += (bytes + 15) & ~size_t(15);
+            return result;
+        };
+
+        if(withTopology)
+        {
+            layout.halfEdges   = allocate(baseSizes.cornerCount * sizeof(HalfEdge));
+            layout.faceOffsets = allocate((baseSizes.faceCount + 1) * sizeof(uint32_t));
+            layout.cornerFaces = allocate(baseSizes.cornerCount * sizeof(uint32_t));
+        }
+
+        for(int s = 0; s < 2; ++s)
+        {
+            layout.positions[s] = allocate(maxSizes.vertexCount * sizeof(Vec3));
+            if(withTopology)
+            {
+                layout.indices[s]   = allocate(maxSizes.cornerCount * sizeof(uint32_t));
+                layout.faceEdges[s] = allocate(maxSizes.cornerCount * sizeof(uint32_t));
+                layout.edges[s]     = allocate(maxSizes.edgeCount * sizeof(EdgeRecord));
+            }
+        }
+
+        layout.facePoints = allocate(maxSizes.faceCount * sizeof(Vec3));
+        layout.faceSums   = allocate(maxSizes.vertexCount * sizeof(Vec3));
+        layout.midSums    = allocate(maxSizes.vertexCount * sizeof(Vec3));
+        layout.faceCounts = allocate(maxSizes.vertexCount * sizeof(uint32_t));
+        layout.edgeCounts = allocate(maxSizes.vertexCount * sizeof(uint32_t));
+
+        layout.totalBytes = offset;
+        return layout;
+    }
+
+    template<typename Counts, typename Indices>
+    void checkTopology(const Counts &faceVertexCounts, const Indices &indices, size_t vertexCount, int iterationCount)
+    {
+        if(iterationCount < 1)
+        {
+            throw std::runtime_error("applyCatmullClarkSubdivision: iteration count must be at least 1");
+        }
+
+        size_t cornerCount = 0;
+        for(size_t f = 0; f < faceVertexCounts.size; ++f)
+        {
+            const uint32_t n = faceVertexCounts[f];
+            if(n != 3 && n != 4)
+            {
+                throw std::runtime_error("applyCatmullClarkSubdivision: faces must have 3 or 4 vertices");
+            }
+            cornerCount += n;
+        }
+
+        if(cornerCount != indices.size)
+        {
+            throw std::runtime_error("applyCatmullClarkSubdivision: index count mismatch");
+        }
+
+        for(size_t c = 0; c < indices.size; ++c)
+        {
+            if(indices[c] >= vertexCount)
+            {
+                throw std::runtime_error("applyCatmullClarkSubdivision: vertex index out of range");
+            }
+        }
+    }
+
+    /**
+     * @brief 工作区中的数组按相对首地址的偏移直接解释为HalfEdge、Vec3等类型，首地址需满足其对齐要求
+     */
+    void checkWorkspace(ArrayView<std::byte> workspace, const char *message)
+    {
+        static_assert(alignof(HalfEdge) <= SUBDIVISION_WORKSPACE_ALIGNMENT);
+        static_assert(alignof(EdgeRecord) <= SUBDIVISION_WORKSPACE_ALIGNMENT);
+        static_assert(alignof(Vec3) <= SUBDIVISION_WORKSPACE_ALIGNMENT);
+
+        if(reinterpret_cast<uintptr_t>(workspace.data) % SUBDIVISION_WORKSPACE_ALIGNMENT != 0)
+        {
+            throw std::runtime_error(message);
+        }
+    }
+
+    /**
+     * @brief 步长小于3个float时相邻位置互相重叠，写入的结果会被覆盖
+     */
+    template<typename Float>
+    void checkStride(const StridedPositions<Float> &positions, const char *message)
+    {
+        if(positions.stride < 3 * sizeof(float) ||
+           positions.stride % alignof(float) != 0 ||
+           reinterpret_cast<uintptr_t>(positions.data) % alignof(float) != 0)
+        {
+            throw std::runtime_error(message);
+        }
+    }
+
+    template<typename Counts>
+    void computeFaceOffsets(const Counts &faceVertexCounts, uint32_t *faceOffsets)
+    {
+        faceOffsets[0] = 0;
+        for(size_t f = 0; f < faceVertexCounts.size; ++f)
+        {
+            faceOffsets[f + 1] = faceOffsets[f] + faceVertexCounts[f];
+        }
+    }
+
+    /**
+     * @brief 按两端顶点排序各面的所有半边，key相同的半边属于同一条边，返回边数
+     */
+    template<typename Indices>
+    size_t sortHalfEdges(const Indices &indices, size_t faceCount, const uint32_t *faceOffsets, HalfEdge *halfEdges)
+    {
+        for(size_t f = 0; f < faceCount; ++f)
+        {
+            const uint32_t begin = faceOffsets[f], end = faceOffsets[f + 1];
+            for(uint32_t c = begin; c < end; ++c)
+            {
+                const uint64_t a = indices[c];
+                const uint64_t b = indices[c + 1 < end ? c + 1 : begin];
+                halfEdges[c] = { ((std::min)(a, b) << 32) | (std::max)(a, b), c, 0 };
+            }
+        }
+
+        HalfEdge *end = halfEdges + indices.size;
+        std::sort(halfEdges, end, [](const HalfEdge &a, const HalfEdge &b)
+        {
+            return a.key != b.key ? a.key < b.key : a.corner < b.corner;
+        });
+
+        size_t edgeCount = 0;
+        for(HalfEdge *e = halfEdges; e != end; ++e)
+        {
+            edgeCount += e == halfEdges || e->key != (e - 1)->key;
+        }
+        return edgeCount;
+    }
+
+    /**
+     * @brief 由排序后的半边建立第0层的边表，以及各角所在的边
+     */
+    void buildBaseEdges(const HalfEdge *halfEdges, size_t cornerCount, EdgeRecord *edges, uint32_t *faceEdges)
+    {
+        for(size_t i = 0, e = 0; i < cornerCount; ++e)
+        {
+            size_t j = i + 1;
+            while(j < cornerCount && halfEdges[j].key == halfEdges[i].key)
+            {
+                ++j;
+            }
+
+            if(j - i > 2)
+            {
+                throw std::runtime_error("topology error: edge.faceCount > 2");
+            }
+
+            const uint64_t key = halfEdges[i].key;
+            edges[e] = {
+                static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key & 0xffffffff),
+                { halfEdges[i].corner, j - i == 2 ? halfEdges[i + 1].corner : INVALID_INDEX }
+            };
+
+            for(size_t k = i; k < j; ++k)
+            {
+                faceEdges[halfEdges[k].corner] = static_cast<uint32_t>(e);
+            }
+
+            i = j;
+        }
+    }
+
+    void computeCornerFaces(const uint32_t *faceOffsets, size_t faceCount, uint32_t *cornerFaces)
+    {
+        for(size_t f = 0; f < faceCount; ++f)
+        {
+            std::fill(cornerFaces + faceOffsets[f], cornerFaces + faceOffsets[f + 1], static_cast<uint32_t>(f));
+        }
+    }
+
+    void loadPositions(const ConstPositionView &input, Vec3 *positions)
+    {
+        for(size_t v = 0; v < input.size; ++v)
+        {
+            const float *p = input.at(v);
+            positions[v] = Vec3(p[0], p[1], p[2]);
+        }
+    }
+
+    template<typename Func>
+    void forEach(size_t count, bool multithreaded, const Func &func)
+    {
+        if(multithreaded)
+        {
+            parallelFor(count, func);
+            return;
+        }
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            func(i);
+        }
+    }
+
+    /**
+     * @brief 一层控制网格。faceOffsets为空时所有面都是四边形
+     */
+    struct Level
+    {
+        LevelSizes sizes;
+
+        Vec3             *positions;
+        const uint32_t   *indices;
+        const uint32_t   *faceOffsets;
+        const uint32_t   *cornerFaces;
+        const uint32_t   *faceEdges;
+        const EdgeRecord *edges;
+
+        uint32_t getFace(uint32_t corner) const noexcept
+        {
+            return faceOffsets ? cornerFaces[corner] : corner / 4;
+        }
+
+        uint32_t getFaceBegin(uint32_t face) const noexcept
+        {
+            return faceOffsets ? faceOffsets[face] : 4 * face;
+        }
+
+        uint32_t getFaceEnd(uint32_t face) const noexcept
+        {
+            return faceOffsets ? faceOffsets[face + 1] : 4 * face + 4;
+        }
+
+        uint32_t getNextCorner(uint32_t corner) const noexcept
+        {
+            const uint32_t face = getFace(corner);
+            return corner + 1 < getFaceEnd(face) ? corner + 1 : getFaceBegin(face);
+        }
+
+        uint32_t getPrevCorner(uint32_t corner) const noexcept
+        {
+            const uint32_t face = getFace(corner);
+            return corner > getFaceBegin(face) ? corner - 1 : getFaceEnd(face) - 1;
+        }
+    };
+
+    /**
+     * @brief 各层共用的临时数组
+     */
+    struct Accumulators
+    {
+        Vec3     *facePoints;
+        Vec3     *faceSums;
+        Vec3     *midSums;
+        uint32_t *faceCounts;
+        uint32_t *edgeCounts;
+    };
+
+    /**
+     * @brief 计算细分一次后的顶点位置，按[vertex points][edge points][face points]的顺序写入positions，
+     *        每个位置只写一次，不读回
+     */
+    void computeNextPositions(const Level &level, const Accumulators &acc, const PositionView &positions, bool multithreaded)
+    {
+        const size_t V = level.sizes.vertexCount, E = level.sizes.edgeCount, F = level.sizes.faceCount;
+
+        auto store = [&](size_t i, const Vec3 &p)
+        {
+            float *output = positions.at(i);
+            output[0] = p.x;
+            output[1] = p.y;
+            output[2] = p.z;
+        };
+
+        // face points
+
+        forEach(F, multithreaded, [&](size_t f)
+        {
+            const uint32_t begin = level.getFaceBegin(static_cast<uint32_t>(f));
+            const uint32_t end   = level.getFaceEnd(static_cast<uint32_t>(f));
+
+            Vec3 sum;
+            for(uint32_t c = begin; c < end; ++c)
+            {
+                sum += level.positions[level.indices[c]];
+            }
+
+            acc.facePoints[f] = sum / static_cast<float>(end - begin);
+            store(V + E + f, acc.facePoints[f]);
+        });
+
+        // edge points
+
+        forEach(E, multithreaded, [&](size_t e)
+        {
+            auto &edge = level.edges[e];
+            const Vec3 &low  = level.positions[edge.lowVertex];
+            const Vec3 &high = level.positions[edge.highVertex];
+
+            if(edge.corners[1] == INVALID_INDEX)
+            {
+                store(V + e, 0.5f * (low + high));
+            }
+            else
+            {
+                store(V + e, 0.25f * (
+                    low + high +
+                    acc.facePoints[level.getFace(edge.corners[0])] +
+                    acc.facePoints[level.getFace(edge.corners[1])]));
+            }
+        });
+
+        // 与applyCatmullClarkSubdivision相同：顶点所属的面按面的顺序累加，
+        // 顶点所属的边只包含被某个面由较小的下标走向较大的下标的边，按面的顺序累加
+
+        std::fill(acc.faceSums, acc.faceSums + V, Vec3());
+        std::fill(acc.midSums, acc.midSums + V, Vec3());
+        std::fill(acc.faceCounts, acc.faceCounts + V, 0u);
+        std::fill(acc.edgeCounts, acc.edgeCounts + V, 0u);
+
+        for(uint32_t c = 0; c < level.sizes.cornerCount; ++c)
+        {
+            const uint32_t start = level.indices[c];
+            acc.faceSums[start] += acc.facePoints[level.getFace(c)];
+            ++acc.faceCounts[start];
+
+            const uint32_t end = level.indices[level.getNextCorner(c)];
+            if(start < end)
+            {
+                const Vec3 mid = 0.5f * (level.positions[start] + level.positions[end]);
+                acc.midSums[start] += mid;
+                acc.midSums[end]   += mid;
+                ++acc.edgeCounts[start];
+                ++acc.edgeCounts[end];
+            }
+        }
+
+        // vertex points
+
+        forEach(V, multithreaded, [&](size_t v)
+        {
+            // 未被面引用的顶点保持原位置
+
+            const int n = static_cast<int>(acc.faceCounts[v]);
+            if(!n)
+            {
+                store(v, level.positions[v]);
+                return;
+            }
+
+            const float m1 = static_cast<float>(n - 3) / n;
+            const float m2 = 1.0f / n;
+            const float m3 = 2.0f / n;
+
+            const Vec3 avgFacePosition = acc.faceSums[v] / static_cast<float>(n);
+            const Vec3 avgEdgeMid      = acc.midSums[v] / static_cast<float>(acc.edgeCounts[v]);
+
+            store(v, m1 * level.positions[v] + m2 * avgFacePosition + m3 * avgEdgeMid);
+        });
+    }
+
+    /**
+     * @brief 第c个旧角产生第c个新面{ 前一条边的edge point, 顶点, 后一条边的edge point, face point }，写入indices
+     */
+    void computeNextIndices(const Level &level, uint32_t *indices, bool multithreaded)
+    {
+        const auto edgePointBase = static_cast<uint32_t>(level.sizes.vertexCount);
+        const auto facePointBase = static_cast<uint32_t>(level.sizes.vertexCount + level.sizes.edgeCount);
+
+        forEach(level.sizes.cornerCount, multithreaded, [&](size_t i)
+        {
+            const auto c = static_cast<uint32_t>(i);
+            indices[4 * c + 0] = edgePointBase + level.faceEdges[level.getPrevCorner(c)];
+            indices[4 * c + 1] = level.indices[c];
+            indices[4 * c + 2] = edgePointBase + level.faceEdges[c];
+            indices[4 * c + 3] = facePointBase + level.getFace(c);
+        });
+    }
+
+    /**
+     * @brief 推出下一层的边，新面的第j条边从其第j个角出发
+     *
+     * - 第e条旧边被分为第2e条（含较小的端点）与第2e + 1条（含较大的端点）新边
+     * - 第c个旧角所在的边的edge point与face point之间为第2E + c条新边
+     */
+    void computeNextEdges(const Level &level, uint32_t *faceEdges, EdgeRecord *edges, bool multithreaded)
+    {
+        const auto V = static_cast<uint32_t>(level.sizes.vertexCount);
+        const auto E = static_cast<uint32_t>(level.sizes.edgeCount);
+
+        auto getHalf = [&](uint32_t e, uint32_t v)
+        {
+            return 2 * e + (v == level.edges[e].lowVertex ? 0 : 1);
+        };
+
+        forEach(level.sizes.cornerCount, multithreaded, [&](size_t i)
+        {
+            const auto c = static_cast<uint32_t>(i);
+            const uint32_t prev = level.getPrevCorner(c);
+            const uint32_t v = level.indices[c];
+
+            faceEdges[4 * c + 0] = getHalf(level.faceEdges[prev], v);
+            faceEdges[4 * c + 1] = getHalf(level.faceEdges[c], v);
+            faceEdges[4 * c + 2] = 2 * E + c;
+            faceEdges[4 * c + 3] = 2 * E + prev;
+
+            // 新面c的第2条边与新面next的第3条边是同一条
+
+            const uint32_t next = level.getNextCorner(c);
+            edges[2 * E + c] = {
+                V + level.faceEdges[c], V + E + level.getFace(c),
+                { (std::min)(4 * c + 2, 4 * next + 3), (std::max)(4 * c + 2, 4 * next + 3) }
+            };
+        });
+
+        forEach(E, multithreaded, [&](size_t i)
+        {
+            const auto e = static_cast<uint32_t>(i);
+            auto &edge = level.edges[e];
+
+            EdgeRecord &lowHalf  = edges[2 * e];
+            EdgeRecord &highHalf = edges[2 * e + 1];
+
+            lowHalf  = { edge.lowVertex, V + e, { INVALID_INDEX, INVALID_INDEX } };
+            highHalf = { edge.highVertex, V + e, { INVALID_INDEX, INVALID_INDEX } };
+
+            // 旧角c处的面经过这条边：起点所在的子面c以第1条边经过起点一侧，终点所在的子面next以第0条边经过终点一侧
+
+            for(uint32_t c : edge.corners)
+            {
+                if(c == INVALID_INDEX)
+                {
+                    continue;
+                }
+
+                const uint32_t next = level.getNextCorner(c);
+                const bool isStartLow = level.indices[c] == edge.lowVertex;
+
+                EdgeRecord &startHalf = isStartLow ? lowHalf : highHalf;
+                EdgeRecord &endHalf   = isStartLow ? highHalf : lowHalf;
+
+                (startHalf.corners[0] == INVALID_INDEX ? startHalf.corners[0] : startHalf.corners[1]) = 4 * c + 1;
+                (endHalf.corners[0] == INVALID_INDEX ? endHalf.corners[0] : endHalf.corners[1]) = 4 * next;
+            }
+
+            for(EdgeRecord *half : { &lowHalf, &highHalf })
+            {
+                if(half->corners[1] != INVALID_INDEX && half->corners[1] < half->corners[0])
+                {
+                    std::swap(half->corners[0], half->corners[1]);
+                }
+            }
+        });
+    }
+
+    // 拓扑文件：TopologyFileHeader，iterationCount个TopologyFileLevel，随后为按64字节对齐的各数组
+
+    constexpr uint32_t TOPOLOGY_FILE_MAGIC      = 0x50544343; // "CCTP"
+    constexpr uint32_t TOPOLOGY_FILE_VERSION    = 2;
+    constexpr uint32_t TOPOLOGY_FILE_BYTE_ORDER = 0x01020304;
+    constexpr int      MAX_FILE_ITERATION_COUNT = 16;
+
+    struct TopologyFileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t byteOrder;
+        int32_t  iterationCount;
+        uint64_t inputVertexCount;
+        uint64_t outputVertexCount;
+        uint64_t outputIndexCount;
+        uint64_t outputIndicesOffset;
+        uint64_t fileBytes;
+        uint64_t checksum; // 头部之后所有内容的校验和
+    };
+
+    // 各数组的字节偏移，不存在的数组为0
+    struct TopologyFileLevel
+    {
+        uint64_t vertexCount;
+        uint64_t faceCount;
+        uint64_t edgeCount;
+        uint64_t cornerCount;
+        uint64_t indices;
+        uint64_t faceOffsets;
+        uint64_t cornerFaces;
+        uint64_t faceEdges;
+        uint64_t edges;
+    };
+
+    /**
+     * @brief 检查从文件载入的一层拓扑中的每个下标都在该层的范围内，evaluate不会越界访问。
+     *        faceOffsets为空时所有面都是四边形
+     */
+    bool checkLevelArrays(
+        const LevelSizes &sizes, const uint32_t *indices, const uint32_t *faceOffsets,
+        const uint32_t *cornerFaces, const uint32_t *faceEdges, const EdgeRecord *edges) noexcept
+    {
+        const size_t V = sizes.vertexCount, F = sizes.faceCount, E = sizes.edgeCount, C = sizes.cornerCount;
+
+        if(faceOffsets)
+        {
+            if(faceOffsets[0] != 0 || faceOffsets[F] != C)
+            {
+                return false;
+            }
+
+            for(size_t f = 0; f < F; ++f)
+            {
+                const uint32_t begin = faceOffsets[f], end = faceOffsets[f + 1];
+                if(end < begin || (end - begin != 3 && end - begin != 4) || end > C)
+                {
+                    return false;
+                }
+
+                for(uint32_t c = begin; c < end; ++c)
+                {
+                    if(cornerFaces[c] != f)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        else if(C != 4 * F)
+        {
+            return false;
+        }
+
+        // 以最大值判断，不逐个分支，便于向量化。corners[1]为INVALID_INDEX时加一后为0
+
+        if(C)
+        {
+            uint32_t maxIndex = 0, maxFaceEdge = 0;
+            for(size_t c = 0; c < C; ++c)
+            {
+                maxIndex    = (std::max)(maxIndex, indices[c]);
+                maxFaceEdge = (std::max)(maxFaceEdge, faceEdges[c]);
+            }
+
+            if(maxIndex >= V || maxFaceEdge >= E)
+            {
+                return false;
+            }
+        }
+
+        uint32_t maxVertex = 0, maxCorner = 0, maxOtherCorner = 0;
+        for(size_t e = 0; e < E; ++e)
+        {
+            const EdgeRecord &edge = edges[e];
+            maxVertex      = (std::max)(maxVertex, (std::max)(edge.lowVertex, edge.highVertex));
+            maxCorner      = (std::max)(maxCorner, edge.corners[0]);
+            maxOtherCorner = (std::max)(maxOtherCorner, edge.corners[1] + 1);
+        }
+
+        return !E || (maxVertex < V && maxCorner < C && maxOtherCorner <= C);
+    }
+
+    uint64_t computeChecksum(const std::byte *data, size_t bytes) noexcept
+    {
+        // 文件的大小总是8的倍数。四路交错的Fletcher校验和，只有加法，可以向量化；
+        // 只用于发现意外的损坏，下标的范围另行检查
+
+        uint64_t sums[4] = {}, sumOfSums[4] = {};
+        size_t i = 0;
+        for(; i + 32 <= bytes; i += 32)
+        {
+            for(int l = 0; l < 4; ++l)
+            {
+                uint64_t word;
+                std::memcpy(&word, data + i + 8 * l, 8);
+                sums[l]      += word;
+                sumOfSums[l] += sums[l];
+            }
+        }
+
+        for(int l = 0; i + 8 <= bytes; i += 8, ++l)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            sums[l]      += word;
+            sumOfSums[l] += sums[l];
+        }
+
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for(int l = 0; l < 4; ++l)
+        {
+            for(uint64_t value : { sums[l], sumOfSums[l] })
+            {
+                hash = (hash ^ value) * 0x9e3779b97f4a7c15ull;
+                hash ^= hash >> 32;
+            }
+        }
+        return hash;
+    }
+
+    /**
+     * @brief 以只读方式映射整个文件；不支持映射的平台上读入内存
+     */
+    std::shared_ptr<const std::byte> mapFile(const std::string &filename, size_t &bytes)
+    {
+#if defined(_WIN32)
+        std::ifstream fin(filename, std::ios::binary | std::ios::ate);
+        if(!fin)
+        {
+            throw std::runtime_error("failed to open topology file: " + filename);
+        }
+
+        bytes = static_cast<size_t>(fin.tellg());
+        auto buffer = std::make_shared<std::vector<uint64_t>>((bytes + 7) / 8);
+        fin.seekg(0);
+        if(!fin.read(reinterpret_cast<char*>(buffer->data()), static_cast<std::streamsize>(bytes)))
+        {
+            throw std::runtime_error("failed to read topology file: " + filename);
+        }
+
+        return std::shared_ptr<const std::byte>(buffer, reinterpret_cast<const std::byte*>(buffer->data()));
+#else
+        const int fd = open(filename.c_str(), O_RDONLY);
+        if(fd < 0)
+        {
+            throw std::runtime_error("failed to open topology file: " + filename);
+        }
+
+        struct stat info;
+        if(fstat(fd, &info) != 0 || info.st_size <= 0)
+        {
+            close(fd);
+            throw std::runtime_error("failed to query topology file: " + filename);
+        }
+
+        bytes = static_cast<size_t>(info.st_size);
+        void *data = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(data == MAP_FAILED)
+        {
+            throw std::runtime_error("failed to map topology file: " + filename);
+        }
+
+        return std::shared_ptr<const std::byte>(
+            static_cast<const std::byte*>(data), [bytes](const std::byte *p)
+        {
+            munmap(const_cast<std::byte*>(p), bytes);
+        });
+#endif
+    }
+
+} // namespace anonymous
+
+SubdivisionBufferSizes querySubdivisionBufferSizes(const MeshView &input, int iterationCount)
+{
+    checkTopology(input.faceVertexCounts, input.indices, input.positions.size, iterationCount);
+
+    std::vector<uint32_t> faceOffsets(input.faceVertexCounts.size + 1);
+    computeFaceOffsets(input.faceVertexCounts, faceOffsets.data());
+
+    std::vector<HalfEdge> halfEdges(input.indices.size);
+    const size_t edgeCount = sortHalfEdges(input.indices, input.faceVertexCounts.size, faceOffsets.data(), halfEdges.data());
+    const LevelSizes baseSizes = { input.positions.size, input.faceVertexCounts.size, edgeCount, input.indices.size };
+    const LevelSizes finalSizes = getFinalSizes(baseSizes, iterationCount);
+
+    SubdivisionBufferSizes result;
+    result.vertexCount    = finalSizes.vertexCount;
+    result.faceCount      = finalSizes.faceCount;
+    result.workspaceBytes = computeWorkspaceLayout(baseSizes, iterationCount).totalBytes;
+    return result;
+}
+
+void applyCatmullClarkSubdivision(
+    const MeshView &input, int iterationCount, const SubdivisionOutput &output,
+    ArrayView<std::byte> workspace, bool multithreaded)
+{
+    checkTopology(input.faceVertexCounts, input.indices, input.positions.size, iterationCount);
+    checkWorkspace(workspace, "applyCatmullClarkSubdivision: workspace is not aligned");
+    checkStride(input.positions, "applyCatmullClarkSubdivision: invalid input position stride");
+    checkStride(output.positions, "applyCatmullClarkSubdivision: invalid output position stride");
+
+    // 工作区的前部可以在知道边数之前确定
+
+    LevelSizes baseSizes = { input.positions.size, input.faceVertexCounts.size, 0, input.indices.size };
+    WorkspaceLayout layout = computeWorkspaceLayout(baseSizes, 1);
+
+    if(workspace.size < layout.positions[0])
+    {
+        throw std::runtime_error("applyCatmullClarkSubdivision: workspace too small");
+    }
+
+    auto at = [&](size_t offset) { return workspace.data + offset; };
+
+    auto faceOffsets = reinterpret_cast<uint32_t*>(at(layout.faceOffsets));
+    auto halfEdges   = reinterpret_cast<HalfEdge*>(at(layout.halfEdges));
+
+    computeFaceOffsets(input.faceVertexCounts, faceOffsets);
+    baseSizes.edgeCount = sortHalfEdges(input.indices, baseSizes.faceCount, faceOffsets, halfEdges);
+
+    const LevelSizes finalSizes = getFinalSizes(baseSizes, iterationCount);
+
+    layout = computeWorkspaceLayout(baseSizes, iterationCount);
+    if(workspace.size < layout.totalBytes ||
+       output.positions.size < finalSizes.vertexCount ||
+       output.indices.size < 4 * finalSizes.faceCount)
+    {
+        throw std::runtime_error("applyCatmullClarkSubdivision: buffer too small");
+    }
+
+    // 第0层：复制位置与下标，由排序后的半边建立边表
+
+    auto positions   = reinterpret_cast<Vec3*>(at(layout.positions[0]));
+    auto indices     = reinterpret_cast<uint32_t*>(at(layout.indices[0]));
+    auto cornerFaces = reinterpret_cast<uint32_t*>(at(layout.cornerFaces));
+    auto faceEdges   = reinterpret_cast<uint32_t*>(at(layout.faceEdges[0]));
+    auto edges       = reinterpret_cast<EdgeRecord*>(at(layout.edges[0]));
+
+    loadPositions(input.positions, positions);
+    std::copy(input.indices.data, input.indices.data + input.indices.size, indices);
+    computeCornerFaces(faceOffsets, baseSizes.faceCount, cornerFaces);
+    buildBaseEdges(halfEdges, baseSizes.cornerCount, edges, faceEdges);
+
+    Level level = { baseSizes, positions, indices, faceOffsets, cornerFaces, faceEdges, edges };
+
+    const Accumulators acc = {
+        reinterpret_cast<Vec3*>(at(layout.facePoints)),
+        reinterpret_cast<Vec3*>(at(layout.faceSums)),
+        reinterpret_cast<Vec3*>(at(layout.midSums)),
+        reinterpret_cast<uint32_t*>(at(layout.faceCounts)),
+        reinterpret_cast<uint32_t*>(at(layout.edgeCounts))
+    };
+
+    // 逐层细分，最后一层直接写入输出
+
+    for(int l = 0; l < iterationCount; ++l)
+    {
+        if(l == iterationCount - 1)
+        {
+            computeNextPositions(level, acc, output.positions, multithreaded);
+            computeNextIndices(level, output.indices.data, multithreaded);
+            break;
+        }
+
+        const int s = (l + 1) % 2;
+        const LevelSizes nextSizes = getNextLevelSizes(level.sizes);
+
+        auto nextPositions = reinterpret_cast<Vec3*>(at(layout.positions[s]));
+        auto nextIndices   = reinterpret_cast<uint32_t*>(at(layout.indices[s]));
+        auto nextFaceEdges = reinterpret_cast<uint32_t*>(at(layout.faceEdges[s]));
+        auto nextEdges     = reinterpret_cast<EdgeRecord*>(at(layout.edges[s]));
+
+        computeNextPositions(level, acc, { &nextPositions[0].x, sizeof(Vec3), nextSizes.vertexCount }, multithreaded);
+        computeNextIndices(level, nextIndices, multithreaded);
+        computeNextEdges(level, nextFaceEdges, nextEdges, multithreaded);
+
+        level = { nextSizes, nextPositions, nextIndices, nullptr, nullptr, nextFaceEdges, nextEdges };
+    }
+}
+
+struct SubdivisionTopology::LevelData
+{
+    LevelSizes sizes = {};
+
+    // 指向下面的数组；从文件加载时指向映射的文件，下面的数组为空
+
+    const uint32_t   *indices     = nullptr;
+    const uint32_t   *faceOffsets = nullptr; // 只有第0层非空
+    const uint32_t   *cornerFaces = nullptr; // 只有第0层非空
+    const uint32_t   *faceEdges   = nullptr;
+    const EdgeRecord *edges       = nullptr;
+
+    std::vector<uint32_t>   ownedIndices;
+    std::vector<uint32_t>   ownedFaceOffsets;
+    std::vector<uint32_t>   ownedCornerFaces;
+    std::vector<uint32_t>   ownedFaceEdges;
+    std::vector<EdgeRecord> ownedEdges;
+
+    void bindOwnedArrays() noexcept
+    {
+        indices     = ownedIndices.data();
+        faceOffsets = ownedFaceOffsets.empty() ? nullptr : ownedFaceOffsets.data();
+        cornerFaces = ownedCornerFaces.empty() ? nullptr : ownedCornerFaces.data();
+        faceEdges   = ownedFaceEdges.data();
+        edges       = ownedEdges.data();
+    }
+
+    size_t getMemoryBytes() const noexcept
+    {
+        const size_t faceOffsetCount = faceOffsets ? sizes.faceCount + 1 : 0;
+        const size_t cornerFaceCount = cornerFaces ? sizes.cornerCount : 0;
+        return (2 * sizes.cornerCount + faceOffsetCount + cornerFaceCount) * sizeof(uint32_t) +
+               sizes.edgeCount * sizeof(EdgeRecord);
+    }
+
+    Level getLevel(Vec3 *positions) const noexcept
+    {
+        return { sizes, positions, indices, faceOffsets, cornerFaces, faceEdges, edges };
+    }
+};
+
+SubdivisionTopology::SubdivisionTopology(
+    const IndexView &faceVertexCounts, const IndexView &indices,
+    size_t vertexCount, int iterationCount, bool multithreaded)
+    : iterationCount_(iterationCount), inputVertexCount_(vertexCount)
+{
+    checkTopology(faceVertexCounts, indices, vertexCount, iterationCount);
+
+    // 第0层
+
+    auto base = std::make_unique<LevelData>();
+
+    base->ownedFaceOffsets.resize(faceVertexCounts.size + 1);
+    computeFaceOffsets(faceVertexCounts, base->ownedFaceOffsets.data());
+
+    std::vector<HalfEdge> halfEdges(indices.size);
+    const size_t edgeCount = sortHalfEdges(
+        indices, faceVertexCounts.size, base->ownedFaceOffsets.data(), halfEdges.data());
+
+    base->sizes = { vertexCount, faceVertexCounts.size, edgeCount, indices.size };
+    const LevelSizes finalSizes = getFinalSizes(base->sizes, iterationCount);
+
+    base->ownedIndices.resize(indices.size);
+    for(size_t c = 0; c < indices.size; ++c)
+    {
+        base->ownedIndices[c] = indices[c];
+    }
+
+    base->ownedCornerFaces.resize(indices.size);
+    computeCornerFaces(base->ownedFaceOffsets.data(), faceVertexCounts.size, base->ownedCornerFaces.data());
+
+    base->ownedFaceEdges.resize(indices.size);
+    base->ownedEdges.resize(edgeCount);
+    buildBaseEdges(halfEdges.data(), indices.size, base->ownedEdges.data(), base->ownedFaceEdges.data());
+
+    base->bindOwnedArrays();
+    levels_.push_back(std::move(base));
+
+    // 此后各层的拓扑由上一层推出，最后一层只需要顶点下标
+
+    for(int l = 1; l < iterationCount; ++l)
+    {
+        const Level prev = levels_[l - 1]->getLevel(nullptr);
+
+        auto next = std::make_unique<LevelData>();
+        next->sizes = getNextLevelSizes(prev.sizes);
+        next->ownedIndices.resize(next->sizes.cornerCount);
+        next->ownedFaceEdges.resize(next->sizes.cornerCount);
+        next->ownedEdges.resize(next->sizes.edgeCount);
+
+        computeNextIndices(prev, next->ownedIndices.data(), multithreaded);
+        computeNextEdges(prev, next->ownedFaceEdges.data(), next->ownedEdges.data(), multithreaded);
+
+        next->bindOwnedArrays();
+        levels_.push_back(std::move(next));
+    }
+
+    ownedOutputIndices_.resize(4 * finalSizes.faceCount);
+    computeNextIndices(levels_.back()->getLevel(nullptr), ownedOutputIndices_.data(), multithreaded);
+    outputIndices_ = { ownedOutputIndices_.data(), ownedOutputIndices_.size() };
+
+    outputVertexCount_ = finalSizes.vertexCount;
+    workspaceBytes_    = computeWorkspaceLayout(levels_[0]->sizes, iterationCount, false).totalBytes;
+}
+
+SubdivisionTopology::~SubdivisionTopology() = default;
+
+int SubdivisionTopology::getIterationCount() const noexcept
+{
+    return iterationCount_;
+}
+
+size_t SubdivisionTopology::getInputVertexCount() const noexcept
+{
+    return inputVertexCount_;
+}
+
+size_t SubdivisionTopology::getOutputVertexCount() const noexcept
+{
+    return outputVertexCount_;
+}
+
+size_t SubdivisionTopology::getOutputFaceCount() const noexcept
+{
+    return outputIndices_.size / 4;
+}
+
+ArrayView<const uint32_t> SubdivisionTopology::getOutputIndices() const noexcept
+{
+    return outputIndices_;
+}
+
+size_t SubdivisionTopology::getWorkspaceBytes() const noexcept
+{
+    return workspaceBytes_;
+}
+
+size_t SubdivisionTopology::getMemoryBytes() const noexcept
+{
+    size_t bytes = outputIndices_.size * sizeof(uint32_t);
+    for(auto &level : levels_)
+    {
+        bytes += level->getMemoryBytes();
+    }
+    return bytes;
+}
+
+void SubdivisionTopology::evaluate(
+    const ConstPositionView &input, const PositionView &output,
+    ArrayView<std::byte> workspace, bool multithreaded) const
+{
+    if(input.size != inputVertexCount_)
+    {
+        throw std::runtime_error("SubdivisionTopology: input vertex count mismatch");
+    }
+
+    if(output.size < outputVertexCount_ || workspace.size < workspaceBytes_)
+    {
+        throw std::runtime_error("SubdivisionTopology: buffer too small");
+    }
+
+    checkWorkspace(workspace, "SubdivisionTopology: workspace is not aligned");
+    checkStride(input, "SubdivisionTopology: invalid input position stride");
+    checkStride(output, "SubdivisionTopology: invalid output position stride");
+
+    const WorkspaceLayout layout = computeWorkspaceLayout(levels_[0]->sizes, iterationCount_, false);
+    auto at = [&](size_t offset) { return workspace.data + offset; };
+
+    const Accumulators acc = {
+        reinterpret_cast<Vec3*>(at(layout.facePoints)),
+        reinterpret_cast<Vec3*>(at(layout.faceSums)),
+        reinterpret_cast<Vec3*>(at(layout.midSums)),
+        reinterpret_cast<uint32_t*>(at(layout.faceCounts)),
+        reinterpret_cast<uint32_t*>(at(layout.edgeCounts))
+    };
+
+    auto positions = reinterpret_cast<Vec3*>(at(layout.positions[0]));
+    loadPositions(input, positions);
+
+    for(int l = 0; l < iterationCount_; ++l)
+    {
+        const Level level = levels_[l]->getLevel(positions);
+
+        if(l == iterationCount_ - 1)
+        {
+            computeNextPositions(level, acc, output, multithreaded);
+            break;
+        }
+
+        auto nextPositions = reinterpret_cast<Vec3*>(at(layout.positions[(l + 1) % 2]));
+        const size_t nextVertexCount = levels_[l + 1]->sizes.vertexCount;
+        computeNextPositions(level, acc, { &nextPositions[0].x, sizeof(Vec3), nextVertexCount }, multithreaded);
+
+        positions = nextPositions;
+    }
+}
+
+bool SubdivisionTopology::matches(
+    const IndexView &faceVertexCounts, const IndexView &indices,
+    size_t vertexCount, int iterationCount) const noexcept
+{
+    const LevelData &base = *levels_[0];
+    if(iterationCount != iterationCount_ || vertexCount != inputVertexCount_ ||
+       faceVertexCounts.size != base.sizes.faceCount || indices.size != base.sizes.cornerCount)
+    {
+        return false;
+    }
+
+    for(size_t f = 0; f < faceVertexCounts.size; ++f)
+    {
+        if(faceVertexCounts[f] != base.faceOffsets[f + 1] - base.faceOffsets[f])
+        {
+            return false;
+        }
+    }
+
+    for(size_t c = 0; c < indices.size; ++c)
+    {
+        if(indices[c] != base.indices[c])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SubdivisionTopology::saveToFile(const std::string &filename) const
+{
+    // 先确定各数组的位置，再在内存中组装整个文件并计算校验和
+
+    size_t offset = sizeof(TopologyFileHeader) + iterationCount_ * sizeof(TopologyFileLevel);
+
+    auto allocate = [&](size_t bytes)
+    {
+        offset = (offset + 63) & ~size_t(63);
+        const size_t result = offset;
+        offset += bytes;
+        return result;
+    };
+
+    std::vector<TopologyFileLevel> levels(iterationCount_);
+    for(int l = 0; l < iterationCount_; ++l)
+    {
+        const LevelData &level = *levels_[l];
+        const LevelSizes &sizes = level.sizes;
+
+        levels[l] = { sizes.vertexCount, sizes.faceCount, sizes.edgeCount, sizes.cornerCount, 0, 0, 0, 0, 0 };
+        levels[l].indices     = allocate(sizes.cornerCount * sizeof(uint32_t));
+        levels[l].faceOffsets = level.faceOffsets ? allocate((sizes.faceCount + 1) * sizeof(uint32_t)) : 0;
+        levels[l].cornerFaces = level.cornerFaces ? allocate(sizes.cornerCount * sizeof(uint32_t)) : 0;
+        levels[l].faceEdges   = allocate(sizes.cornerCount * sizeof(uint32_t));
+        levels[l].edges       = allocate(sizes.edgeCount * sizeof(EdgeRecord));
+    }
+
+    TopologyFileHeader header = {};
+    header.magic               = TOPOLOGY_FILE_MAGIC;
+    header.version             = TOPOLOGY_FILE_VERSION;
+    header.byteOrder           = TOPOLOGY_FILE_BYTE_ORDER;
+    header.iterationCount      = iterationCount_;
+    header.inputVertexCount    = inputVertexCount_;
+    header.outputVertexCount   = outputVertexCount_;
+    header.outputIndexCount    = outputIndices_.size;
+    header.outputIndicesOffset = allocate(outputIndices_.size * sizeof(uint32_t));
+    header.fileBytes           = (offset + 7) & ~size_t(7);
+
+    std::vector<uint64_t> buffer(header.fileBytes / 8);
+    auto data = reinterpret_cast<std::byte*>(buffer.data());
+
+    auto store = [&](size_t at, const void *src, size_t bytes)
+    {
+        if(bytes)
+        {
+            std::memcpy(data + at, src, bytes);
+        }
+    };
+
+    store(sizeof(TopologyFileHeader), levels.data(), levels.size() * sizeof(TopologyFileLevel));
+    for(int l = 0; l < iterationCount_; ++l)
+    {
+        const LevelData &level = *levels_[l];
+        const LevelSizes &sizes = level.sizes;
+
+        store(levels[l].indices, level.indices, sizes.cornerCount * sizeof(uint32_t));
+        if(level.faceOffsets)
+        {
+            store(levels[l].faceOffsets, level.faceOffsets, (sizes.faceCount + 1) * sizeof(uint32_t));
+        }
+        if(level.cornerFaces)
+        {
+            store(levels[l].cornerFaces, level.cornerFaces, sizes.cornerCount * sizeof(uint32_t));
+        }
+        store(levels[l].faceEdges, level.faceEdges, sizes.cornerCount * sizeof(uint32_t));
+        store(levels[l].edges, level.edges, sizes.edgeCount * sizeof(EdgeRecord));
+    }
+    store(header.outputIndicesOffset, outputIndices_.data, outputIndices_.size * sizeof(uint32_t));
+
+    header.checksum = computeChecksum(
+        data + sizeof(TopologyFileHeader), header.fileBytes - sizeof(TopologyFileHeader));
+    store(0, &header, sizeof(header));
+
+    // 写入临时文件后改名，读取方不会看到写了一半的文件
+
+    static std::atomic<uint64_t> tempCounter = 0;
+    const std::string tempFilename = filename + ".tmp" +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" +
+        std::to_string(tempCounter++);
+
+    {
+        std::ofstream fout(tempFilename, std::ios::binary | std::ios::trunc);
+        if(!fout || !fout.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(header.fileBytes)))
+        {
+            std::error_code ec;
+            std::filesystem::remove(tempFilename, ec);
+            throw std::runtime_error("failed to write topology file: " + tempFilename);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempFilename, filename, ec);
+    if(ec)
+    {
+        std::filesystem::remove(tempFilename, ec);
+        throw std::runtime_error("failed to rename topology file to " + filename);
+    }
+}
+
+std::unique_ptr<SubdivisionTopology> SubdivisionTopology::loadFromFile(const std::string &filename)
+{
+    size_t fileBytes = 0;
+    std::shared_ptr<const std::byte> storage = mapFile(filename, fileBytes);
+    const std::byte *data = storage.get();
+
+    auto fail = [&](const char *reason)
+    {
+        return std::runtime_error("invalid topology file " + filename + ": " + reason);
+    };
+
+    TopologyFileHeader header;
+    if(fileBytes < sizeof(header))
+    {
+        throw fail("truncated");
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if(header.magic != TOPOLOGY_FILE_MAGIC || header.byteOrder != TOPOLOGY_FILE_BYTE_ORDER)
+    {
+        throw fail("not a topology file");
+    }
+
+    if(header.version != TOPOLOGY_FILE_VERSION)
+    {
+        throw fail("unsupported version");
+    }
+
+    if(header.fileBytes != fileBytes || fileBytes % 8 ||
+       header.iterationCount < 1 || header.iterationCount > MAX_FILE_ITERATION_COUNT ||
+       sizeof(header) + header.iterationCount * sizeof(TopologyFileLevel) > fileBytes)
+    {
+        throw fail("truncated");
+    }
+
+    if(computeChecksum(data + sizeof(header), fileBytes - sizeof(header)) != header.checksum)
+    {
+        throw fail("checksum mismatch");
+    }
+
+    // 各数组必须位于文件内且对齐；各层的大小必须与第0层推出的一致，且各数组中的下标都在范围内。
+    // 校验和只能发现意外的损坏，被改写的文件也不能导致越界访问
+
+    auto getArray = [&](uint64_t offset, uint64_t count, size_t elementSize) -> const std::byte*
+    {
+        if(!offset || offset % 4 || count > fileBytes / elementSize || offset > fileBytes - count * elementSize)
+        {
+            throw fail("array out of range");
+        }
+        return data + offset;
+    };
+
+    std::vector<TopologyFileLevel> levels(header.iterationCount);
+    std::memcpy(levels.data(), data + sizeof(header), levels.size() * sizeof(TopologyFileLevel));
+
+    std::unique_ptr<SubdivisionTopology> result(new SubdivisionTopology);
+    result->iterationCount_    = header.iterationCount;
+    result->inputVertexCount_  = header.inputVertexCount;
+    result->outputVertexCount_ = header.outputVertexCount;
+
+    for(int l = 0; l < header.iterationCount; ++l)
+    {
+        const TopologyFileLevel &stored = levels[l];
+
+        auto level = std::make_unique<LevelData>();
+        level->sizes = { stored.vertexCount, stored.faceCount, stored.edgeCount, stored.cornerCount };
+
+        if(l > 0)
+        {
+            const LevelSizes expected = getNextLevelSizes(result->levels_[l - 1]->sizes);
+            if(std::memcmp(&expected, &level->sizes, sizeof(LevelSizes)) != 0 || stored.faceOffsets || stored.cornerFaces)
+            {
+                throw fail("inconsistent level sizes");
+            }
+        }
+        else if(!stored.faceOffsets || !stored.cornerFaces || stored.vertexCount != header.inputVertexCount)
+        {
+            throw fail("missing base level");
+        }
+
+        if(stored.vertexCount > UINT32_MAX || stored.faceCount > UINT32_MAX ||
+           stored.edgeCount > UINT32_MAX || stored.cornerCount > UINT32_MAX)
+        {
+            throw fail("level exceeds 32-bit indices");
+        }
+
+        const auto &sizes = level->sizes;
+        level->indices   = reinterpret_cast<const uint32_t*>(getArray(stored.indices, sizes.cornerCount, 4));
+        level->faceEdges = reinterpret_cast<const uint32_t*>(getArray(stored.faceEdges, sizes.cornerCount, 4));
+        level->edges     = reinterpret_cast<const EdgeRecord*>(
+            getArray(stored.edges, sizes.edgeCount, sizeof(EdgeRecord)));
+
+        if(!l)
+        {
+            level->faceOffsets = reinterpret_cast<const uint32_t*>(getArray(stored.faceOffsets, sizes.faceCount + 1, 4));
+            level->cornerFaces = reinterpret_cast<const uint32_t*>(getArray(stored.cornerFaces, sizes.cornerCount, 4));
+        }
+
+        if(!checkLevelArrays(sizes, level->indices, level->faceOffsets, level->cornerFaces, level->faceEdges, level->edges))
+        {
+            throw fail("index out of range");
+        }
+
+        result->levels_.push_back(std::move(level));
+    }
+
+    const LevelSizes finalSizes = getFinalSizes(result->levels_[0]->sizes, header.iterationCount);
+    if(finalSizes.vertexCount != header.outputVertexCount || 4 * finalSizes.faceCount != header.outputIndexCount)
+    {
+        throw fail("inconsistent output sizes");
+    }
+
+    result->outputIndices_ = {
+        reinterpret_cast<const uint32_t*>(getArray(header.outputIndicesOffset, header.outputIndexCount, 4)),
+        header.outputIndexCount
+    };
+
+    uint32_t maxOutputIndex = 0;
+    for(size_t i = 0; i < result->outputIndices_.size; ++i)
+    {
+        maxOutputIndex = (std::max)(maxOutputIndex, result->outputIndices_.data[i]);
+    }
+
+    if(result->outputIndices_.size && maxOutputIndex >= header.outputVertexCount)
+    {
+        throw fail("index out of range");
+    }
+
+    result->workspaceBytes_ = computeWorkspaceLayout(result->levels_[0]->sizes, header.iterationCount, false).totalBytes;
+    result->storage_        = std::move(storage);
+    return result;
+}
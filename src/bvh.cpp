@@ -0,0 +1,662 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+#include <catmull_clark/bvh.h>
+#include <catmull_clark/parallel.h>
+
+namespace
+{
+
+    struct AABB
+    {
+        Vec3 low  = Vec3((std::numeric_limits<float>::max)());
+        Vec3 high = Vec3((std::numeric_limits<float>::lowest)());
+
+        void extend(const Vec3 &p)
+        {
+            low.x = (std::min)(low.x, p.x);
+            low.y = (std::min)(low.y, p.y);
+            low.z = (std::min)(low.z, p.z);
+
+            high.x = (std::max)(high.x, p.x);
+            high.y = (std::max)(high.y, p.y);
+            high.z = (std::max)(high.z, p.z);
+        }
+
+        void extend(const AABB &rhs)
+        {
+            low.x = (std::min)(low.x, rhs.low.x);
+            low.y = (std::min)(low.y, rhs.low.y);
+            low.z = (std::min)(low.z, rhs.low.z);
+
+            high.x = (std::max)(high.x, rhs.high.x);
+            high.y = (std::max)(high.y, rhs.high.y);
+            high.z = (std::max)(high.z, rhs.high.z);
+        }
+
+        bool empty() const
+        {
+            return low.x > high.x;
+        }
+
+        float surfaceArea() const
+        {
+            if(empty())
+            {
+                return 0;
+            }
+
+            Vec3 d = high - low;
+            return 2 * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+    };
+
+    /**
+     * @brief 图元的包围盒与质心，构建过程中保持原有顺序，只重排图元下标
+     */
+    struct BuildPrimitive
+    {
+        AABB bounds;
+        Vec3 centroid;
+    };
+
+    constexpr int      BIN_COUNT          = 16;
+    constexpr int      MIN_BIN_COUNT      = 4;
+    constexpr uint32_t MAX_LEAF_SIZE      = 8;
+    constexpr float    TRAVERSAL_COST     = 1;
+    constexpr size_t   PARALLEL_THRESHOLD = 4096;
+    constexpr size_t   PARALLEL_GRAIN     = 65536;
+
+    // 超过此深度后改为按中位数平分，保证遍历栈不会溢出
+    constexpr int      MAX_SAH_DEPTH      = 32;
+
+    struct Bin
+    {
+        AABB     bounds;
+        AABB     centroidBounds;
+        uint32_t count = 0;
+    };
+
+    /**
+     * @brief 待构建的子树：下标区间[begin, end)，以及其中图元的包围盒与质心包围盒
+     */
+    struct BuildRange
+    {
+        size_t begin;
+        size_t end;
+        AABB   bounds;
+        AABB   centroidBounds;
+    };
+
+    /**
+     * @brief 自顶向下的分桶SAH构建
+     *
+     * 图元数据只读，划分时只交换indices中的下标；
+     * 子节点的包围盒在父节点分桶时一并求出，每个节点只需遍历一次其中的图元。
+     * 节点数组预先按最大可能的节点数分配，子节点通过原子计数器成对地取得下标，
+     * 因此不同线程构建的子树可以直接写入同一个数组
+     */
+    class BVHBuilder
+    {
+    public:
+
+        BVHBuilder(
+            const std::vector<BuildPrimitive> &primitives, std::vector<uint32_t> &indices,
+            std::vector<BVHNode> &nodes)
+            : primitives_(primitives), indices_(indices), nodes_(nodes), nodeCount_(1)
+        {
+            indices_.resize(primitives_.size());
+            for(size_t i = 0; i < indices_.size(); ++i)
+            {
+                indices_[i] = static_cast<uint32_t>(i);
+            }
+
+            nodes_.resize((std::max<size_t>)(1, 2 * primitives_.size()));
+
+            size_t threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+            parallelDepth_ = 0;
+            while((size_t(1) << parallelDepth_) < 2 * threadCount)
+            {
+                ++parallelDepth_;
+            }
+        }
+
+        void build()
+        {
+            buildNode(0, makeRange(0, primitives_.size()), 0);
+            nodes_.resize(nodeCount_);
+        }
+
+    private:
+
+        BuildRange makeRange(size_t begin, size_t end) const
+        {
+            BuildRange range = { begin, end, AABB(), AABB() };
+            std::mutex boundsMutex;
+
+            parallelForRange(end - begin, PARALLEL_GRAIN, [&](size_t rangeBegin, size_t rangeEnd)
+            {
+                AABB localBounds, localCentroidBounds;
+                for(size_t i = begin + rangeBegin; i < begin + rangeEnd; ++i)
+                {
+                    auto &p = primitives_[indices_[i]];
+                    localBounds.extend(p.bounds);
+                    localCentroidBounds.extend(p.centroid);
+                }
+
+                std::lock_guard lk(boundsMutex);
+                range.bounds.extend(localBounds);
+                range.centroidBounds.extend(localCentroidBounds);
+            });
+
+            return range;
+        }
+
+        void buildNode(uint32_t nodeIndex, const BuildRange &range, int depth)
+        {
+            const size_t count = range.end - range.begin;
+
+            BVHNode &node = nodes_[nodeIndex];
+            node.low   = range.bounds.low;
+            node.high  = range.bounds.high;
+
+            auto makeLeaf = [&]
+            {
+                node.offset = static_cast<uint32_t>(range.begin);
+                node.count  = static_cast<uint32_t>(count);
+            };
+
+            if(count <= 1)
+            {
+                makeLeaf();
+                return;
+            }
+
+            // 在质心包围盒最长的轴上分桶
+
+            Vec3 extent = range.centroidBounds.high - range.centroidBounds.low;
+            int axis = 0;
+            if(extent.y > extent[axis]) axis = 1;
+            if(extent.z > extent[axis]) axis = 2;
+
+            if(extent[axis] <= 0 || depth >= MAX_SAH_DEPTH)
+            {
+                if(count <= MAX_LEAF_SIZE)
+                {
+                    makeLeaf();
+                }
+                else
+                {
+                    splitMiddle(node, axis, range, depth);
+                }
+                return;
+            }
+
+            // 图元较少的节点使用较少的桶：这类节点占了节点总数的大部分，
+            // 其耗时主要在于初始化与扫描桶，而不是遍历图元
+
+            const int binCount = static_cast<int>(
+                (std::min<size_t>)(BIN_COUNT, (std::max<size_t>)(MIN_BIN_COUNT, count)));
+
+            const float axisLow  = range.centroidBounds.low[axis];
+            const float binScale = binCount / extent[axis];
+
+            auto binOf = [&](uint32_t primitive)
+            {
+                int bin = static_cast<int>((primitives_[primitive].centroid[axis] - axisLow) * binScale);
+                return (std::min)(bin, binCount - 1);
+            };
+
+            auto fillBins = [&](size_t begin, size_t end, Bin *output)
+            {
+                for(size_t i = begin; i < end; ++i)
+                {
+                    const uint32_t primitive = indices_[i];
+                    auto &p = primitives_[primitive];
+                    auto &bin = output[binOf(primitive)];
+                    bin.bounds.extend(p.bounds);
+                    bin.centroidBounds.extend(p.centroid);
+                    ++bin.count;
+                }
+            };
+
+            Bin bins[BIN_COUNT];
+
+            if(count <= PARALLEL_GRAIN)
+            {
+                fillBins(range.begin, range.end, bins);
+            }
+            else
+            {
+                std::mutex binMutex;
+                parallelForRange(count, PARALLEL_GRAIN, [&](size_t rangeBegin, size_t rangeEnd)
+                {
+                    Bin localBins[BIN_COUNT];
+                    fillBins(range.begin + rangeBegin, range.begin + rangeEnd, localBins);
+
+                    std::lock_guard lk(binMutex);
+                    for(int b = 0; b < binCount; ++b)
+                    {
+                        bins[b].bounds.extend(localBins[b].bounds);
+                        bins[b].centroidBounds.extend(localBins[b].centroidBounds);
+                        bins[b].count += localBins[b].count;
+                    }
+                });
+            }
+
+            // 从右向左累积，再从左向右扫描，求出代价最小的划分位置
+
+            float    rightArea [BIN_COUNT];
+            uint32_t rightCount[BIN_COUNT];
+
+            AABB     accumulated;
+            uint32_t accumulatedCount = 0;
+            for(int b = binCount - 1; b > 0; --b)
+            {
+                accumulated.extend(bins[b].bounds);
+                accumulatedCount += bins[b].count;
+                rightArea[b]  = accumulated.surfaceArea();
+                rightCount[b] = accumulatedCount;
+            }
+
+            float bestCost = (std::numeric_limits<float>::max)();
+            int   bestSplit = -1;
+
+            accumulated = AABB();
+            accumulatedCount = 0;
+            for(int b = 1; b < binCount; ++b)
+            {
+                accumulated.extend(bins[b - 1].bounds);
+                accumulatedCount += bins[b - 1].count;
+
+                if(!accumulatedCount || !rightCount[b])
+                {
+                    continue;
+                }
+
+                float cost = accumulated.surfaceArea() * accumulatedCount + rightArea[b] * rightCount[b];
+                if(cost < bestCost)
+                {
+                    bestCost  = cost;
+                    bestSplit = b;
+                }
+            }
+
+            const float nodeArea = range.bounds.surfaceArea();
+            const float splitCost = TRAVERSAL_COST + (nodeArea > 0 ? bestCost / nodeArea : 0);
+
+            if(bestSplit < 0 || (count <= MAX_LEAF_SIZE && static_cast<float>(count) <= splitCost))
+            {
+                if(count <= MAX_LEAF_SIZE)
+                {
+                    makeLeaf();
+                }
+                else
+                {
+                    splitMiddle(node, axis, range, depth);
+                }
+                return;
+            }
+
+            auto middle = std::partition(
+                indices_.begin() + range.begin, indices_.begin() + range.end,
+                [&](uint32_t primitive) { return binOf(primitive) < bestSplit; });
+
+            BuildRange left  = { range.begin, static_cast<size_t>(middle - indices_.begin()), AABB(), AABB() };
+            BuildRange right = { left.end, range.end, AABB(), AABB() };
+
+            for(int b = 0; b < binCount; ++b)
+            {
+                BuildRange &side = b < bestSplit ? left : right;
+                side.bounds.extend(bins[b].bounds);
+                side.centroidBounds.extend(bins[b].centroidBounds);
+            }
+
+            buildChildren(node, left, right, depth);
+        }
+
+        /**
+         * @brief 无法按SAH划分时（例如所有质心重合），按质心在axis上的中位数平分
+         */
+        void splitMiddle(BVHNode &node, int axis, const BuildRange &range, int depth)
+        {
+            size_t middle = range.begin + (range.end - range.begin) / 2;
+            std::nth_element(
+                indices_.begin() + range.begin, indices_.begin() + middle, indices_.begin() + range.end,
+                [&](uint32_t a, uint32_t b)
+            {
+                return primitives_[a].centroid[axis] < primitives_[b].centroid[axis];
+            });
+
+            buildChildren(node, makeRange(range.begin, middle), makeRange(middle, range.end), depth);
+        }
+
+        void buildChildren(BVHNode &node, const BuildRange &left, const BuildRange &right, int depth)
+        {
+            const uint32_t leftIndex = nodeCount_.fetch_add(2);
+            node.offset = leftIndex;
+            node.count  = 0;
+
+            if(depth < parallelDepth_ && right.end - left.begin >= PARALLEL_THRESHOLD)
+            {
+                std::thread leftThread([=] { buildNode(leftIndex, left, depth + 1); });
+                buildNode(leftIndex + 1, right, depth + 1);
+                leftThread.join();
+            }
+            else
+            {
+                buildNode(leftIndex,     left,  depth + 1);
+                buildNode(leftIndex + 1, right, depth + 1);
+            }
+        }
+
+        const std::vector<BuildPrimitive> &primitives_;
+        std::vector<uint32_t>             &indices_;
+        std::vector<BVHNode>              &nodes_;
+
+        std::atomic<uint32_t> nodeCount_;
+        int parallelDepth_;
+    };
+
+    bool intersectAABB(
+        const Vec3 &low, const Vec3 &high, const Vec3 &origin, const Vec3 &invDir, float tMin, float tMax,
+        float *entry = nullptr)
+    {
+        for(int axis = 0; axis < 3; ++axis)
+        {
+            float t0 = (low[axis]  - origin[axis]) * invDir[axis];
+            float t1 = (high[axis] - origin[axis]) * invDir[axis];
+            if(t0 > t1)
+            {
+                std::swap(t0, t1);
+            }
+
+            tMin = (std::max)(tMin, t0);
+            tMax = (std::min)(tMax, t1);
+            if(tMin > tMax)
+            {
+                return false;
+            }
+        }
+
+        if(entry)
+        {
+            *entry = tMin;
+        }
+        return true;
+    }
+
+} // namespace anonymous
+
+MeshBVH::MeshBVH(const Mesh &mesh)
+{
+    // 每个四边形拆分为两个三角形
+
+    std::vector<uint32_t> triangleOffsets(mesh.faces.size() + 1);
+    triangleOffsets[0] = 0;
+    for(size_t i = 0; i < mesh.faces.size(); ++i)
+    {
+        triangleOffsets[i + 1] = triangleOffsets[i] + (mesh.faces[i].isQuad ? 2 : 1);
+    }
+
+    std::vector<Triangle> triangles(triangleOffsets.back());
+    std::vector<BuildPrimitive> primitives(triangles.size());
+
+    parallelFor(mesh.faces.size(), [&](size_t fi)
+    {
+        auto &f = mesh.faces[fi];
+        int triangleCount = f.isQuad ? 2 : 1;
+
+        for(int h = 0; h < triangleCount; ++h)
+        {
+            const uint32_t ti = triangleOffsets[fi] + h;
+
+            const Vec3 &a = mesh.vertices[f.indices[0]].position;
+            const Vec3 &b = mesh.vertices[f.indices[h + 1]].position;
+            const Vec3 &c = mesh.vertices[f.indices[h + 2]].position;
+
+            triangles[ti] = { a, b - a, c - a, static_cast<uint32_t>(fi), f.isQuad ? uint32_t(h) : 2u };
+
+            auto &p = primitives[ti];
+            p.bounds.extend(a);
+            p.bounds.extend(b);
+            p.bounds.extend(c);
+            p.centroid = (a + b + c) / 3.0f;
+        }
+    });
+
+    std::vector<uint32_t> indices;
+    BVHBuilder(primitives, indices, nodes_).build();
+
+    // 按叶节点中的顺序重排三角形
+
+    triangles_.resize(triangles.size());
+    parallelFor(indices.size(), [&](size_t i)
+    {
+        triangles_[i] = triangles[indices[i]];
+    });
+}
+
+bool MeshBVH::intersect(const Ray &ray, MeshHit &hit) const
+{
+    return traverse<false>(ray, &hit);
+}
+
+bool MeshBVH::occluded(const Ray &ray) const
+{
+    return traverse<true>(ray, nullptr);
+}
+
+size_t MeshBVH::getNodeCount() const noexcept
+{
+    return nodes_.size();
+}
+
+size_t MeshBVH::getTriangleCount() const noexcept
+{
+    return triangles_.size();
+}
+
+template<bool AnyHit>
+bool MeshBVH::traverse(const Ray &ray, MeshHit *hit) const
+{
+    if(triangles_.empty())
+    {
+        return false;
+    }
+
+    const Vec3 invDir(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z);
+
+    float tMax = ray.tMax;
+    const Triangle *closest = nullptr;
+    float closestB1 = 0, closestB2 = 0;
+
+    uint32_t stack[64];
+    int stackTop = 0;
+    stack[stackTop++] = 0;
+
+    while(stackTop)
+    {
+        const BVHNode &node = nodes_[stack[--stackTop]];
+        if(!intersectAABB(node.low, node.high, ray.origin, invDir, ray.tMin, tMax))
+        {
+            continue;
+        }
+
+        if(!node.count)
+        {
+            // 先访问射线方向上较近的子节点
+
+            const BVHNode &left  = nodes_[node.offset];
+            const BVHNode &right = nodes_[node.offset + 1];
+
+            float leftDistance  = dot(left.low  + left.high  - 2.0f * ray.origin, ray.direction);
+            float rightDistance = dot(right.low + right.high - 2.0f * ray.origin, ray.direction);
+
+            if(leftDistance < rightDistance)
+            {
+                stack[stackTop++] = node.offset + 1;
+                stack[stackTop++] = node.offset;
+            }
+            else
+            {
+                stack[stackTop++] = node.offset;
+                stack[stackTop++] = node.offset + 1;
+            }
+            continue;
+        }
+
+        // Möller–Trumbore
+
+        for(uint32_t i = node.offset; i < node.offset + node.count; ++i)
+        {
+            auto &tri = triangles_[i];
+
+            Vec3 p = cross(ray.direction, tri.ac);
+            float det = dot(tri.ab, p);
+            if(std::abs(det) < 1e-12f)
+            {
+                continue;
+            }
+            float invDet = 1 / det;
+
+            Vec3 s = ray.origin - tri.a;
+            float b1 = dot(s, p) * invDet;
+            if(b1 < 0 || b1 > 1)
+            {
+                continue;
+            }
+
+            Vec3 q = cross(s, tri.ab);
+            float b2 = dot(ray.direction, q) * invDet;
+            if(b2 < 0 || b1 + b2 > 1)
+            {
+                continue;
+            }
+
+            float t = dot(tri.ac, q) * invDet;
+            if(t < ray.tMin || t > tMax)
+            {
+                continue;
+            }
+
+            if(AnyHit)
+            {
+                return true;
+            }
+
+            tMax      = t;
+            closest   = &tri;
+            closestB1 = b1;
+            closestB2 = b2;
+        }
+    }
+
+    if(!closest)
+    {
+        return false;
+    }
+
+    if(hit)
+    {
+        hit->t        = tMax;
+        hit->face     = closest->face;
+        hit->position = closest->a + closestB1 * closest->ab + closestB2 * closest->ac;
+
+        // 三角形的重心坐标转换为四边形上的参数
+
+        if(closest->half == 0)
+        {
+            hit->faceUV = Vec2(closestB1 + closestB2, closestB2);
+        }
+        else if(closest->half == 1)
+        {
+            hit->faceUV = Vec2(closestB1, closestB1 + closestB2);
+        }
+        else
+        {
+            hit->faceUV = Vec2(closestB1, closestB2);
+        }
+    }
+
+    return true;
+}
+
+bool intersectSurface(
+    const MeshBVH &bvh, const SubdivisionHierarchy &hierarchy, int level,
+    const Ray &ray, SurfaceHit &hit)
+{
+    if(!bvh.intersect(ray, hit.meshHit))
+    {
+        return false;
+    }
+
+    hit.location = hierarchy.locate(level, hit.meshHit.face, hit.meshHit.faceUV);
+    return true;
+}
+
+BoxBVH::BoxBVH(const std::vector<BoundingBox> &boxes)
+    : boxes_(boxes)
+{
+    std::vector<BuildPrimitive> primitives(boxes.size());
+    parallelFor(boxes.size(), [&](size_t i)
+    {
+        auto &p = primitives[i];
+        p.bounds.extend(boxes[i].low);
+        p.bounds.extend(boxes[i].high);
+        p.centroid = 0.5f * (boxes[i].low + boxes[i].high);
+    });
+
+    BVHBuilder(primitives, boxIndices_, nodes_).build();
+}
+
+void BoxBVH::intersect(const Ray &ray, std::vector<BoxHit> &hits) const
+{
+    hits.clear();
+    if(boxes_.empty())
+    {
+        return;
+    }
+
+    const Vec3 invDir(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z);
+
+    uint32_t stack[64];
+    int stackTop = 0;
+    stack[stackTop++] = 0;
+
+    while(stackTop)
+    {
+        const BVHNode &node = nodes_[stack[--stackTop]];
+        if(!intersectAABB(node.low, node.high, ray.origin, invDir, ray.tMin, ray.tMax))
+        {
+            continue;
+        }
+
+        if(!node.count)
+        {
+            stack[stackTop++] = node.offset;
+            stack[stackTop++] = node.offset + 1;
+            continue;
+        }
+
+        for(uint32_t i = node.offset; i < node.offset + node.count; ++i)
+        {
+            const uint32_t boxIndex = boxIndices_[i];
+            auto &box = boxes_[boxIndex];
+
+            float entry;
+            if(intersectAABB(box.low, box.high, ray.origin, invDir, ray.tMin, ray.tMax, &entry))
+            {
+                hits.push_back({ entry, boxIndex });
+            }
+        }
+    }
+
+    std::sort(hits.begin(), hits.end(), [](const BoxHit &a, const BoxHit &b)
+    {
+        return a.t < b.t;
+    });
+}
@@ -0,0 +1,284 @@
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include <catmull_clark/buffer_subdivision.h>
+#include <catmull_clark/c_api.h>
+
+struct CcsTopology
+{
+    std::shared_ptr<const SubdivisionTopology> topology;
+};
+
+struct CcsEvaluator
+{
+    std::shared_ptr<const SubdivisionTopology> topology;
+    std::vector<std::byte> workspace;
+    bool multithreaded;
+};
+
+namespace
+{
+
+    thread_local std::string lastError;
+
+    CcsResult fail(CcsResult result, const char *message)
+    {
+        lastError = message;
+        return result;
+    }
+
+    /**
+     * @brief 调用func，把异常转换为错误码。C++异常不能穿过C接口
+     */
+    template<typename Func>
+    CcsResult translateExceptions(CcsResult errorOnRuntimeError, const Func &func) noexcept
+    {
+        try
+        {
+            return func();
+        }
+        catch(const std::bad_alloc &)
+        {
+            return fail(CCS_ERROR_OUT_OF_MEMORY, "out of memory");
+        }
+        catch(const std::runtime_error &err)
+        {
+            return fail(errorOnRuntimeError, err.what());
+        }
+        catch(const std::exception &err)
+        {
+            return fail(CCS_ERROR_UNKNOWN, err.what());
+        }
+        catch(...)
+        {
+            return fail(CCS_ERROR_UNKNOWN, "unknown error");
+        }
+    }
+
+    size_t getIndexSize(CcsIndexType type) noexcept
+    {
+        switch(type)
+        {
+        case CCS_INDEX_TYPE_UINT8:  return sizeof(uint8_t);
+        case CCS_INDEX_TYPE_UINT16: return sizeof(uint16_t);
+        case CCS_INDEX_TYPE_UINT32: return sizeof(uint32_t);
+        default:                    return 0;
+        }
+    }
+
+    bool isValidBuffer(const void *data, size_t count, size_t stride, size_t elementSize) noexcept
+    {
+        return (data || !count) && elementSize && stride >= elementSize;
+    }
+
+    size_t getPositionStride(size_t stride) noexcept
+    {
+        return stride ? stride : 3 * sizeof(float);
+    }
+
+    /**
+     * @brief 检查并转换输入的整数数组，不复制数据
+     */
+    bool toIndexView(const CcsConstIndexBuffer *buffer, IndexView &view) noexcept
+    {
+        if(!buffer)
+        {
+            return false;
+        }
+
+        const size_t elementSize = getIndexSize(buffer->type);
+        const size_t stride = buffer->stride ? buffer->stride : elementSize;
+        if(!isValidBuffer(buffer->data, buffer->count, stride, elementSize))
+        {
+            return false;
+        }
+
+        view.data   = buffer->data;
+        view.stride = stride;
+        view.size   = buffer->count;
+        view.format = static_cast<IndexFormat>(buffer->type);
+        return true;
+    }
+
+    template<typename Index>
+    void storeIndices(const ArrayView<const uint32_t> &src, unsigned char *dst, size_t stride) noexcept
+    {
+        for(size_t i = 0; i < src.size; ++i)
+        {
+            *reinterpret_cast<Index*>(dst + i * stride) = static_cast<Index>(src[i]);
+        }
+    }
+
+} // namespace anonymous
+
+static_assert(static_cast<int>(IndexFormat::UInt8)  == CCS_INDEX_TYPE_UINT8);
+static_assert(static_cast<int>(IndexFormat::UInt16) == CCS_INDEX_TYPE_UINT16);
+static_assert(static_cast<int>(IndexFormat::UInt32) == CCS_INDEX_TYPE_UINT32);
+
+uint32_t ccsGetApiVersion(void)
+{
+    return CCS_API_VERSION;
+}
+
+const char *ccsGetLastError(void)
+{
+    return lastError.c_str();
+}
+
+CcsResult ccsCreateTopology(
+    const CcsConstIndexBuffer *faceVertexCounts,
+    const CcsConstIndexBuffer *indices,
+    size_t                     vertexCount,
+    int                        iterationCount,
+    uint32_t                   flags,
+    CcsTopology              **topology)
+{
+    IndexView countView, indexView;
+    if(!topology || !toIndexView(faceVertexCounts, countView) || !toIndexView(indices, indexView))
+    {
+        return fail(CCS_ERROR_INVALID_ARGUMENT, "ccsCreateTopology: invalid buffer");
+    }
+
+    if(iterationCount < 1)
+    {
+        return fail(CCS_ERROR_INVALID_ARGUMENT, "ccsCreateTopology: iteration count must be at least 1");
+    }
+
+    *topology = nullptr;
+    return translateExceptions(CCS_ERROR_INVALID_TOPOLOGY, [&]
+    {
+        const bool multithreaded = !(flags & CCS_FLAG_SINGLE_THREADED);
+        auto result = std::make_unique<CcsTopology>();
+        result->topology = std::make_shared<SubdivisionTopology>(
+            countView, indexView, vertexCount, iterationCount, multithreaded);
+
+        *topology = result.release();
+        return CCS_SUCCESS;
+    });
+}
+
+void ccsDestroyTopology(CcsTopology *topology)
+{
+    delete topology;
+}
+
+size_t ccsGetInputVertexCount(const CcsTopology *topology)
+{
+    return topology ? topology->topology->getInputVertexCount() : 0;
+}
+
+size_t ccsGetOutputVertexCount(const CcsTopology *topology)
+{
+    return topology ? topology->topology->getOutputVertexCount() : 0;
+}
+
+size_t ccsGetOutputFaceCount(const CcsTopology *topology)
+{
+    return topology ? topology->topology->getOutputFaceCount() : 0;
+}
+
+CcsResult ccsCopyOutputIndices(const CcsTopology *topology, const CcsIndexBuffer *indices)
+{
+    if(!topology || !indices)
+    {
+        return fail(CCS_ERROR_INVALID_ARGUMENT, "ccsCopyOutputIndices: null argument");
+    }
+
+    const size_t elementSize = getIndexSize(indices->type);
+    const size_t stride = indices->stride ? indices->stride : elementSize;
+    if(!isValidBuffer(indices->data, indices->count, stride, elementSize))
+    {
+        return fail(CCS_ERROR_INVALID_ARGUMENT, "ccsCopyOutputIndices: invalid buffer");
+    }
+
+    const SubdivisionTopology &t = *topology->topology;
+    if(indices->type == CCS_INDEX_TYPE_UINT8 ||
+      (indices->type == CCS_INDEX_TYPE_UINT16 && t.getOutputVertexCount() > UINT16_MAX + size_t(1)))
+    {
+        return fail(CCS_ERROR_INVALID_ARGUMENT, "ccsCopyOutputIndices: index type too narrow");
+    }
+
+    const ArrayView<const uint32_t> src = t.getOutputIndices();
+    if(indices->count < src.size)
+    {
+        return fail(CCS_ERROR_BUFFER_TOO_SMALL, "ccsCopyOutputIndices: buffer too small");
+    }
+
+    auto dst = static_cast<unsigned char*>(indices->data);
+    if(indices->type == CCS_INDEX_TYPE_UINT16)
+    {
+        storeIndices<uint16_t>(src, dst, stride);
+    }
+    else
+    {
+        storeIndices<uint32_t>(src, dst, stride);
+    }
+    return CCS_SUCCESS;
+}
+
+CcsResult ccsCreateEvaluator(const CcsTopology *topology, uint32_t flags, CcsEvaluator **evaluator)
+{
+    if(!topology || !evaluator)
+    {
+        return fail(CCS_ERROR_INVALID_ARGUMENT, "ccsCreateEvaluator: null argument");
+    }
+
+    *evaluator = nullptr;
+    return translateExceptions(CCS_ERROR_UNKNOWN, [&]
+    {
+        auto result = std::make_unique<CcsEvaluator>();
+        result->topology      = topology->topology;
+        result->multithreaded = !(flags & CCS_FLAG_SINGLE_THREADED);
+        result->workspace.resize(result->topology->getWorkspaceBytes());
+
+        *evaluator = result.release();
+        return CCS_SUCCESS;
+    });
+}
+
+void ccsDestroyEvaluator(CcsEvaluator *evaluator)
+{
+    delete evaluator;
+}
+
+CcsResult ccsEvaluate(
+    CcsEvaluator                 *evaluator,
+    const CcsConstPositionBuffer *input,
+    const CcsPositionBuffer      *output)
+{
+    if(!evaluator || !input || !output)
+    {
+        return fail(CCS_ERROR_INVALID_ARGUMENT, "ccsEvaluate: null argument");
+    }
+
+    const size_t inputStride  = getPositionStride(input->stride);
+    const size_t outputStride = getPositionStride(output->stride);
+    if(!isValidBuffer(input->data, input->count, inputStride, 3 * sizeof(float)) ||
+       !isValidBuffer(output->data, output->count, outputStride, 3 * sizeof(float)))
+    {
+        return fail(CCS_ERROR_INVALID_ARGUMENT, "ccsEvaluate: invalid buffer");
+    }
+
+    const SubdivisionTopology &topology = *evaluator->topology;
+    if(input->count != topology.getInputVertexCount())
+    {
+        return fail(CCS_ERROR_INVALID_ARGUMENT, "ccsEvaluate: input vertex count mismatch");
+    }
+
+    if(output->count < topology.getOutputVertexCount())
+    {
+        return fail(CCS_ERROR_BUFFER_TOO_SMALL, "ccsEvaluate: output buffer too small");
+    }
+
+    return translateExceptions(CCS_ERROR_UNKNOWN, [&]
+    {
+        topology.evaluate(
+            { input->data, inputStride, input->count },
+            { output->data, outputStride, output->count },
+            { evaluator->workspace.data(), evaluator->workspace.size() },
+            evaluator->multithreaded);
+        return CCS_SUCCESS;
+    });
+}
@@ -1,7 +1,15 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/mesh_validation.h>
+#include <catmull_clark/parallel.h>
 
 namespace
 {
@@ -31,7 +39,7 @@ namespace
     /**
      * @brief 带有拓扑信息的模型
      *
-     * - 位于同一位置的多个顶点被自动合并
+     * - 位于同一位置的多个顶点被自动合并（按顶点下标建立时除外）
      * - 每个顶点属于哪些边和哪些面
      * - 每条边属于哪些面，包含哪些顶点
      * - 每个面包含哪些边和哪些顶点
@@ -47,22 +55,6 @@ namespace
         std::unordered_map<Vec3, int>  positionToVertex;
         std::unordered_map<Vec2i, int> vertexPairToEdge;
 
-        /**
-         * @brief 将某个顶点挪动到指定的新位置
-         */
-        void moveVertex(int vertexIndex, const Vec3 &newPosition)
-        {
-            auto oldPosition = vertices[vertexIndex].position;
-            positionToVertex.erase(oldPosition);
-            if(positionToVertex.find(newPosition) != positionToVertex.end())
-            {
-                throw std::runtime_error(
-                    "topology error in moving vertex: same position for different vertices");
-            }
-            positionToVertex[newPosition] = vertexIndex;
-            vertices[vertexIndex].position = newPosition;
-        }
-
         /**
          * @brief 取得position对应的顶点下标
          *
@@ -114,11 +106,23 @@ namespace
 
     /**
      * @brief 将网格模型转换为带基本拓扑信息的model
+     *
+     * weldVertices为false时不按位置合并顶点，model中的顶点与mesh中的一一对应，此时mesh的每个顶点都须被面引用，
+     * 且positionToVertex为空
      */
-    Model meshToModel(const Mesh &mesh)
+    Model meshToModel(const Mesh &mesh, bool weldVertices = true)
     {
         Model model;
 
+        if(!weldVertices)
+        {
+            model.vertices.resize(mesh.vertices.size());
+            for(size_t i = 0; i < mesh.vertices.size(); ++i)
+            {
+                model.vertices[i].position = mesh.vertices[i].position;
+            }
+        }
+
         for(auto &f : mesh.faces)
         {
             // 将顶点添加到顶点表，记录其下标
@@ -127,7 +131,8 @@ namespace
             int vertexIndices[4] = { -1, -1, -1, -1 };
             for(int i = 0; i < vertexCount; ++i)
             {
-                vertexIndices[i] = model.getVertexIndex(mesh.vertices[f.indices[i]].position);
+                vertexIndices[i] = weldVertices ?
+                    model.getVertexIndex(mesh.vertices[f.indices[i]].position) : static_cast<int>(f.indices[i]);
             }
 
             // 将边添加到边表，记录其下标
@@ -190,9 +195,11 @@ namespace
     }
 
     /**
-     * @brief 在oldModel上应用一次Catmull-Clark算法
+     * @brief 计算细分一次后的顶点位置，按[vertex points][edge points][face points]的顺序排列
+     *
+     * 若fixedVertices非空，其中为true的顶点保持原位置
      */
-    Mesh applyCatmullClarkSubdivisionOnce(Model oldModel)
+    std::vector<Vertex> computeSubdividedVertices(const Model &oldModel, const std::vector<bool> *fixedVertices)
     {
         // 计算face points
 
@@ -232,19 +239,21 @@ namespace
             }
         }
 
-        // 更新vertex位置
+        // 更新vertex位置，直接写入新的顶点表
 
-        std::vector<Vec3> oldPositions;
-        oldPositions.reserve(oldModel.vertices.size());
-        for(auto &v : oldModel.vertices)
-        {
-            oldPositions.push_back(v.position);
-        }
+        std::vector<Vertex> newVertices(
+            oldModel.vertices.size() + oldModel.edges.size() + oldModel.faces.size());
 
         for(size_t i = 0; i < oldModel.vertices.size(); ++i)
         {
             auto &v = oldModel.vertices[i];
 
+            if(fixedVertices && (*fixedVertices)[i])
+            {
+                newVertices[i].position = v.position;
+                continue;
+            }
+
             int n = static_cast<int>(v.faces.size());
             float m1 = static_cast<float>(n - 3) / n;
             float m2 = 1.0f / n;
@@ -261,101 +270,225 @@ namespace
             for(auto edgeIndex : v.edges)
             {
                 auto &edge = oldModel.edges[edgeIndex];
-                avgEdgeMid += 0.5f * (oldPositions[edge.lowVertex] + oldPositions[edge.highVertex]);
+                avgEdgeMid += 0.5f * (
+                    oldModel.vertices[edge.lowVertex].position +
+                    oldModel.vertices[edge.highVertex].position);
             }
             avgEdgeMid /= static_cast<float>(v.edges.size());
 
-            Vec3 newPosition = m1 * oldPositions[i] + m2 * avgFacePosition + m3 * avgEdgeMid;
-            oldModel.moveVertex(static_cast<int>(i), newPosition);
+            newVertices[i].position = m1 * v.position + m2 * avgFacePosition + m3 * avgEdgeMid;
+        }
+
+        const auto edgePointBase = static_cast<Face::Index>(oldModel.vertices.size());
+        for(size_t i = 0; i < edgePoints.size(); ++i)
+        {
+            newVertices[edgePointBase + i].position = edgePoints[i];
+        }
+
+        const auto facePointBase = static_cast<Face::Index>(edgePointBase + edgePoints.size());
+        for(size_t i = 0; i < facePoints.size(); ++i)
+        {
+            newVertices[facePointBase + i].position = facePoints[i];
         }
 
-        // 构造新mesh
+        return newVertices;
+    }
 
+    /**
+     * @brief 以computeSubdividedVertices的结果为顶点表构造细分一次后的mesh，各面共享位于同一位置的顶点
+     *
+     * 若newEdges非空，还会输出新mesh的边表：
+     * - 每条旧边被其edge point分为两条新边，位于[2 * i, 2 * i + 1]
+     * - 每个旧面的face point与其各边的edge point相连，按面的顺序排列在旧边之后
+     */
+    Mesh buildSubdividedMesh(const Model &oldModel, std::vector<Vertex> newVertices, std::vector<Edge> *newEdges)
+    {
         Mesh newMesh;
+        newMesh.vertices = std::move(newVertices);
+
+        const auto edgePointBase = static_cast<Face::Index>(oldModel.vertices.size());
+        const auto facePointBase = static_cast<Face::Index>(edgePointBase + oldModel.edges.size());
+
+        // 构造新mesh的面
+
+        newMesh.faces.reserve(4 * oldModel.faces.size());
 
         for(size_t fi = 0; fi < oldModel.faces.size(); ++fi)
         {
             auto &f = oldModel.faces[fi];
+            auto faceIndex = static_cast<Face::Index>(facePointBase + fi);
+
             if(f.isQuad)
             {
-                Vec3 va = oldModel.vertices[f.vertices[0]].position;
-                Vec3 vb = oldModel.vertices[f.vertices[1]].position;
-                Vec3 vc = oldModel.vertices[f.vertices[2]].position;
-                Vec3 vd = oldModel.vertices[f.vertices[3]].position;
-
-                Vec3 eab = edgePoints[oldModel.getEdgeIndex({ f.vertices[0], f.vertices[1] })];
-                Vec3 ebc = edgePoints[oldModel.getEdgeIndex({ f.vertices[1], f.vertices[2] })];
-                Vec3 ecd = edgePoints[oldModel.getEdgeIndex({ f.vertices[2], f.vertices[3] })];
-                Vec3 eda = edgePoints[oldModel.getEdgeIndex({ f.vertices[3], f.vertices[0] })];
-
-                Vec3 fabcd = facePoints[fi];
-
-                auto aIndex = static_cast<Face::Index>(newMesh.vertices.size());
-                auto bIndex = aIndex + 1;
-                auto cIndex = aIndex + 2;
-                auto dIndex = aIndex + 3;
-
-                auto eabIndex = aIndex + 4;
-                auto ebcIndex = aIndex + 5;
-                auto ecdIndex = aIndex + 6;
-                auto edaIndex = aIndex + 7;
-
-                auto fabcdIndex = aIndex + 8;
-
-                newMesh.vertices.push_back({ va    });
-                newMesh.vertices.push_back({ vb    });
-                newMesh.vertices.push_back({ vc    });
-                newMesh.vertices.push_back({ vd    });
-                newMesh.vertices.push_back({ eab   });
-                newMesh.vertices.push_back({ ebc   });
-                newMesh.vertices.push_back({ ecd   });
-                newMesh.vertices.push_back({ eda   });
-                newMesh.vertices.push_back({ fabcd });
-
-                newMesh.faces.push_back({ true, { edaIndex, aIndex, eabIndex, fabcdIndex } });
-                newMesh.faces.push_back({ true, { eabIndex, bIndex, ebcIndex, fabcdIndex } });
-                newMesh.faces.push_back({ true, { ebcIndex, cIndex, ecdIndex, fabcdIndex } });
-                newMesh.faces.push_back({ true, { ecdIndex, dIndex, edaIndex, fabcdIndex } });
+                auto aIndex = static_cast<Face::Index>(f.vertices[0]);
+                auto bIndex = static_cast<Face::Index>(f.vertices[1]);
+                auto cIndex = static_cast<Face::Index>(f.vertices[2]);
+                auto dIndex = static_cast<Face::Index>(f.vertices[3]);
+
+                auto eabIndex = static_cast<Face::Index>(edgePointBase + f.edges[0]);
+                auto ebcIndex = static_cast<Face::Index>(edgePointBase + f.edges[1]);
+                auto ecdIndex = static_cast<Face::Index>(edgePointBase + f.edges[2]);
+                auto edaIndex = static_cast<Face::Index>(edgePointBase + f.edges[3]);
+
+                newMesh.faces.push_back({ true, { edaIndex, aIndex, eabIndex, faceIndex } });
+                newMesh.faces.push_back({ true, { eabIndex, bIndex, ebcIndex, faceIndex } });
+                newMesh.faces.push_back({ true, { ebcIndex, cIndex, ecdIndex, faceIndex } });
+                newMesh.faces.push_back({ true, { ecdIndex, dIndex, edaIndex, faceIndex } });
             }
             else
             {
-                Vec3 va = oldModel.vertices[f.vertices[0]].position;
-                Vec3 vb = oldModel.vertices[f.vertices[1]].position;
-                Vec3 vc = oldModel.vertices[f.vertices[2]].position;
+                auto aIndex = static_cast<Face::Index>(f.vertices[0]);
+                auto bIndex = static_cast<Face::Index>(f.vertices[1]);
+                auto cIndex = static_cast<Face::Index>(f.vertices[2]);
 
-                Vec3 eab = edgePoints[oldModel.getEdgeIndex({ f.vertices[0], f.vertices[1] })];
-                Vec3 ebc = edgePoints[oldModel.getEdgeIndex({ f.vertices[1], f.vertices[2] })];
-                Vec3 eca = edgePoints[oldModel.getEdgeIndex({ f.vertices[2], f.vertices[0] })];
+                auto eabIndex = static_cast<Face::Index>(edgePointBase + f.edges[0]);
+                auto ebcIndex = static_cast<Face::Index>(edgePointBase + f.edges[1]);
+                auto ecaIndex = static_cast<Face::Index>(edgePointBase + f.edges[2]);
 
-                Vec3 fabc = facePoints[fi];
+                newMesh.faces.push_back({ true, { ecaIndex, aIndex, eabIndex, faceIndex } });
+                newMesh.faces.push_back({ true, { eabIndex, bIndex, ebcIndex, faceIndex } });
+                newMesh.faces.push_back({ true, { ebcIndex, cIndex, ecaIndex, faceIndex } });
+            }
+        }
 
-                auto aIndex = static_cast<Face::Index>(newMesh.vertices.size());
-                auto bIndex = aIndex + 1;
-                auto cIndex = aIndex + 2;
-                
-                auto eabIndex = aIndex + 3;
-                auto ebcIndex = aIndex + 4;
-                auto ecaIndex = aIndex + 5;
-                
-                auto fabcIndex = aIndex + 6;
+        // 构造新mesh的边表
 
-                newMesh.vertices.push_back({ va   });
-                newMesh.vertices.push_back({ vb   });
-                newMesh.vertices.push_back({ vc   });
-                newMesh.vertices.push_back({ eab  });
-                newMesh.vertices.push_back({ ebc  });
-                newMesh.vertices.push_back({ eca  });
-                newMesh.vertices.push_back({ fabc });
+        if(newEdges)
+        {
+            const size_t oldEdgeCount = oldModel.edges.size();
 
-                newMesh.faces.push_back({ true, { ecaIndex, aIndex, eabIndex, fabcIndex } });
-                newMesh.faces.push_back({ true, { eabIndex, bIndex, ebcIndex, fabcIndex } });
-                newMesh.faces.push_back({ true, { ebcIndex, cIndex, ecaIndex, fabcIndex } });
+            std::vector<size_t> faceEdgeOffsets(oldModel.faces.size() + 1);
+            faceEdgeOffsets[0] = 2 * oldEdgeCount;
+            for(size_t fi = 0; fi < oldModel.faces.size(); ++fi)
+            {
+                faceEdgeOffsets[fi + 1] = faceEdgeOffsets[fi] + (oldModel.faces[fi].isQuad ? 4 : 3);
             }
+
+            newEdges->resize(faceEdgeOffsets.back());
+            auto &edges = *newEdges;
+
+            parallelFor(oldEdgeCount, [&](size_t i)
+            {
+                auto &e = oldModel.edges[i];
+                auto edgePointIndex = static_cast<Face::Index>(edgePointBase + i);
+
+                edges[2 * i]     = { { static_cast<Face::Index>(e.lowVertex), edgePointIndex } };
+                edges[2 * i + 1] = { { edgePointIndex, static_cast<Face::Index>(e.highVertex) } };
+            });
+
+            parallelFor(oldModel.faces.size(), [&](size_t fi)
+            {
+                auto &f = oldModel.faces[fi];
+                auto faceIndex = static_cast<Face::Index>(facePointBase + fi);
+
+                int edgeCount = f.isQuad ? 4 : 3;
+                for(int i = 0; i < edgeCount; ++i)
+                {
+                    auto edgePointIndex = static_cast<Face::Index>(edgePointBase + f.edges[i]);
+                    edges[faceEdgeOffsets[fi] + i] = { { edgePointIndex, faceIndex } };
+                }
+            });
         }
 
         return newMesh;
     }
 
+    /**
+     * @brief 在oldModel上应用一次Catmull-Clark算法
+     */
+    Mesh applyCatmullClarkSubdivisionOnce(
+        const Model &oldModel, std::vector<Edge> *newEdges, const std::vector<bool> *fixedVertices = nullptr)
+    {
+        return buildSubdividedMesh(oldModel, computeSubdividedVertices(oldModel, fixedVertices), newEdges);
+    }
+
+    /**
+     * @brief 估计各原始面上细分时控制网格位移的收敛速率，即相邻两层的最大位移之比
+     *
+     * 正则区域上的细分是双三次B样条细分，位移与二阶差分成正比，渐近地每层缩小为1/4；
+     * 度数为n的内部奇异顶点附近按次主特征值λ(n)收敛；开放边界上的顶点规则依赖于顶点编号，
+     * 实测速率约为2/3，取3/4。这些都是渐近速率，头几层的实际比值可能更大，因此只是估计值
+     * 原始三角形细分后其中心成为度数为3的奇异顶点
+     */
+    std::vector<float> computeFaceConvergenceRates(const Model &model)
+    {
+        std::vector<bool> isBoundary(model.vertices.size());
+        for(auto &e : model.edges)
+        {
+            if(e.faceCount != 2)
+            {
+                isBoundary[e.lowVertex] = isBoundary[e.highVertex] = true;
+            }
+        }
+
+        auto computeSubdominantEigenvalue = [](int n)
+        {
+            const float c1 = std::cos(2 * agz::math::PI_f / n);
+            const float c2 = std::cos(agz::math::PI_f / n);
+            return (5 + c1 + c2 * std::sqrt(2 * (9 + c1))) / 16;
+        };
+
+        std::vector<float> vertexRates(model.vertices.size());
+        for(size_t i = 0; i < model.vertices.size(); ++i)
+        {
+            const int n = static_cast<int>(model.vertices[i].faces.size());
+            if(isBoundary[i])
+            {
+                vertexRates[i] = 0.75f;
+            }
+            else
+            {
+                vertexRates[i] = n == 4 ? 0.25f : computeSubdominantEigenvalue(n);
+            }
+        }
+
+        std::vector<float> faceRates(model.faces.size());
+        for(size_t fi = 0; fi < model.faces.size(); ++fi)
+        {
+            auto &f = model.faces[fi];
+            float rate = f.isQuad ? 0.25f : computeSubdominantEigenvalue(3);
+            for(int i = 0; i < (f.isQuad ? 4 : 3); ++i)
+            {
+                rate = (std::max)(rate, vertexRates[f.vertices[i]]);
+            }
+            faceRates[fi] = rate;
+        }
+
+        return faceRates;
+    }
+
+    /**
+     * @brief 收集未细分的网格模型中的所有边
+     *
+     * 直接使用mesh中的顶点下标，不合并位于同一位置的顶点
+     */
+    std::vector<Edge> collectMeshEdges(const Mesh &mesh)
+    {
+        std::vector<Edge> edges;
+        std::unordered_set<Vec2i> isEdgeAdded;
+
+        for(auto &f : mesh.faces)
+        {
+            int vertexCount = f.isQuad ? 4 : 3;
+            for(int i = 0; i < vertexCount; ++i)
+            {
+                auto a = f.indices[i];
+                auto b = f.indices[(i + 1) % vertexCount];
+                if(a > b)
+                {
+                    std::swap(a, b);
+                }
+
+                if(isEdgeAdded.insert({ static_cast<int>(a), static_cast<int>(b) }).second)
+                {
+                    edges.push_back({ { a, b } });
+                }
+            }
+        }
+
+        return edges;
+    }
+
 } // namespace anonymous
 
 Mesh applyCatmullClarkSubdivision(const Mesh &originalMesh, int iterationCount)
@@ -365,7 +498,378 @@ Mesh applyCatmullClarkSubdivision(const Mesh &originalMesh, int iterationCount)
     Mesh mesh = originalMesh;
     for(int i = 0; i < iterationCount; ++i)
     {
-        mesh = applyCatmullClarkSubdivisionOnce(meshToModel(mesh));
+        mesh = applyCatmullClarkSubdivisionOnce(meshToModel(mesh), nullptr);
     }
     return mesh;
 }
+
+Mesh applyCatmullClarkSubdivision(
+    const Mesh &originalMesh, int iterationCount, std::vector<Edge> &edges)
+{
+    assert(iterationCount >= 0);
+
+    if(!iterationCount)
+    {
+        edges = collectMeshEdges(originalMesh);
+        return originalMesh;
+    }
+
+    Mesh mesh = originalMesh;
+    for(int i = 0; i < iterationCount; ++i)
+    {
+        bool isLast = i == iterationCount - 1;
+        mesh = applyCatmullClarkSubdivisionOnce(meshToModel(mesh), isLast ? &edges : nullptr);
+    }
+    return mesh;
+}
+
+ToleranceSubdivisionResult applyCatmullClarkSubdivision(
+    const Mesh &originalMesh, const ToleranceSubdivisionOptions &options)
+{
+    assert(options.maxIterationCount >= 0);
+
+    const size_t baseFaceCount = originalMesh.faces.size();
+    if(!options.faceTolerances.empty() && options.faceTolerances.size() != baseFaceCount)
+    {
+        throw std::runtime_error("applyCatmullClarkSubdivision: face tolerance count mismatch");
+    }
+
+    ToleranceSubdivisionResult result;
+    result.faceErrorEstimates.resize(baseFaceCount);
+    result.faceIterationCounts.assign(baseFaceCount, -1);
+
+    // baseFaces[i]为当前mesh中第i个面所属的原始面
+
+    Mesh mesh = originalMesh;
+    std::vector<uint32_t> baseFaces(baseFaceCount);
+    for(size_t f = 0; f < baseFaceCount; ++f)
+    {
+        baseFaces[f] = static_cast<uint32_t>(f);
+    }
+
+    std::vector<float> faceRates;
+    std::vector<float> vertexDisplacements, edgeDisplacements, faceDisplacements(baseFaceCount);
+
+    for(int level = 0;; ++level)
+    {
+        const Model model = meshToModel(mesh);
+        if(!level)
+        {
+            faceRates = computeFaceConvergenceRates(model);
+        }
+
+        // 本层控制网格（视为分片双线性曲面）与下一层之间的参数距离不超过顶点与边中点的最大位移，
+        // face point恰为面的双线性中心，不产生位移
+
+        std::vector<Vertex> newVertices = computeSubdividedVertices(model, nullptr);
+
+        vertexDisplacements.resize(model.vertices.size());
+        for(size_t i = 0; i < model.vertices.size(); ++i)
+        {
+            vertexDisplacements[i] = (newVertices[i].position - model.vertices[i].position).length();
+        }
+
+        edgeDisplacements.resize(model.edges.size());
+        for(size_t i = 0; i < model.edges.size(); ++i)
+        {
+            auto &e = model.edges[i];
+            const Vec3 mid = 0.5f * (model.vertices[e.lowVertex].position + model.vertices[e.highVertex].position);
+            edgeDisplacements[i] = (newVertices[model.vertices.size() + i].position - mid).length();
+        }
+
+        std::fill(faceDisplacements.begin(), faceDisplacements.end(), 0.0f);
+        for(size_t fi = 0; fi < model.faces.size(); ++fi)
+        {
+            auto &f = model.faces[fi];
+            float &displacement = faceDisplacements[baseFaces[fi]];
+            for(int i = 0; i < (f.isQuad ? 4 : 3); ++i)
+            {
+                displacement = (std::max)(displacement, vertexDisplacements[f.vertices[i]]);
+                displacement = (std::max)(displacement, edgeDisplacements[f.edges[i]]);
+            }
+        }
+
+        // 假设此后各层的位移按收敛速率r几何递减，到极限曲面的总距离估计为本层位移的1 / (1 - r)倍
+
+        bool isDone = true;
+        for(size_t f = 0; f < baseFaceCount; ++f)
+        {
+            const float estimate = faceDisplacements[f] / (1 - faceRates[f]);
+            const float tolerance = options.faceTolerances.empty() ? options.tolerance : options.faceTolerances[f];
+
+            result.faceErrorEstimates[f] = estimate;
+            if(result.faceIterationCounts[f] < 0 && estimate <= tolerance)
+            {
+                result.faceIterationCounts[f] = level;
+            }
+            isDone &= result.faceIterationCounts[f] >= 0;
+        }
+
+        if(isDone || level >= options.maxIterationCount)
+        {
+            for(size_t f = 0; f < baseFaceCount; ++f)
+            {
+                if(result.faceIterationCounts[f] < 0)
+                {
+                    result.faceIterationCounts[f] = level;
+                }
+                result.errorEstimate = (std::max)(result.errorEstimate, result.faceErrorEstimates[f]);
+            }
+
+            result.iterationCount = level;
+            result.mesh = std::move(mesh);
+            return result;
+        }
+
+        std::vector<uint32_t> newBaseFaces;
+        newBaseFaces.reserve(4 * baseFaces.size());
+        for(size_t fi = 0; fi < model.faces.size(); ++fi)
+        {
+            newBaseFaces.insert(newBaseFaces.end(), model.faces[fi].isQuad ? 4 : 3, baseFaces[fi]);
+        }
+        baseFaces.swap(newBaseFaces);
+
+        mesh = buildSubdividedMesh(model, std::move(newVertices), nullptr);
+    }
+}
+
+Mesh applyCatmullClarkSubdivision(
+    const Mesh &originalMesh, int iterationCount, const SubdivisionOptions &options)
+{
+    assert(iterationCount >= 0);
+
+    if(!options.splitNonManifold)
+    {
+        const MeshValidationReport report = validateMesh(originalMesh);
+        if(!report.nonManifoldEdges.empty())
+        {
+            throw std::runtime_error(
+                "topology error: " + std::to_string(report.nonManifoldEdges.size()) +
+                " edges belong to more than 2 faces");
+        }
+        return applyCatmullClarkSubdivision(originalMesh, iterationCount);
+    }
+
+    // 拆分后位于同一位置的顶点副本不能再被合并，此后各层都按顶点下标建立拓扑；
+    // 细分结果的每个顶点都被面引用，满足按下标建立的要求
+
+    Mesh mesh = splitNonManifold(originalMesh);
+    for(int i = 0; i < iterationCount; ++i)
+    {
+        mesh = applyCatmullClarkSubdivisionOnce(meshToModel(mesh, false), nullptr);
+    }
+    return mesh;
+}
+
+Mesh applyCatmullClarkSubdivision(
+    const Mesh &originalMesh, int iterationCount, const std::vector<bool> &faceMask)
+{
+    assert(iterationCount >= 0);
+
+    if(faceMask.size() != originalMesh.faces.size())
+    {
+        throw std::runtime_error("applyCatmullClarkSubdivision: face mask size mismatch");
+    }
+
+    // 在合并了重复顶点的模型上区分选中与未选中的面，选中的面构成待细分的子网格
+
+    const Model baseModel = meshToModel(originalMesh);
+
+    Mesh mesh;
+    mesh.vertices.resize(baseModel.vertices.size());
+    for(size_t i = 0; i < baseModel.vertices.size(); ++i)
+    {
+        mesh.vertices[i].position = baseModel.vertices[i].position;
+    }
+
+    std::vector<size_t> unselectedFaces;
+    for(size_t fi = 0; fi < baseModel.faces.size(); ++fi)
+    {
+        if(!faceMask[fi])
+        {
+            unselectedFaces.push_back(fi);
+            continue;
+        }
+
+        auto &f = baseModel.faces[fi];
+        Face newFace;
+        newFace.isQuad = f.isQuad;
+        for(int i = 0; i < (f.isQuad ? 4 : 3); ++i)
+        {
+            newFace.indices[i] = static_cast<Face::Index>(f.vertices[i]);
+        }
+        mesh.faces.push_back(newFace);
+    }
+
+    if(unselectedFaces.empty())
+    {
+        return applyCatmullClarkSubdivision(originalMesh, iterationCount);
+    }
+
+    if(mesh.faces.empty() || !iterationCount)
+    {
+        return originalMesh;
+    }
+
+    // 同时属于选中与未选中的面的顶点保持不动，两侧共享的边上只插入中点（与边界边的规则相同），
+    // 未选中的面因此在几何上保持不变。
+    // borderChains[e]记录边e上从lowVertex到highVertex依次排列的顶点在当前子网格中的下标
+
+    std::vector<bool> isFixed(baseModel.vertices.size());
+    for(size_t v = 0; v < baseModel.vertices.size(); ++v)
+    {
+        bool hasSelected = false, hasUnselected = false;
+        for(int fi : baseModel.vertices[v].faces)
+        {
+            (faceMask[fi] ? hasSelected : hasUnselected) = true;
+        }
+        isFixed[v] = hasSelected && hasUnselected;
+    }
+
+    std::vector<Face::Index> fixedIndices(baseModel.vertices.size());
+    for(size_t v = 0; v < baseModel.vertices.size(); ++v)
+    {
+        fixedIndices[v] = static_cast<Face::Index>(v);
+    }
+
+    std::vector<std::vector<Face::Index>> borderChains(baseModel.edges.size());
+    for(size_t e = 0; e < baseModel.edges.size(); ++e)
+    {
+        auto &edge = baseModel.edges[e];
+        if(edge.faceCount == 2 && faceMask[edge.faces[0]] != faceMask[edge.faces[1]])
+        {
+            borderChains[e] = {
+                static_cast<Face::Index>(edge.lowVertex),
+                static_cast<Face::Index>(edge.highVertex)
+            };
+        }
+    }
+
+    for(int level = 0; level < iterationCount; ++level)
+    {
+        const Model model = meshToModel(mesh);
+
+        // meshToModel会重新编号顶点，把记录的下标换算到model中
+
+        auto toModel = [&](Face::Index i)
+        {
+            return static_cast<Face::Index>(model.positionToVertex.at(mesh.vertices[i].position));
+        };
+
+        std::vector<bool> modelFixed(model.vertices.size());
+
+        for(size_t v = 0; v < baseModel.vertices.size(); ++v)
+        {
+            if(isFixed[v])
+            {
+                fixedIndices[v] = toModel(fixedIndices[v]);
+                modelFixed[fixedIndices[v]] = true;
+            }
+        }
+
+        // 细分后顶点i的vertex point下标仍为i，边e的edge point下标为顶点数 + e
+
+        const auto edgePointBase = static_cast<Face::Index>(model.vertices.size());
+
+        for(auto &chain : borderChains)
+        {
+            if(chain.empty())
+            {
+                continue;
+            }
+
+            std::vector<Face::Index> newChain;
+            newChain.reserve(2 * chain.size() - 1);
+
+            for(size_t i = 0; i < chain.size(); ++i)
+            {
+                const Face::Index v = toModel(chain[i]);
+                modelFixed[v] = true;
+
+                if(i > 0)
+                {
+                    const Face::Index prev = newChain.back();
+                    const Vec2i pair(static_cast<int>((std::min)(prev, v)), static_cast<int>((std::max)(prev, v)));
+                    newChain.push_back(edgePointBase + static_cast<Face::Index>(model.vertexPairToEdge.at(pair)));
+                }
+                newChain.push_back(v);
+            }
+
+            chain = std::move(newChain);
+        }
+
+        mesh = applyCatmullClarkSubdivisionOnce(model, nullptr, &modelFixed);
+    }
+
+    // 未选中的面原样追加在细分结果之后；与选中区域共享边的面上插入了新的顶点，
+    // 以面中心为公共顶点剖分为三角形，使结果没有T形连接
+
+    constexpr Face::Index INVALID_INDEX = (std::numeric_limits<Face::Index>::max)();
+    std::vector<Face::Index> unselectedIndices(baseModel.vertices.size(), INVALID_INDEX);
+
+    auto getVertexIndex = [&](int v)
+    {
+        if(isFixed[v])
+        {
+            return fixedIndices[v];
+        }
+
+        if(unselectedIndices[v] == INVALID_INDEX)
+        {
+            unselectedIndices[v] = static_cast<Face::Index>(mesh.vertices.size());
+            mesh.vertices.push_back({ baseModel.vertices[v].position });
+        }
+        return unselectedIndices[v];
+    };
+
+    std::vector<Face::Index> polygon;
+    for(size_t fi : unselectedFaces)
+    {
+        auto &f = baseModel.faces[fi];
+        const int vertexCount = f.isQuad ? 4 : 3;
+
+        polygon.clear();
+        for(int i = 0; i < vertexCount; ++i)
+        {
+            auto &chain = borderChains[f.edges[i]];
+            if(chain.empty())
+            {
+                polygon.push_back(getVertexIndex(f.vertices[i]));
+            }
+            else if(baseModel.edges[f.edges[i]].lowVertex == f.vertices[i])
+            {
+                polygon.insert(polygon.end(), chain.begin(), chain.end() - 1);
+            }
+            else
+            {
+                polygon.insert(polygon.end(), chain.rbegin(), chain.rend() - 1);
+            }
+        }
+
+        if(static_cast<int>(polygon.size()) == vertexCount)
+        {
+            Face newFace;
+            newFace.isQuad = f.isQuad;
+            std::copy(polygon.begin(), polygon.end(), newFace.indices);
+            mesh.faces.push_back(newFace);
+            continue;
+        }
+
+        Vec3 center;
+        for(int i = 0; i < vertexCount; ++i)
+        {
+            center += baseModel.vertices[f.vertices[i]].position;
+        }
+        center /= static_cast<float>(vertexCount);
+
+        const auto centerIndex = static_cast<Face::Index>(mesh.vertices.size());
+        mesh.vertices.push_back({ center });
+
+        for(size_t i = 0; i < polygon.size(); ++i)
+        {
+            mesh.faces.push_back({ false, { polygon[i], polygon[(i + 1) % polygon.size()], centerIndex } });
+        }
+    }
+
+    return mesh;
+}
@@ -0,0 +1,164 @@
+#include <cmath>
+
+#include <catmull_clark/closest_point.h>
+#include <catmull_clark/parallel.h>
+
+namespace
+{
+
+    // 初值取自曲面片上INITIAL_GRID x INITIAL_GRID个均匀分布的采样点
+    constexpr int INITIAL_GRID = 3;
+
+    constexpr int   MAX_NEWTON_ITERATIONS = 16;
+    constexpr float NEWTON_EPSILON        = 1e-6f;
+
+    std::vector<BoundingBox> collectPatchBounds(const LimitPatchTable &table)
+    {
+        std::vector<BoundingBox> boxes;
+        boxes.reserve(table.getPatchCount());
+        for(auto &patch : table.getPatches())
+        {
+            boxes.push_back({ patch.low, patch.high });
+        }
+        return boxes;
+    }
+
+} // namespace anonymous
+
+LimitSurfaceProjector::LimitSurfaceProjector(const LimitPatchTable &table)
+    : table_(table), bvh_(collectPatchBounds(table))
+{
+
+}
+
+SurfaceProjection LimitSurfaceProjector::project(const Vec3 &point) const
+{
+    float bestDistanceSquare = (std::numeric_limits<float>::max)();
+    uint32_t bestPatch = 0;
+    Vec2 bestST;
+
+    bvh_.visitNearest(point, bestDistanceSquare, [&](uint32_t patch, float &maxDistanceSquare)
+    {
+        Vec2 st;
+        const float distanceSquare = projectOnPatch(patch, point, st);
+        if(distanceSquare < maxDistanceSquare)
+        {
+            maxDistanceSquare = distanceSquare;
+            bestPatch = patch;
+            bestST    = st;
+        }
+    });
+
+    SurfaceProjection result;
+    if(!table_.getPatchCount())
+    {
+        return result;
+    }
+
+    auto &patch = table_.getPatch(bestPatch);
+    result.location = { patch.baseFace, patch.subFace, patch.frame.apply(bestST) };
+
+    table_.evaluate(bestPatch, bestST, result.position, result.normal);
+    result.distance = (result.position - point).length();
+
+    return result;
+}
+
+void LimitSurfaceProjector::project(const Vec3 *points, size_t count, SurfaceProjection *results) const
+{
+    parallelForRange(count, 256, [&](size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; ++i)
+        {
+            results[i] = project(points[i]);
+        }
+    });
+}
+
+float LimitSurfaceProjector::projectOnPatch(uint32_t patch, const Vec3 &point, Vec2 &st) const
+{
+    PatchDerivatives d;
+
+    // 粗采样取得初值，避免Newton迭代收敛到较远的局部极小值
+
+    float bestDistanceSquare = (std::numeric_limits<float>::max)();
+    for(int i = 0; i < INITIAL_GRID; ++i)
+    {
+        for(int j = 0; j < INITIAL_GRID; ++j)
+        {
+            const Vec2 sample((j + 0.5f) / INITIAL_GRID, (i + 0.5f) / INITIAL_GRID);
+            table_.evaluate(patch, sample, d);
+
+            const float distanceSquare = (d.position - point).length_square();
+            if(distanceSquare < bestDistanceSquare)
+            {
+                bestDistanceSquare = distanceSquare;
+                st = sample;
+            }
+        }
+    }
+
+    // 最小化f(s, t) = |S(s, t) - point|^2 / 2，Hessian不正定时退化为Gauss-Newton。
+    // 迭代不保证单调，因此记录途经的最近点
+
+    Vec2 current = st;
+    for(int iteration = 0; iteration < MAX_NEWTON_ITERATIONS; ++iteration)
+    {
+        table_.evaluate(patch, current, d);
+        const Vec3 r = d.position - point;
+
+        const float distanceSquare = r.length_square();
+        if(distanceSquare < bestDistanceSquare)
+        {
+            bestDistanceSquare = distanceSquare;
+            st = current;
+        }
+
+        const float gs = dot(r, d.ds);
+        const float gt = dot(r, d.dt);
+
+        float hss = dot(d.ds, d.ds) + dot(r, d.dss);
+        float hst = dot(d.ds, d.dt) + dot(r, d.dst);
+        float htt = dot(d.dt, d.dt) + dot(r, d.dtt);
+        float det = hss * htt - hst * hst;
+
+        if(hss <= 0 || det <= 0)
+        {
+            hss = dot(d.ds, d.ds);
+            hst = dot(d.ds, d.dt);
+            htt = dot(d.dt, d.dt);
+            det = hss * htt - hst * hst;
+            if(det <= 0)
+            {
+                return bestDistanceSquare;
+            }
+        }
+
+        const Vec2 step(
+            -(htt * gs - hst * gt) / det,
+            -(hss * gt - hst * gs) / det);
+
+        Vec2 next = current + step;
+        next.x = agz::math::clamp(next.x, 0.0f, 1.0f);
+        next.y = agz::math::clamp(next.y, 0.0f, 1.0f);
+
+        const bool converged = std::abs(next.x - current.x) + std::abs(next.y - current.y) < NEWTON_EPSILON;
+        current = next;
+        if(converged)
+        {
+            break;
+        }
+    }
+
+    // 最后一步得到的点尚未求值
+
+    table_.evaluate(patch, current, d, false);
+    const float distanceSquare = (d.position - point).length_square();
+    if(distanceSquare < bestDistanceSquare)
+    {
+        bestDistanceSquare = distanceSquare;
+        st = current;
+    }
+
+    return bestDistanceSquare;
+}
@@ -0,0 +1,331 @@
+#include <cmath>
+#include <limits>
+
+#include <catmull_clark/cluster.h>
+#include <catmull_clark/parallel.h>
+
+namespace
+{
+
+    /**
+     * @brief 一个簇在面数组中对应的区间[faceBegin, faceEnd)
+     */
+    struct FaceRange
+    {
+        size_t faceBegin;
+        size_t faceEnd;
+    };
+
+    int triangleCountOf(const Face &f)
+    {
+        return f.isQuad ? 2 : 1;
+    }
+
+    /**
+     * @brief 取得面中的第i个三角形，拆分方式与RenderMesh一致
+     */
+    void getTriangle(const Mesh &mesh, const Face &f, int i, Vec3 &a, Vec3 &b, Vec3 &c)
+    {
+        a = mesh.vertices[f.indices[0]].position;
+        b = mesh.vertices[f.indices[i + 1]].position;
+        c = mesh.vertices[f.indices[i + 2]].position;
+    }
+
+    void computeClusterBounds(const Mesh &mesh, const FaceRange &range, Cluster &cluster)
+    {
+        // 包围球：以包围盒中心为球心
+
+        Vec3 low((std::numeric_limits<float>::max)());
+        Vec3 high((std::numeric_limits<float>::lowest)());
+
+        for(size_t fi = range.faceBegin; fi < range.faceEnd; ++fi)
+        {
+            auto &f = mesh.faces[fi];
+            int vertexCount = f.isQuad ? 4 : 3;
+            for(int i = 0; i < vertexCount; ++i)
+            {
+                auto &p = mesh.vertices[f.indices[i]].position;
+
+                low.x = (std::min)(low.x, p.x);
+                low.y = (std::min)(low.y, p.y);
+                low.z = (std::min)(low.z, p.z);
+
+                high.x = (std::max)(high.x, p.x);
+                high.y = (std::max)(high.y, p.y);
+                high.z = (std::max)(high.z, p.z);
+            }
+        }
+
+        cluster.center = 0.5f * (low + high);
+
+        float radiusSquare = 0;
+        for(size_t fi = range.faceBegin; fi < range.faceEnd; ++fi)
+        {
+            auto &f = mesh.faces[fi];
+            int vertexCount = f.isQuad ? 4 : 3;
+            for(int i = 0; i < vertexCount; ++i)
+            {
+                auto &p = mesh.vertices[f.indices[i]].position;
+                radiusSquare = (std::max)(radiusSquare, (p - cluster.center).length_square());
+            }
+        }
+        cluster.radius = std::sqrt(radiusSquare);
+
+        // 法线锥：轴为三角形法线的平均方向
+
+        Vec3 normalSum;
+        for(size_t fi = range.faceBegin; fi < range.faceEnd; ++fi)
+        {
+            auto &f = mesh.faces[fi];
+            for(int i = 0; i < triangleCountOf(f); ++i)
+            {
+                Vec3 a, b, c;
+                getTriangle(mesh, f, i, a, b, c);
+
+                Vec3 nor = cross(b - a, c - a);
+                float len = nor.length();
+                if(len > 0)
+                {
+                    normalSum += nor / len;
+                }
+            }
+        }
+
+        cluster.coneAxis   = Vec3(0, 0, 1);
+        cluster.coneApex   = cluster.center;
+        cluster.coneCutoff = 1;
+
+        float axisLength = normalSum.length();
+        if(axisLength <= 0)
+        {
+            return;
+        }
+        Vec3 axis = normalSum / axisLength;
+
+        float minDot = 1;
+        float maxT   = 0;
+
+        for(size_t fi = range.faceBegin; fi < range.faceEnd; ++fi)
+        {
+            auto &f = mesh.faces[fi];
+            for(int i = 0; i < triangleCountOf(f); ++i)
+            {
+                Vec3 a, b, c;
+                getTriangle(mesh, f, i, a, b, c);
+
+                Vec3 nor = cross(b - a, c - a);
+                float len = nor.length();
+                if(len <= 0)
+                {
+                    continue;
+                }
+                nor /= len;
+
+                float d = dot(axis, nor);
+                minDot = (std::min)(minDot, d);
+
+                // 锥顶沿-axis方向后退，直到三角形所在平面全部位于锥顶前方
+
+                if(d > 0)
+                {
+                    float t = dot(cluster.center - a, nor) / d;
+                    maxT = (std::max)(maxT, t);
+                }
+            }
+        }
+
+        // 法线锥超过约84度时背面剔除几乎不会成功，直接放弃
+
+        if(minDot <= 0.1f)
+        {
+            return;
+        }
+
+        cluster.coneAxis   = axis;
+        cluster.coneApex   = cluster.center - axis * maxT;
+        cluster.coneCutoff = std::sqrt(1 - minDot * minDot);
+    }
+
+} // namespace anonymous
+
+std::vector<Cluster> buildClusters(const Mesh &mesh, const ClusterLimits &limits)
+{
+    std::vector<Cluster>   clusters;
+    std::vector<FaceRange> faceRanges;
+
+    // 按面的顺序贪心切分，vertexMark[v]记录顶点v最后属于哪个簇
+
+    constexpr uint32_t NO_CLUSTER = UINT32_MAX;
+    std::vector<uint32_t> vertexMark(mesh.vertices.size(), NO_CLUSTER);
+
+    Cluster current;
+    FaceRange currentRange = { 0, 0 };
+    uint32_t indexOffset = 0;
+
+    auto closeCurrent = [&]
+    {
+        if(current.indexCount)
+        {
+            clusters.push_back(current);
+            faceRanges.push_back(currentRange);
+        }
+
+        current = Cluster();
+        current.indexOffset = indexOffset;
+        currentRange = { currentRange.faceEnd, currentRange.faceEnd };
+    };
+
+    for(size_t fi = 0; fi < mesh.faces.size(); ++fi)
+    {
+        auto &f = mesh.faces[fi];
+        int vertexCount = f.isQuad ? 4 : 3;
+        auto clusterIndex = static_cast<uint32_t>(clusters.size());
+
+        int newVertexCount = 0;
+        for(int i = 0; i < vertexCount; ++i)
+        {
+            if(vertexMark[f.indices[i]] != clusterIndex)
+            {
+                ++newVertexCount;
+            }
+        }
+
+        int triangleCount = static_cast<int>(current.indexCount / 3) + triangleCountOf(f);
+        if(current.indexCount &&
+           (current.vertexCount + newVertexCount > static_cast<uint32_t>(limits.maxVertices) ||
+            triangleCount > limits.maxTriangles))
+        {
+            closeCurrent();
+            clusterIndex = static_cast<uint32_t>(clusters.size());
+        }
+
+        for(int i = 0; i < vertexCount; ++i)
+        {
+            if(vertexMark[f.indices[i]] != clusterIndex)
+            {
+                vertexMark[f.indices[i]] = clusterIndex;
+                ++current.vertexCount;
+            }
+        }
+
+        auto faceIndexCount = static_cast<uint32_t>(3 * triangleCountOf(f));
+        current.indexCount += faceIndexCount;
+        indexOffset        += faceIndexCount;
+        currentRange.faceEnd = fi + 1;
+    }
+
+    closeCurrent();
+
+    // 各簇的包围体互不相关，并行计算
+
+    parallelFor(clusters.size(), [&](size_t i)
+    {
+        computeClusterBounds(mesh, faceRanges[i], clusters[i]);
+    });
+
+    return clusters;
+}
+
+void updateClusterBounds(const Mesh &mesh, std::vector<Cluster> &clusters)
+{
+    // 簇按面的顺序排列，由各簇的索引区间恢复其对应的面区间
+
+    std::vector<FaceRange> faceRanges(clusters.size());
+
+    size_t faceIndex = 0;
+    uint32_t indexOffset = 0;
+
+    for(size_t i = 0; i < clusters.size(); ++i)
+    {
+        const uint32_t indexEnd = clusters[i].indexOffset + clusters[i].indexCount;
+
+        faceRanges[i].faceBegin = faceIndex;
+        while(faceIndex < mesh.faces.size() && indexOffset < indexEnd)
+        {
+            indexOffset += static_cast<uint32_t>(3 * triangleCountOf(mesh.faces[faceIndex]));
+            ++faceIndex;
+        }
+        faceRanges[i].faceEnd = faceIndex;
+    }
+
+    parallelFor(clusters.size(), [&](size_t i)
+    {
+        computeClusterBounds(mesh, faceRanges[i], clusters[i]);
+    });
+}
+
+void cullClusters(
+    const std::vector<Cluster> &clusters,
+    const Mat4                 &world,
+    const Mat4                 &viewProj,
+    const Vec3                 &cameraPosition,
+    std::vector<uint32_t>      &visibleClusters)
+{
+    visibleClusters.clear();
+
+    // 从world * viewProj中提取模型空间中的六个裁剪平面（法线朝内）
+
+    Mat4 wvp = world * viewProj;
+
+    auto column = [&](int c)
+    {
+        return Vec4(wvp(0, c), wvp(1, c), wvp(2, c), wvp(3, c));
+    };
+
+    Vec4 c0 = column(0), c1 = column(1), c2 = column(2), c3 = column(3);
+    Vec4 planes[6] = { c3 + c0, c3 - c0, c3 + c1, c3 - c1, c2, c3 - c2 };
+
+    for(auto &p : planes)
+    {
+        float len = Vec3(p.x, p.y, p.z).length();
+        if(len > 0)
+        {
+            p = p * (1 / len);
+        }
+    }
+
+    // 摄像机位置变换到模型空间：world为统一缩放，用缩放后的转置近似逆矩阵
+
+    Vec3 worldOrigin = transformPoint(Vec3(0, 0, 0), world);
+    Vec3 axisX = transformDirection(Vec3(1, 0, 0), world);
+    Vec3 axisY = transformDirection(Vec3(0, 1, 0), world);
+    Vec3 axisZ = transformDirection(Vec3(0, 0, 1), world);
+
+    float scaleSquare = axisX.length_square();
+    Vec3 relativeCamera = cameraPosition - worldOrigin;
+    Vec3 localCamera = scaleSquare > 0 ?
+        Vec3(dot(relativeCamera, axisX), dot(relativeCamera, axisY), dot(relativeCamera, axisZ)) / scaleSquare :
+        Vec3(0, 0, 0);
+
+    for(size_t i = 0; i < clusters.size(); ++i)
+    {
+        auto &cluster = clusters[i];
+
+        bool outside = false;
+        for(auto &p : planes)
+        {
+            if(p.x * cluster.center.x + p.y * cluster.center.y + p.z * cluster.center.z + p.w < -cluster.radius)
+            {
+                outside = true;
+                break;
+            }
+        }
+
+        if(outside)
+        {
+            continue;
+        }
+
+        if(cluster.coneCutoff < 1)
+        {
+            Vec3 toApex = cluster.coneApex - localCamera;
+            float distance = toApex.length();
+            if(distance > 0 && dot(toApex, cluster.coneAxis) >= cluster.coneCutoff * distance)
+            {
+                continue;
+            }
+        }
+
+        visibleClusters.push_back(static_cast<uint32_t>(i));
+    }
+}
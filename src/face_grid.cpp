@@ -0,0 +1,178 @@
+#include <cmath>
+
+#include <catmull_clark/face_grid.h>
+#include <catmull_clark/parallel.h>
+
+namespace
+{
+
+    // 中心面第k个顶点的参数坐标
+    const int QUAD_CORNERS[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+
+    /**
+     * @brief 一个等待常量矩阵处理的正则子面
+     */
+    struct GridJob
+    {
+        Vec3 points[16];
+        RegularGridTarget target;
+        int level;
+    };
+
+    /**
+     * @brief 计算patch的中心面细分remaining次后的顶点在网格中的写入位置
+     *
+     * patch.frame把中心面的参数映射到网格的参数空间，各层的变换都是二进的，换算到网格下标后恰为整数
+     */
+    RegularGridTarget computeTarget(const LocalPatch &patch, int remaining, Vec3 *grid, int gridLevel)
+    {
+        const int span = 1 << gridLevel;
+        const ptrdiff_t rowStride = span + 1;
+
+        auto toOffset = [&](const Vec2 &p, float scale)
+        {
+            return std::lround(p.y * scale) * rowStride + std::lround(p.x * scale);
+        };
+
+        const float stepScale = static_cast<float>(span >> remaining);
+        return {
+            grid + toOffset(patch.frame.origin, static_cast<float>(span)),
+            toOffset(patch.frame.axisS, stepScale),
+            toOffset(patch.frame.axisT, stepScale)
+        };
+    }
+
+    void subdivideGrid(
+        const LocalPatch &patch, int remaining, Vec3 *grid, int gridLevel, std::vector<GridJob> &jobs)
+    {
+        auto &center = patch.mesh.faces[0];
+        const RegularGridTarget target = computeTarget(patch, remaining, grid, gridLevel);
+
+        if(!remaining)
+        {
+            for(int k = 0; k < 4; ++k)
+            {
+                target.origin[QUAD_CORNERS[k][0] * target.stepS + QUAD_CORNERS[k][1] * target.stepT] =
+                    patch.mesh.vertices[center.indices[k]].position;
+            }
+            return;
+        }
+
+        GridJob job;
+        if(gatherRegularPatchPoints(patch, job.points))
+        {
+            job.target = target;
+            job.level  = remaining;
+            jobs.push_back(job);
+            return;
+        }
+
+        LocalPatch children[4];
+        const int childCount = refinePatch(patch, children);
+        for(int k = 0; k < childCount; ++k)
+        {
+            subdivideGrid(children[k], remaining - 1, grid, gridLevel, jobs);
+        }
+    }
+
+} // namespace anonymous
+
+FaceGridMesh subdivideToFaceGrids(const Mesh &baseMesh, int level)
+{
+    level = agz::math::clamp(level, 1, MAX_REGULAR_GRID_LEVEL);
+
+    const PatchTopology topology(baseMesh);
+    const size_t faceCount = topology.getFaceCount();
+
+    // 先确定各网格的位置：四边形一个网格，三角形三个较小的网格
+
+    FaceGridMesh result;
+    std::vector<uint32_t> firstGrids(faceCount);
+
+    const int quadGridSize     = getRegularGridSize(level);
+    const int triangleGridSize = getRegularGridSize(level - 1);
+
+    uint32_t pointCount = 0;
+    for(size_t f = 0; f < faceCount; ++f)
+    {
+        firstGrids[f] = static_cast<uint32_t>(result.grids.size());
+
+        if(baseMesh.faces[f].isQuad)
+        {
+            result.grids.push_back({ static_cast<uint32_t>(f), 0, level, pointCount });
+            pointCount += quadGridSize * quadGridSize;
+        }
+        else
+        {
+            for(int k = 0; k < 3; ++k)
+            {
+                result.grids.push_back({ static_cast<uint32_t>(f), k, level - 1, pointCount });
+                pointCount += triangleGridSize * triangleGridSize;
+            }
+        }
+    }
+
+    result.points.resize(pointCount);
+
+    // 各面并行地局部细分，正则的（子）面只记录下来
+
+    std::vector<std::vector<GridJob>> faceJobs(faceCount);
+    std::vector<uint8_t> isRegularFace(faceCount);
+
+    parallelForRange(faceCount, 16, [&](size_t begin, size_t end)
+    {
+        for(size_t f = begin; f < end; ++f)
+        {
+            const LocalPatch patch = topology.extractPatch(static_cast<uint32_t>(f));
+            auto &grid = result.grids[firstGrids[f]];
+            auto &jobs = faceJobs[f];
+
+            if(patch.subFace >= 0)
+            {
+                subdivideGrid(patch, level, &result.points[grid.firstPoint], level, jobs);
+                isRegularFace[f] = jobs.size() == 1 && jobs[0].level == level;
+                continue;
+            }
+
+            LocalPatch children[4];
+            const int childCount = refinePatch(patch, children);
+            for(int k = 0; k < childCount; ++k)
+            {
+                auto &subGrid = result.grids[firstGrids[f] + k];
+                subdivideGrid(children[k], level - 1, &result.points[subGrid.firstPoint], level - 1, jobs);
+            }
+        }
+    });
+
+    for(uint8_t isRegular : isRegularFace)
+    {
+        result.regularFaceCount += isRegular;
+    }
+
+    // 按层级分组，交给常量矩阵批量处理
+
+    std::vector<Vec3> controlPoints;
+    std::vector<RegularGridTarget> targets;
+
+    for(int jobLevel = 1; jobLevel <= level; ++jobLevel)
+    {
+        controlPoints.clear();
+        targets.clear();
+
+        for(auto &jobs : faceJobs)
+        {
+            for(auto &job : jobs)
+            {
+                if(job.level == jobLevel)
+                {
+                    controlPoints.insert(controlPoints.end(), job.points, job.points + 16);
+                    targets.push_back(job.target);
+                }
+            }
+        }
+
+        refineRegularPatches(controlPoints.data(), targets.size(), jobLevel, targets.data());
+    }
+
+    return result;
+}
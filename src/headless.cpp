@@ -0,0 +1,138 @@
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <agz/utility/time.h>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/mesh_io.h>
+#include <catmull_clark/mesh_optimizer.h>
+#include <catmull_clark/software_renderer.h>
+
+namespace
+{
+
+    void printUsage(const char *program)
+    {
+        std::cout << "usage: " << program
+                  << " input.obj subdivision_count output.ppm [width height] [--wireframe] [--cache-stats]" << std::endl;
+    }
+
+    /**
+     * @brief 输出优化前后三角形索引的顶点缓存模拟结果
+     */
+    void printCacheStatistics(const Mesh &mesh, const std::vector<Edge> &edges)
+    {
+        RenderMesh renderMesh = buildRenderMesh(mesh, edges);
+        const VertexCacheStatistics before = analyzeVertexCache(renderMesh);
+
+        agz::time::clock_t clock;
+        optimizeRenderMesh(renderMesh);
+        const float optimizeTime = clock.us() / 1000.0f;
+
+        const VertexCacheStatistics after = analyzeVertexCache(renderMesh);
+
+        std::cout << "vertex cache (FIFO 16), unoptimized: ACMR " << before.acmr << ", ATVR " << before.atvr << std::endl;
+        std::cout << "vertex cache (FIFO 16), optimized:   ACMR " << after.acmr  << ", ATVR " << after.atvr
+                  << " (" << optimizeTime << "ms)" << std::endl;
+    }
+
+    void run(int argc, char *argv[])
+    {
+        bool wireframe = false;
+        bool cacheStats = false;
+        std::vector<const char*> args;
+        for(int i = 1; i < argc; ++i)
+        {
+            if(std::strcmp(argv[i], "--wireframe") == 0)
+            {
+                wireframe = true;
+            }
+            else if(std::strcmp(argv[i], "--cache-stats") == 0)
+            {
+                cacheStats = true;
+            }
+            else
+            {
+                args.push_back(argv[i]);
+            }
+        }
+
+        if(args.size() != 3 && args.size() != 5)
+        {
+            printUsage(argv[0]);
+            return;
+        }
+
+        const int subdivisionCount = std::stoi(args[1]);
+        const int width  = args.size() == 5 ? std::stoi(args[3]) : 1920;
+        const int height = args.size() == 5 ? std::stoi(args[4]) : 1080;
+
+        // 细分
+
+        agz::time::clock_t clock;
+
+        Mesh originalMesh = loadMesh(args[0]);
+        std::vector<Edge> subdividedEdges;
+        Mesh subdividedMesh = applyCatmullClarkSubdivision(originalMesh, subdivisionCount, subdividedEdges);
+
+        std::cout << "subdivision time: " << clock.us() / 1000.0f << "ms" << std::endl;
+
+        // 与Main中初始状态相同的摄像机与光照
+
+        const float cameraVertRad = 0.5f;
+        const float cameraHoriRad = 0.2f;
+        const float cameraDistance = 5;
+
+        Vec3 cameraPos = cameraDistance * Vec3(
+            std::cos(cameraVertRad) * std::cos(cameraHoriRad),
+            std::sin(cameraVertRad),
+            std::cos(cameraVertRad) * std::sin(cameraHoriRad));
+        Vec3 lightDir = -Vec3(
+            std::cos(cameraVertRad + 0.3f) * std::cos(cameraHoriRad - 0.2f),
+            std::sin(cameraVertRad + 0.3f),
+            std::cos(cameraVertRad + 0.3f) * std::sin(cameraHoriRad - 0.2f)).normalize();
+
+        Mat4 view = Trans4::look_at(cameraPos, { 0, 0, 0 }, { 0, 1, 0 });
+        Mat4 proj = Trans4::perspective(
+            agz::math::deg2rad(30.0f), static_cast<float>(width) / height, 0.1f, 100.0f);
+
+        RenderMeshOptions renderMeshOptions;
+        renderMeshOptions.normalWeighting = NormalWeighting::Limit;
+
+        SoftwareRenderer renderer(width, height);
+        renderer.setWorldTransform(localToUnitCube(originalMesh));
+        renderer.setLightDir(lightDir);
+        renderer.setCameraViewProj(view * proj);
+        renderer.setWireframe(wireframe);
+
+        clock.restart();
+        renderer.setMesh(subdividedMesh, subdividedEdges, renderMeshOptions);
+        std::cout << "render mesh time: " << clock.us() / 1000.0f << "ms" << std::endl;
+
+        if(cacheStats)
+        {
+            printCacheStatistics(subdividedMesh, subdividedEdges);
+        }
+
+        clock.restart();
+        renderer.render();
+        std::cout << "render time: " << clock.us() / 1000.0f << "ms" << std::endl;
+
+        renderer.saveToPPM(args[2]);
+    }
+
+} // namespace anonymous
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        run(argc, argv);
+    }
+    catch(const std::exception &err)
+    {
+        std::cout << err.what() << std::endl;
+        return -1;
+    }
+}
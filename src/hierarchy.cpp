@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <catmull_clark/hierarchy.h>
+
+namespace
+{
+
+    const Vec2 QUAD_CORNERS[4] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+
+    /**
+     * @brief 第level层的面数，面下标为32位，超出UINT32_MAX的层级无效，此时返回false
+     */
+    bool computeFaceCount(int level, size_t baseFaceCount, size_t level1FaceCount, uint64_t &faceCount)
+    {
+        if(level < 0)
+        {
+            return false;
+        }
+
+        if(level == 0)
+        {
+            faceCount = baseFaceCount;
+            return true;
+        }
+
+        const int shift = 2 * (level - 1);
+        if(shift >= 32)
+        {
+            return false;
+        }
+
+        faceCount = uint64_t(level1FaceCount) << shift;
+        return faceCount <= UINT32_MAX;
+    }
+
+} // namespace anonymous
+
+UVFrame getQuadChildFrame(int k)
+{
+    const Vec2 &prev   = QUAD_CORNERS[(k + 3) % 4];
+    const Vec2 &corner = QUAD_CORNERS[k];
+
+    Vec2 origin = 0.5f * (prev + corner);
+    return { origin, corner - origin, Vec2(0.5f, 0.5f) - origin };
+}
+
+UVFrame getTriangleSubFaceFrame()
+{
+    return { { 0, 1 }, { 0, -1 }, { 1, 0 } };
+}
+
+SubdivisionHierarchy::SubdivisionHierarchy(const Mesh &baseMesh)
+{
+    isBaseQuad_.resize(baseMesh.faces.size());
+    baseToLevel1_.resize(baseMesh.faces.size() + 1);
+
+    uint32_t level1FaceCount = 0;
+    for(size_t i = 0; i < baseMesh.faces.size(); ++i)
+    {
+        isBaseQuad_[i]   = baseMesh.faces[i].isQuad;
+        baseToLevel1_[i] = level1FaceCount;
+        level1FaceCount += baseMesh.faces[i].isQuad ? 4 : 3;
+    }
+    baseToLevel1_.back() = level1FaceCount;
+
+    level1ToBase_.resize(level1FaceCount);
+    for(size_t i = 0; i < baseMesh.faces.size(); ++i)
+    {
+        for(uint32_t j = baseToLevel1_[i]; j < baseToLevel1_[i + 1]; ++j)
+        {
+            level1ToBase_[j] = static_cast<uint32_t>(i);
+        }
+    }
+}
+
+size_t SubdivisionHierarchy::getBaseFaceCount() const noexcept
+{
+    return isBaseQuad_.size();
+}
+
+size_t SubdivisionHierarchy::getFaceCount(int level) const
+{
+    uint64_t faceCount;
+    if(!computeFaceCount(level, isBaseQuad_.size(), level1ToBase_.size(), faceCount))
+    {
+        throw std::runtime_error("SubdivisionHierarchy: level out of range");
+    }
+    return static_cast<size_t>(faceCount);
+}
+
+uint32_t SubdivisionHierarchy::getBaseFace(int level, uint32_t face) const
+{
+    checkFace(level, face);
+
+    if(level == 0)
+    {
+        return face;
+    }
+    return level1ToBase_[face >> (2 * (level - 1))];
+}
+
+FaceRange SubdivisionHierarchy::getFaceRange(int level, uint32_t baseFace) const
+{
+    checkFace(0, baseFace);
+    checkLevel(level);
+
+    if(level == 0)
+    {
+        return { baseFace, baseFace + 1 };
+    }
+
+    // 在64位中移位，checkLevel保证结果不超过UINT32_MAX
+    const int shift = 2 * (level - 1);
+    return {
+        static_cast<uint32_t>(uint64_t(baseToLevel1_[baseFace])     << shift),
+        static_cast<uint32_t>(uint64_t(baseToLevel1_[baseFace + 1]) << shift)
+    };
+}
+
+uint32_t SubdivisionHierarchy::getParent(int level, uint32_t face) const
+{
+    if(level == 0)
+    {
+        throw std::runtime_error("SubdivisionHierarchy: base faces have no parent");
+    }
+    checkFace(level, face);
+
+    if(level == 1)
+    {
+        return level1ToBase_[face];
+    }
+    return face >> 2;
+}
+
+FaceRange SubdivisionHierarchy::getChildren(int level, uint32_t face) const
+{
+    checkFace(level, face);
+    checkLevel(level + 1);
+
+    if(level == 0)
+    {
+        return getFaceRange(1, face);
+    }
+    return { 4 * face, 4 * face + 4 };
+}
+
+void SubdivisionHierarchy::checkLevel(int level) const
+{
+    uint64_t faceCount;
+    if(!computeFaceCount(level, isBaseQuad_.size(), level1ToBase_.size(), faceCount))
+    {
+        throw std::runtime_error("SubdivisionHierarchy: level out of range");
+    }
+}
+
+void SubdivisionHierarchy::checkFace(int level, uint32_t face) const
+{
+    uint64_t faceCount;
+    if(!computeFaceCount(level, isBaseQuad_.size(), level1ToBase_.size(), faceCount))
+    {
+        throw std::runtime_error("SubdivisionHierarchy: level out of range");
+    }
+
+    if(face >= faceCount)
+    {
+        throw std::runtime_error("SubdivisionHierarchy: face index out of range");
+    }
+}
+
+FaceRegion SubdivisionHierarchy::locateFace(int level, uint32_t face) const
+{
+    FaceRegion result;
+    result.baseFace = getBaseFace(level, face);
+
+    if(level == 0)
+    {
+        result.subFace = isBaseQuad_[face] ? 0 : -1;
+        result.low     = Vec2(0, 0);
+        result.high    = Vec2(1, 1);
+        return result;
+    }
+
+    // 从第1层向下逐层复合子面的坐标系
+
+    const uint32_t level1Face = face >> (2 * (level - 1));
+    const int k = static_cast<int>(level1Face - baseToLevel1_[result.baseFace]);
+
+    UVFrame frame;
+    if(isBaseQuad_[result.baseFace])
+    {
+        result.subFace = 0;
+        frame = getQuadChildFrame(k);
+    }
+    else
+    {
+        result.subFace = k;
+        frame = getTriangleSubFaceFrame();
+    }
+
+    for(int l = level - 2; l >= 0; --l)
+    {
+        frame = frame.compose(getQuadChildFrame((face >> (2 * l)) & 3));
+    }
+
+    // 各层的坐标轴都与u、v轴平行，对角的两个角点确定了覆盖的正方形
+
+    const Vec2 a = frame.origin;
+    const Vec2 b = frame.origin + frame.axisS + frame.axisT;
+
+    result.frame = frame;
+    result.low   = Vec2((std::min)(a.x, b.x), (std::min)(a.y, b.y));
+    result.high  = Vec2((std::max)(a.x, b.x), (std::max)(a.y, b.y));
+    return result;
+}
+
+SurfaceLocation SubdivisionHierarchy::locate(int level, uint32_t face, const Vec2 &faceUV) const
+{
+    const FaceRegion region = locateFace(level, face);
+    return { region.baseFace, region.subFace, region.frame.apply(faceUV) };
+}
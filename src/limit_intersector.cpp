@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <cmath>
+
+#include <catmull_clark/limit_intersector.h>
+
+namespace
+{
+
+    // 曲面片在缓存中的键：高32位为原始面下标，低32位为以1开头、每层2位的子面路径
+
+    constexpr int MAX_PATCH_LEVEL = 15;
+
+    uint64_t makeRootKey(uint32_t baseFace)
+    {
+        return (uint64_t(baseFace) << 32) | 1;
+    }
+
+    uint64_t makeChildKey(uint64_t key, int child)
+    {
+        const uint64_t path = key & 0xffffffff;
+        return (key & ~uint64_t(0xffffffff)) | (path << 2) | uint64_t(child);
+    }
+
+    // 不同层级的曲面片在边上的采样点不同，相邻的叶节点之间可能有很窄的缝隙，
+    // 与中心面求交时将其在参数空间中略微放大以覆盖缝隙。
+    // 重心坐标的各分量不小于-LEAF_EXPANSION时，交点到叶节点包围盒的距离不超过2 * LEAF_EXPANSION倍对角线，
+    // 因此交点到极限曲面的距离不超过(1 + 2 * LEAF_EXPANSION) * tolerance
+
+    constexpr float LEAF_EXPANSION = 1e-2f;
+
+    bool intersectAABB(
+        const Vec3 &low, const Vec3 &high, const Vec3 &origin, const Vec3 &invDir,
+        float tMin, float tMax, float &entry)
+    {
+        for(int axis = 0; axis < 3; ++axis)
+        {
+            float t0 = (low[axis]  - origin[axis]) * invDir[axis];
+            float t1 = (high[axis] - origin[axis]) * invDir[axis];
+            if(t0 > t1)
+            {
+                std::swap(t0, t1);
+            }
+
+            tMin = (std::max)(tMin, t0);
+            tMax = (std::min)(tMax, t1);
+            if(tMin > tMax)
+            {
+                return false;
+            }
+        }
+
+        entry = tMin;
+        return true;
+    }
+
+} // namespace anonymous
+
+struct LimitSurfaceIntersector::Traversal
+{
+    const Ray &ray;
+    Vec3 invDir;
+    float tMax;
+    bool found;
+    SurfaceHit &hit;
+};
+
+LimitSurfaceIntersector::LimitSurfaceIntersector(const Mesh &baseMesh, const LimitIntersectorOptions &options)
+    : options_(options), topology_(baseMesh), cacheHitCount_(0), cacheMissCount_(0)
+{
+    options_.maxLevel      = agz::math::clamp(options_.maxLevel, 0, MAX_PATCH_LEVEL);
+    options_.cacheCapacity = (std::max<size_t>)(options_.cacheCapacity, 1);
+
+    std::vector<BoundingBox> boxes(topology_.getFaceCount());
+    for(size_t i = 0; i < boxes.size(); ++i)
+    {
+        topology_.computePatchBounds(static_cast<uint32_t>(i), boxes[i].low, boxes[i].high);
+    }
+
+    patchBVH_ = std::make_unique<BoxBVH>(boxes);
+}
+
+bool LimitSurfaceIntersector::intersect(const Ray &ray, SurfaceHit &hit)
+{
+    std::vector<BoxHit> candidates;
+    patchBVH_->intersect(ray, candidates);
+
+    Traversal traversal = {
+        ray, Vec3(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z), ray.tMax, false, hit
+    };
+
+    for(auto &candidate : candidates)
+    {
+        if(candidate.t > traversal.tMax)
+        {
+            break;
+        }
+
+        Vec3 low, high;
+        topology_.computePatchBounds(candidate.index, low, high);
+
+        if(isLeaf(low, high, 0))
+        {
+            intersectCenterFace(topology_.extractPatch(candidate.index), traversal);
+            continue;
+        }
+
+        const uint64_t key = makeRootKey(candidate.index);
+        auto refinement = getRefinement(key, nullptr);
+        intersectChildren(*refinement, key, traversal);
+    }
+
+    return traversal.found;
+}
+
+size_t LimitSurfaceIntersector::getCachedRefinementCount() const noexcept
+{
+    return cache_.size();
+}
+
+size_t LimitSurfaceIntersector::getCacheHitCount() const noexcept
+{
+    return cacheHitCount_;
+}
+
+size_t LimitSurfaceIntersector::getCacheMissCount() const noexcept
+{
+    return cacheMissCount_;
+}
+
+LimitSurfaceIntersector::RefinementPtr LimitSurfaceIntersector::getRefinement(
+    uint64_t key, const LocalPatch *patch)
+{
+    auto it = cacheIndex_.find(key);
+    if(it != cacheIndex_.end())
+    {
+        ++cacheHitCount_;
+        cache_.splice(cache_.begin(), cache_, it->second);
+        return it->second->second;
+    }
+
+    ++cacheMissCount_;
+
+    auto refinement = std::make_shared<Refinement>();
+    if(patch)
+    {
+        refinement->childCount = refinePatch(*patch, refinement->children);
+    }
+    else
+    {
+        const LocalPatch basePatch = topology_.extractPatch(static_cast<uint32_t>(key >> 32));
+        refinement->childCount = refinePatch(basePatch, refinement->children);
+    }
+
+    // 被淘汰的细分结果可能仍被递归中的上层持有，由shared_ptr保证其在使用期间有效
+
+    if(cache_.size() >= options_.cacheCapacity)
+    {
+        cacheIndex_.erase(cache_.back().first);
+        cache_.pop_back();
+    }
+
+    cache_.emplace_front(key, refinement);
+    cacheIndex_[key] = cache_.begin();
+
+    return refinement;
+}
+
+void LimitSurfaceIntersector::intersectChildren(
+    const Refinement &refinement, uint64_t key, Traversal &traversal)
+{
+    // 按进入距离从近到远访问子曲面片，较远的子曲面片可能因tMax缩小而被跳过
+
+    std::pair<float, int> order[4];
+    int orderCount = 0;
+
+    for(int k = 0; k < refinement.childCount; ++k)
+    {
+        auto &child = refinement.children[k];
+
+        float entry;
+        if(intersectAABB(
+            child.low, child.high, traversal.ray.origin, traversal.invDir,
+            traversal.ray.tMin, traversal.tMax, entry))
+        {
+            order[orderCount++] = { entry, k };
+        }
+    }
+
+    std::sort(order, order + orderCount);
+
+    for(int i = 0; i < orderCount; ++i)
+    {
+        if(order[i].first > traversal.tMax)
+        {
+            break;
+        }
+
+        const int k = order[i].second;
+        intersectPatch(refinement.children[k], makeChildKey(key, k), traversal);
+    }
+}
+
+void LimitSurfaceIntersector::intersectPatch(const LocalPatch &patch, uint64_t key, Traversal &traversal)
+{
+    if(isLeaf(patch.low, patch.high, patch.level))
+    {
+        intersectCenterFace(patch, traversal);
+        return;
+    }
+
+    auto refinement = getRefinement(key, &patch);
+    intersectChildren(*refinement, key, traversal);
+}
+
+void LimitSurfaceIntersector::intersectCenterFace(const LocalPatch &patch, Traversal &traversal) const
+{
+    auto &f = patch.mesh.faces[0];
+    const int triangleCount = f.isQuad ? 2 : 1;
+
+    const Ray &ray = traversal.ray;
+
+    for(int h = 0; h < triangleCount; ++h)
+    {
+        const Vec3 &a = patch.mesh.vertices[f.indices[0]].position;
+        const Vec3 &b = patch.mesh.vertices[f.indices[h + 1]].position;
+        const Vec3 &c = patch.mesh.vertices[f.indices[h + 2]].position;
+
+        // Möller–Trumbore
+
+        const Vec3 ab = b - a, ac = c - a;
+
+        Vec3 p = cross(ray.direction, ac);
+        float det = dot(ab, p);
+        if(std::abs(det) < 1e-20f)
+        {
+            continue;
+        }
+        float invDet = 1 / det;
+
+        Vec3 s = ray.origin - a;
+        float b1 = dot(s, p) * invDet;
+        if(b1 < -LEAF_EXPANSION || b1 > 1 + LEAF_EXPANSION)
+        {
+            continue;
+        }
+
+        Vec3 q = cross(s, ab);
+        float b2 = dot(ray.direction, q) * invDet;
+        if(b2 < -LEAF_EXPANSION || b1 + b2 > 1 + LEAF_EXPANSION)
+        {
+            continue;
+        }
+
+        float t = dot(ac, q) * invDet;
+        if(t < ray.tMin || t > traversal.tMax)
+        {
+            continue;
+        }
+
+        // 三角形的重心坐标转换为中心面上的参数，约定与MeshBVH相同
+
+        Vec2 faceUV;
+        if(!f.isQuad)
+        {
+            faceUV = Vec2(b1, b2);
+        }
+        else if(h == 0)
+        {
+            faceUV = Vec2(b1 + b2, b2);
+        }
+        else
+        {
+            faceUV = Vec2(b1, b1 + b2);
+        }
+
+        faceUV.x = agz::math::clamp(faceUV.x, 0.0f, 1.0f);
+        faceUV.y = agz::math::clamp(faceUV.y, 0.0f, 1.0f);
+
+        traversal.tMax  = t;
+        traversal.found = true;
+
+        auto &hit = traversal.hit;
+        hit.location.baseFace = patch.baseFace;
+        hit.location.subFace  = patch.subFace;
+        hit.location.uv       = patch.frame.apply(faceUV);
+
+        hit.meshHit.t        = t;
+        hit.meshHit.face     = patch.baseFace;
+        hit.meshHit.faceUV   = hit.location.uv;
+        hit.meshHit.position = ray.origin + t * ray.direction;
+    }
+}
+
+bool LimitSurfaceIntersector::isLeaf(const Vec3 &low, const Vec3 &high, int level) const
+{
+    return level >= options_.maxLevel || (high - low).length() <= options_.tolerance;
+}
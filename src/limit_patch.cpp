@@ -0,0 +1,923 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <catmull_clark/limit_patch.h>
+#include <catmull_clark/parallel.h>
+
+namespace
+{
+
+    // 中心面的第k个顶点在4x4控制点网格中的位置(行, 列)
+    const int CORNER_GRID[4][2] = { { 1, 1 }, { 1, 2 }, { 2, 2 }, { 2, 1 } };
+
+    // Gregory曲面片所允许的最大顶点度数，更大的顶点处使用Bilinear曲面片
+    constexpr int MAX_GREGORY_VALENCE = 32;
+
+    // Gregory曲面片第k个角点及其两个边控制点在4x4 Bézier控制点网格中的位置(行, 列)
+    const int GREGORY_CORNER_GRID[4][2] = { { 0, 0 }, { 0, 3 }, { 3, 3 }, { 3, 0 } };
+    const int GREGORY_NEXT_GRID  [4][2] = { { 0, 1 }, { 1, 3 }, { 3, 2 }, { 2, 0 } };
+    const int GREGORY_PREV_GRID  [4][2] = { { 1, 0 }, { 0, 2 }, { 2, 3 }, { 3, 1 } };
+
+    // 第k个角的F+、F-的混合权重，形如c + a * s + b * t，分别为到边(k, k - 1)与边(k, k + 1)的距离
+    const float GREGORY_PLUS_WEIGHT [4][3] = { { 0, 1, 0 }, { 0, 0, 1 }, { 1, -1, 0 }, { 1, 0, -1 } };
+    const float GREGORY_MINUS_WEIGHT[4][3] = { { 0, 0, 1 }, { 1, -1, 0 }, { 1, 0, -1 }, { 0, 1, 0 } };
+
+    int findVertex(const Face &f, Face::Index v)
+    {
+        for(int i = 0; i < (f.isQuad ? 4 : 3); ++i)
+        {
+            if(f.indices[i] == v)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief 中心面的一个顶点周围按顺序排列的面
+     *
+     * 第i个面以该顶点为角，其next顶点为edges[i]，对角顶点为diagonals[i]，prev顶点为edges[i + 1]。
+     * 第0个面为中心面，第1个面与中心面共享边(k, k - 1)，最后一个面与中心面共享边(k, k + 1)
+     */
+    struct VertexRing
+    {
+        int  valence = 0;
+        Vec3 vertex;
+        Vec3 edges    [MAX_GREGORY_VALENCE];
+        Vec3 diagonals[MAX_GREGORY_VALENCE];
+    };
+
+    /**
+     * @brief 取出中心面第k个顶点周围的面，该顶点须为内部顶点且周围都是朝向一致的四边形
+     */
+    bool gatherVertexRing(const Mesh &mesh, int k, VertexRing &ring)
+    {
+        const Face::Index v = mesh.faces[0].indices[k];
+
+        int faceCount = 0;
+        for(auto &f : mesh.faces)
+        {
+            if(findVertex(f, v) >= 0)
+            {
+                if(!f.isQuad)
+                {
+                    return false;
+                }
+                ++faceCount;
+            }
+        }
+
+        ring.vertex  = mesh.vertices[v].position;
+        ring.valence = 0;
+
+        size_t face = 0;
+        int corner = k;
+        for(;;)
+        {
+            if(ring.valence == MAX_GREGORY_VALENCE)
+            {
+                return false;
+            }
+
+            auto &f = mesh.faces[face];
+            ring.edges    [ring.valence] = mesh.vertices[f.indices[(corner + 1) % 4]].position;
+            ring.diagonals[ring.valence] = mesh.vertices[f.indices[(corner + 2) % 4]].position;
+            ++ring.valence;
+
+            // 下一个面以(v, prev)为next边
+
+            const Face::Index prev = f.indices[(corner + 3) % 4];
+
+            size_t next = mesh.faces.size();
+            for(size_t fi = 0; fi < mesh.faces.size(); ++fi)
+            {
+                const int i = fi != face ? findVertex(mesh.faces[fi], v) : -1;
+                if(i >= 0 && mesh.faces[fi].indices[(i + 1) % 4] == prev)
+                {
+                    next   = fi;
+                    corner = i;
+                    break;
+                }
+            }
+
+            if(next == mesh.faces.size())
+            {
+                return false;
+            }
+            if(next == 0)
+            {
+                break;
+            }
+            face = next;
+        }
+
+        return ring.valence == faceCount && ring.valence >= 3;
+    }
+
+    bool lessPosition(const Vec3 &a, const Vec3 &b)
+    {
+        if(a.x != b.x)
+        {
+            return a.x < b.x;
+        }
+        if(a.y != b.y)
+        {
+            return a.y < b.y;
+        }
+        return a.z < b.z;
+    }
+
+    /**
+     * @brief 计算顶点处的极限位置，以及指向edges[0]与edges[1]的两个Bézier边控制点
+     *
+     * 切向量使用与RenderMesh中相同的极限切向掩码，缩放到在4度顶点处与双三次B样条的Bézier控制点一致。
+     * 求和总是从位置最小的边顶点开始，使共享该顶点的各个曲面片得到逐位相同的结果
+     */
+    void computeCornerPoints(const VertexRing &ring, Vec3 &position, Vec3 &next, Vec3 &prev)
+    {
+        const int n = ring.valence;
+
+        int first = 0;
+        for(int i = 1; i < n; ++i)
+        {
+            if(lessPosition(ring.edges[i], ring.edges[first]))
+            {
+                first = i;
+            }
+        }
+
+        const float twoPi = 2 * agz::math::PI_f;
+        const float cos2PiN = std::cos(twoPi / n);
+        const float A = 1 + cos2PiN + std::cos(twoPi / (2 * n)) * std::sqrt(2 * (9 + cos2PiN));
+
+        Vec3 sum, tangentNext, tangentPrev;
+        for(int offset = 0; offset < n; ++offset)
+        {
+            const int i = (first + offset) % n;
+            const Vec3 &e = ring.edges[i];
+            const Vec3 &d = ring.diagonals[i];
+
+            sum += 4 * e + d;
+
+            const float c0 = std::cos(twoPi * i / n);
+            const float c1 = std::cos(twoPi * ((i + 1) % n) / n);
+            tangentNext += A * c0 * e + (c0 + c1) * d;
+
+            const float p0 = std::cos(twoPi * ((i + n - 1) % n) / n);
+            tangentPrev += A * p0 * e + (p0 + c0) * d;
+        }
+
+        const float scale = 1.0f / (n * (n + 5));
+        position = scale * (static_cast<float>(n * n) * ring.vertex + sum);
+        next     = position + scale * tangentNext;
+        prev     = position + scale * tangentPrev;
+    }
+
+    /**
+     * @brief 若局部控制网格的中心面可以用Gregory曲面片近似，按LimitPatch的约定计算其20个控制点
+     *
+     * 边控制点由极限切向掩码给出，面控制点满足相邻Gregory曲面片间的G1条件，
+     * 剩下的自由度取自两侧的面按双三次近似（ACC）得到的内部控制点之差，使之在正则处退化为B样条曲面片
+     */
+    bool gatherGregoryPoints(const LocalPatch &patch, Vec3 points[20])
+    {
+        auto &mesh = patch.mesh;
+        if(!mesh.faces[0].isQuad)
+        {
+            return false;
+        }
+
+        VertexRing rings[4];
+        for(int k = 0; k < 4; ++k)
+        {
+            if(!gatherVertexRing(mesh, k, rings[k]))
+            {
+                return false;
+            }
+        }
+
+        Vec3 P[4], Ep[4], Em[4];
+        float c[4];
+        Vec3 innerCenter[4], innerNext[4], innerPrev[4];
+
+        for(int k = 0; k < 4; ++k)
+        {
+            auto &ring = rings[k];
+            const int n = ring.valence;
+
+            computeCornerPoints(ring, P[k], Ep[k], Em[k]);
+            c[k] = std::cos(2 * agz::math::PI_f / n);
+
+            // ACC的内部控制点：(n * v + 2 * (next + prev) + diagonal) / (n + 5)
+
+            auto inner = [&](int i)
+            {
+                return (static_cast<float>(n) * ring.vertex
+                      + 2 * (ring.edges[i] + ring.edges[(i + 1) % n])
+                      + ring.diagonals[i]) / static_cast<float>(n + 5);
+            };
+            innerCenter[k] = inner(0);
+            innerNext[k]   = inner(n - 1);
+            innerPrev[k]   = inner(1);
+        }
+
+        for(int k = 0; k < 4; ++k)
+        {
+            const int kn = (k + 1) % 4, kp = (k + 3) % 4;
+
+            const Vec3 Fp = (c[kn] * P[k] + (3 - 2 * c[k] - c[kn]) * Ep[k] + 2 * c[k] * Em[kn]) / 3
+                          + 0.5f * (innerCenter[k] - innerNext[k]);
+            const Vec3 Fm = (c[kp] * P[k] + (3 - 2 * c[k] - c[kp]) * Em[k] + 2 * c[k] * Ep[kp]) / 3
+                          + 0.5f * (innerCenter[k] - innerPrev[k]);
+
+            points[5 * k + 0] = P[k];
+            points[5 * k + 1] = Ep[k];
+            points[5 * k + 2] = Em[k];
+            points[5 * k + 3] = Fp;
+            points[5 * k + 4] = Fm;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief 三次Bernstein基函数及其一阶、二阶导数
+     */
+    void evaluateBernsteinBasis(float t, float b[4], float d[4], float dd[4])
+    {
+        const float s = 1 - t;
+
+        b[0] = s * s * s;
+        b[1] = 3 * t * s * s;
+        b[2] = 3 * t * t * s;
+        b[3] = t * t * t;
+
+        d[0] = -3 * s * s;
+        d[1] = 3 * s * s - 6 * t * s;
+        d[2] = 6 * t * s - 3 * t * t;
+        d[3] = 3 * t * t;
+
+        dd[0] = 6 * s;
+        dd[1] = 18 * t - 12;
+        dd[2] = 6 - 18 * t;
+        dd[3] = 6 * t;
+    }
+
+    /**
+     * @brief 在Gregory曲面片的参数st处求位置与各阶偏导数
+     */
+    void evaluateGregory(const Vec3 points[20], const Vec2 &st, PatchDerivatives &result, bool secondOrder)
+    {
+        // 先在st处混合出16个Bézier控制点，并记下4个内部控制点对s、t的偏导数
+
+        Vec3 bezier[4][4];
+        Vec3 innerDs[4], innerDt[4];
+
+        for(int k = 0; k < 4; ++k)
+        {
+            const Vec3 *corner = &points[5 * k];
+
+            bezier[GREGORY_CORNER_GRID[k][0]][GREGORY_CORNER_GRID[k][1]] = corner[0];
+            bezier[GREGORY_NEXT_GRID  [k][0]][GREGORY_NEXT_GRID  [k][1]] = corner[1];
+            bezier[GREGORY_PREV_GRID  [k][0]][GREGORY_PREV_GRID  [k][1]] = corner[2];
+
+            const float *wp = GREGORY_PLUS_WEIGHT[k];
+            const float *wm = GREGORY_MINUS_WEIGHT[k];
+            const float plus  = wp[0] + wp[1] * st.x + wp[2] * st.y;
+            const float minus = wm[0] + wm[1] * st.x + wm[2] * st.y;
+            const float sum = plus + minus;
+
+            Vec3 &inner = bezier[CORNER_GRID[k][0]][CORNER_GRID[k][1]];
+            if(sum > 0)
+            {
+                const Vec3 diff = corner[3] - corner[4];
+                const float invSum2 = 1 / (sum * sum);
+
+                inner      = (plus * corner[3] + minus * corner[4]) / sum;
+                innerDs[k] = (wp[1] * minus - plus * wm[1]) * invSum2 * diff;
+                innerDt[k] = (wp[2] * minus - plus * wm[2]) * invSum2 * diff;
+            }
+            else
+            {
+                // 恰好位于角点处，内部控制点的权重为0
+                inner      = 0.5f * (corner[3] + corner[4]);
+                innerDs[k] = Vec3();
+                innerDt[k] = Vec3();
+            }
+        }
+
+        float bs[4], ds[4], dds[4];
+        float bt[4], dt[4], ddt[4];
+        evaluateBernsteinBasis(st.x, bs, ds, dds);
+        evaluateBernsteinBasis(st.y, bt, dt, ddt);
+
+        result = PatchDerivatives();
+
+        for(int i = 0; i < 4; ++i)
+        {
+            Vec3 row, rowDs, rowDss;
+            for(int j = 0; j < 4; ++j)
+            {
+                row    += bs[j] * bezier[i][j];
+                rowDs  += ds[j] * bezier[i][j];
+                rowDss += dds[j] * bezier[i][j];
+            }
+
+            result.position += bt[i] * row;
+            result.ds       += bt[i] * rowDs;
+            result.dt       += dt[i] * row;
+
+            if(secondOrder)
+            {
+                result.dss += bt[i]  * rowDss;
+                result.dst += dt[i]  * rowDs;
+                result.dtt += ddt[i] * row;
+            }
+        }
+
+        for(int k = 0; k < 4; ++k)
+        {
+            const float weight = bt[CORNER_GRID[k][0]] * bs[CORNER_GRID[k][1]];
+            result.ds += weight * innerDs[k];
+            result.dt += weight * innerDt[k];
+        }
+    }
+
+    /**
+     * @brief 三次均匀B样条的基函数及其一阶导数
+     */
+    void evaluateBSplineBasis(float t, float b[4], float d[4])
+    {
+        const float t2 = t * t, t3 = t2 * t, s = 1 - t;
+        constexpr float INV6 = 1.0f / 6;
+
+        b[0] = INV6 * s * s * s;
+        b[1] = INV6 * (3 * t3 - 6 * t2 + 4);
+        b[2] = INV6 * (-3 * t3 + 3 * t2 + 3 * t + 1);
+        b[3] = INV6 * t3;
+
+        d[0] = -0.5f * s * s;
+        d[1] = 1.5f * t2 - 2 * t;
+        d[2] = -1.5f * t2 + t + 0.5f;
+        d[3] = 0.5f * t2;
+    }
+
+    /**
+     * @brief 三次均匀B样条基函数的二阶导数
+     */
+    void evaluateBSplineBasisSecondOrder(float t, float dd[4])
+    {
+        dd[0] = 1 - t;
+        dd[1] = 3 * t - 2;
+        dd[2] = -3 * t + 1;
+        dd[3] = t;
+    }
+
+    /**
+     * @brief 将双三次B样条曲面片的控制点转换为等价的Bézier曲面片的控制点
+     *
+     * Bézier曲面片同样位于其控制点的凸包内，且控制点集中在中心面附近，包围盒比B样条控制点的更紧
+     */
+    void convertBSplineToBezier(const Vec3 bspline[16], Vec3 bezier[16])
+    {
+        static const float M[4][4] = {
+            { 1.0f / 6, 4.0f / 6, 1.0f / 6, 0        },
+            { 0,        4.0f / 6, 2.0f / 6, 0        },
+            { 0,        2.0f / 6, 4.0f / 6, 0        },
+            { 0,        1.0f / 6, 4.0f / 6, 1.0f / 6 }
+        };
+
+        Vec3 rows[16];
+        for(int i = 0; i < 4; ++i)
+        {
+            for(int j = 0; j < 4; ++j)
+            {
+                Vec3 sum;
+                for(int k = 0; k < 4; ++k)
+                {
+                    sum += M[j][k] * bspline[4 * i + k];
+                }
+                rows[4 * i + j] = sum;
+            }
+        }
+
+        for(int i = 0; i < 4; ++i)
+        {
+            for(int j = 0; j < 4; ++j)
+            {
+                Vec3 sum;
+                for(int k = 0; k < 4; ++k)
+                {
+                    sum += M[i][k] * rows[4 * k + j];
+                }
+                bezier[4 * i + j] = sum;
+            }
+        }
+    }
+
+    /**
+     * @brief 双三次Bézier曲面片上|ds × dt|的上界，|ds|与|dt|的上界写入maxDs与maxDt
+     *
+     * ds为(2, 3)次、dt为(3, 2)次的Bézier曲面片，两者的叉积为(5, 5)次的Bézier曲面片，
+     * 其控制点由Bernstein基的乘积公式给出；曲面片位于控制点的凸包内，模长不超过控制点模长的最大值
+     */
+    float computeBezierJacobianBound(const Vec3 bezier[16], float &maxDs, float &maxDt)
+    {
+        static const float BINOMIAL[6][6] = {
+            { 1 },
+            { 1, 1 },
+            { 1, 2, 1 },
+            { 1, 3, 3, 1 },
+            { 1, 4, 6, 4, 1 },
+            { 1, 5, 10, 10, 5, 1 }
+        };
+
+        // Ds[a][b]：t方向第a个、s方向第b个控制点；Dt[c][d]同理
+
+        Vec3 Ds[4][3], Dt[3][4];
+        maxDs = maxDt = 0;
+        for(int i = 0; i < 4; ++i)
+        {
+            for(int j = 0; j < 3; ++j)
+            {
+                Ds[i][j] = 3 * (bezier[4 * i + j + 1] - bezier[4 * i + j]);
+                Dt[j][i] = 3 * (bezier[4 * (j + 1) + i] - bezier[4 * j + i]);
+                maxDs = (std::max)(maxDs, Ds[i][j].length());
+                maxDt = (std::max)(maxDt, Dt[j][i].length());
+            }
+        }
+
+        Vec3 product[6][6];
+        for(int a = 0; a < 4; ++a)
+        {
+            for(int b = 0; b < 3; ++b)
+            {
+                for(int c = 0; c < 3; ++c)
+                {
+                    for(int d = 0; d < 4; ++d)
+                    {
+                        const float weight = BINOMIAL[3][a] * BINOMIAL[2][c] * BINOMIAL[2][b] * BINOMIAL[3][d];
+                        product[a + c][b + d] += weight * cross(Ds[a][b], Dt[c][d]);
+                    }
+                }
+            }
+        }
+
+        float result = 0;
+        for(int i = 0; i < 6; ++i)
+        {
+            for(int j = 0; j < 6; ++j)
+            {
+                const float scale = 1 / (BINOMIAL[5][i] * BINOMIAL[5][j]);
+                result = (std::max)(result, scale * product[i][j].length());
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Gregory曲面片上|ds × dt|的上界，取|ds|与|dt|的上界之积，两者写入maxDs与maxDt
+     *
+     * evaluateGregory中的ds由两部分组成：内部控制点取st处混合值的Bézier曲面片的偏导数，
+     * 以及内部控制点本身随s的变化。前者是各相邻控制点之差的3倍的凸组合，内部控制点位于F+与F-之间，
+     * 差的模长在端点处取得最大值；后者中第k个内部控制点的贡献形如9s(1 - s)^2 t(1 - t)^2 t / (s + t)^2 |F+ - F-|，
+     * 系数的最大值约为0.2157。dt同理
+     */
+    float computeGregoryJacobianBound(const Vec3 points[20], float &maxDs, float &maxDt)
+    {
+        constexpr float INNER_DERIVATIVE_BOUND = 0.22f;
+
+        // 每个位置的控制点可能取的值：角点与边控制点是固定的，内部控制点取F+或F-
+
+        Vec3 candidates[4][4][2];
+        for(int k = 0; k < 4; ++k)
+        {
+            const Vec3 *corner = &points[5 * k];
+            for(int e = 0; e < 2; ++e)
+            {
+                candidates[GREGORY_CORNER_GRID[k][0]][GREGORY_CORNER_GRID[k][1]][e] = corner[0];
+                candidates[GREGORY_NEXT_GRID  [k][0]][GREGORY_NEXT_GRID  [k][1]][e] = corner[1];
+                candidates[GREGORY_PREV_GRID  [k][0]][GREGORY_PREV_GRID  [k][1]][e] = corner[2];
+                candidates[CORNER_GRID        [k][0]][CORNER_GRID        [k][1]][e] = corner[3 + e];
+            }
+        }
+
+        maxDs = maxDt = 0;
+        for(int i = 0; i < 4; ++i)
+        {
+            for(int j = 0; j < 3; ++j)
+            {
+                for(int e0 = 0; e0 < 2; ++e0)
+                {
+                    for(int e1 = 0; e1 < 2; ++e1)
+                    {
+                        maxDs = (std::max)(maxDs, 3 * (candidates[i][j + 1][e1] - candidates[i][j][e0]).length());
+                        maxDt = (std::max)(maxDt, 3 * (candidates[j + 1][i][e1] - candidates[j][i][e0]).length());
+                    }
+                }
+            }
+        }
+
+        float inner = 0;
+        for(int k = 0; k < 4; ++k)
+        {
+            inner += INNER_DERIVATIVE_BOUND * (points[5 * k + 3] - points[5 * k + 4]).length();
+        }
+
+        maxDs += inner;
+        maxDt += inner;
+        return maxDs * maxDt;
+    }
+
+    int findQuadChild(const Vec2 &st)
+    {
+        if(st.y < 0.5f)
+        {
+            return st.x < 0.5f ? 0 : 1;
+        }
+        return st.x < 0.5f ? 3 : 2;
+    }
+
+} // namespace anonymous
+
+struct LimitPatchTable::FaceTree
+{
+    std::vector<Node>       nodes;
+    std::vector<LimitPatch> patches;
+    std::vector<Vec3>       points;
+};
+
+LimitPatchTable::LimitPatchTable(const Mesh &baseMesh, const LimitPatchOptions &options)
+    : regularPatchCount_(0)
+{
+    LimitPatchOptions clampedOptions = options;
+    clampedOptions.isolationLevel = agz::math::clamp(options.isolationLevel, 1, 15);
+
+    const PatchTopology topology(baseMesh);
+    const size_t faceCount = topology.getFaceCount();
+
+    // 各原始面独立构建，再按面的顺序拼接
+
+    std::vector<FaceTree> trees(faceCount);
+    parallelForRange(faceCount, 16, [&](size_t begin, size_t end)
+    {
+        for(size_t f = begin; f < end; ++f)
+        {
+            trees[f].nodes.push_back({ 0, 0 });
+            buildFaceTree(topology.extractPatch(static_cast<uint32_t>(f)), clampedOptions, trees[f], 0);
+        }
+    });
+
+    baseRoots_.resize(faceCount);
+
+    for(auto &tree : trees)
+    {
+        const auto nodeOffset  = static_cast<uint32_t>(nodes_.size());
+        const auto patchOffset = static_cast<uint32_t>(patches_.size());
+        const auto pointOffset = static_cast<uint32_t>(points_.size());
+
+        baseRoots_[&tree - trees.data()] = nodeOffset;
+
+        for(auto node : tree.nodes)
+        {
+            node.index += node.childCount ? nodeOffset : patchOffset;
+            nodes_.push_back(node);
+        }
+
+        for(auto patch : tree.patches)
+        {
+            patch.firstPoint += pointOffset;
+            patches_.push_back(patch);
+
+            if(patch.type == LimitPatchType::Regular)
+            {
+                ++regularPatchCount_;
+            }
+        }
+
+        points_.insert(points_.end(), tree.points.begin(), tree.points.end());
+    }
+}
+
+size_t LimitPatchTable::getBaseFaceCount() const noexcept
+{
+    return baseRoots_.size();
+}
+
+size_t LimitPatchTable::getPatchCount() const noexcept
+{
+    return patches_.size();
+}
+
+size_t LimitPatchTable::getRegularPatchCount() const noexcept
+{
+    return regularPatchCount_;
+}
+
+const LimitPatch &LimitPatchTable::getPatch(uint32_t patch) const noexcept
+{
+    return patches_[patch];
+}
+
+const std::vector<LimitPatch> &LimitPatchTable::getPatches() const noexcept
+{
+    return patches_;
+}
+
+const std::vector<Vec3> &LimitPatchTable::getControlPoints() const noexcept
+{
+    return points_;
+}
+
+uint32_t LimitPatchTable::findPatch(const SurfaceLocation &location, Vec2 &st) const
+{
+    const Node *node = &nodes_[baseRoots_[location.baseFace]];
+    st = location.uv;
+
+    // 原始三角形的根节点总有3个子节点，对应SurfaceLocation中的3个子面
+
+    if(node->childCount == 3)
+    {
+        const int k = agz::math::clamp(location.subFace, 0, 2);
+        node = &nodes_[node->index + k];
+        st = getTriangleSubFaceFrame().applyInverse(st);
+    }
+
+    while(node->childCount)
+    {
+        const int k = findQuadChild(st);
+        node = &nodes_[node->index + k];
+        st = getQuadChildFrame(k).applyInverse(st);
+    }
+
+    st.x = agz::math::clamp(st.x, 0.0f, 1.0f);
+    st.y = agz::math::clamp(st.y, 0.0f, 1.0f);
+
+    return node->index;
+}
+
+void LimitPatchTable::evaluate(uint32_t patch, const Vec2 &st, PatchDerivatives &result, bool secondOrder) const
+{
+    auto &p = patches_[patch];
+    const Vec3 *points = &points_[p.firstPoint];
+
+    if(p.type == LimitPatchType::Bilinear)
+    {
+        const float s = st.x, t = st.y;
+
+        result.position = (1 - t) * ((1 - s) * points[0] + s * points[1])
+                        +      t  * ((1 - s) * points[3] + s * points[2]);
+        result.ds  = (1 - t) * (points[1] - points[0]) + t * (points[2] - points[3]);
+        result.dt  = (1 - s) * (points[3] - points[0]) + s * (points[2] - points[1]);
+        result.dss = Vec3();
+        result.dst = points[0] - points[1] + points[2] - points[3];
+        result.dtt = Vec3();
+        return;
+    }
+
+    if(p.type == LimitPatchType::Gregory)
+    {
+        evaluateGregory(points, st, result, secondOrder);
+        return;
+    }
+
+    float bs[4], ds[4];
+    float bt[4], dt[4];
+    evaluateBSplineBasis(st.x, bs, ds);
+    evaluateBSplineBasis(st.y, bt, dt);
+
+    if(!secondOrder)
+    {
+        Vec3 position, du, dv;
+        for(int i = 0; i < 4; ++i)
+        {
+            Vec3 row, rowDs;
+            for(int j = 0; j < 4; ++j)
+            {
+                const Vec3 &point = points[4 * i + j];
+                row   += bs[j] * point;
+                rowDs += ds[j] * point;
+            }
+
+            position += bt[i] * row;
+            du       += bt[i] * rowDs;
+            dv       += dt[i] * row;
+        }
+
+        result.position = position;
+        result.ds       = du;
+        result.dt       = dv;
+        return;
+    }
+
+    float dds[4], ddt[4];
+    evaluateBSplineBasisSecondOrder(st.x, dds);
+    evaluateBSplineBasisSecondOrder(st.y, ddt);
+
+    result = PatchDerivatives();
+
+    for(int i = 0; i < 4; ++i)
+    {
+        Vec3 row, rowDs, rowDss;
+        for(int j = 0; j < 4; ++j)
+        {
+            const Vec3 &point = points[4 * i + j];
+            row    += bs[j]  * point;
+            rowDs  += ds[j]  * point;
+            rowDss += dds[j] * point;
+        }
+
+        result.position += bt[i]  * row;
+        result.ds       += bt[i]  * rowDs;
+        result.dt       += dt[i]  * row;
+        result.dss      += bt[i]  * rowDss;
+        result.dst      += dt[i]  * rowDs;
+        result.dtt      += ddt[i] * row;
+    }
+}
+
+void LimitPatchTable::evaluate(uint32_t patch, const Vec2 &st, Vec3 &position, Vec3 &normal) const
+{
+    PatchDerivatives derivatives;
+    evaluate(patch, st, derivatives, false);
+
+    position = derivatives.position;
+
+    normal = cross(derivatives.ds, derivatives.dt);
+    const float length = normal.length();
+    normal = length > 0 ? normal / length : Vec3(0, 0, 1);
+}
+
+void LimitPatchTable::evaluate(const SurfaceLocation &location, Vec3 &position, Vec3 &normal) const
+{
+    Vec2 st;
+    const uint32_t patch = findPatch(location, st);
+    evaluate(patch, st, position, normal);
+}
+
+void LimitPatchTable::evaluate(
+    const SurfaceLocation *locations, size_t count, Vec3 *positions, Vec3 *normals) const
+{
+    parallelForRange(count, 4096, [&](size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; ++i)
+        {
+            Vec3 position, normal;
+            evaluate(locations[i], position, normal);
+
+            if(positions)
+            {
+                positions[i] = position;
+            }
+            if(normals)
+            {
+                normals[i] = normal;
+            }
+        }
+    });
+}
+
+float LimitPatchTable::getJacobianBound(uint32_t patch) const
+{
+    auto &p = patches_[patch];
+    const int pointCount = p.type == LimitPatchType::Regular ? 16 : (p.type == LimitPatchType::Gregory ? 20 : 4);
+
+    // 平移到第一个控制点处再计算，控制点远离原点时相邻控制点之差不会丢失精度
+
+    Vec3 points[20];
+    float maxCoordinate = 0;
+    for(int i = 0; i < pointCount; ++i)
+    {
+        const Vec3 &point = points_[p.firstPoint + i];
+        points[i] = point - points_[p.firstPoint];
+        maxCoordinate = (std::max)({ maxCoordinate, std::abs(point.x), std::abs(point.y), std::abs(point.z) });
+    }
+
+    float bound, maxDs, maxDt;
+    if(p.type == LimitPatchType::Bilinear)
+    {
+        // ds只与t有关、dt只与s有关，叉积是双线性的，最大值在角点处取得
+
+        const Vec3 ds[2] = { points[1] - points[0], points[2] - points[3] };
+        const Vec3 dt[2] = { points[3] - points[0], points[2] - points[1] };
+
+        bound = 0;
+        for(auto &u : ds)
+        {
+            for(auto &v : dt)
+            {
+                bound = (std::max)(bound, cross(u, v).length());
+            }
+        }
+
+        maxDs = (std::max)(ds[0].length(), ds[1].length());
+        maxDt = (std::max)(dt[0].length(), dt[1].length());
+    }
+    else if(p.type == LimitPatchType::Gregory)
+    {
+        bound = computeGregoryJacobianBound(points, maxDs, maxDt);
+    }
+    else
+    {
+        Vec3 bezier[16];
+        convertBSplineToBezier(points, bezier);
+        bound = computeBezierJacobianBound(bezier, maxDs, maxDt);
+    }
+
+    // evaluate直接由未平移的控制点求值，ds与dt的舍入误差约与控制点坐标的大小成正比。
+    // 系数由各基函数之和的上界给出并留有余量，对所有细分层级的曲面片都足够
+
+    constexpr float EVALUATION_ERROR = 64 * std::numeric_limits<float>::epsilon();
+    return bound + EVALUATION_ERROR * maxCoordinate * (maxDs + maxDt + EVALUATION_ERROR * maxCoordinate);
+}
+
+void LimitPatchTable::buildFaceTree(
+    const LocalPatch &patch, const LimitPatchOptions &options, FaceTree &tree, uint32_t nodeIndex)
+{
+    auto &center = patch.mesh.faces[0];
+
+    Vec3 patchPoints[20];
+    LimitPatchType type = LimitPatchType::Bilinear;
+    int pointCount = 0;
+
+    if(center.isQuad && gatherRegularPatchPoints(patch, patchPoints))
+    {
+        type       = LimitPatchType::Regular;
+        pointCount = 16;
+    }
+    else if(center.isQuad && patch.level >= options.isolationLevel)
+    {
+        if(options.endCap == LimitEndCap::Gregory && gatherGregoryPoints(patch, patchPoints))
+        {
+            type       = LimitPatchType::Gregory;
+            pointCount = 20;
+        }
+        else
+        {
+            for(int i = 0; i < 4; ++i)
+            {
+                patchPoints[i] = patch.mesh.vertices[center.indices[i]].position;
+            }
+            pointCount = 4;
+        }
+    }
+
+    if(pointCount)
+    {
+        LimitPatch newPatch;
+        newPatch.type       = type;
+        newPatch.baseFace   = patch.baseFace;
+        newPatch.subFace    = patch.subFace;
+        newPatch.level      = patch.level;
+        newPatch.frame      = patch.frame;
+        newPatch.firstPoint = static_cast<uint32_t>(tree.points.size());
+
+        tree.points.insert(tree.points.end(), patchPoints, patchPoints + pointCount);
+
+        // 曲面片位于其Bézier控制点（双线性曲面片即为4个控制点）的凸包内；
+        // Gregory曲面片的内部Bézier控制点是F+与F-的凸组合，因此位于20个控制点的凸包内
+
+        Vec3 boundPoints[20];
+        if(type == LimitPatchType::Regular)
+        {
+            convertBSplineToBezier(patchPoints, boundPoints);
+        }
+        else
+        {
+            std::copy(patchPoints, patchPoints + pointCount, boundPoints);
+        }
+
+        newPatch.low  = Vec3((std::numeric_limits<float>::max)());
+        newPatch.high = Vec3((std::numeric_limits<float>::lowest)());
+        for(int i = 0; i < pointCount; ++i)
+        {
+            const Vec3 &p = boundPoints[i];
+
+            newPatch.low.x = (std::min)(newPatch.low.x, p.x);
+            newPatch.low.y = (std::min)(newPatch.low.y, p.y);
+            newPatch.low.z = (std::min)(newPatch.low.z, p.z);
+
+            newPatch.high.x = (std::max)(newPatch.high.x, p.x);
+            newPatch.high.y = (std::max)(newPatch.high.y, p.y);
+            newPatch.high.z = (std::max)(newPatch.high.z, p.z);
+        }
+
+        tree.nodes[nodeIndex] = { static_cast<uint32_t>(tree.patches.size()), 0 };
+        tree.patches.push_back(newPatch);
+        return;
+    }
+
+    LocalPatch children[4];
+    const int childCount = refinePatch(patch, children);
+
+    const auto firstChild = static_cast<uint32_t>(tree.nodes.size());
+    tree.nodes.resize(tree.nodes.size() + childCount);
+    tree.nodes[nodeIndex] = { firstChild, static_cast<uint32_t>(childCount) };
+
+    for(int k = 0; k < childCount; ++k)
+    {
+        buildFaceTree(children[k], options, tree, firstChild + k);
+    }
+}
@@ -0,0 +1,142 @@
+#include <cmath>
+#include <stdexcept>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/lod.h>
+
+namespace
+{
+
+    /**
+     * @brief 选择屏幕空间边长不超过maxEdgePixels的最粗层级，均不满足时返回最细层级
+     */
+    int coarsestLevelWithin(const LodChain &chain, float pixelsPerUnit, float maxEdgePixels)
+    {
+        for(int level = 0; level < chain.getMaxLevel(); ++level)
+        {
+            if(chain.getEstimatedEdgeLength(level) * pixelsPerUnit <= maxEdgePixels)
+            {
+                return level;
+            }
+        }
+        return chain.getMaxLevel();
+    }
+
+} // namespace anonymous
+
+LodChain::LodChain(Mesh baseMesh, int maxLevel)
+    : maxLevel_(maxLevel), baseEdgeLength_(0)
+{
+    if(maxLevel < 0)
+    {
+        throw std::out_of_range("LodChain: negative max level");
+    }
+
+    levels_.resize(maxLevel + 1);
+    levels_[0] = std::make_unique<Level>();
+    levels_[0]->mesh = applyCatmullClarkSubdivision(baseMesh, 0, levels_[0]->edges);
+
+    auto &mesh = levels_[0]->mesh;
+    auto &edges = levels_[0]->edges;
+
+    double edgeLengthSum = 0;
+    for(auto &e : edges)
+    {
+        edgeLengthSum += (mesh.vertices[e.vertices[0]].position - mesh.vertices[e.vertices[1]].position).length();
+    }
+    if(!edges.empty())
+    {
+        baseEdgeLength_ = static_cast<float>(edgeLengthSum / edges.size());
+    }
+}
+
+int LodChain::getMaxLevel() const noexcept
+{
+    return maxLevel_;
+}
+
+const Mesh &LodChain::getMesh(int level)
+{
+    buildLevels(level);
+    return levels_[level]->mesh;
+}
+
+const std::vector<Edge> &LodChain::getEdges(int level)
+{
+    buildLevels(level);
+    return levels_[level]->edges;
+}
+
+bool LodChain::isLevelReady(int level) const noexcept
+{
+    return 0 <= level && level <= maxLevel_ && levels_[level];
+}
+
+float LodChain::getEstimatedEdgeLength(int level) const noexcept
+{
+    return std::ldexp(baseEdgeLength_, -level);
+}
+
+void LodChain::buildLevels(int level)
+{
+    if(level < 0 || level > maxLevel_)
+    {
+        throw std::out_of_range("LodChain: level out of range");
+    }
+
+    for(int i = 1; i <= level; ++i)
+    {
+        if(!levels_[i])
+        {
+            auto newLevel = std::make_unique<Level>();
+            newLevel->mesh = applyCatmullClarkSubdivision(levels_[i - 1]->mesh, 1, newLevel->edges);
+            levels_[i] = std::move(newLevel);
+        }
+    }
+}
+
+float computePixelsPerUnit(
+    float objectToWorldScale, float cameraDistance, float verticalFov, float viewportHeight)
+{
+    float halfHeightAtDistance = cameraDistance * std::tan(0.5f * verticalFov);
+    return objectToWorldScale * 0.5f * viewportHeight / halfHeightAtDistance;
+}
+
+LodSelector::LodSelector(const LodSelectorParams &params)
+    : params_(params), currentLevel_(-1)
+{
+
+}
+
+int LodSelector::select(const LodChain &chain, float pixelsPerUnit)
+{
+    int finer = coarsestLevelWithin(chain, pixelsPerUnit, params_.targetEdgePixels);
+
+    if(currentLevel_ < 0 || currentLevel_ > chain.getMaxLevel() || finer > currentLevel_)
+    {
+        // 需要更多细节时立即切换
+        currentLevel_ = finer;
+        return currentLevel_;
+    }
+
+    // 只有在更粗的层级明显足够时才降低层级
+
+    int coarser = coarsestLevelWithin(
+        chain, pixelsPerUnit, params_.targetEdgePixels * (1 - params_.hysteresis));
+    if(coarser < currentLevel_)
+    {
+        currentLevel_ = coarser;
+    }
+
+    return currentLevel_;
+}
+
+int LodSelector::getCurrentLevel() const noexcept
+{
+    return currentLevel_;
+}
+
+void LodSelector::reset() noexcept
+{
+    currentLevel_ = -1;
+}
@@ -1,75 +1,17 @@
 #include <iostream>
+#include <memory>
 
 #include <agz/utility/d3d11/ImGui/imgui.h>
 #include <agz/utility/d3d11/ImGui/imfilebrowser.h>
-#include <agz/utility/mesh.h>
 #include <agz/utility/time.h>
 
+#include <catmull_clark/bvh.h>
 #include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/limit_intersector.h>
+#include <catmull_clark/lod.h>
+#include <catmull_clark/mesh_io.h>
 #include <catmull_clark/renderer.h>
 
-/**
- * @brief 从指定obj文件中加载网格模型
- */
-Mesh loadMesh(const std::string &filename)
-{
-    Mesh mesh;
-
-    auto faces = agz::mesh::load_from_obj(filename);
-    for(auto &f : faces)
-    {
-        auto index = static_cast<Face::Index>(mesh.vertices.size());
-
-        mesh.vertices.push_back({ f.vertices[0].position });
-        mesh.vertices.push_back({ f.vertices[1].position });
-        mesh.vertices.push_back({ f.vertices[2].position });
-
-        if(f.is_quad)
-        {
-            mesh.vertices.push_back({ f.vertices[3].position });
-            mesh.faces.push_back({ true, { index, index + 1, index + 2, index + 3 } });
-        }
-        else
-        {
-            mesh.faces.push_back({ false, { index, index + 1, index + 2 } });
-        }
-    }
-
-    return mesh;
-}
-
-/**
- * @brief 计算将模型从本地变换到[-0.5, +0.5]^3中的变换矩阵
- */
-Mat4 localToUnitCube(const Mesh &mesh)
-{
-    Vec3 low((std::numeric_limits<float>::max)());
-    Vec3 high((std::numeric_limits<float>::lowest)());
-
-    for(auto &f : mesh.faces)
-    {
-        int vertexCount = f.isQuad ? 4 : 3;
-
-        for(int i = 0; i < vertexCount; ++i)
-        {
-            auto &v = mesh.vertices[f.indices[i]];
-
-            low.x = (std::min)(low.x, v.position.x);
-            low.y = (std::min)(low.y, v.position.y);
-            low.z = (std::min)(low.z, v.position.z);
-
-            high.x = (std::max)(high.x, v.position.x);
-            high.y = (std::max)(high.y, v.position.y);
-            high.z = (std::max)(high.z, v.position.z);
-        }
-    }
-
-    float maxExtent = (high - low).max_elem();
-    float scale = 1 / maxExtent;
-    Vec3 trans  = -0.5f * (low + high);
-    return Trans4::translate(trans) * Trans4::scale(scale, scale, scale);
-}
-
 void run()
 {
     D3D::WindowDesc windowDesc;
@@ -86,14 +28,16 @@ void run()
 
     // 投影矩阵
 
+    const float fovY = agz::math::deg2rad(30.0f);
+
     Mat4 proj = Trans4::perspective(
-        agz::math::deg2rad(30.0f), window.GetClientAspectRatio(), 0.1f, 100.0f);
+        fovY, window.GetClientAspectRatio(), 0.1f, 100.0f);
 
     D3D::WindowResizeHandler windowResizeHandler(
         [&](const D3D::WindowResizeEvent &e)
     {
         proj = Trans4::perspective(
-            agz::math::deg2rad(30.0f), window.GetClientAspectRatio(), 0.1f, 100.0f);
+            fovY, window.GetClientAspectRatio(), 0.1f, 100.0f);
     });
     window.Attach(&windowResizeHandler);
 
@@ -107,15 +51,69 @@ void run()
 
     int subdivisionCount = 0;
     Mesh originalMesh   = loadMesh("./asset/cube.obj");
-    Mesh subdividedMesh = applyCatmullClarkSubdivision(originalMesh, subdivisionCount);
+    std::vector<Edge> subdividedEdges;
+    Mesh subdividedMesh = applyCatmullClarkSubdivision(originalMesh, subdivisionCount, subdividedEdges);
+
+    RenderMeshOptions renderMeshOptions;
+    renderMeshOptions.normalWeighting = NormalWeighting::Limit;
 
     Renderer renderer;
     renderer.setWorldTransform(localToUnitCube(originalMesh));
-    renderer.setMesh(subdividedMesh);
+    renderer.setMesh(subdividedMesh, subdividedEdges, renderMeshOptions);
+
+    // 根据摄像机距离自动选择细分层级
+
+    constexpr int MAX_SUBDIVISION_COUNT = 5;
+
+    bool autoLod = false;
+    auto lodChain = std::make_unique<LodChain>(originalMesh, MAX_SUBDIVISION_COUNT);
+    float objectScale = localToUnitCubeScale(originalMesh);
+    LodSelector lodSelector;
+
+    // 渲染选项变化时重新设置当前显示的模型
+
+    auto setDisplayedMesh = [&]
+    {
+        if(autoLod)
+        {
+            renderer.setMesh(
+                lodChain->getMesh(subdivisionCount), lodChain->getEdges(subdivisionCount), renderMeshOptions);
+        }
+        else
+        {
+            renderer.setMesh(subdividedMesh, subdividedEdges, renderMeshOptions);
+        }
+    };
+
+    auto getDisplayedMesh = [&]() -> const Mesh&
+    {
+        return autoLod ? lodChain->getMesh(subdivisionCount) : subdividedMesh;
+    };
+
+    // 拾取：在当前显示的细分结果或极限曲面上求交，BVH与极限曲面求交器在首次拾取时构建
+
+    auto hierarchy = std::make_unique<SubdivisionHierarchy>(originalMesh);
+    Mat4 worldToLocal = unitCubeToLocal(originalMesh);
+
+    std::unique_ptr<MeshBVH> pickBVH;
+    std::unique_ptr<LimitSurfaceIntersector> limitIntersector;
+    bool pickLimitSurface = false;
+    bool hasPickHit = false;
+    SurfaceHit pickHit;
+
+    auto invalidatePick = [&]
+    {
+        pickBVH.reset();
+        hasPickHit = false;
+    };
 
     // 绘制状态
 
     bool wireframe = false;
+    int normalWeighting = static_cast<int>(renderMeshOptions.normalWeighting);
+    bool optimizeIndices = renderMeshOptions.optimizeIndices;
+    bool quantize        = renderMeshOptions.quantize;
+    bool clusterCulling  = renderMeshOptions.buildClusters;
     float cameraVertRad = 0.5f;
     float cameraHoriRad = 0.2f;
     float cameraDistance = 5;
@@ -161,6 +159,63 @@ void run()
         Mat4 view = Trans4::look_at(cameraPos, { 0, 0, 0 }, { 0, 1, 0 });
         renderer.setLightDir(lightDir);
         renderer.setCameraViewProj(view * proj);
+        renderer.setCameraPosition(cameraPos);
+
+        if(autoLod)
+        {
+            float pixelsPerUnit = computePixelsPerUnit(
+                objectScale, cameraDistance, fovY, static_cast<float>(window.GetClientHeight()));
+
+            int level = lodSelector.select(*lodChain, pixelsPerUnit);
+            if(level != subdivisionCount)
+            {
+                subdivisionCount = level;
+                renderer.setMesh(lodChain->getMesh(level), lodChain->getEdges(level), renderMeshOptions);
+                invalidatePick();
+            }
+        }
+
+        // 左键拾取
+
+        if(mouse->IsMouseButtonPressed(D3D::MouseButton::Left) && !ImGui::GetIO().WantCaptureMouse)
+        {
+            if(pickLimitSurface && !limitIntersector)
+            {
+                LimitIntersectorOptions limitOptions;
+                limitOptions.tolerance = 1e-3f / objectScale;
+                limitIntersector = std::make_unique<LimitSurfaceIntersector>(originalMesh, limitOptions);
+            }
+            else if(!pickLimitSurface && !pickBVH)
+            {
+                agz::time::clock_t clock;
+                pickBVH = std::make_unique<MeshBVH>(getDisplayedMesh());
+                std::cout << "bvh build time: " << clock.us() / 1000.0f << "ms" << std::endl;
+            }
+
+            const float tanHalfFovY = std::tan(0.5f * fovY);
+            const float ndcX = 2 * (mouse->GetCursorPositionX() + 0.5f) / window.GetClientWidth() - 1;
+            const float ndcY = 1 - 2 * (mouse->GetCursorPositionY() + 0.5f) / window.GetClientHeight();
+
+            Vec3 forward = -cameraPos.normalize();
+            Vec3 right   = cross(Vec3(0, 1, 0), forward).normalize();
+            Vec3 up      = cross(forward, right);
+            Vec3 direction = forward
+                           + ndcX * tanHalfFovY * window.GetClientAspectRatio() * right
+                           + ndcY * tanHalfFovY * up;
+
+            Ray ray;
+            ray.origin    = transformPoint(cameraPos, worldToLocal);
+            ray.direction = transformDirection(direction, worldToLocal);
+
+            if(pickLimitSurface)
+            {
+                hasPickHit = limitIntersector->intersect(ray, pickHit);
+            }
+            else
+            {
+                hasPickHit = intersectSurface(*pickBVH, *hierarchy, subdivisionCount, ray, pickHit);
+            }
+        }
 
         // GUI
 
@@ -171,16 +226,62 @@ void run()
                 renderer.setWireframe(wireframe);
             }
 
+            if(ImGui::Checkbox("pick limit surface", &pickLimitSurface))
+            {
+                hasPickHit = false;
+            }
+
+            if(ImGui::Checkbox("auto lod", &autoLod))
+            {
+                lodSelector.reset();
+
+                if(!autoLod)
+                {
+                    // 保持关闭自动选择前显示的层级
+                    subdividedMesh  = lodChain->getMesh(subdivisionCount);
+                    subdividedEdges = lodChain->getEdges(subdivisionCount);
+                }
+            }
+
             ImGui::PushItemWidth(200);
-            if(ImGui::SliderInt("subdivision", &subdivisionCount, 0, 5))
+            if(ImGui::SliderInt("subdivision", &subdivisionCount, 0, MAX_SUBDIVISION_COUNT) && !autoLod)
             {
                 agz::time::clock_t clock;
-                subdividedMesh = applyCatmullClarkSubdivision(originalMesh, subdivisionCount);
+                subdividedMesh = applyCatmullClarkSubdivision(originalMesh, subdivisionCount, subdividedEdges);
                 std::cout << "time: " << clock.us() / 1000.0f / 100 << "ms" << std::endl;
-                renderer.setMesh(subdividedMesh);
+                renderer.setMesh(subdividedMesh, subdividedEdges, renderMeshOptions);
+                invalidatePick();
+            }
+
+            const char *normalWeightingNames[] = { "area", "angle", "limit" };
+            if(ImGui::Combo("normal", &normalWeighting, normalWeightingNames, 3))
+            {
+                renderMeshOptions.normalWeighting = static_cast<NormalWeighting>(normalWeighting);
+                setDisplayedMesh();
             }
             ImGui::PopItemWidth();
 
+            if(ImGui::Checkbox("optimize indices", &optimizeIndices))
+            {
+                renderMeshOptions.optimizeIndices = optimizeIndices;
+
+                agz::time::clock_t clock;
+                setDisplayedMesh();
+                std::cout << "render mesh time: " << clock.us() / 1000.0f << "ms" << std::endl;
+            }
+
+            if(ImGui::Checkbox("quantize", &quantize))
+            {
+                renderMeshOptions.quantize = quantize;
+                setDisplayedMesh();
+            }
+
+            if(ImGui::Checkbox("cluster culling", &clusterCulling))
+            {
+                renderMeshOptions.buildClusters = clusterCulling;
+                setDisplayedMesh();
+            }
+
             if(ImGui::Button("select obj"))
             {
                 fileBrowser.Open();
@@ -190,6 +291,31 @@ void run()
             ImGui::Text("edge:     %d", renderer.getEdgeCount());
             ImGui::Text("quad:     %d", renderer.getQuadCount());
             ImGui::Text("triangle: %d", renderer.getTriangleCount());
+
+            auto &cacheStatistics = renderer.getVertexCacheStatistics();
+            ImGui::Text("ACMR:     %.3f", cacheStatistics.acmr);
+            ImGui::Text("ATVR:     %.3f", cacheStatistics.atvr);
+
+            if(clusterCulling)
+            {
+                ImGui::Text("cluster:  %d / %d", renderer.getVisibleClusterCount(), renderer.getClusterCount());
+            }
+
+            if(quantize)
+            {
+                auto &quantizationError = renderer.getQuantizationError();
+                ImGui::Text("position error: %g", quantizationError.maxPositionError);
+                ImGui::Text("normal error:   %.4f deg", quantizationError.maxNormalErrorDegrees);
+            }
+
+            if(hasPickHit)
+            {
+                auto &location = pickHit.location;
+                auto &position = pickHit.meshHit.position;
+                ImGui::Text("pick face:  %u (sub %d)", location.baseFace, location.subFace);
+                ImGui::Text("pick uv:    %.3f, %.3f", location.uv.x, location.uv.y);
+                ImGui::Text("pick pos:   %.3f, %.3f, %.3f", position.x, position.y, position.z);
+            }
         }
         ImGui::End();
 
@@ -201,10 +327,19 @@ void run()
 
             subdivisionCount = 0;
             originalMesh = loadMesh(fileBrowser.GetSelected().string());
-            subdividedMesh = originalMesh;
+            subdividedMesh = applyCatmullClarkSubdivision(originalMesh, 0, subdividedEdges);
 
             renderer.setWorldTransform(localToUnitCube(originalMesh));
-            renderer.setMesh(subdividedMesh);
+            renderer.setMesh(subdividedMesh, subdividedEdges, renderMeshOptions);
+
+            lodChain = std::make_unique<LodChain>(originalMesh, MAX_SUBDIVISION_COUNT);
+            objectScale = localToUnitCubeScale(originalMesh);
+            lodSelector.reset();
+
+            hierarchy = std::make_unique<SubdivisionHierarchy>(originalMesh);
+            worldToLocal = unitCubeToLocal(originalMesh);
+            limitIntersector.reset();
+            invalidatePick();
         }
 
         // rendering
@@ -0,0 +1,99 @@
+#include <limits>
+#include <unordered_map>
+
+#include <agz/utility/mesh.h>
+
+#include <catmull_clark/mesh_io.h>
+
+Mesh loadMesh(const std::string &filename)
+{
+    Mesh mesh;
+    std::unordered_map<Vec3, Face::Index> positionToVertex;
+
+    auto getVertexIndex = [&](const Vec3 &position)
+    {
+        auto it = positionToVertex.find(position);
+        if(it != positionToVertex.end())
+        {
+            return it->second;
+        }
+
+        auto ret = static_cast<Face::Index>(mesh.vertices.size());
+        mesh.vertices.push_back({ position });
+        positionToVertex[position] = ret;
+
+        return ret;
+    };
+
+    auto faces = agz::mesh::load_from_obj(filename);
+    for(auto &f : faces)
+    {
+        auto a = getVertexIndex(f.vertices[0].position);
+        auto b = getVertexIndex(f.vertices[1].position);
+        auto c = getVertexIndex(f.vertices[2].position);
+
+        if(f.is_quad)
+        {
+            auto d = getVertexIndex(f.vertices[3].position);
+            mesh.faces.push_back({ true, { a, b, c, d } });
+        }
+        else
+        {
+            mesh.faces.push_back({ false, { a, b, c } });
+        }
+    }
+
+    return mesh;
+}
+
+void computeBoundingBox(const Mesh &mesh, Vec3 &low, Vec3 &high)
+{
+    low  = Vec3((std::numeric_limits<float>::max)());
+    high = Vec3((std::numeric_limits<float>::lowest)());
+
+    for(auto &f : mesh.faces)
+    {
+        int vertexCount = f.isQuad ? 4 : 3;
+
+        for(int i = 0; i < vertexCount; ++i)
+        {
+            auto &v = mesh.vertices[f.indices[i]];
+
+            low.x = (std::min)(low.x, v.position.x);
+            low.y = (std::min)(low.y, v.position.y);
+            low.z = (std::min)(low.z, v.position.z);
+
+            high.x = (std::max)(high.x, v.position.x);
+            high.y = (std::max)(high.y, v.position.y);
+            high.z = (std::max)(high.z, v.position.z);
+        }
+    }
+}
+
+float localToUnitCubeScale(const Mesh &mesh)
+{
+    Vec3 low, high;
+    computeBoundingBox(mesh, low, high);
+    return 1 / (high - low).max_elem();
+}
+
+Mat4 localToUnitCube(const Mesh &mesh)
+{
+    Vec3 low, high;
+    computeBoundingBox(mesh, low, high);
+
+    float maxExtent = (high - low).max_elem();
+    float scale = 1 / maxExtent;
+    Vec3 trans  = -0.5f * (low + high);
+    return Trans4::translate(trans) * Trans4::scale(scale, scale, scale);
+}
+
+Mat4 unitCubeToLocal(const Mesh &mesh)
+{
+    Vec3 low, high;
+    computeBoundingBox(mesh, low, high);
+
+    float maxExtent = (high - low).max_elem();
+    Vec3 trans = 0.5f * (low + high);
+    return Trans4::scale(maxExtent, maxExtent, maxExtent) * Trans4::translate(trans);
+}
@@ -0,0 +1,403 @@
+#include <cmath>
+#include <cstring>
+
+#include <catmull_clark/mesh_optimizer.h>
+
+namespace
+{
+
+    constexpr int FORSYTH_CACHE_SIZE = 32;
+    constexpr int FORSYTH_MAX_VALENCE = 32;
+
+    /**
+     * @brief Forsyth算法中的顶点得分
+     *
+     * cachePosition为顶点在模拟缓存中的位置（-1表示不在缓存中），
+     * remainingTriangles为该顶点尚未输出的三角形数
+     */
+    class ForsythScoreTable
+    {
+        float cacheScore_[FORSYTH_CACHE_SIZE];
+        float valenceScore_[FORSYTH_MAX_VALENCE + 1];
+
+    public:
+
+        ForsythScoreTable()
+        {
+            for(int i = 0; i < FORSYTH_CACHE_SIZE; ++i)
+            {
+                if(i < 3)
+                {
+                    // 刚刚使用过的三个顶点得分固定，避免总是选择同一条边上的三角形
+                    cacheScore_[i] = 0.75f;
+                }
+                else
+                {
+                    float t = 1 - static_cast<float>(i - 3) / (FORSYTH_CACHE_SIZE - 3);
+                    cacheScore_[i] = std::pow(t, 1.5f);
+                }
+            }
+
+            valenceScore_[0] = 0;
+            for(int i = 1; i <= FORSYTH_MAX_VALENCE; ++i)
+            {
+                valenceScore_[i] = 2.0f / std::sqrt(static_cast<float>(i));
+            }
+        }
+
+        float operator()(int cachePosition, int remainingTriangles) const noexcept
+        {
+            if(!remainingTriangles)
+            {
+                return -1;
+            }
+
+            float score = cachePosition >= 0 ? cacheScore_[cachePosition] : 0.0f;
+            return score + valenceScore_[(std::min)(remainingTriangles, FORSYTH_MAX_VALENCE)];
+        }
+    };
+
+    template<typename Index>
+    void remapIndices(std::vector<Index> &indices, const std::vector<uint32_t> &oldToNew)
+    {
+        for(auto &i : indices)
+        {
+            i = static_cast<Index>(oldToNew[i]);
+        }
+    }
+
+    template<typename Index>
+    void optimizeVertexFetchImpl(RenderMesh &mesh, std::vector<Index> &indices, std::vector<Index> &lineIndices)
+    {
+        constexpr uint32_t UNUSED = UINT32_MAX;
+
+        std::vector<uint32_t> oldToNew(mesh.vertices.size(), UNUSED);
+        uint32_t nextVertex = 0;
+
+        for(auto i : indices)
+        {
+            if(oldToNew[i] == UNUSED)
+            {
+                oldToNew[i] = nextVertex++;
+            }
+        }
+
+        for(auto &i : oldToNew)
+        {
+            if(i == UNUSED)
+            {
+                i = nextVertex++;
+            }
+        }
+
+        std::vector<RenderVertex> newVertices(mesh.vertices.size());
+        for(size_t i = 0; i < mesh.vertices.size(); ++i)
+        {
+            newVertices[oldToNew[i]] = mesh.vertices[i];
+        }
+        mesh.vertices.swap(newVertices);
+
+        // 与此前的重排复合，使vertexRemap始终指向原网格中的顶点
+
+        std::vector<uint32_t> newRemap(mesh.vertices.size());
+        for(size_t i = 0; i < oldToNew.size(); ++i)
+        {
+            newRemap[oldToNew[i]] = mesh.vertexRemap.empty() ? static_cast<uint32_t>(i) : mesh.vertexRemap[i];
+        }
+        mesh.vertexRemap.swap(newRemap);
+
+        remapIndices(indices, oldToNew);
+        remapIndices(lineIndices, oldToNew);
+    }
+
+    /**
+     * @brief 在每个簇的索引区间内部分别执行optimizeVertexCache
+     *
+     * 簇内顶点先被映射为局部下标，使每次优化的开销只与簇的大小有关
+     */
+    template<typename Index>
+    void optimizeClusterVertexCache(
+        std::vector<Index> &indices, const std::vector<Cluster> &clusters, size_t vertexCount)
+    {
+        constexpr uint32_t NO_LOCAL = UINT32_MAX;
+
+        std::vector<uint32_t> globalToLocal(vertexCount, NO_LOCAL);
+        std::vector<uint32_t> localToGlobal;
+        std::vector<uint32_t> localIndices;
+
+        for(auto &cluster : clusters)
+        {
+            localToGlobal.clear();
+            localIndices.clear();
+
+            for(uint32_t i = 0; i < cluster.indexCount; ++i)
+            {
+                auto v = static_cast<uint32_t>(indices[cluster.indexOffset + i]);
+                if(globalToLocal[v] == NO_LOCAL)
+                {
+                    globalToLocal[v] = static_cast<uint32_t>(localToGlobal.size());
+                    localToGlobal.push_back(v);
+                }
+                localIndices.push_back(globalToLocal[v]);
+            }
+
+            optimizeVertexCache(localIndices, localToGlobal.size());
+
+            for(uint32_t i = 0; i < cluster.indexCount; ++i)
+            {
+                indices[cluster.indexOffset + i] = static_cast<Index>(localToGlobal[localIndices[i]]);
+            }
+
+            for(auto v : localToGlobal)
+            {
+                globalToLocal[v] = NO_LOCAL;
+            }
+        }
+    }
+
+} // namespace anonymous
+
+template<typename Index>
+VertexCacheStatistics analyzeVertexCache(
+    const std::vector<Index> &indices, size_t vertexCount, int cacheSize)
+{
+    VertexCacheStatistics result;
+    if(indices.empty() || !vertexCount)
+    {
+        return result;
+    }
+
+    // 用时间戳模拟FIFO缓存：顶点进入缓存时记录当时的写入计数，
+    // 写入计数超过cacheSize后该顶点被挤出
+
+    std::vector<int> insertTime(vertexCount, -cacheSize - 1);
+    int writeCount = 0;
+
+    for(auto i : indices)
+    {
+        if(writeCount - insertTime[i] > cacheSize)
+        {
+            insertTime[i] = writeCount++;
+        }
+    }
+
+    result.transformedVertexCount = writeCount;
+    result.acmr = static_cast<float>(writeCount) / (indices.size() / 3);
+    result.atvr = static_cast<float>(writeCount) / vertexCount;
+    return result;
+}
+
+template VertexCacheStatistics analyzeVertexCache<uint16_t>(const std::vector<uint16_t>&, size_t, int);
+template VertexCacheStatistics analyzeVertexCache<uint32_t>(const std::vector<uint32_t>&, size_t, int);
+
+template<typename Index>
+void optimizeVertexCache(std::vector<Index> &indices, size_t vertexCount)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if(!triangleCount)
+    {
+        return;
+    }
+
+    static const ForsythScoreTable scoreTable;
+
+    // 顶点到三角形的压缩邻接表
+
+    std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+    for(auto i : indices)
+    {
+        ++triangleOffsets[i + 1];
+    }
+    for(size_t i = 1; i <= vertexCount; ++i)
+    {
+        triangleOffsets[i] += triangleOffsets[i - 1];
+    }
+
+    std::vector<uint32_t> vertexTriangles(indices.size());
+    {
+        std::vector<uint32_t> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+        for(size_t i = 0; i < indices.size(); ++i)
+        {
+            vertexTriangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    // 顶点与三角形的初始得分
+
+    std::vector<int>   remainingTriangles(vertexCount);
+    std::vector<int>   cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+
+    for(size_t v = 0; v < vertexCount; ++v)
+    {
+        remainingTriangles[v] = static_cast<int>(triangleOffsets[v + 1] - triangleOffsets[v]);
+        vertexScore[v] = scoreTable(-1, remainingTriangles[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool>  isTriangleEmitted(triangleCount, false);
+
+    for(size_t t = 0; t < triangleCount; ++t)
+    {
+        triangleScore[t] =
+            vertexScore[indices[3 * t]] + vertexScore[indices[3 * t + 1]] + vertexScore[indices[3 * t + 2]];
+    }
+
+    // 贪心地输出得分最高的三角形，候选三角形只从缓存中的顶点上取得
+
+    std::vector<Index> output;
+    output.reserve(indices.size());
+
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    int cacheSize = 0;
+
+    size_t scanCursor = 0;
+    int64_t bestTriangle = 0;
+
+    while(bestTriangle >= 0)
+    {
+        auto t = static_cast<size_t>(bestTriangle);
+        isTriangleEmitted[t] = true;
+
+        // 输出该三角形，并将其顶点移到缓存最前面
+
+        uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+        int newCacheSize = 0;
+
+        for(int k = 0; k < 3; ++k)
+        {
+            uint32_t v = indices[3 * t + k];
+            output.push_back(static_cast<Index>(v));
+            newCache[newCacheSize++] = v;
+
+            // 从v的邻接表中删除t，保持未输出的三角形位于表头
+
+            uint32_t *begin = vertexTriangles.data() + triangleOffsets[v];
+            uint32_t *end   = begin + remainingTriangles[v];
+            for(uint32_t *it = begin; it != end; ++it)
+            {
+                if(*it == t)
+                {
+                    std::swap(*it, *(end - 1));
+                    break;
+                }
+            }
+            --remainingTriangles[v];
+        }
+
+        for(int i = 0; i < cacheSize; ++i)
+        {
+            uint32_t v = cache[i];
+            if(v != newCache[0] && v != newCache[1] && v != newCache[2])
+            {
+                newCache[newCacheSize++] = v;
+            }
+        }
+
+        // 更新缓存中（及被挤出的）顶点的得分，以及相关三角形的得分
+
+        for(int i = 0; i < newCacheSize; ++i)
+        {
+            uint32_t v = newCache[i];
+            cachePosition[v] = i < FORSYTH_CACHE_SIZE ? i : -1;
+
+            float newScore = scoreTable(cachePosition[v], remainingTriangles[v]);
+            float delta = newScore - vertexScore[v];
+            vertexScore[v] = newScore;
+
+            uint32_t *begin = vertexTriangles.data() + triangleOffsets[v];
+            for(int j = 0; j < remainingTriangles[v]; ++j)
+            {
+                triangleScore[begin[j]] += delta;
+            }
+        }
+
+        cacheSize = (std::min)(newCacheSize, FORSYTH_CACHE_SIZE);
+        std::memcpy(cache, newCache, sizeof(uint32_t) * cacheSize);
+
+        // 从缓存顶点的剩余三角形中选取得分最高者
+
+        bestTriangle = -1;
+        float bestScore = -1;
+
+        for(int i = 0; i < cacheSize; ++i)
+        {
+            uint32_t v = cache[i];
+            uint32_t *begin = vertexTriangles.data() + triangleOffsets[v];
+            for(int j = 0; j < remainingTriangles[v]; ++j)
+            {
+                uint32_t candidate = begin[j];
+                if(triangleScore[candidate] > bestScore)
+                {
+                    bestScore = triangleScore[candidate];
+                    bestTriangle = candidate;
+                }
+            }
+        }
+
+        // 缓存中没有可用的三角形时，按原顺序找到下一个未输出的三角形
+
+        if(bestTriangle < 0)
+        {
+            while(scanCursor < triangleCount && isTriangleEmitted[scanCursor])
+            {
+                ++scanCursor;
+            }
+            if(scanCursor < triangleCount)
+            {
+                bestTriangle = static_cast<int64_t>(scanCursor);
+            }
+        }
+    }
+
+    indices.swap(output);
+}
+
+template void optimizeVertexCache<uint16_t>(std::vector<uint16_t>&, size_t);
+template void optimizeVertexCache<uint32_t>(std::vector<uint32_t>&, size_t);
+
+void optimizeVertexFetch(RenderMesh &mesh)
+{
+    if(mesh.isIndex16())
+    {
+        optimizeVertexFetchImpl(mesh, mesh.indices16, mesh.lineIndices16);
+    }
+    else
+    {
+        optimizeVertexFetchImpl(mesh, mesh.indices32, mesh.lineIndices32);
+    }
+}
+
+void optimizeRenderMesh(RenderMesh &mesh)
+{
+    if(!mesh.clusters.empty())
+    {
+        if(mesh.isIndex16())
+        {
+            optimizeClusterVertexCache(mesh.indices16, mesh.clusters, mesh.vertices.size());
+        }
+        else
+        {
+            optimizeClusterVertexCache(mesh.indices32, mesh.clusters, mesh.vertices.size());
+        }
+    }
+    else if(mesh.isIndex16())
+    {
+        optimizeVertexCache(mesh.indices16, mesh.vertices.size());
+    }
+    else
+    {
+        optimizeVertexCache(mesh.indices32, mesh.vertices.size());
+    }
+
+    optimizeVertexFetch(mesh);
+}
+
+VertexCacheStatistics analyzeVertexCache(const RenderMesh &mesh, int cacheSize)
+{
+    if(mesh.isIndex16())
+    {
+        return analyzeVertexCache(mesh.indices16, mesh.getVertexCount(), cacheSize);
+    }
+    return analyzeVertexCache(mesh.indices32, mesh.getVertexCount(), cacheSize);
+}
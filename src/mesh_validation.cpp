@@ -0,0 +1,424 @@
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include <catmull_clark/mesh_validation.h>
+#include <catmull_clark/parallel.h>
+
+namespace
+{
+
+    constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    int getVertexCount(const Face &f) noexcept
+    {
+        return f.isQuad ? 4 : 3;
+    }
+
+    /**
+     * @brief 并行排序：各段在不同线程上分别排序，再逐轮两两归并
+     */
+    template<typename T, typename Less>
+    void parallelSort(std::vector<T> &data, const Less &less)
+    {
+        const size_t count = data.size();
+        const size_t threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+        const size_t chunkCount = (std::min)(threadCount, (count + 4095) / 4096);
+
+        if(chunkCount <= 1)
+        {
+            std::sort(data.begin(), data.end(), less);
+            return;
+        }
+
+        const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+        parallelForRange(chunkCount, 1, [&](size_t begin, size_t end)
+        {
+            for(size_t c = begin; c < end; ++c)
+            {
+                const size_t first = c * chunkSize;
+                const size_t last  = (std::min)(count, first + chunkSize);
+                std::sort(data.begin() + first, data.begin() + last, less);
+            }
+        });
+
+        for(size_t width = chunkSize; width < count; width *= 2)
+        {
+            const size_t pairCount = (count + 2 * width - 1) / (2 * width);
+            parallelForRange(pairCount, 1, [&](size_t begin, size_t end)
+            {
+                for(size_t p = begin; p < end; ++p)
+                {
+                    const size_t first = p * 2 * width;
+                    const size_t mid   = (std::min)(count, first + width);
+                    const size_t last  = (std::min)(count, first + 2 * width);
+                    if(mid < last)
+                    {
+                        std::inplace_merge(data.begin() + first, data.begin() + mid, data.begin() + last, less);
+                    }
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief 面的一条有向边，从所在面的第i个角指向第i + 1个角
+     */
+    struct HalfEdge
+    {
+        uint64_t key;       // 两端合并后的顶点下标，较小者在高32位
+        uint32_t corner;    // 起点所在的角
+        bool     isForward; // 是否由较小的顶点下标指向较大的
+    };
+
+    /**
+     * @brief 检查与拆分共用的拓扑信息
+     *
+     * 第f个面的第i个顶点称为一个角，其下标为faceOffsets[f] + i
+     */
+    struct Topology
+    {
+        std::vector<uint32_t> weldedVertices; // 每个顶点合并后的下标，即位于同一位置的最小顶点下标
+        std::vector<uint32_t> faceOffsets;
+        std::vector<uint32_t> cornerFaces;
+        std::vector<uint32_t> cornerVertices; // 每个角合并后的顶点下标
+        std::vector<HalfEdge> halfEdges;      // 按key排序，key相同的半边连续排列
+        std::vector<uint8_t>  isDegenerate;
+    };
+
+    Topology buildTopology(const Mesh &mesh)
+    {
+        Topology topology;
+
+        // 按位置排序以合并顶点，位置相同时按下标排序，使每组中第一个顶点的下标最小
+
+        const size_t vertexCount = mesh.vertices.size();
+        std::vector<uint32_t> order(vertexCount);
+        std::iota(order.begin(), order.end(), 0u);
+
+        parallelSort(order, [&](uint32_t a, uint32_t b)
+        {
+            const Vec3 &p = mesh.vertices[a].position, &q = mesh.vertices[b].position;
+            if(p.x != q.x) return p.x < q.x;
+            if(p.y != q.y) return p.y < q.y;
+            if(p.z != q.z) return p.z < q.z;
+            return a < b;
+        });
+
+        topology.weldedVertices.resize(vertexCount);
+        for(size_t i = 0; i < vertexCount; ++i)
+        {
+            const uint32_t v = order[i];
+            const bool isSame = i > 0 && mesh.vertices[order[i - 1]].position == mesh.vertices[v].position;
+            topology.weldedVertices[v] = isSame ? topology.weldedVertices[order[i - 1]] : v;
+        }
+
+        // 各面的角与半边
+
+        const size_t faceCount = mesh.faces.size();
+        topology.faceOffsets.resize(faceCount + 1);
+        for(size_t f = 0; f < faceCount; ++f)
+        {
+            topology.faceOffsets[f + 1] = topology.faceOffsets[f] + getVertexCount(mesh.faces[f]);
+        }
+
+        const size_t cornerCount = topology.faceOffsets.back();
+        topology.cornerFaces.resize(cornerCount);
+        topology.cornerVertices.resize(cornerCount);
+        topology.halfEdges.resize(cornerCount);
+        topology.isDegenerate.resize(faceCount);
+
+        parallelFor(faceCount, [&](size_t f)
+        {
+            auto &face = mesh.faces[f];
+            const int n = getVertexCount(face);
+            const uint32_t offset = topology.faceOffsets[f];
+
+            for(int i = 0; i < n; ++i)
+            {
+                topology.cornerFaces[offset + i]    = static_cast<uint32_t>(f);
+                topology.cornerVertices[offset + i] = topology.weldedVertices[face.indices[i]];
+            }
+
+            bool isDegenerate = false;
+            for(int i = 0; i < n; ++i)
+            {
+                const uint64_t a = topology.cornerVertices[offset + i];
+                const uint64_t b = topology.cornerVertices[offset + (i + 1) % n];
+                topology.halfEdges[offset + i] = { ((std::min)(a, b) << 32) | (std::max)(a, b), offset + i, a < b };
+
+                for(int j = i + 1; j < n; ++j)
+                {
+                    isDegenerate |= a == topology.cornerVertices[offset + j];
+                }
+            }
+
+            // 四边形的面积向量为两条对角线叉积的一半
+
+            auto position = [&](int i) { return mesh.vertices[face.indices[i]].position; };
+            const Vec3 area = n == 4 ? cross(position(2) - position(0), position(3) - position(1))
+                                     : cross(position(1) - position(0), position(2) - position(0));
+            isDegenerate |= area == Vec3(0);
+
+            topology.isDegenerate[f] = isDegenerate;
+        });
+
+        parallelSort(topology.halfEdges, [](const HalfEdge &a, const HalfEdge &b)
+        {
+            return a.key != b.key ? a.key < b.key : a.corner < b.corner;
+        });
+
+        return topology;
+    }
+
+    /**
+     * @brief 半边按边分组后的检查结果
+     */
+    struct EdgeGroups
+    {
+        std::vector<uint64_t> nonManifoldKeys;
+        std::vector<uint64_t> inconsistentKeys;
+
+        // 属于同一个顶点、所在的面经由一条流形边相邻的两个角
+        std::vector<std::pair<uint32_t, uint32_t>> cornerPairs;
+    };
+
+    EdgeGroups scanEdgeGroups(const Topology &topology)
+    {
+        auto &halfEdges = topology.halfEdges;
+        const size_t count = halfEdges.size();
+
+        auto nextCorner = [&](uint32_t corner)
+        {
+            const uint32_t f = topology.cornerFaces[corner];
+            return corner + 1 < topology.faceOffsets[f + 1] ? corner + 1 : topology.faceOffsets[f];
+        };
+
+        // 半边e上较小、较大顶点下标对应的角
+
+        auto lowCorner  = [&](const HalfEdge &e) { return e.isForward ? e.corner : nextCorner(e.corner); };
+        auto highCorner = [&](const HalfEdge &e) { return e.isForward ? nextCorner(e.corner) : e.corner; };
+
+        EdgeGroups result;
+        std::mutex resultMutex;
+
+        // 每个区间处理起点落在其中的组
+
+        parallelForRange(count, 4096, [&](size_t begin, size_t end)
+        {
+            EdgeGroups local;
+
+            size_t first = begin;
+            while(first > 0 && first < end && halfEdges[first].key == halfEdges[first - 1].key)
+            {
+                ++first;
+            }
+
+            while(first < end)
+            {
+                size_t last = first + 1;
+                while(last < count && halfEdges[last].key == halfEdges[first].key)
+                {
+                    ++last;
+                }
+
+                const uint64_t key = halfEdges[first].key;
+                const bool isLoop = (key >> 32) == (key & 0xffffffff);
+
+                if(last - first > 2)
+                {
+                    local.nonManifoldKeys.push_back(key);
+                }
+                else if(last - first == 2 && !isLoop)
+                {
+                    auto &e0 = halfEdges[first], &e1 = halfEdges[first + 1];
+                    if(e0.isForward == e1.isForward)
+                    {
+                        local.inconsistentKeys.push_back(key);
+                    }
+                    local.cornerPairs.push_back({ lowCorner(e0), lowCorner(e1) });
+                    local.cornerPairs.push_back({ highCorner(e0), highCorner(e1) });
+                }
+
+                first = last;
+            }
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            result.nonManifoldKeys.insert(result.nonManifoldKeys.end(), local.nonManifoldKeys.begin(), local.nonManifoldKeys.end());
+            result.inconsistentKeys.insert(result.inconsistentKeys.end(), local.inconsistentKeys.begin(), local.inconsistentKeys.end());
+            result.cornerPairs.insert(result.cornerPairs.end(), local.cornerPairs.begin(), local.cornerPairs.end());
+        });
+
+        std::sort(result.nonManifoldKeys.begin(), result.nonManifoldKeys.end());
+        std::sort(result.inconsistentKeys.begin(), result.inconsistentKeys.end());
+
+        return result;
+    }
+
+    /**
+     * @brief 将经由流形边相邻的角合并，每个顶点周围连成一片的面的角具有相同的代表元
+     */
+    std::vector<uint32_t> computeCornerRoots(const Topology &topology, const EdgeGroups &groups)
+    {
+        std::vector<uint32_t> parents(topology.cornerVertices.size());
+        std::iota(parents.begin(), parents.end(), 0u);
+
+        auto find = [&](uint32_t c)
+        {
+            while(parents[c] != c)
+            {
+                parents[c] = parents[parents[c]];
+                c = parents[c];
+            }
+            return c;
+        };
+
+        for(auto &pair : groups.cornerPairs)
+        {
+            const uint32_t a = find(pair.first), b = find(pair.second);
+            if(a != b)
+            {
+                parents[(std::max)(a, b)] = (std::min)(a, b);
+            }
+        }
+
+        for(uint32_t c = 0; c < parents.size(); ++c)
+        {
+            parents[c] = find(c);
+        }
+
+        return parents;
+    }
+
+    Edge keyToEdge(uint64_t key) noexcept
+    {
+        return { { static_cast<Face::Index>(key >> 32), static_cast<Face::Index>(key & 0xffffffff) } };
+    }
+
+} // namespace anonymous
+
+MeshValidationReport validateMesh(const Mesh &mesh)
+{
+    const Topology topology = buildTopology(mesh);
+    const EdgeGroups groups = scanEdgeGroups(topology);
+    const std::vector<uint32_t> roots = computeCornerRoots(topology, groups);
+
+    MeshValidationReport report;
+
+    for(uint64_t key : groups.nonManifoldKeys)
+    {
+        report.nonManifoldEdges.push_back(keyToEdge(key));
+    }
+
+    for(uint64_t key : groups.inconsistentKeys)
+    {
+        report.inconsistentEdges.push_back(keyToEdge(key));
+    }
+
+    for(uint32_t f = 0; f < topology.isDegenerate.size(); ++f)
+    {
+        if(topology.isDegenerate[f])
+        {
+            report.degenerateFaces.push_back(f);
+        }
+    }
+
+    // 顶点周围的角有多个代表元时，其周围的面分成了互不相连的几片
+
+    std::vector<uint32_t> firstRoots(mesh.vertices.size(), INVALID_INDEX);
+    std::vector<uint8_t> isNonManifold(mesh.vertices.size());
+
+    for(uint32_t c = 0; c < roots.size(); ++c)
+    {
+        uint32_t &firstRoot = firstRoots[topology.cornerVertices[c]];
+        if(firstRoot == INVALID_INDEX)
+        {
+            firstRoot = roots[c];
+        }
+        else if(firstRoot != roots[c])
+        {
+            isNonManifold[topology.cornerVertices[c]] = true;
+        }
+    }
+
+    for(uint32_t v = 0; v < isNonManifold.size(); ++v)
+    {
+        if(isNonManifold[v])
+        {
+            report.nonManifoldVertices.push_back(v);
+        }
+    }
+
+    return report;
+}
+
+Mesh splitNonManifold(const Mesh &mesh)
+{
+    const Topology topology = buildTopology(mesh);
+    const EdgeGroups groups = scanEdgeGroups(topology);
+    const std::vector<uint32_t> roots = computeCornerRoots(topology, groups);
+
+    // 非流形边上的面若在两端仍属于同一片，保留前两个面，其余的面分离为独立的面
+
+    auto &halfEdges = topology.halfEdges;
+    std::vector<uint8_t> isDetached(mesh.faces.size());
+
+    for(uint64_t key : groups.nonManifoldKeys)
+    {
+        auto first = std::lower_bound(halfEdges.begin(), halfEdges.end(), key,
+            [](const HalfEdge &e, uint64_t k) { return e.key < k; });
+
+        std::vector<std::pair<uint64_t, uint32_t>> copies;
+        for(auto it = first; it != halfEdges.end() && it->key == key; ++it)
+        {
+            const uint32_t f = topology.cornerFaces[it->corner];
+            const uint32_t next = it->corner + 1 < topology.faceOffsets[f + 1] ? it->corner + 1 : topology.faceOffsets[f];
+
+            const uint64_t a = roots[it->corner], b = roots[next];
+            copies.push_back({ ((std::min)(a, b) << 32) | (std::max)(a, b), f });
+        }
+
+        std::sort(copies.begin(), copies.end());
+        for(size_t i = 2; i < copies.size(); ++i)
+        {
+            if(copies[i].first == copies[i - 2].first)
+            {
+                isDetached[copies[i].second] = true;
+            }
+        }
+    }
+
+    // 每个代表元对应结果中的一个顶点，被分离的面的每个角各对应一个顶点，按首次出现的顺序编号
+
+    Mesh result;
+    result.faces = mesh.faces;
+
+    std::vector<uint32_t> rootVertices(roots.size(), INVALID_INDEX);
+
+    for(uint32_t f = 0; f < mesh.faces.size(); ++f)
+    {
+        const uint32_t offset = topology.faceOffsets[f];
+        for(int i = 0; i < getVertexCount(mesh.faces[f]); ++i)
+        {
+            const uint32_t c = offset + i;
+            if(isDetached[f] || rootVertices[roots[c]] == INVALID_INDEX)
+            {
+                const auto v = static_cast<uint32_t>(result.vertices.size());
+                result.vertices.push_back(mesh.vertices[topology.cornerVertices[c]]);
+                if(!isDetached[f])
+                {
+                    rootVertices[roots[c]] = v;
+                }
+                result.faces[f].indices[i] = v;
+            }
+            else
+            {
+                result.faces[f].indices[i] = rootVertices[roots[c]];
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,386 @@
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/patch.h>
+
+namespace
+{
+
+    // 中心面的第k个顶点在4x4控制点网格中的位置(行, 列)
+    const int CORNER_GRID[4][2] = { { 1, 1 }, { 1, 2 }, { 2, 2 }, { 2, 1 } };
+
+    // 中心面的第k条边(k, k + 1)向外的方向
+    const int EDGE_OUTWARD[4][2] = { { -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 } };
+
+    // 中心面的第k个顶点处对角方向
+    const int CORNER_OUTWARD[4][2] = { { -1, -1 }, { -1, 1 }, { 1, 1 }, { 1, -1 } };
+
+    int getVertexCount(const Face &f)
+    {
+        return f.isQuad ? 4 : 3;
+    }
+
+    int findVertex(const Face &f, Face::Index v)
+    {
+        for(int i = 0; i < getVertexCount(f); ++i)
+        {
+            if(f.indices[i] == v)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief 构造顶点到面的邻接表，第v个顶点所属的面为vertexFaces[offsets[v], offsets[v + 1])
+     */
+    void buildVertexFaces(
+        const Mesh &mesh, std::vector<uint32_t> &offsets, std::vector<uint32_t> &vertexFaces)
+    {
+        offsets.assign(mesh.vertices.size() + 1, 0);
+        for(auto &f : mesh.faces)
+        {
+            for(int i = 0; i < getVertexCount(f); ++i)
+            {
+                ++offsets[f.indices[i] + 1];
+            }
+        }
+
+        for(size_t v = 0; v < mesh.vertices.size(); ++v)
+        {
+            offsets[v + 1] += offsets[v];
+        }
+
+        vertexFaces.resize(offsets.back());
+        std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+        for(size_t fi = 0; fi < mesh.faces.size(); ++fi)
+        {
+            auto &f = mesh.faces[fi];
+            for(int i = 0; i < getVertexCount(f); ++i)
+            {
+                vertexFaces[cursors[f.indices[i]]++] = static_cast<uint32_t>(fi);
+            }
+        }
+    }
+
+    /**
+     * @brief 收集与center共享顶点的所有面，center排在第一个
+     */
+    void collectRingFaces(
+        const Mesh &mesh, const std::vector<uint32_t> &offsets, const std::vector<uint32_t> &vertexFaces,
+        uint32_t center, std::vector<uint32_t> &ringFaces)
+    {
+        ringFaces.clear();
+        ringFaces.push_back(center);
+
+        auto &f = mesh.faces[center];
+        for(int i = 0; i < getVertexCount(f); ++i)
+        {
+            const uint32_t v = f.indices[i];
+            for(uint32_t j = offsets[v]; j < offsets[v + 1]; ++j)
+            {
+                const uint32_t neighbor = vertexFaces[j];
+                if(std::find(ringFaces.begin(), ringFaces.end(), neighbor) == ringFaces.end())
+                {
+                    ringFaces.push_back(neighbor);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 用ringFaces构造局部控制网格，并计算其包围盒
+     */
+    void buildRingMesh(const Mesh &mesh, const std::vector<uint32_t> &ringFaces, LocalPatch &patch)
+    {
+        std::vector<uint32_t> ringVertices;
+        for(auto fi : ringFaces)
+        {
+            auto &f = mesh.faces[fi];
+            ringVertices.insert(ringVertices.end(), f.indices, f.indices + getVertexCount(f));
+        }
+        std::sort(ringVertices.begin(), ringVertices.end());
+        ringVertices.erase(std::unique(ringVertices.begin(), ringVertices.end()), ringVertices.end());
+
+        patch.low  = Vec3((std::numeric_limits<float>::max)());
+        patch.high = Vec3((std::numeric_limits<float>::lowest)());
+
+        patch.mesh.vertices.resize(ringVertices.size());
+        for(size_t i = 0; i < ringVertices.size(); ++i)
+        {
+            const Vec3 &p = mesh.vertices[ringVertices[i]].position;
+            patch.mesh.vertices[i].position = p;
+
+            patch.low.x = (std::min)(patch.low.x, p.x);
+            patch.low.y = (std::min)(patch.low.y, p.y);
+            patch.low.z = (std::min)(patch.low.z, p.z);
+
+            patch.high.x = (std::max)(patch.high.x, p.x);
+            patch.high.y = (std::max)(patch.high.y, p.y);
+            patch.high.z = (std::max)(patch.high.z, p.z);
+        }
+
+        patch.mesh.faces.resize(ringFaces.size());
+        for(size_t i = 0; i < ringFaces.size(); ++i)
+        {
+            auto &f = mesh.faces[ringFaces[i]];
+            auto &newFace = patch.mesh.faces[i];
+
+            newFace.isQuad = f.isQuad;
+            for(int j = 0; j < getVertexCount(f); ++j)
+            {
+                newFace.indices[j] = static_cast<Face::Index>(
+                    std::lower_bound(ringVertices.begin(), ringVertices.end(), f.indices[j]) - ringVertices.begin());
+            }
+        }
+    }
+
+} // namespace anonymous
+
+PatchTopology::PatchTopology(const Mesh &baseMesh)
+{
+    std::unordered_map<Vec3, Face::Index> positionToVertex;
+
+    auto getVertexIndex = [&](const Vec3 &position)
+    {
+        auto it = positionToVertex.find(position);
+        if(it != positionToVertex.end())
+        {
+            return it->second;
+        }
+
+        auto ret = static_cast<Face::Index>(mesh_.vertices.size());
+        mesh_.vertices.push_back({ position });
+        positionToVertex[position] = ret;
+
+        return ret;
+    };
+
+    mesh_.faces.resize(baseMesh.faces.size());
+    for(size_t fi = 0; fi < baseMesh.faces.size(); ++fi)
+    {
+        auto &f = baseMesh.faces[fi];
+        mesh_.faces[fi].isQuad = f.isQuad;
+        for(int i = 0; i < getVertexCount(f); ++i)
+        {
+            mesh_.faces[fi].indices[i] = getVertexIndex(baseMesh.vertices[f.indices[i]].position);
+        }
+    }
+
+    buildVertexFaces(mesh_, vertexFaceOffsets_, vertexFaces_);
+}
+
+size_t PatchTopology::getFaceCount() const noexcept
+{
+    return mesh_.faces.size();
+}
+
+LocalPatch PatchTopology::extractPatch(uint32_t face) const
+{
+    std::vector<uint32_t> ringFaces;
+    collectRingFaces(mesh_, vertexFaceOffsets_, vertexFaces_, face, ringFaces);
+
+    LocalPatch patch;
+    buildRingMesh(mesh_, ringFaces, patch);
+
+    patch.baseFace = face;
+    patch.subFace  = mesh_.faces[face].isQuad ? 0 : -1;
+    patch.level    = 0;
+    return patch;
+}
+
+void PatchTopology::computePatchBounds(uint32_t face, Vec3 &low, Vec3 &high) const
+{
+    low  = Vec3((std::numeric_limits<float>::max)());
+    high = Vec3((std::numeric_limits<float>::lowest)());
+
+    auto &f = mesh_.faces[face];
+    for(int i = 0; i < getVertexCount(f); ++i)
+    {
+        const uint32_t v = f.indices[i];
+        for(uint32_t j = vertexFaceOffsets_[v]; j < vertexFaceOffsets_[v + 1]; ++j)
+        {
+            auto &neighbor = mesh_.faces[vertexFaces_[j]];
+            for(int k = 0; k < getVertexCount(neighbor); ++k)
+            {
+                const Vec3 &p = mesh_.vertices[neighbor.indices[k]].position;
+
+                low.x = (std::min)(low.x, p.x);
+                low.y = (std::min)(low.y, p.y);
+                low.z = (std::min)(low.z, p.z);
+
+                high.x = (std::max)(high.x, p.x);
+                high.y = (std::max)(high.y, p.y);
+                high.z = (std::max)(high.z, p.z);
+            }
+        }
+    }
+}
+
+int refinePatch(const LocalPatch &patch, LocalPatch children[4])
+{
+    // 局部控制网格外圈的细分结果是错误的，但中心面的子面及其1-ring只依赖于正确的部分
+
+    const Mesh refined = applyCatmullClarkSubdivision(patch.mesh, 1);
+    const int childCount = getVertexCount(patch.mesh.faces[0]);
+
+    std::vector<uint32_t> offsets, vertexFaces, ringFaces;
+    buildVertexFaces(refined, offsets, vertexFaces);
+
+    // 未细分的三角形的第k个子面即为SurfaceLocation中的第k个子面
+
+    const bool isBaseTriangle = patch.subFace < 0;
+
+    for(int k = 0; k < childCount; ++k)
+    {
+        auto &child = children[k];
+
+        collectRingFaces(refined, offsets, vertexFaces, static_cast<uint32_t>(k), ringFaces);
+        buildRingMesh(refined, ringFaces, child);
+
+        child.baseFace = patch.baseFace;
+        child.level    = patch.level + 1;
+
+        if(isBaseTriangle)
+        {
+            child.subFace = k;
+            child.frame   = getTriangleSubFaceFrame();
+        }
+        else
+        {
+            child.subFace = patch.subFace;
+            child.frame   = patch.frame.compose(getQuadChildFrame(k));
+        }
+    }
+
+    return childCount;
+}
+
+bool gatherRegularPatchPoints(const LocalPatch &patch, Vec3 points[16])
+{
+    auto &mesh = patch.mesh;
+    if(mesh.faces.size() != 9 || mesh.vertices.size() != 16)
+    {
+        return false;
+    }
+
+    for(auto &f : mesh.faces)
+    {
+        if(!f.isQuad)
+        {
+            return false;
+        }
+    }
+
+    auto &center = mesh.faces[0];
+
+    // 中心面的每个顶点都属于4个面，且这4个面围成一圈（4个相邻顶点）
+
+    for(int k = 0; k < 4; ++k)
+    {
+        const Face::Index v = center.indices[k];
+
+        int faceCount = 0;
+        Face::Index neighbors[8];
+        int neighborCount = 0;
+
+        for(auto &f : mesh.faces)
+        {
+            int i = findVertex(f, v);
+            if(i < 0)
+            {
+                continue;
+            }
+            ++faceCount;
+
+            for(Face::Index n : { f.indices[(i + 1) % 4], f.indices[(i + 3) % 4] })
+            {
+                if(std::find(neighbors, neighbors + neighborCount, n) == neighbors + neighborCount)
+                {
+                    if(neighborCount == 8)
+                    {
+                        return false;
+                    }
+                    neighbors[neighborCount++] = n;
+                }
+            }
+        }
+
+        if(faceCount != 4 || neighborCount != 4)
+        {
+            return false;
+        }
+    }
+
+    int grid[4][4];
+    for(auto &row : grid)
+    {
+        std::fill(std::begin(row), std::end(row), -1);
+    }
+
+    for(int k = 0; k < 4; ++k)
+    {
+        grid[CORNER_GRID[k][0]][CORNER_GRID[k][1]] = static_cast<int>(center.indices[k]);
+    }
+
+    for(size_t fi = 1; fi < mesh.faces.size(); ++fi)
+    {
+        auto &f = mesh.faces[fi];
+
+        for(int k = 0; k < 4; ++k)
+        {
+            const Face::Index a = center.indices[k];
+            const Face::Index b = center.indices[(k + 1) % 4];
+            const Face::Index c = center.indices[(k + 3) % 4];
+
+            const int ia = findVertex(f, a);
+            if(ia < 0)
+            {
+                continue;
+            }
+
+            const int ib = findVertex(f, b);
+            const int ic = findVertex(f, c);
+
+            if(ib >= 0)
+            {
+                // 与中心面共享边(a, b)的面，其余两个顶点位于该边外侧的一行（列）
+
+                const int ra = (f.indices[(ia + 1) % 4] == b) ? (ia + 3) % 4 : (ia + 1) % 4;
+                const int rb = (f.indices[(ib + 1) % 4] == a) ? (ib + 3) % 4 : (ib + 1) % 4;
+
+                const int *ga = CORNER_GRID[k];
+                const int *gb = CORNER_GRID[(k + 1) % 4];
+                const int *d  = EDGE_OUTWARD[k];
+
+                grid[ga[0] + d[0]][ga[1] + d[1]] = static_cast<int>(f.indices[ra]);
+                grid[gb[0] + d[0]][gb[1] + d[1]] = static_cast<int>(f.indices[rb]);
+            }
+            else if(ic < 0)
+            {
+                // 只与中心面共享顶点a的面，a的对角顶点位于网格的角上
+
+                const int *g = CORNER_GRID[k];
+                const int *d = CORNER_OUTWARD[k];
+                grid[g[0] + d[0]][g[1] + d[1]] = static_cast<int>(f.indices[(ia + 2) % 4]);
+            }
+        }
+    }
+
+    for(int i = 0; i < 4; ++i)
+    {
+        for(int j = 0; j < 4; ++j)
+        {
+            if(grid[i][j] < 0)
+            {
+                return false;
+            }
+            points[4 * i + j] = mesh.vertices[grid[i][j]].position;
+        }
+    }
+
+    return true;
+}
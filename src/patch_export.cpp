@@ -0,0 +1,63 @@
+#include <catmull_clark/patch_export.h>
+
+PatchExport exportPatches(const Mesh &baseMesh, const PatchExportOptions &options)
+{
+    LimitPatchOptions tableOptions;
+    tableOptions.isolationLevel = options.isolationLevel;
+    tableOptions.endCap         = options.endCap;
+
+    const LimitPatchTable table(baseMesh, tableOptions);
+    return exportPatches(table);
+}
+
+PatchExport exportPatches(const LimitPatchTable &table)
+{
+    PatchExport result;
+
+    size_t regularCount = 0, gregoryCount = 0;
+    for(auto &patch : table.getPatches())
+    {
+        if(patch.type == LimitPatchType::Regular)
+        {
+            ++regularCount;
+        }
+        else if(patch.type == LimitPatchType::Gregory)
+        {
+            ++gregoryCount;
+        }
+    }
+    const size_t bilinearCount = table.getPatchCount() - regularCount - gregoryCount;
+
+    result.regularPatches .reserve(regularCount);
+    result.regularPoints  .reserve(16 * regularCount);
+    result.gregoryPatches .reserve(gregoryCount);
+    result.gregoryPoints  .reserve(20 * gregoryCount);
+    result.bilinearPatches.reserve(bilinearCount);
+    result.bilinearPoints .reserve(4 * bilinearCount);
+
+    auto &points = table.getControlPoints();
+
+    for(auto &patch : table.getPatches())
+    {
+        const ExportedPatch exported = { patch.baseFace, patch.subFace, patch.level, patch.frame };
+        const Vec3 *first = &points[patch.firstPoint];
+
+        switch(patch.type)
+        {
+        case LimitPatchType::Regular:
+            result.regularPatches.push_back(exported);
+            result.regularPoints.insert(result.regularPoints.end(), first, first + 16);
+            break;
+        case LimitPatchType::Gregory:
+            result.gregoryPatches.push_back(exported);
+            result.gregoryPoints.insert(result.gregoryPoints.end(), first, first + 20);
+            break;
+        case LimitPatchType::Bilinear:
+            result.bilinearPatches.push_back(exported);
+            result.bilinearPoints.insert(result.bilinearPoints.end(), first, first + 4);
+            break;
+        }
+    }
+
+    return result;
+}
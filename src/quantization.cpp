@@ -0,0 +1,165 @@
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#include <catmull_clark/parallel.h>
+#include <catmull_clark/render_mesh.h>
+
+namespace
+{
+
+    int16_t toSnorm16(float v)
+    {
+        v = agz::math::clamp(v, -1.0f, 1.0f);
+        return static_cast<int16_t>(std::lround(v * 32767));
+    }
+
+    float fromSnorm16(int16_t v)
+    {
+        return (std::max)(v / 32767.0f, -1.0f);
+    }
+
+    float signNotZero(float v)
+    {
+        return v >= 0 ? 1.0f : -1.0f;
+    }
+
+    /**
+     * @brief 将单位向量映射到八面体展开的[-1, 1]^2上
+     */
+    Vec2 encodeOctahedral(const Vec3 &n)
+    {
+        float invL1 = 1 / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+        Vec2 p(n.x * invL1, n.y * invL1);
+
+        if(n.z < 0)
+        {
+            p = Vec2(
+                (1 - std::abs(p.y)) * signNotZero(p.x),
+                (1 - std::abs(p.x)) * signNotZero(p.y));
+        }
+
+        return p;
+    }
+
+    Vec3 decodeOctahedral(const Vec2 &p)
+    {
+        Vec3 n(p.x, p.y, 1 - std::abs(p.x) - std::abs(p.y));
+        float t = (std::max)(-n.z, 0.0f);
+        n.x += n.x >= 0 ? -t : t;
+        n.y += n.y >= 0 ? -t : t;
+        return n.normalize();
+    }
+
+    /**
+     * @brief 量化法线
+     *
+     * 在四舍五入结果附近的2x2个候选中选取解码误差最小者。
+     * 误差只有千分之几度，acos在1附近的精度不足以分辨，因此由叉积与点积求夹角
+     */
+    void quantizeNormal(const Vec3 &normal, int16_t output[2], float &angleError)
+    {
+        Vec2 p = encodeOctahedral(normal);
+
+        float bestAngle = (std::numeric_limits<float>::max)();
+        for(int i = 0; i < 4; ++i)
+        {
+            float x = (i & 1 ? std::ceil(p.x * 32767) : std::floor(p.x * 32767)) / 32767;
+            float y = (i & 2 ? std::ceil(p.y * 32767) : std::floor(p.y * 32767)) / 32767;
+
+            int16_t qx = toSnorm16(x), qy = toSnorm16(y);
+            Vec3 decoded = decodeOctahedral({ fromSnorm16(qx), fromSnorm16(qy) });
+            float angle = std::atan2(cross(decoded, normal).length(), dot(decoded, normal));
+
+            if(angle < bestAngle)
+            {
+                bestAngle = angle;
+                output[0] = qx;
+                output[1] = qy;
+            }
+        }
+
+        angleError = bestAngle;
+    }
+
+} // namespace anonymous
+
+void quantizeRenderMesh(RenderMesh &mesh)
+{
+    if(mesh.vertices.empty())
+    {
+        return;
+    }
+
+    // 统一缩放的量化空间
+
+    Vec3 low((std::numeric_limits<float>::max)());
+    Vec3 high((std::numeric_limits<float>::lowest)());
+
+    for(auto &v : mesh.vertices)
+    {
+        low.x = (std::min)(low.x, v.position.x);
+        low.y = (std::min)(low.y, v.position.y);
+        low.z = (std::min)(low.z, v.position.z);
+
+        high.x = (std::max)(high.x, v.position.x);
+        high.y = (std::max)(high.y, v.position.y);
+        high.z = (std::max)(high.z, v.position.z);
+    }
+
+    Vec3 center = 0.5f * (low + high);
+    float halfExtent = 0.5f * (high - low).max_elem();
+    if(halfExtent <= 0)
+    {
+        halfExtent = 1;
+    }
+    float invHalfExtent = 1 / halfExtent;
+
+    // 并行量化，各区间独立统计误差后再合并
+
+    mesh.quantizedVertices.resize(mesh.vertices.size());
+
+    std::mutex errorMutex;
+    float maxPositionError = 0;
+    float maxNormalError   = 0;
+
+    parallelForRange(mesh.vertices.size(), 4096, [&](size_t begin, size_t end)
+    {
+        float rangeMaxPositionError = 0;
+        float rangeMaxNormalError   = 0;
+
+        for(size_t i = begin; i < end; ++i)
+        {
+            auto &v = mesh.vertices[i];
+            auto &q = mesh.quantizedVertices[i];
+
+            Vec3 p = (v.position - center) * invHalfExtent;
+            q.position[0] = toSnorm16(p.x);
+            q.position[1] = toSnorm16(p.y);
+            q.position[2] = toSnorm16(p.z);
+            q.position[3] = 32767;
+
+            Vec3 dequantized = center + halfExtent * Vec3(
+                fromSnorm16(q.position[0]), fromSnorm16(q.position[1]), fromSnorm16(q.position[2]));
+            rangeMaxPositionError = (std::max)(rangeMaxPositionError, (dequantized - v.position).length());
+
+            float normalError;
+            quantizeNormal(v.normal, q.normal, normalError);
+            rangeMaxNormalError = (std::max)(rangeMaxNormalError, normalError);
+        }
+
+        std::lock_guard lk(errorMutex);
+        maxPositionError = (std::max)(maxPositionError, rangeMaxPositionError);
+        maxNormalError   = (std::max)(maxNormalError, rangeMaxNormalError);
+    });
+
+    QuantizationError error;
+    error.maxPositionError = maxPositionError;
+    error.maxNormalErrorDegrees = maxNormalError * 180 / agz::math::PI_f;
+
+    mesh.quantizationError = error;
+    mesh.dequantizeTransform =
+        Trans4::scale(halfExtent, halfExtent, halfExtent) * Trans4::translate(center);
+
+    std::vector<RenderVertex>().swap(mesh.vertices);
+}
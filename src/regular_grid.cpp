@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CATMULL_CLARK_SSE2
+#endif
+
+#include <catmull_clark/parallel.h>
+#include <catmull_clark/regular_grid.h>
+
+namespace
+{
+
+    /**
+     * @brief 4路浮点向量，每一路对应一个曲面片，没有SSE2时退化为标量实现
+     */
+#ifdef CATMULL_CLARK_SSE2
+
+    struct Float4
+    {
+        __m128 v;
+
+        static Float4 load(const float *input) { return { _mm_loadu_ps(input) }; }
+
+        Float4 operator+(const Float4 &rhs) const { return { _mm_add_ps(v, rhs.v) }; }
+
+        Float4 operator*(float rhs) const { return { _mm_mul_ps(v, _mm_set1_ps(rhs)) }; }
+
+        void store(float *output) const { _mm_storeu_ps(output, v); }
+    };
+
+#else
+
+    struct Float4
+    {
+        float v[4];
+
+        static Float4 load(const float *input) { return { { input[0], input[1], input[2], input[3] } }; }
+
+        Float4 operator+(const Float4 &rhs) const
+        {
+            return { { v[0] + rhs.v[0], v[1] + rhs.v[1], v[2] + rhs.v[2], v[3] + rhs.v[3] } };
+        }
+
+        Float4 operator*(float rhs) const
+        {
+            return { { v[0] * rhs, v[1] * rhs, v[2] * rhs, v[3] * rhs } };
+        }
+
+        void store(float *output) const
+        {
+            for(int i = 0; i < 4; ++i)
+            {
+                output[i] = v[i];
+            }
+        }
+    };
+
+#endif
+
+    constexpr int BATCH_SIZE = 4;
+
+    void checkLevel(int level)
+    {
+        if(level < 0 || level > MAX_REGULAR_GRID_LEVEL)
+        {
+            throw std::runtime_error("refineRegularPatches: unsupported level " + std::to_string(level));
+        }
+    }
+
+    /**
+     * @brief 细分一组曲面片，只写出前count个的结果，其余各路由调用者以任意有效的控制点填充
+     */
+    template<int Level>
+    void refineBatch(const Vec3 *const patches[BATCH_SIZE], const RegularGridTarget *const targets[BATCH_SIZE], int count)
+    {
+        constexpr int SIZE = RegularGridWeights<Level>::SIZE;
+        constexpr auto &W = RegularGridWeights<Level>::WEIGHTS;
+
+        // 转置为SoA：control[c][i]的第p路为第p个曲面片第i个控制点的第c个分量
+
+        Float4 control[3][16];
+        for(int i = 0; i < 16; ++i)
+        {
+            float lanes[3][BATCH_SIZE];
+            for(int p = 0; p < BATCH_SIZE; ++p)
+            {
+                const Vec3 &point = patches[p][i];
+                lanes[0][p] = point.x;
+                lanes[1][p] = point.y;
+                lanes[2][p] = point.z;
+            }
+
+            for(int c = 0; c < 3; ++c)
+            {
+                control[c][i] = Float4::load(lanes[c]);
+            }
+        }
+
+        // 先细分4行控制点，每行得到SIZE个点
+
+        Float4 rows[3][4][SIZE];
+        for(int c = 0; c < 3; ++c)
+        {
+            for(int r = 0; r < 4; ++r)
+            {
+                const Float4 *row = &control[c][4 * r];
+                for(int j = 0; j < SIZE; ++j)
+                {
+                    rows[c][r][j] = row[0] * W[j][0] + row[1] * W[j][1] + row[2] * W[j][2] + row[3] * W[j][3];
+                }
+            }
+        }
+
+        // 再细分每一列，逐点写出
+
+        for(int i = 0; i < SIZE; ++i)
+        {
+            const float w0 = W[i][0], w1 = W[i][1], w2 = W[i][2], w3 = W[i][3];
+
+            for(int j = 0; j < SIZE; ++j)
+            {
+                float lanes[3][BATCH_SIZE];
+                for(int c = 0; c < 3; ++c)
+                {
+                    const Float4 v = rows[c][0][j] * w0 + rows[c][1][j] * w1
+                                   + rows[c][2][j] * w2 + rows[c][3][j] * w3;
+                    v.store(lanes[c]);
+                }
+
+                for(int p = 0; p < count; ++p)
+                {
+                    auto &target = *targets[p];
+                    target.origin[i * target.stepT + j * target.stepS] = Vec3(lanes[0][p], lanes[1][p], lanes[2][p]);
+                }
+            }
+        }
+    }
+
+    using BatchFunc = void(*)(const Vec3 *const[BATCH_SIZE], const RegularGridTarget *const[BATCH_SIZE], int);
+
+    const BatchFunc BATCH_FUNCS[MAX_REGULAR_GRID_LEVEL + 1] = {
+        &refineBatch<0>,
+        &refineBatch<1>,
+        &refineBatch<2>,
+        &refineBatch<3>,
+        &refineBatch<4>,
+        &refineBatch<5>,
+        &refineBatch<6>
+    };
+
+} // namespace anonymous
+
+void refineRegularPatches(
+    const Vec3 *controlPoints, size_t patchCount, int level, const RegularGridTarget *targets)
+{
+    checkLevel(level);
+
+    const BatchFunc func = BATCH_FUNCS[level];
+    const size_t batchCount = (patchCount + BATCH_SIZE - 1) / BATCH_SIZE;
+
+    parallelForRange(batchCount, 16, [&](size_t begin, size_t end)
+    {
+        for(size_t batch = begin; batch < end; ++batch)
+        {
+            const size_t first = batch * BATCH_SIZE;
+            const int count = static_cast<int>((std::min)(patchCount - first, static_cast<size_t>(BATCH_SIZE)));
+
+            const Vec3 *patches[BATCH_SIZE];
+            const RegularGridTarget *batchTargets[BATCH_SIZE];
+            for(int p = 0; p < BATCH_SIZE; ++p)
+            {
+                const size_t i = first + (p < count ? p : 0);
+                patches[p]      = controlPoints + 16 * i;
+                batchTargets[p] = targets + i;
+            }
+
+            func(patches, batchTargets, count);
+        }
+    });
+}
+
+void refineRegularPatches(
+    const Vec3 *controlPoints, size_t patchCount, int level, Vec3 *grids)
+{
+    checkLevel(level);
+    const int size = getRegularGridSize(level);
+
+    std::vector<RegularGridTarget> targets(patchCount);
+    for(size_t i = 0; i < patchCount; ++i)
+    {
+        targets[i] = { grids + i * size * size, 1, size };
+    }
+
+    refineRegularPatches(controlPoints, patchCount, level, targets.data());
+}
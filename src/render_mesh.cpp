@@ -0,0 +1,363 @@
+#include <cmath>
+
+#include <catmull_clark/mesh_optimizer.h>
+#include <catmull_clark/parallel.h>
+#include <catmull_clark/render_mesh.h>
+
+namespace
+{
+
+    /**
+     * @brief 顶点所在的一个面角
+     */
+    struct Corner
+    {
+        Face::Index face;
+        int corner;
+    };
+
+    /**
+     * @brief 顶点到其所在各面角的压缩邻接表
+     *
+     * 顶点i的面角为corners[offsets[i], offsets[i + 1])
+     */
+    struct VertexCorners
+    {
+        std::vector<uint32_t> offsets;
+        std::vector<Corner>   corners;
+    };
+
+    VertexCorners buildVertexCorners(const Mesh &mesh)
+    {
+        VertexCorners result;
+        result.offsets.assign(mesh.vertices.size() + 1, 0);
+
+        for(auto &f : mesh.faces)
+        {
+            int vertexCount = f.isQuad ? 4 : 3;
+            for(int i = 0; i < vertexCount; ++i)
+            {
+                ++result.offsets[f.indices[i] + 1];
+            }
+        }
+
+        for(size_t i = 1; i < result.offsets.size(); ++i)
+        {
+            result.offsets[i] += result.offsets[i - 1];
+        }
+
+        std::vector<uint32_t> cursor(result.offsets.begin(), result.offsets.end() - 1);
+        result.corners.resize(result.offsets.back());
+
+        for(size_t fi = 0; fi < mesh.faces.size(); ++fi)
+        {
+            auto &f = mesh.faces[fi];
+            int vertexCount = f.isQuad ? 4 : 3;
+            for(int i = 0; i < vertexCount; ++i)
+            {
+                result.corners[cursor[f.indices[i]]++] = { static_cast<Face::Index>(fi), i };
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief 面的法线，长度为面积的两倍
+     */
+    Vec3 faceAreaNormal(const Mesh &mesh, const Face &f)
+    {
+        auto &v0 = mesh.vertices[f.indices[0]].position;
+        auto &v1 = mesh.vertices[f.indices[1]].position;
+        auto &v2 = mesh.vertices[f.indices[2]].position;
+
+        if(f.isQuad)
+        {
+            auto &v3 = mesh.vertices[f.indices[3]].position;
+            return cross(v2 - v0, v3 - v1);
+        }
+        return cross(v1 - v0, v2 - v0);
+    }
+
+    Vec3 areaWeightedNormal(const Mesh &mesh, const Corner *begin, const Corner *end)
+    {
+        Vec3 sum;
+        for(auto c = begin; c != end; ++c)
+        {
+            sum += faceAreaNormal(mesh, mesh.faces[c->face]);
+        }
+        return sum;
+    }
+
+    Vec3 angleWeightedNormal(const Mesh &mesh, const Corner *begin, const Corner *end)
+    {
+        Vec3 sum;
+        for(auto c = begin; c != end; ++c)
+        {
+            auto &f = mesh.faces[c->face];
+            int vertexCount = f.isQuad ? 4 : 3;
+
+            Vec3 nor = faceAreaNormal(mesh, f);
+            float len = nor.length();
+            if(len <= 0)
+            {
+                continue;
+            }
+
+            auto &v    = mesh.vertices[f.indices[c->corner]].position;
+            auto &prev = mesh.vertices[f.indices[(c->corner + vertexCount - 1) % vertexCount]].position;
+            auto &next = mesh.vertices[f.indices[(c->corner + 1) % vertexCount]].position;
+
+            Vec3 a = prev - v, b = next - v;
+            float angle = std::atan2(cross(a, b).length(), dot(a, b));
+
+            sum += (angle / len) * nor;
+        }
+        return sum;
+    }
+
+    /**
+     * @brief 计算顶点处Catmull-Clark极限曲面的法线
+     *
+     * 要求顶点被n个四边形以一致的朝向围成一圈，否则返回false
+     */
+    bool limitNormal(const Mesh &mesh, const Corner *begin, const Corner *end, Vec3 &output)
+    {
+        constexpr int MAX_VALENCE = 32;
+
+        int n = static_cast<int>(end - begin);
+        if(n < 3 || n > MAX_VALENCE)
+        {
+            return false;
+        }
+
+        for(auto c = begin; c != end; ++c)
+        {
+            if(!mesh.faces[c->face].isQuad)
+            {
+                return false;
+            }
+        }
+
+        auto cornerVertex = [&](const Corner &c, int offset)
+        {
+            return mesh.faces[c.face].indices[(c.corner + offset) % 4];
+        };
+
+        // 将面角排成一圈：下一个面角的prev顶点为当前面角的next顶点
+
+        int order[MAX_VALENCE];
+        bool used[MAX_VALENCE] = { };
+
+        order[0] = 0;
+        used[0] = true;
+
+        for(int i = 1; i < n; ++i)
+        {
+            auto next = cornerVertex(begin[order[i - 1]], 1);
+
+            int found = -1;
+            for(int j = 0; j < n; ++j)
+            {
+                if(!used[j] && cornerVertex(begin[j], 3) == next)
+                {
+                    found = j;
+                    break;
+                }
+            }
+
+            if(found < 0)
+            {
+                return false;
+            }
+
+            order[i] = found;
+            used[found] = true;
+        }
+
+        if(cornerVertex(begin[order[0]], 3) != cornerVertex(begin[order[n - 1]], 1))
+        {
+            return false;
+        }
+
+        // e_i为第i个面角的next顶点，f_i为e_i与e_{i+1}之间的对角顶点
+
+        const float twoPi = 2 * agz::math::PI_f;
+        const float cos2PiN = std::cos(twoPi / n);
+        const float A = 1 + cos2PiN + std::cos(twoPi / (2 * n)) * std::sqrt(2 * (9 + cos2PiN));
+
+        Vec3 tangentU, tangentV;
+        for(int i = 0; i < n; ++i)
+        {
+            auto &e = mesh.vertices[cornerVertex(begin[order[i]], 1)].position;
+            auto &f = mesh.vertices[cornerVertex(begin[order[(i + 1) % n]], 2)].position;
+
+            float c0 = std::cos(twoPi * i / n), c1 = std::cos(twoPi * (i + 1) / n);
+            float s0 = std::sin(twoPi * i / n), s1 = std::sin(twoPi * (i + 1) / n);
+
+            tangentU += A * c0 * e + (c0 + c1) * f;
+            tangentV += A * s0 * e + (s0 + s1) * f;
+        }
+
+        Vec3 nor = cross(tangentU, tangentV);
+        if(dot(nor, areaWeightedNormal(mesh, begin, end)) < 0)
+        {
+            nor = -nor;
+        }
+
+        output = nor;
+        return true;
+    }
+
+    /**
+     * @brief 将三角形列表写入合适位宽的索引缓冲
+     */
+    template<typename Index>
+    void fillTriangleIndices(const Mesh &mesh, std::vector<Index> &indices)
+    {
+        indices.reserve(6 * mesh.faces.size());
+
+        for(auto &f : mesh.faces)
+        {
+            indices.push_back(static_cast<Index>(f.indices[0]));
+            indices.push_back(static_cast<Index>(f.indices[1]));
+            indices.push_back(static_cast<Index>(f.indices[2]));
+
+            if(f.isQuad)
+            {
+                indices.push_back(static_cast<Index>(f.indices[0]));
+                indices.push_back(static_cast<Index>(f.indices[2]));
+                indices.push_back(static_cast<Index>(f.indices[3]));
+            }
+        }
+    }
+
+    /**
+     * @brief 将边表并行写入线段列表索引缓冲
+     */
+    template<typename Index>
+    void fillLineIndices(const std::vector<Edge> &edges, std::vector<Index> &indices)
+    {
+        indices.resize(2 * edges.size());
+
+        parallelFor(edges.size(), [&](size_t i)
+        {
+            indices[2 * i]     = static_cast<Index>(edges[i].vertices[0]);
+            indices[2 * i + 1] = static_cast<Index>(edges[i].vertices[1]);
+        });
+    }
+
+    RenderMesh buildRenderMeshImpl(
+        const Mesh &mesh, const std::vector<Edge> *edges, const RenderMeshOptions &options)
+    {
+        RenderMesh renderMesh;
+
+        // 顶点位置与法线
+
+        renderMesh.vertices.resize(mesh.vertices.size());
+        for(size_t i = 0; i < mesh.vertices.size(); ++i)
+        {
+            renderMesh.vertices[i].position = mesh.vertices[i].position;
+        }
+
+        computeVertexNormals(mesh, options.normalWeighting, renderMesh.vertices.data());
+
+        // 索引
+
+        for(auto &f : mesh.faces)
+        {
+            if(f.isQuad)
+            {
+                ++renderMesh.quadCount;
+            }
+            else
+            {
+                ++renderMesh.triangleCount;
+            }
+        }
+
+        if(mesh.vertices.size() <= 65536)
+        {
+            fillTriangleIndices(mesh, renderMesh.indices16);
+        }
+        else
+        {
+            fillTriangleIndices(mesh, renderMesh.indices32);
+        }
+
+        if(options.buildClusters)
+        {
+            renderMesh.clusters = buildClusters(mesh, options.clusterLimits);
+        }
+
+        if(edges)
+        {
+            if(renderMesh.isIndex16())
+            {
+                fillLineIndices(*edges, renderMesh.lineIndices16);
+            }
+            else
+            {
+                fillLineIndices(*edges, renderMesh.lineIndices32);
+            }
+        }
+
+        if(options.optimizeIndices)
+        {
+            optimizeRenderMesh(renderMesh);
+        }
+
+        if(options.quantize)
+        {
+            quantizeRenderMesh(renderMesh);
+        }
+
+        return renderMesh;
+    }
+
+} // namespace anonymous
+
+void computeVertexNormals(
+    const Mesh &mesh, NormalWeighting weighting, RenderVertex *vertices)
+{
+    // 以顶点为单位收集法线，各线程只写入自己负责的顶点，无需同步
+
+    VertexCorners vertexCorners = buildVertexCorners(mesh);
+
+    parallelFor(mesh.vertices.size(), [&](size_t i)
+    {
+        const Corner *begin = vertexCorners.corners.data() + vertexCorners.offsets[i];
+        const Corner *end   = vertexCorners.corners.data() + vertexCorners.offsets[i + 1];
+
+        Vec3 nor;
+        switch(weighting)
+        {
+        case NormalWeighting::Angle:
+            nor = angleWeightedNormal(mesh, begin, end);
+            break;
+        case NormalWeighting::Limit:
+            if(!limitNormal(mesh, begin, end, nor))
+            {
+                nor = areaWeightedNormal(mesh, begin, end);
+            }
+            break;
+        default:
+            nor = areaWeightedNormal(mesh, begin, end);
+            break;
+        }
+
+        float len = nor.length();
+        vertices[i].normal = len > 0 ? nor / len : Vec3(0, 1, 0);
+    });
+}
+
+RenderMesh buildRenderMesh(const Mesh &mesh, const RenderMeshOptions &options)
+{
+    return buildRenderMeshImpl(mesh, nullptr, options);
+}
+
+RenderMesh buildRenderMesh(
+    const Mesh &mesh, const std::vector<Edge> &edges, const RenderMeshOptions &options)
+{
+    return buildRenderMeshImpl(mesh, &edges, options);
+}
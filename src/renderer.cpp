@@ -1,3 +1,6 @@
+#include <cstring>
+#include <stdexcept>
+
 #include <catmull_clark/renderer.h>
 
 namespace
@@ -49,6 +52,43 @@ float4 main(PSInput input) : SV_TARGET
     lightFactor = pow(lightFactor, 1 / 1.4);
     return float4(lightFactor, lightFactor, lightFactor, 1);
 };
+)___";
+
+    const char *QUANTIZED_SOLID_VERTEX_SHADER_SOURCE = R"___(
+cbuffer Transform
+{
+    float4x4 WVP;
+    float4x4 World;
+};
+
+struct VSInput
+{
+    float4 position : POSITION;
+    float2 normal   : NORMAL;
+};
+
+struct VSOutput
+{
+    float4 position : SV_POSITION;
+    float3 normal   : NORMAL;
+};
+
+float3 decodeOctahedral(float2 p)
+{
+    float3 n = float3(p.x, p.y, 1 - abs(p.x) - abs(p.y));
+    float t = saturate(-n.z);
+    n.x += n.x >= 0 ? -t : t;
+    n.y += n.y >= 0 ? -t : t;
+    return normalize(n);
+}
+
+VSOutput main(VSInput input)
+{
+    VSOutput output = (VSOutput)0;
+    output.position = mul(float4(input.position.xyz, 1), WVP);
+    output.normal   = mul(float4(decodeOctahedral(input.normal), 0), World);
+    return output;
+}
 )___";
 
     const char *WIREFRAME_VERTEX_SHADER_SOURCE = R"___(
@@ -98,6 +138,13 @@ Renderer::Renderer()
         throw std::runtime_error("failed to initialize renderer solid shader");
     }
 
+    quantizedSolidShader_.InitializeStage<D3D::SS_VS>(QUANTIZED_SOLID_VERTEX_SHADER_SOURCE);
+    quantizedSolidShader_.InitializeStage<D3D::SS_PS>(SOLID_PIXEL_SHADER_SOURCE);
+    if(!quantizedSolidShader_.IsAllStagesAvailable())
+    {
+        throw std::runtime_error("failed to initialize renderer quantized solid shader");
+    }
+
     wireframeShader_.InitializeStage<D3D::SS_VS>(WIREFRAME_VERTEX_SHADER_SOURCE);
     wireframeShader_.InitializeStage<D3D::SS_PS>(WIREFRAME_PIXEL_SHADER_SOURCE);
     if(!wireframeShader_.IsAllStagesAvailable())
@@ -105,21 +152,32 @@ Renderer::Renderer()
         throw std::runtime_error("failed to initialize renderer wireframe shader");
     }
 
-    solidUniforms_     = solidShader_.CreateUniformManager();
-    wireframeUniforms_ = wireframeShader_.CreateUniformManager();
+    solidUniforms_          = solidShader_.CreateUniformManager();
+    quantizedSolidUniforms_ = quantizedSolidShader_.CreateUniformManager();
+    wireframeUniforms_      = wireframeShader_.CreateUniformManager();
 
     solidInputLayout_ = D3D::InputLayoutBuilder
-        ("POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(SolidVertex, position))
-        ("NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(SolidVertex, normal))
+        ("POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(RenderVertex, position))
+        ("NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(RenderVertex, normal))
         .Build(solidShader_);
     wireframeInputLayout_ = D3D::InputLayoutBuilder
-        ("POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0)
+        ("POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(RenderVertex, position))
+        .Build(wireframeShader_);
+
+    quantizedSolidInputLayout_ = D3D::InputLayoutBuilder
+        ("POSITION", 0, DXGI_FORMAT_R16G16B16A16_SNORM, offsetof(QuantizedRenderVertex, position))
+        ("NORMAL",   0, DXGI_FORMAT_R16G16_SNORM,       offsetof(QuantizedRenderVertex, normal))
+        .Build(quantizedSolidShader_);
+    quantizedWireframeInputLayout_ = D3D::InputLayoutBuilder
+        ("POSITION", 0, DXGI_FORMAT_R16G16B16A16_SNORM, offsetof(QuantizedRenderVertex, position))
         .Build(wireframeShader_);
 
     solidVSTransform_.Initialize(true, nullptr);
     solidPSLight_    .Initialize(true, nullptr);
     solidUniforms_.GetConstantBufferSlot<D3D::SS_VS>("Transform")->SetBuffer(solidVSTransform_);
     solidUniforms_.GetConstantBufferSlot<D3D::SS_PS>("Light")->SetBuffer(solidPSLight_);
+    quantizedSolidUniforms_.GetConstantBufferSlot<D3D::SS_VS>("Transform")->SetBuffer(solidVSTransform_);
+    quantizedSolidUniforms_.GetConstantBufferSlot<D3D::SS_PS>("Light")->SetBuffer(solidPSLight_);
 
     wireframeVSTransform_.Initialize(true, nullptr);
     wireframeUniforms_.GetConstantBufferSlot<D3D::SS_VS>("Transform")->SetBuffer(wireframeVSTransform_);
@@ -129,127 +187,89 @@ Renderer::Renderer()
     wireframeRasterizerState_.Initialize(D3D11_FILL_WIREFRAME, D3D11_CULL_NONE, false);
 }
 
-void Renderer::setMesh(const Mesh &mesh)
+void Renderer::setMesh(
+    const Mesh &mesh, const std::vector<Edge> &edges, const RenderMeshOptions &options)
 {
-    vertexCount_   = 0;
-    edgeCount_     = 0;
-    triangleCount_ = 0;
-    quadCount_     = 0;
-
-    // triangles
-
-    std::vector<SolidVertex> vertex_data;
-    for(auto &f : mesh.faces)
+    if(canUpdateVertices(mesh, edges, options))
     {
-        if(f.isQuad)
-        {
-            auto &v0 = mesh.vertices[f.indices[0]].position;
-            auto &v1 = mesh.vertices[f.indices[1]].position;
-            auto &v2 = mesh.vertices[f.indices[2]].position;
-            auto &v3 = mesh.vertices[f.indices[3]].position;
-
-            Vec3 nor0 = cross(v1 - v0, v2 - v1).normalize();
-            Vec3 nor1 = cross(v2 - v0, v3 - v2).normalize();
-            Vec3 nor = (nor0 + nor1).normalize();
-
-            vertex_data.push_back({ v0, nor });
-            vertex_data.push_back({ v1, nor });
-            vertex_data.push_back({ v2, nor });
+        updateVertices(mesh);
+        return;
+    }
 
-            vertex_data.push_back({ v0, nor });
-            vertex_data.push_back({ v2, nor });
-            vertex_data.push_back({ v3, nor });
+    RenderMesh renderMesh = buildRenderMesh(mesh, edges, options);
 
-            ++quadCount_;
-        }
-        else
-        {
-            auto &v0 = mesh.vertices[f.indices[0]].position;
-            auto &v1 = mesh.vertices[f.indices[1]].position;
-            auto &v2 = mesh.vertices[f.indices[2]].position;
+    vertexCount_   = static_cast<int>(renderMesh.getVertexCount());
+    edgeCount_     = static_cast<int>(edges.size());
+    triangleCount_ = renderMesh.triangleCount;
+    quadCount_     = renderMesh.quadCount;
 
-            Vec3 nor = cross(v1 - v0, v2 - v1).normalize();
+    vertexCacheStatistics_ = analyzeVertexCache(renderMesh);
+    quantizationError_     = renderMesh.quantizationError;
 
-            vertex_data.push_back({ v0, nor });
-            vertex_data.push_back({ v1, nor });
-            vertex_data.push_back({ v2, nor });
-
-            ++triangleCount_;
-        }
+    renderMeshOptions_ = options;
+    if(renderMesh.isQuantized())
+    {
+        vertexStream_.clear();
+    }
+    else
+    {
+        vertexStream_.reset(mesh, renderMesh, options.normalWeighting);
     }
 
-    solidBuffer_.Destroy();
-    solidBuffer_.Initialize(UINT(vertex_data.size()), false, vertex_data.data());
-
-    // wireframe
+    clusters_ = std::move(renderMesh.clusters);
+    visibleClusters_.clear();
 
-    std::vector<Vec3> vertices;
-    std::unordered_map<Vec3, int> positionToVertex;
-    std::unordered_set<Vec2i> isEdgeAdded;
+    solidBuffer_.Destroy();
+    quantizedBuffer_.Destroy();
+    solidIndexBuffer16_.Destroy();
+    solidIndexBuffer32_.Destroy();
+    wireframeIndexBuffer16_.Destroy();
+    wireframeIndexBuffer32_.Destroy();
 
-    std::vector<Vec3> wireframeData;
+    vertexTransform_ = renderMesh.isQuantized() ? renderMesh.dequantizeTransform : Mat4();
+    updateTransforms();
 
-    auto getVertexIndex = [&](const Vec3 &pos)
+    if(!renderMesh.getIndexCount())
     {
-        auto it = positionToVertex.find(pos);
-        if(it != positionToVertex.end())
-        {
-            return it->second;
-        }
-
-        int ret = static_cast<int>(vertices.size());
-        vertices.push_back(pos);
-        positionToVertex[pos] = ret;
+        vertexStream_.clear();
+        return;
+    }
 
-        return ret;
-    };
+    // 实体与线框模式共享同一个顶点缓冲。未量化的顶点缓冲是动态的，以便只有顶点变化时直接改写
 
-    auto addEdge = [&](int v0, int v1)
+    if(renderMesh.isQuantized())
     {
-        if(v0 > v1)
-        {
-            std::swap(v0, v1);
-        }
-
-        if(isEdgeAdded.find({ v0, v1 }) != isEdgeAdded.end())
-            return;
-
-        isEdgeAdded.insert({ v0, v1 });
-        wireframeData.push_back(vertices[v0]);
-        wireframeData.push_back(vertices[v1]);
-    };
+        quantizedBuffer_.Initialize(
+            UINT(renderMesh.quantizedVertices.size()), false, renderMesh.quantizedVertices.data());
+    }
+    else
+    {
+        solidBuffer_.Initialize(
+            UINT(renderMesh.vertices.size()), true, renderMesh.vertices.data());
+    }
 
-    for(auto &f : mesh.faces)
+    if(renderMesh.isIndex16())
     {
-        if(f.isQuad)
+        solidIndexBuffer16_.Initialize(
+            UINT(renderMesh.indices16.size()), false, renderMesh.indices16.data());
+
+        if(renderMesh.getLineIndexCount())
         {
-            int a = getVertexIndex(mesh.vertices[f.indices[0]].position);
-            int b = getVertexIndex(mesh.vertices[f.indices[1]].position);
-            int c = getVertexIndex(mesh.vertices[f.indices[2]].position);
-            int d = getVertexIndex(mesh.vertices[f.indices[3]].position);
-
-            addEdge(a, b);
-            addEdge(b, c);
-            addEdge(c, d);
-            addEdge(d, a);
+            wireframeIndexBuffer16_.Initialize(
+                UINT(renderMesh.lineIndices16.size()), false, renderMesh.lineIndices16.data());
         }
-        else
-        {
-            int a = getVertexIndex(mesh.vertices[f.indices[0]].position);
-            int b = getVertexIndex(mesh.vertices[f.indices[1]].position);
-            int c = getVertexIndex(mesh.vertices[f.indices[2]].position);
+    }
+    else
+    {
+        solidIndexBuffer32_.Initialize(
+            UINT(renderMesh.indices32.size()), false, renderMesh.indices32.data());
 
-            addEdge(a, b);
-            addEdge(b, c);
-            addEdge(c, a);
+        if(renderMesh.getLineIndexCount())
+        {
+            wireframeIndexBuffer32_.Initialize(
+                UINT(renderMesh.lineIndices32.size()), false, renderMesh.lineIndices32.data());
         }
     }
-
-    wireframeBuffer_.Destroy();
-    wireframeBuffer_.Initialize(UINT(wireframeData.size()), false, wireframeData.data());
-
-    vertexCount_ = static_cast<int>(vertices.size());
-    edgeCount_   = static_cast<int>(isEdgeAdded.size());
 }
 
 void Renderer::setLightDir(const Vec3 &lightDir)
@@ -259,20 +279,19 @@ void Renderer::setLightDir(const Vec3 &lightDir)
 
 void Renderer::setWorldTransform(const Mat4 &world)
 {
-    Mat4 wvp = world * viewProj_;
-
     world_ = world;
-    solidVSTransform_.SetValue({ wvp, world_ });
-    wireframeVSTransform_.SetValue({ wvp });
+    updateTransforms();
 }
 
 void Renderer::setCameraViewProj(const Mat4 &viewProj)
 {
-    Mat4 wvp = world_ * viewProj;
-
     viewProj_ = viewProj;
-    solidVSTransform_.SetValue({ wvp, world_ });
-    wireframeVSTransform_.SetValue({ wvp });
+    updateTransforms();
+}
+
+void Renderer::setCameraPosition(const Vec3 &position)
+{
+    cameraPosition_ = position;
 }
 
 void Renderer::setWireframe(bool wireframe)
@@ -282,47 +301,61 @@ void Renderer::setWireframe(bool wireframe)
 
 void Renderer::render()
 {
+    bool quantized = quantizedBuffer_.IsAvailable();
+    if(!quantized && !solidBuffer_.IsAvailable())
+    {
+        return;
+    }
+
     if(wireframe_)
     {
-        if(!wireframeBuffer_.IsAvailable())
+        if(!wireframeIndexBuffer16_.IsAvailable() && !wireframeIndexBuffer32_.IsAvailable())
         {
             return;
         }
 
+        auto &inputLayout = quantized ? quantizedWireframeInputLayout_ : wireframeInputLayout_;
+
         wireframeShader_         .Bind();
         wireframeUniforms_       .Bind();
-        wireframeInputLayout_    .Bind();
+        inputLayout              .Bind();
         wireframeRasterizerState_.Bind();
-        wireframeBuffer_         .Bind(0);
+        bindVertexBuffer();
 
-        D3D::RenderState::Draw(D3D11_PRIMITIVE_TOPOLOGY_LINELIST, wireframeBuffer_.GetVertexCount());
+        drawIndexed(D3D11_PRIMITIVE_TOPOLOGY_LINELIST, wireframeIndexBuffer16_, wireframeIndexBuffer32_);
 
-        wireframeBuffer_         .Unbind(0);
+        unbindVertexBuffer();
         wireframeRasterizerState_.Unbind();
-        wireframeInputLayout_    .Unbind();
+        inputLayout              .Unbind();
         wireframeUniforms_       .Unbind();
         wireframeShader_         .Unbind();
     }
     else
     {
-        if(!solidBuffer_.IsAvailable())
-        {
-            return;
-        }
+        auto &shader      = quantized ? quantizedSolidShader_      : solidShader_;
+        auto &uniforms    = quantized ? quantizedSolidUniforms_    : solidUniforms_;
+        auto &inputLayout = quantized ? quantizedSolidInputLayout_ : solidInputLayout_;
 
-        solidShader_         .Bind();
-        solidUniforms_       .Bind();
-        solidInputLayout_    .Bind();
+        shader               .Bind();
+        uniforms             .Bind();
+        inputLayout          .Bind();
         solidRasterizerState_.Bind();
-        solidBuffer_         .Bind(0);
+        bindVertexBuffer();
 
-        D3D::RenderState::Draw(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, solidBuffer_.GetVertexCount());
+        if(clusters_.empty())
+        {
+            drawIndexed(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, solidIndexBuffer16_, solidIndexBuffer32_);
+        }
+        else
+        {
+            drawVisibleClusters();
+        }
 
-        solidBuffer_         .Unbind(0);
+        unbindVertexBuffer();
         solidRasterizerState_.Unbind();
-        solidInputLayout_    .Unbind();
-        solidUniforms_       .Unbind();
-        solidShader_         .Unbind();
+        inputLayout          .Unbind();
+        uniforms             .Unbind();
+        shader               .Unbind();
     }
 }
 
@@ -345,3 +378,172 @@ int Renderer::getQuadCount() const noexcept
 {
     return quadCount_;
 }
+
+const VertexCacheStatistics &Renderer::getVertexCacheStatistics() const noexcept
+{
+    return vertexCacheStatistics_;
+}
+
+const QuantizationError &Renderer::getQuantizationError() const noexcept
+{
+    return quantizationError_;
+}
+
+int Renderer::getClusterCount() const noexcept
+{
+    return static_cast<int>(clusters_.size());
+}
+
+int Renderer::getVisibleClusterCount() const noexcept
+{
+    return static_cast<int>(visibleClusters_.size());
+}
+
+bool Renderer::canUpdateVertices(
+    const Mesh &mesh, const std::vector<Edge> &edges, const RenderMeshOptions &options) const
+{
+    // 线框索引由边表决定；边表由面唯一确定，因此只需比较边数
+
+    if(!solidBuffer_.IsAvailable() || options.quantize || edges.size() != static_cast<size_t>(edgeCount_))
+    {
+        return false;
+    }
+
+    auto &last = renderMeshOptions_;
+    if(options.normalWeighting != last.normalWeighting ||
+       options.optimizeIndices != last.optimizeIndices ||
+       options.buildClusters   != last.buildClusters   ||
+       options.clusterLimits.maxVertices  != last.clusterLimits.maxVertices ||
+       options.clusterLimits.maxTriangles != last.clusterLimits.maxTriangles)
+    {
+        return false;
+    }
+
+    return vertexStream_.isCompatible(mesh);
+}
+
+void Renderer::updateVertices(const Mesh &mesh)
+{
+    VertexRange dirty = vertexStream_.update(mesh);
+
+    if(!clusters_.empty())
+    {
+        updateClusterBounds(mesh, clusters_);
+    }
+
+    if(dirty.empty())
+    {
+        return;
+    }
+
+    // 以WRITE_DISCARD映射时必须写入整个缓冲，暂存数组中保存着完整的顶点数据
+
+    auto &vertices = vertexStream_.getVertices();
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    if(FAILED(D3D::gDeviceContext->Map(solidBuffer_.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource)))
+    {
+        throw std::runtime_error("failed to map vertex buffer");
+    }
+    std::memcpy(mappedResource.pData, vertices.data(), sizeof(RenderVertex) * vertices.size());
+    D3D::gDeviceContext->Unmap(solidBuffer_.Get(), 0);
+}
+
+void Renderer::updateTransforms()
+{
+    Mat4 world = vertexTransform_ * world_;
+    Mat4 wvp   = world * viewProj_;
+
+    solidVSTransform_.SetValue({ wvp, world });
+    wireframeVSTransform_.SetValue({ wvp });
+}
+
+void Renderer::bindVertexBuffer()
+{
+    if(quantizedBuffer_.IsAvailable())
+    {
+        quantizedBuffer_.Bind(0);
+    }
+    else
+    {
+        solidBuffer_.Bind(0);
+    }
+}
+
+void Renderer::unbindVertexBuffer()
+{
+    if(quantizedBuffer_.IsAvailable())
+    {
+        quantizedBuffer_.Unbind(0);
+    }
+    else
+    {
+        solidBuffer_.Unbind(0);
+    }
+}
+
+void Renderer::drawIndexed(
+    D3D11_PRIMITIVE_TOPOLOGY topology,
+    const D3D::IndexBuffer<uint16_t> &indices16,
+    const D3D::IndexBuffer<uint32_t> &indices32)
+{
+    if(indices16.IsAvailable())
+    {
+        indices16.Bind();
+        D3D::RenderState::DrawIndexed(topology, indices16.GetIndexCount());
+        indices16.Unbind();
+    }
+    else if(indices32.IsAvailable())
+    {
+        indices32.Bind();
+        D3D::RenderState::DrawIndexed(topology, indices32.GetIndexCount());
+        indices32.Unbind();
+    }
+}
+
+void Renderer::drawVisibleClusters()
+{
+    // 簇的包围体位于模型空间，与量化无关，因此不包含vertexTransform_
+
+    cullClusters(clusters_, world_, viewProj_, cameraPosition_, visibleClusters_);
+    if(visibleClusters_.empty())
+    {
+        return;
+    }
+
+    if(solidIndexBuffer16_.IsAvailable())
+    {
+        solidIndexBuffer16_.Bind();
+    }
+    else
+    {
+        solidIndexBuffer32_.Bind();
+    }
+
+    D3D::gDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+    uint32_t rangeBegin = clusters_[visibleClusters_[0]].indexOffset;
+    uint32_t rangeEnd   = rangeBegin;
+
+    for(auto ci : visibleClusters_)
+    {
+        auto &cluster = clusters_[ci];
+        if(cluster.indexOffset != rangeEnd)
+        {
+            D3D::gDeviceContext->DrawIndexed(rangeEnd - rangeBegin, rangeBegin, 0);
+            rangeBegin = cluster.indexOffset;
+        }
+        rangeEnd = cluster.indexOffset + cluster.indexCount;
+    }
+
+    D3D::gDeviceContext->DrawIndexed(rangeEnd - rangeBegin, rangeBegin, 0);
+
+    if(solidIndexBuffer16_.IsAvailable())
+    {
+        solidIndexBuffer16_.Unbind();
+    }
+    else
+    {
+        solidIndexBuffer32_.Unbind();
+    }
+}
@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <catmull_clark/shared_mesh.h>
+
+namespace
+{
+
+    constexpr uint32_t SEGMENT_MAGIC   = 0x4d434353; // "SCCM"
+    constexpr uint32_t SEGMENT_VERSION = 1;
+    constexpr size_t   SLOT_COUNT      = 2;
+    constexpr size_t   ALIGNMENT       = 64;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory requires lock-free 64-bit atomics");
+
+    // 各字段都是原子量：读取方可能与写入方同时访问，读到的值只有在版本号检查通过后才被采信
+
+    struct SegmentHeader
+    {
+        std::atomic<uint32_t> magic; // 其余字段初始化完毕后才写入
+        uint32_t version;
+        uint64_t maxVertexCount;
+        uint64_t maxFaceCount;
+        uint64_t slotOffsets[SLOT_COUNT];
+
+        alignas(ALIGNMENT) std::atomic<uint64_t> latest; // 最新发布的帧号
+    };
+
+    /**
+     * @brief 帧号为n的帧写入第n % SLOT_COUNT个槽，写入期间版本号为2n - 1，写完后为2n
+     */
+    struct SlotHeader
+    {
+        alignas(ALIGNMENT) std::atomic<uint64_t> version;
+        std::atomic<uint64_t> publishTimeNs;
+        std::atomic<uint64_t> vertexCount;
+        std::atomic<uint64_t> faceCount;
+    };
+
+    size_t alignUp(size_t value) noexcept
+    {
+        return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    size_t getPositionOffset() noexcept
+    {
+        return alignUp(sizeof(SlotHeader));
+    }
+
+    size_t getIndexOffset(size_t maxVertexCount) noexcept
+    {
+        return getPositionOffset() + alignUp(3 * sizeof(float) * maxVertexCount);
+    }
+
+    size_t getSlotBytes(size_t maxVertexCount, size_t maxFaceCount) noexcept
+    {
+        return getIndexOffset(maxVertexCount) + alignUp(4 * sizeof(uint32_t) * maxFaceCount);
+    }
+
+    template<typename Byte>
+    auto getHeader(Byte *data) noexcept
+    {
+        using Header = std::conditional_t<std::is_const_v<Byte>, const SegmentHeader, SegmentHeader>;
+        return reinterpret_cast<Header*>(data);
+    }
+
+    template<typename Byte>
+    auto getSlot(Byte *data, uint64_t sequence) noexcept
+    {
+        using Slot = std::conditional_t<std::is_const_v<Byte>, const SlotHeader, SlotHeader>;
+        return reinterpret_cast<Slot*>(data + getHeader(data)->slotOffsets[sequence % SLOT_COUNT]);
+    }
+
+    uint64_t getSteadyTimeNs() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+#if !defined(_WIN32)
+
+    std::runtime_error makeSystemError(const std::string &what, const std::string &name)
+    {
+        return std::runtime_error(what + " '" + name + "': " + std::strerror(errno));
+    }
+
+#endif
+
+} // namespace anonymous
+
+SharedMeshWriter::SharedMeshWriter(const std::string &name, size_t maxVertexCount, size_t maxFaceCount)
+    : name_(name), maxVertexCount_(maxVertexCount), maxFaceCount_(maxFaceCount)
+{
+#if defined(_WIN32)
+    throw std::runtime_error("SharedMeshWriter: shared memory is only supported on POSIX systems");
+#else
+    const size_t slotBytes = getSlotBytes(maxVertexCount, maxFaceCount);
+    size_ = alignUp(sizeof(SegmentHeader)) + SLOT_COUNT * slotBytes;
+
+    // 替换同名的旧共享内存，已经映射它的读取方不受影响
+
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if(fd < 0)
+    {
+        throw makeSystemError("SharedMeshWriter: failed to create shared memory", name);
+    }
+
+    if(ftruncate(fd, static_cast<off_t>(size_)) != 0)
+    {
+        const auto err = makeSystemError("SharedMeshWriter: failed to resize shared memory", name);
+        close(fd);
+        shm_unlink(name.c_str());
+        throw err;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) != 0)
+    {
+        const auto err = makeSystemError("SharedMeshWriter: failed to query shared memory", name);
+        close(fd);
+        shm_unlink(name.c_str());
+        throw err;
+    }
+
+    device_ = static_cast<uint64_t>(info.st_dev);
+    inode_  = static_cast<uint64_t>(info.st_ino);
+
+    void *data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED)
+    {
+        const auto err = makeSystemError("SharedMeshWriter: failed to map shared memory", name);
+        shm_unlink(name.c_str());
+        throw err;
+    }
+
+    data_ = static_cast<std::byte*>(data);
+
+    // ftruncate得到的内存全为0，原子量的初值即为0
+
+    auto header = new(data_) SegmentHeader;
+    header->version        = SEGMENT_VERSION;
+    header->maxVertexCount = maxVertexCount;
+    header->maxFaceCount   = maxFaceCount;
+    for(size_t s = 0; s < SLOT_COUNT; ++s)
+    {
+        header->slotOffsets[s] = alignUp(sizeof(SegmentHeader)) + s * slotBytes;
+        new(data_ + header->slotOffsets[s]) SlotHeader;
+    }
+
+    header->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+#endif
+}
+
+SharedMeshWriter::~SharedMeshWriter()
+{
+#if !defined(_WIN32)
+    // 其他写入方可能已用同名的新共享内存替换了本对象的共享内存，此时不能删除名字。
+    // 比较须在munmap之前：映射未解除时本对象的共享内存不会被释放，其inode不会被新的共享内存重用
+
+    const int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+    if(fd >= 0)
+    {
+        struct stat info;
+        const bool isOwned = fstat(fd, &info) == 0 &&
+                             static_cast<uint64_t>(info.st_dev) == device_ &&
+                             static_cast<uint64_t>(info.st_ino) == inode_;
+        close(fd);
+
+        if(isOwned)
+        {
+            shm_unlink(name_.c_str());
+        }
+    }
+
+    munmap(data_, size_);
+#endif
+}
+
+SubdivisionOutput SharedMeshWriter::beginFrame(size_t vertexCount, size_t faceCount)
+{
+    if(vertexCount > maxVertexCount_ || faceCount > maxFaceCount_)
+    {
+        throw std::runtime_error("SharedMeshWriter: frame exceeds shared memory capacity");
+    }
+
+    auto header = getHeader(data_);
+    const uint64_t sequence = header->latest.load(std::memory_order_relaxed) + 1;
+    auto slot = getSlot(data_, sequence);
+
+    // 先使版本号变为奇数，正在读取该槽中上上帧的读取方会发现数据已失效
+
+    slot->version.store(2 * sequence - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->vertexCount.store(vertexCount, std::memory_order_relaxed);
+    slot->faceCount.store(faceCount, std::memory_order_relaxed);
+    writingSlot_ = static_cast<int>(sequence % SLOT_COUNT);
+
+    auto slotData = reinterpret_cast<std::byte*>(slot);
+
+    SubdivisionOutput output;
+    output.positions = { reinterpret_cast<float*>(slotData + getPositionOffset()), 3 * sizeof(float), vertexCount };
+    output.indices   = { reinterpret_cast<uint32_t*>(slotData + getIndexOffset(maxVertexCount_)), 4 * faceCount };
+    return output;
+}
+
+uint64_t SharedMeshWriter::publishFrame()
+{
+    if(writingSlot_ < 0)
+    {
+        throw std::runtime_error("SharedMeshWriter: publishFrame without beginFrame");
+    }
+
+    auto header = getHeader(data_);
+    const uint64_t sequence = header->latest.load(std::memory_order_relaxed) + 1;
+    auto slot = getSlot(data_, sequence);
+
+    slot->publishTimeNs.store(getSteadyTimeNs(), std::memory_order_relaxed);
+    slot->version.store(2 * sequence, std::memory_order_release);
+    header->latest.store(sequence, std::memory_order_release);
+
+    writingSlot_ = -1;
+    return sequence;
+}
+
+uint64_t SharedMeshWriter::publish(
+    const SubdivisionTopology &topology, const ConstPositionView &controlPoints,
+    ArrayView<std::byte> workspace, bool multithreaded)
+{
+    const SubdivisionOutput output = beginFrame(topology.getOutputVertexCount(), topology.getOutputFaceCount());
+
+    topology.evaluate(controlPoints, output.positions, workspace, multithreaded);
+
+    const ArrayView<const uint32_t> indices = topology.getOutputIndices();
+    std::copy(indices.data, indices.data + indices.size, output.indices.data);
+
+    return publishFrame();
+}
+
+SharedMeshReader::SharedMeshReader(const std::string &name)
+{
+#if defined(_WIN32)
+    throw std::runtime_error("SharedMeshReader: shared memory is only supported on POSIX systems");
+#else
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if(fd < 0)
+    {
+        throw makeSystemError("SharedMeshReader: failed to open shared memory", name);
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) != 0)
+    {
+        const auto err = makeSystemError("SharedMeshReader: failed to query shared memory", name);
+        close(fd);
+        throw err;
+    }
+
+    size_ = static_cast<size_t>(info.st_size);
+    if(size_ < sizeof(SegmentHeader))
+    {
+        close(fd);
+        throw std::runtime_error("SharedMeshReader: shared memory '" + name + "' is not initialized");
+    }
+
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED)
+    {
+        throw makeSystemError("SharedMeshReader: failed to map shared memory", name);
+    }
+
+    data_ = static_cast<const std::byte*>(data);
+
+    auto header = getHeader(data_);
+    if(header->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC || header->version != SEGMENT_VERSION ||
+       header->slotOffsets[SLOT_COUNT - 1] +
+       getSlotBytes(header->maxVertexCount, header->maxFaceCount) > size_)
+    {
+        munmap(const_cast<std::byte*>(data_), size_);
+        throw std::runtime_error("SharedMeshReader: shared memory '" + name + "' has an invalid header");
+    }
+#endif
+}
+
+SharedMeshReader::~SharedMeshReader()
+{
+#if !defined(_WIN32)
+    munmap(const_cast<std::byte*>(data_), size_);
+#endif
+}
+
+uint64_t SharedMeshReader::getLatestSequence() const noexcept
+{
+    return getHeader(data_)->latest.load(std::memory_order_acquire);
+}
+
+bool SharedMeshReader::waitForNewerThan(uint64_t sequence, std::chrono::microseconds timeout) const
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto interval = std::chrono::microseconds(20);
+
+    for(int spin = 0; getLatestSequence() <= sequence; ++spin)
+    {
+        if(std::chrono::steady_clock::now() >= deadline)
+        {
+            return false;
+        }
+
+        // 先让出时间片，之后以最长1ms的间隔休眠
+
+        if(spin < 64)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::this_thread::sleep_for(interval);
+        interval = (std::min)(2 * interval, std::chrono::microseconds(1000));
+    }
+
+    return true;
+}
+
+bool SharedMeshReader::acquireLatest(SharedMeshFrame &frame) const noexcept
+{
+    auto header = getHeader(data_);
+
+    // 读取最新帧号与槽的版本号之间，写入方可能已开始覆盖该槽，此时重新读取最新帧号
+
+    for(;;)
+    {
+        const uint64_t sequence = header->latest.load(std::memory_order_acquire);
+        if(!sequence)
+        {
+            return false;
+        }
+
+        auto slot = getSlot(data_, sequence);
+        if(slot->version.load(std::memory_order_acquire) != 2 * sequence)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // 数量取自可能正被覆盖的槽，限制在容量以内，保证指针不越界；是否完整由isValid确认
+
+        auto slotData = reinterpret_cast<const std::byte*>(slot);
+
+        frame.sequence      = sequence;
+        frame.publishTimeNs = slot->publishTimeNs.load(std::memory_order_relaxed);
+        frame.vertexCount   = (std::min)(slot->vertexCount.load(std::memory_order_relaxed), header->maxVertexCount);
+        frame.faceCount     = (std::min)(slot->faceCount.load(std::memory_order_relaxed), header->maxFaceCount);
+        frame.positions     = reinterpret_cast<const float*>(slotData + getPositionOffset());
+        frame.indices       = reinterpret_cast<const uint32_t*>(slotData + getIndexOffset(header->maxVertexCount));
+        return true;
+    }
+}
+
+bool SharedMeshReader::isValid(const SharedMeshFrame &frame) const noexcept
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return getSlot(data_, frame.sequence)->version.load(std::memory_order_relaxed) == 2 * frame.sequence;
+}
+
+uint64_t SharedMeshReader::copyLatest(std::vector<float> &positions, std::vector<uint32_t> &indices) const
+{
+    SharedMeshFrame frame;
+    while(acquireLatest(frame))
+    {
+        positions.assign(frame.positions, frame.positions + 3 * frame.vertexCount);
+        indices.assign(frame.indices, frame.indices + 4 * frame.faceCount);
+
+        if(isValid(frame))
+        {
+            return frame.sequence;
+        }
+    }
+
+    return 0;
+}
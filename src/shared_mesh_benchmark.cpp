@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <agz/utility/time.h>
+
+#include <catmull_clark/mesh_io.h>
+#include <catmull_clark/shared_mesh.h>
+
+namespace
+{
+
+    const char *SEGMENT_NAME = "/catmull_clark_shared_mesh_benchmark";
+
+    void printUsage(const char *program)
+    {
+        std::cout << "usage: " << program << " input.obj [subdivision_count consumer_count frame_count]" << std::endl;
+    }
+
+    /**
+     * @brief 第sequence帧的控制点沿x轴平移的距离。细分是仿射不变的，结果也平移同样的距离
+     */
+    float getFrameOffset(uint64_t sequence)
+    {
+        return 0.25f * static_cast<float>(sequence % 64);
+    }
+
+    struct ConsumerStats
+    {
+        uint64_t frames     = 0; // 完整读取并校验的帧
+        uint64_t skipped    = 0; // 读取期间写入方发布的帧
+        uint64_t torn       = 0; // 读取期间被覆盖、按协议丢弃的帧
+        uint64_t mismatches = 0; // 通过版本号检查但数据不正确的帧，应为0
+
+        std::vector<double> latenciesUs;
+    };
+
+    /**
+     * @brief 在子进程中读取共享内存中的每一帧，逐顶点与reference比较
+     */
+    ConsumerStats runConsumer(const std::vector<float> &reference, uint64_t frameCount, int readyPipe)
+    {
+        const SharedMeshReader reader(SEGMENT_NAME);
+
+        const char ready = 1;
+        if(write(readyPipe, &ready, 1) != 1)
+        {
+            throw std::runtime_error("failed to notify readiness");
+        }
+
+        ConsumerStats stats;
+        uint64_t last = 0;
+
+        while(last < frameCount && reader.waitForNewerThan(last, std::chrono::seconds(10)))
+        {
+            SharedMeshFrame frame;
+            if(!reader.acquireLatest(frame) || frame.sequence <= last)
+            {
+                continue;
+            }
+
+            // 直接在共享内存上校验，不复制
+
+            const float offset = getFrameOffset(frame.sequence);
+            bool isCorrect = frame.vertexCount * 3 == reference.size();
+            for(size_t i = 0; isCorrect && i < frame.vertexCount; ++i)
+            {
+                const float *p = frame.positions + 3 * i;
+                const float *r = reference.data() + 3 * i;
+                isCorrect = std::abs(p[0] - r[0] - offset) < 1e-3f &&
+                            std::abs(p[1] - r[1]) < 1e-3f &&
+                            std::abs(p[2] - r[2]) < 1e-3f;
+            }
+
+            const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+
+            if(!reader.isValid(frame))
+            {
+                ++stats.torn;
+            }
+            else
+            {
+                ++stats.frames;
+                stats.mismatches += !isCorrect;
+                stats.latenciesUs.push_back((now - static_cast<int64_t>(frame.publishTimeNs)) / 1000.0);
+            }
+
+            stats.skipped += frame.sequence - last - 1;
+            last = frame.sequence;
+        }
+
+        return stats;
+    }
+
+    void printConsumerStats(int index, ConsumerStats &stats)
+    {
+        std::sort(stats.latenciesUs.begin(), stats.latenciesUs.end());
+
+        double mean = 0;
+        for(double latency : stats.latenciesUs)
+        {
+            mean += latency;
+        }
+        mean /= (std::max)(size_t(1), stats.latenciesUs.size());
+
+        const double p99 = stats.latenciesUs.empty() ? 0.0 :
+            stats.latenciesUs[(stats.latenciesUs.size() - 1) * 99 / 100];
+
+        std::printf(
+            "consumer %d: frames %llu, skipped %llu, torn %llu, mismatches %llu, latency mean %.1fus p99 %.1fus\n",
+            index,
+            static_cast<unsigned long long>(stats.frames), static_cast<unsigned long long>(stats.skipped),
+            static_cast<unsigned long long>(stats.torn), static_cast<unsigned long long>(stats.mismatches),
+            mean, p99);
+        std::fflush(stdout);
+    }
+
+    int run(int argc, char *argv[])
+    {
+        if(argc != 2 && argc != 5)
+        {
+            printUsage(argv[0]);
+            return -1;
+        }
+
+        const int subdivisionCount = argc == 5 ? std::stoi(argv[2]) : 3;
+        const int consumerCount    = argc == 5 ? std::stoi(argv[3]) : 4;
+        const auto frameCount      = static_cast<uint64_t>(argc == 5 ? std::stoll(argv[4]) : 2000);
+
+        // 建立拓扑，计算未平移时的细分结果作为校验的参照
+
+        const Mesh mesh = loadMesh(argv[1]);
+
+        std::vector<uint8_t> faceVertexCounts;
+        std::vector<uint32_t> indices;
+        for(auto &face : mesh.faces)
+        {
+            const int n = face.isQuad ? 4 : 3;
+            faceVertexCounts.push_back(static_cast<uint8_t>(n));
+            indices.insert(indices.end(), face.indices, face.indices + n);
+        }
+
+        const SubdivisionTopology topology(
+            { faceVertexCounts.data(), sizeof(uint8_t), faceVertexCounts.size(), IndexFormat::UInt8 },
+            { indices.data(), sizeof(uint32_t), indices.size(), IndexFormat::UInt32 },
+            mesh.vertices.size(), subdivisionCount);
+
+        std::vector<std::byte> workspace(topology.getWorkspaceBytes());
+        std::vector<float> controlPoints(3 * mesh.vertices.size());
+        for(size_t v = 0; v < mesh.vertices.size(); ++v)
+        {
+            controlPoints[3 * v + 0] = mesh.vertices[v].position.x;
+            controlPoints[3 * v + 1] = mesh.vertices[v].position.y;
+            controlPoints[3 * v + 2] = mesh.vertices[v].position.z;
+        }
+
+        std::vector<float> reference(3 * topology.getOutputVertexCount());
+        topology.evaluate(
+            { controlPoints.data(), 3 * sizeof(float), mesh.vertices.size() },
+            { reference.data(), 3 * sizeof(float), topology.getOutputVertexCount() },
+            { workspace.data(), workspace.size() });
+
+        SharedMeshWriter writer(SEGMENT_NAME, topology.getOutputVertexCount(), topology.getOutputFaceCount());
+
+        // 启动读取方进程，等待它们都映射了共享内存
+
+        int readyPipe[2];
+        if(pipe(readyPipe) != 0)
+        {
+            throw std::runtime_error("failed to create pipe");
+        }
+
+        std::vector<pid_t> consumers;
+        for(int i = 0; i < consumerCount; ++i)
+        {
+            const pid_t pid = fork();
+            if(pid < 0)
+            {
+                throw std::runtime_error("failed to fork consumer");
+            }
+
+            if(!pid)
+            {
+                int status = 1;
+                try
+                {
+                    ConsumerStats stats = runConsumer(reference, frameCount, readyPipe[1]);
+                    printConsumerStats(i, stats);
+                    status = stats.mismatches ? 1 : 0;
+                }
+                catch(const std::exception &err)
+                {
+                    std::cout << "consumer " << i << ": " << err.what() << std::endl;
+                }
+                _exit(status);
+            }
+
+            consumers.push_back(pid);
+        }
+
+        for(int i = 0; i < consumerCount; ++i)
+        {
+            char ready;
+            if(read(readyPipe[0], &ready, 1) != 1)
+            {
+                throw std::runtime_error("consumer failed to start");
+            }
+        }
+
+        // 写入方逐帧平移控制点，细分结果直接写入共享内存
+
+        std::printf("%zu vertices, %zu faces per frame (%.1f MB), %d consumers\n",
+            topology.getOutputVertexCount(), topology.getOutputFaceCount(),
+            (12.0 * topology.getOutputVertexCount() + 16.0 * topology.getOutputFaceCount()) / (1 << 20),
+            consumerCount);
+        std::fflush(stdout);
+
+        agz::time::clock_t clock;
+
+        for(uint64_t sequence = 1; sequence <= frameCount; ++sequence)
+        {
+            const float offset = getFrameOffset(sequence);
+            for(size_t v = 0; v < mesh.vertices.size(); ++v)
+            {
+                controlPoints[3 * v] = mesh.vertices[v].position.x + offset;
+            }
+
+            writer.publish(
+                topology, { controlPoints.data(), 3 * sizeof(float), mesh.vertices.size() },
+                { workspace.data(), workspace.size() }, true);
+        }
+
+        const double seconds = clock.us() / 1e6;
+        std::printf("writer: %llu frames in %.2fs (%.0f frames/s)\n",
+            static_cast<unsigned long long>(frameCount), seconds, frameCount / seconds);
+        std::fflush(stdout);
+
+        int failures = 0;
+        for(pid_t pid : consumers)
+        {
+            int status = 0;
+            waitpid(pid, &status, 0);
+            failures += !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+        }
+
+        std::printf("%d of %d consumers failed\n", failures, consumerCount);
+        return failures ? -1 : 0;
+    }
+
+} // namespace anonymous
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        return run(argc, argv);
+    }
+    catch(const std::exception &err)
+    {
+        std::cout << err.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,576 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CATMULL_CLARK_SSE2
+#endif
+
+#include <catmull_clark/parallel.h>
+#include <catmull_clark/software_renderer.h>
+
+namespace
+{
+
+    /**
+     * @brief 4路浮点向量，没有SSE2时退化为标量实现
+     */
+#ifdef CATMULL_CLARK_SSE2
+
+    struct Float4
+    {
+        __m128 v;
+
+        static Float4 broadcast(float f) { return { _mm_set1_ps(f) }; }
+        static Float4 ramp()             { return { _mm_set_ps(3, 2, 1, 0) }; }
+
+        Float4 operator+(const Float4 &rhs) const { return { _mm_add_ps(v, rhs.v) }; }
+        Float4 operator*(const Float4 &rhs) const { return { _mm_mul_ps(v, rhs.v) }; }
+
+        /**
+         * @brief 返回各分量满足 >= 0（inclusive为true）或 > 0 的位掩码
+         */
+        int positiveMask(bool inclusive) const
+        {
+            __m128 zero = _mm_setzero_ps();
+            return _mm_movemask_ps(inclusive ? _mm_cmpge_ps(v, zero) : _mm_cmpgt_ps(v, zero));
+        }
+
+        void store(float *output) const { _mm_storeu_ps(output, v); }
+    };
+
+#else
+
+    struct Float4
+    {
+        float v[4];
+
+        static Float4 broadcast(float f) { return { { f, f, f, f } }; }
+        static Float4 ramp()             { return { { 0, 1, 2, 3 } }; }
+
+        Float4 operator+(const Float4 &rhs) const
+        {
+            return { { v[0] + rhs.v[0], v[1] + rhs.v[1], v[2] + rhs.v[2], v[3] + rhs.v[3] } };
+        }
+
+        Float4 operator*(const Float4 &rhs) const
+        {
+            return { { v[0] * rhs.v[0], v[1] * rhs.v[1], v[2] * rhs.v[2], v[3] * rhs.v[3] } };
+        }
+
+        int positiveMask(bool inclusive) const
+        {
+            int mask = 0;
+            for(int i = 0; i < 4; ++i)
+            {
+                if(inclusive ? v[i] >= 0 : v[i] > 0)
+                {
+                    mask |= 1 << i;
+                }
+            }
+            return mask;
+        }
+
+        void store(float *output) const
+        {
+            for(int i = 0; i < 4; ++i)
+            {
+                output[i] = v[i];
+            }
+        }
+    };
+
+#endif
+
+    /**
+     * @brief 与实体着色器相同的光照计算
+     */
+    uint8_t shadeSolid(const Vec3 &normal, const Vec3 &lightDir)
+    {
+        float len = normal.length();
+        Vec3 n = len > 0 ? normal / len : normal;
+
+        float lightFactor = 0.1f + 0.75f * (std::max)(0.0f, dot(n, -lightDir));
+        lightFactor = 0.4f * lightFactor + 0.6f * lightFactor * lightFactor;
+        lightFactor = std::pow(lightFactor, 1 / 1.4f);
+
+        return static_cast<uint8_t>(agz::math::clamp(lightFactor, 0.0f, 1.0f) * 255 + 0.5f);
+    }
+
+    /**
+     * @brief 边函数，p位于u->v左侧（屏幕空间y轴向下时为顺时针三角形的内部）时为正
+     */
+    float edgeFunction(float ux, float uy, float vx, float vy, float px, float py)
+    {
+        return (vx - ux) * (py - uy) - (vy - uy) * (px - ux);
+    }
+
+    /**
+     * @brief 边函数为零时，像素是否属于该边（top-left规则）
+     */
+    bool isTopLeftEdge(float ux, float uy, float vx, float vy)
+    {
+        float dx = vx - ux, dy = vy - uy;
+        return (dy == 0 && dx > 0) || dy < 0;
+    }
+
+    size_t getBinningChunkCount()
+    {
+        return (std::max)(1u, std::thread::hardware_concurrency());
+    }
+
+} // namespace anonymous
+
+SoftwareRenderer::SoftwareRenderer(int width, int height)
+    : width_(width), height_(height), wireframe_(false)
+{
+    if(width <= 0 || height <= 0)
+    {
+        throw std::runtime_error("invalid software render target size");
+    }
+
+    tileCountX_ = (width  + TILE_SIZE - 1) / TILE_SIZE;
+    tileCountY_ = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+    lightDir_ = Vec3(0, -1, 0);
+
+    bins_.resize(getBinningChunkCount());
+    for(auto &chunkBins : bins_)
+    {
+        chunkBins.resize(tileCountX_ * tileCountY_);
+    }
+
+    color_.resize(3 * width_ * height_);
+    depth_.resize(width_ * height_);
+}
+
+void SoftwareRenderer::setMesh(
+    const Mesh &mesh, const std::vector<Edge> &edges, const RenderMeshOptions &options)
+{
+    RenderMeshOptions softwareOptions = options;
+    softwareOptions.quantize = false;
+
+    mesh_ = buildRenderMesh(mesh, edges, softwareOptions);
+}
+
+void SoftwareRenderer::setLightDir(const Vec3 &lightDir)
+{
+    lightDir_ = lightDir.normalize();
+}
+
+void SoftwareRenderer::setWorldTransform(const Mat4 &world)
+{
+    world_ = world;
+}
+
+void SoftwareRenderer::setCameraViewProj(const Mat4 &viewProj)
+{
+    viewProj_ = viewProj;
+}
+
+void SoftwareRenderer::setWireframe(bool wireframe)
+{
+    wireframe_ = wireframe;
+}
+
+void SoftwareRenderer::render()
+{
+    std::fill(color_.begin(), color_.end(), uint8_t(0));
+    std::fill(depth_.begin(), depth_.end(), 1.0f);
+
+    transformVertices();
+    binPrimitives();
+
+    parallelForRange(tileCountX_ * tileCountY_, 1, [&](size_t begin, size_t end)
+    {
+        for(size_t tile = begin; tile < end; ++tile)
+        {
+            rasterizeTile(static_cast<int>(tile % tileCountX_), static_cast<int>(tile / tileCountX_));
+        }
+    });
+}
+
+int SoftwareRenderer::getWidth() const noexcept
+{
+    return width_;
+}
+
+int SoftwareRenderer::getHeight() const noexcept
+{
+    return height_;
+}
+
+const std::vector<uint8_t> &SoftwareRenderer::getColorBuffer() const noexcept
+{
+    return color_;
+}
+
+void SoftwareRenderer::saveToPPM(const std::string &filename) const
+{
+    std::ofstream fout(filename, std::ios::binary | std::ios::trunc);
+    if(!fout)
+    {
+        throw std::runtime_error("failed to open output file: " + filename);
+    }
+
+    fout << "P6\n" << width_ << " " << height_ << "\n255\n";
+    fout.write(reinterpret_cast<const char*>(color_.data()), color_.size());
+}
+
+void SoftwareRenderer::transformVertices()
+{
+    Mat4 wvp = world_ * viewProj_;
+
+    screenVertices_.resize(mesh_.vertices.size());
+
+    parallelFor(mesh_.vertices.size(), [&](size_t i)
+    {
+        auto &v = mesh_.vertices[i];
+        auto &output = screenVertices_[i];
+
+        Vec4 clip = transformHomogeneous(Vec4(v.position.x, v.position.y, v.position.z, 1), wvp);
+
+        output.valid = clip.w > 1e-6f;
+        if(!output.valid)
+        {
+            return;
+        }
+
+        output.invW = 1 / clip.w;
+        output.x = (0.5f + 0.5f * clip.x * output.invW) * width_;
+        output.y = (0.5f - 0.5f * clip.y * output.invW) * height_;
+        output.z = clip.z * output.invW;
+        output.normal = transformDirection(v.normal, world_);
+    });
+}
+
+template<typename Index>
+void SoftwareRenderer::getPrimitive(
+    const std::vector<Index> &indices, uint32_t primitive, int vertexCount, uint32_t *output) const
+{
+    for(int i = 0; i < vertexCount; ++i)
+    {
+        output[i] = indices[vertexCount * primitive + i];
+    }
+}
+
+void SoftwareRenderer::binPrimitives()
+{
+    const int vertexCount = wireframe_ ? 2 : 3;
+    const size_t primitiveCount =
+        (wireframe_ ? mesh_.getLineIndexCount() : mesh_.getIndexCount()) / vertexCount;
+
+    const size_t chunkCount = bins_.size();
+    const size_t chunkSize = (primitiveCount + chunkCount - 1) / chunkCount;
+
+    parallelForRange(chunkCount, 1, [&](size_t chunkBegin, size_t chunkEnd)
+    {
+        for(size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+        {
+            auto &chunkBins = bins_[chunk];
+            for(auto &bin : chunkBins)
+            {
+                bin.clear();
+            }
+
+            size_t begin = (std::min)(primitiveCount, chunk * chunkSize);
+            size_t end   = (std::min)(primitiveCount, begin + chunkSize);
+
+            for(size_t p = begin; p < end; ++p)
+            {
+                auto primitive = static_cast<uint32_t>(p);
+
+                uint32_t vertices[3];
+                if(wireframe_)
+                {
+                    if(mesh_.isIndex16())
+                        getPrimitive(mesh_.lineIndices16, primitive, 2, vertices);
+                    else
+                        getPrimitive(mesh_.lineIndices32, primitive, 2, vertices);
+                }
+                else
+                {
+                    if(mesh_.isIndex16())
+                        getPrimitive(mesh_.indices16, primitive, 3, vertices);
+                    else
+                        getPrimitive(mesh_.indices32, primitive, 3, vertices);
+                }
+
+                float minX = (std::numeric_limits<float>::max)(), maxX = (std::numeric_limits<float>::lowest)();
+                float minY = minX, maxY = maxX;
+                bool valid = true;
+
+                for(int i = 0; i < vertexCount; ++i)
+                {
+                    auto &v = screenVertices_[vertices[i]];
+                    valid &= v.valid;
+
+                    minX = (std::min)(minX, v.x);
+                    maxX = (std::max)(maxX, v.x);
+                    minY = (std::min)(minY, v.y);
+                    maxY = (std::max)(maxY, v.y);
+                }
+
+                if(!valid)
+                {
+                    continue;
+                }
+
+                // 背面剔除：与Renderer一致，屏幕空间中顺时针的三角形为正面
+
+                if(!wireframe_)
+                {
+                    auto &a = screenVertices_[vertices[0]];
+                    auto &b = screenVertices_[vertices[1]];
+                    auto &c = screenVertices_[vertices[2]];
+                    if(edgeFunction(a.x, a.y, b.x, b.y, c.x, c.y) <= 0)
+                    {
+                        continue;
+                    }
+                }
+
+                if(maxX < 0 || maxY < 0 || minX >= width_ || minY >= height_)
+                {
+                    continue;
+                }
+
+                int tileX0 = agz::math::clamp(static_cast<int>(minX) / TILE_SIZE, 0, tileCountX_ - 1);
+                int tileX1 = agz::math::clamp(static_cast<int>(maxX) / TILE_SIZE, 0, tileCountX_ - 1);
+                int tileY0 = agz::math::clamp(static_cast<int>(minY) / TILE_SIZE, 0, tileCountY_ - 1);
+                int tileY1 = agz::math::clamp(static_cast<int>(maxY) / TILE_SIZE, 0, tileCountY_ - 1);
+
+                for(int ty = tileY0; ty <= tileY1; ++ty)
+                {
+                    for(int tx = tileX0; tx <= tileX1; ++tx)
+                    {
+                        chunkBins[ty * tileCountX_ + tx].push_back(primitive);
+                    }
+                }
+            }
+        }
+    });
+}
+
+void SoftwareRenderer::rasterizeTile(int tileX, int tileY)
+{
+    const int tile = tileY * tileCountX_ + tileX;
+
+    for(auto &chunkBins : bins_)
+    {
+        for(auto primitive : chunkBins[tile])
+        {
+            if(wireframe_)
+            {
+                rasterizeLine(tileX, tileY, primitive);
+            }
+            else
+            {
+                rasterizeTriangle(tileX, tileY, primitive);
+            }
+        }
+    }
+}
+
+void SoftwareRenderer::rasterizeTriangle(int tileX, int tileY, uint32_t triangle)
+{
+    uint32_t vertices[3];
+    if(mesh_.isIndex16())
+        getPrimitive(mesh_.indices16, triangle, 3, vertices);
+    else
+        getPrimitive(mesh_.indices32, triangle, 3, vertices);
+
+    auto &a = screenVertices_[vertices[0]];
+    auto &b = screenVertices_[vertices[1]];
+    auto &c = screenVertices_[vertices[2]];
+
+    const float area = edgeFunction(a.x, a.y, b.x, b.y, c.x, c.y);
+    const float invArea = 1 / area;
+
+    // 包围盒与块求交
+
+    int x0 = (std::max)(tileX * TILE_SIZE, static_cast<int>(std::floor((std::min)({ a.x, b.x, c.x }))));
+    int y0 = (std::max)(tileY * TILE_SIZE, static_cast<int>(std::floor((std::min)({ a.y, b.y, c.y }))));
+    int x1 = (std::min)((std::min)((tileX + 1) * TILE_SIZE, width_) - 1,
+                        static_cast<int>(std::ceil((std::max)({ a.x, b.x, c.x }))));
+    int y1 = (std::min)((std::min)((tileY + 1) * TILE_SIZE, height_) - 1,
+                        static_cast<int>(std::ceil((std::max)({ a.y, b.y, c.y }))));
+
+    if(x0 > x1 || y0 > y1)
+    {
+        return;
+    }
+
+    // 三条边函数：w0对应边bc，w1对应边ca，w2对应边ab
+    // 沿x方向每移动一个像素，边函数增加stepX；沿y方向增加stepY
+
+    const ScreenVertex *edgeStart[3] = { &b, &c, &a };
+    const ScreenVertex *edgeEnd  [3] = { &c, &a, &b };
+
+    float rowValue[3], stepX[3];
+    bool inclusive[3];
+
+    const float px = x0 + 0.5f, py = y0 + 0.5f;
+
+    float stepY[3];
+    for(int e = 0; e < 3; ++e)
+    {
+        auto &u = *edgeStart[e];
+        auto &v = *edgeEnd[e];
+
+        rowValue[e]  = edgeFunction(u.x, u.y, v.x, v.y, px, py);
+        stepX[e]     = -(v.y - u.y);
+        stepY[e]     = v.x - u.x;
+        inclusive[e] = isTopLeftEdge(u.x, u.y, v.x, v.y);
+    }
+
+    const Float4 ramp = Float4::ramp();
+    const Float4 depthA = Float4::broadcast(a.z * invArea);
+    const Float4 depthB = Float4::broadcast(b.z * invArea);
+    const Float4 depthC = Float4::broadcast(c.z * invArea);
+
+    Float4 step4[3], stepRamp[3];
+    for(int e = 0; e < 3; ++e)
+    {
+        step4[e]    = Float4::broadcast(4 * stepX[e]);
+        stepRamp[e] = ramp * Float4::broadcast(stepX[e]);
+    }
+
+    for(int y = y0; y <= y1; ++y)
+    {
+        Float4 w[3];
+        for(int e = 0; e < 3; ++e)
+        {
+            w[e] = Float4::broadcast(rowValue[e]) + stepRamp[e];
+            rowValue[e] += stepY[e];
+        }
+
+        for(int x = x0; x <= x1; x += 4)
+        {
+            int mask = w[0].positiveMask(inclusive[0]) &
+                       w[1].positiveMask(inclusive[1]) &
+                       w[2].positiveMask(inclusive[2]);
+
+            if(x1 - x < 3)
+            {
+                mask &= (1 << (x1 - x + 1)) - 1;
+            }
+
+            if(mask)
+            {
+                float w0[4], w1[4], w2[4], z[4];
+                w[0].store(w0);
+                w[1].store(w1);
+                w[2].store(w2);
+                (w[0] * depthA + w[1] * depthB + w[2] * depthC).store(z);
+
+                for(int lane = 0; lane < 4; ++lane)
+                {
+                    if(!(mask & (1 << lane)))
+                    {
+                        continue;
+                    }
+
+                    const int pixel = y * width_ + x + lane;
+                    if(z[lane] < 0 || z[lane] > 1 || z[lane] >= depth_[pixel])
+                    {
+                        continue;
+                    }
+                    depth_[pixel] = z[lane];
+
+                    // 透视校正插值法线
+
+                    float pa = w0[lane] * a.invW, pb = w1[lane] * b.invW, pc = w2[lane] * c.invW;
+                    Vec3 normal = pa * a.normal + pb * b.normal + pc * c.normal;
+
+                    uint8_t shade = shadeSolid(normal, lightDir_);
+                    color_[3 * pixel]     = shade;
+                    color_[3 * pixel + 1] = shade;
+                    color_[3 * pixel + 2] = shade;
+                }
+            }
+
+            for(int e = 0; e < 3; ++e)
+            {
+                w[e] = w[e] + step4[e];
+            }
+        }
+    }
+}
+
+void SoftwareRenderer::rasterizeLine(int tileX, int tileY, uint32_t line)
+{
+    uint32_t vertices[2];
+    if(mesh_.isIndex16())
+        getPrimitive(mesh_.lineIndices16, line, 2, vertices);
+    else
+        getPrimitive(mesh_.lineIndices32, line, 2, vertices);
+
+    auto &a = screenVertices_[vertices[0]];
+    auto &b = screenVertices_[vertices[1]];
+
+    // 用Liang-Barsky算法将线段裁剪到块内，只遍历块内的部分
+
+    const float rectX0 = static_cast<float>(tileX * TILE_SIZE);
+    const float rectY0 = static_cast<float>(tileY * TILE_SIZE);
+    const float rectX1 = static_cast<float>((std::min)((tileX + 1) * TILE_SIZE, width_));
+    const float rectY1 = static_cast<float>((std::min)((tileY + 1) * TILE_SIZE, height_));
+
+    const float dx = b.x - a.x, dy = b.y - a.y;
+    float t0 = 0, t1 = 1;
+
+    auto clip = [&](float p, float q)
+    {
+        if(p == 0)
+        {
+            return q >= 0;
+        }
+
+        float t = q / p;
+        if(p < 0)
+        {
+            t0 = (std::max)(t0, t);
+        }
+        else
+        {
+            t1 = (std::min)(t1, t);
+        }
+        return t0 <= t1;
+    };
+
+    if(!clip(-dx, a.x - rectX0) || !clip(dx, rectX1 - a.x) ||
+       !clip(-dy, a.y - rectY0) || !clip(dy, rectY1 - a.y))
+    {
+        return;
+    }
+
+    const float length = (std::max)(std::abs(dx), std::abs(dy));
+    const int stepCount = (std::max)(1, static_cast<int>(std::ceil(length * (t1 - t0))));
+
+    for(int i = 0; i <= stepCount; ++i)
+    {
+        float t = t0 + (t1 - t0) * i / stepCount;
+
+        int x = static_cast<int>(a.x + t * dx);
+        int y = static_cast<int>(a.y + t * dy);
+        if(x < rectX0 || x >= rectX1 || y < rectY0 || y >= rectY1)
+        {
+            continue;
+        }
+
+        float z = a.z + t * (b.z - a.z);
+        const int pixel = y * width_ + x;
+        if(z < 0 || z > 1 || z >= depth_[pixel])
+        {
+            continue;
+        }
+
+        depth_[pixel] = z;
+        color_[3 * pixel]     = 255;
+        color_[3 * pixel + 1] = 255;
+        color_[3 * pixel + 2] = 255;
+    }
+}
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+
+#include <pthread.h>
+
+#include <agz/utility/time.h>
+
+#include <catmull_clark/mesh_io.h>
+#include <catmull_clark/shared_mesh.h>
+#include <catmull_clark/subdivision_service.h>
+
+namespace
+{
+
+    void printUsage(const char *program)
+    {
+        std::cout << "usage:\n"
+                  << "  " << program << " serve socket_path [thread_count [cache_directory]]\n"
+                  << "  " << program << " stats socket_path\n"
+                  << "  " << program << " bench socket_path input.obj subdivision_count request_count [client_count [shm]]"
+                  << std::endl;
+    }
+
+    /**
+     * @brief 运行服务，直到收到SIGINT或SIGTERM
+     */
+    int serve(const std::string &socketPath, size_t threadCount, const std::string &cacheDirectory)
+    {
+        // 在创建其他线程之前屏蔽信号，由主线程同步地等待
+
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        SubdivisionServerOptions options;
+        options.threadCount    = threadCount;
+        options.cacheDirectory = cacheDirectory;
+
+        SubdivisionServer server(socketPath, options);
+        std::thread serverThread([&] { server.run(); });
+
+        std::cout << "listening on " << socketPath << std::endl;
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+
+        server.stop();
+        serverThread.join();
+
+        std::cout << server.getMetrics().toString();
+        return 0;
+    }
+
+    struct BenchMesh
+    {
+        std::vector<float>    positions;
+        std::vector<uint8_t>  faceVertexCounts;
+        std::vector<uint32_t> indices;
+
+        MeshView getView() const
+        {
+            MeshView view;
+            view.positions        = { positions.data(), 3 * sizeof(float), positions.size() / 3 };
+            view.faceVertexCounts = { faceVertexCounts.data(), faceVertexCounts.size() };
+            view.indices          = { indices.data(), indices.size() };
+            return view;
+        }
+    };
+
+    /**
+     * @brief 每个客户端在一个连接上保持最多WINDOW个未完成的请求，统计吞吐量与每个请求的往返时间。
+     *        sharedMemory为true时结果经共享内存取得，往返时间包括从共享内存复制结果
+     */
+    int bench(const std::string &socketPath, const std::string &filename,
+              int subdivisionCount, size_t requestCount, size_t clientCount, bool sharedMemory)
+    {
+        constexpr size_t WINDOW = 16;
+
+        const Mesh mesh = loadMesh(filename);
+
+        BenchMesh benchMesh;
+        for(auto &vertex : mesh.vertices)
+        {
+            benchMesh.positions.insert(benchMesh.positions.end(), { vertex.position.x, vertex.position.y, vertex.position.z });
+        }
+        for(auto &face : mesh.faces)
+        {
+            const int n = face.isQuad ? 4 : 3;
+            benchMesh.faceVertexCounts.push_back(static_cast<uint8_t>(n));
+            benchMesh.indices.insert(benchMesh.indices.end(), face.indices, face.indices + n);
+        }
+
+        const MeshView view = benchMesh.getView();
+
+        // 与本地求值的结果比较
+
+        const SubdivisionTopology topology(
+            { view.faceVertexCounts.data, 1, view.faceVertexCounts.size, IndexFormat::UInt8 },
+            { view.indices.data, 4, view.indices.size, IndexFormat::UInt32 },
+            view.positions.size, subdivisionCount);
+
+        std::vector<float> expected(3 * topology.getOutputVertexCount());
+        std::vector<std::byte> workspace(topology.getWorkspaceBytes());
+        topology.evaluate(
+            view.positions, { expected.data(), 3 * sizeof(float), topology.getOutputVertexCount() },
+            { workspace.data(), workspace.size() });
+
+        std::vector<std::vector<double>> roundTrips(clientCount);
+        std::vector<size_t> errors(clientCount);
+
+        agz::time::clock_t clock;
+
+        std::vector<std::thread> clients;
+        for(size_t c = 0; c < clientCount; ++c)
+        {
+            clients.emplace_back([&, c]
+            {
+                SubdivisionClient client(socketPath);
+                std::vector<agz::time::clock_t> sendClocks(requestCount);
+
+                std::unique_ptr<SharedMeshReader> reader;
+                std::string readerName;
+                std::vector<float> positions;
+                std::vector<uint32_t> indices;
+
+                size_t sent = 0;
+                for(size_t received = 0; received < requestCount; ++received)
+                {
+                    while(sent < requestCount && sent < received + WINDOW)
+                    {
+                        sendClocks[sent].restart();
+                        const uint32_t flags = sharedMemory ? SERVICE_FLAG_SHARED_MEMORY :
+                                               sent         ? SERVICE_FLAG_OMIT_INDICES : 0;
+                        client.sendRequest(sent, view, subdivisionCount, flags);
+                        ++sent;
+                    }
+
+                    ServiceResponse response = client.receiveResponse();
+                    if(sharedMemory && response.status == ServiceStatus::Success)
+                    {
+                        // 每个请求的控制点相同，共享内存中最新的帧即为期望的结果
+
+                        if(!reader || readerName != response.message)
+                        {
+                            reader     = std::make_unique<SharedMeshReader>(response.message);
+                            readerName = response.message;
+                        }
+                        reader->copyLatest(positions, indices);
+                        response.positions.swap(positions);
+                        response.indices.swap(indices);
+                    }
+
+                    roundTrips[c].push_back(sendClocks[response.requestId].us());
+
+                    const bool hasIndices = !response.requestId || sharedMemory;
+                    if(response.status != ServiceStatus::Success || response.positions != expected ||
+                       (hasIndices && response.indices.size() != 4 * topology.getOutputFaceCount()))
+                    {
+                        ++errors[c];
+                    }
+                }
+            });
+        }
+
+        for(auto &client : clients)
+        {
+            client.join();
+        }
+
+        const double seconds = clock.us() / 1e6;
+
+        std::vector<double> all;
+        size_t errorCount = 0;
+        for(size_t c = 0; c < clientCount; ++c)
+        {
+            all.insert(all.end(), roundTrips[c].begin(), roundTrips[c].end());
+            errorCount += errors[c];
+        }
+        std::sort(all.begin(), all.end());
+
+        std::printf("%zu requests from %zu clients in %.3fs: %.0f requests/s, round trip p50 %.0fus p99 %.0fus, %zu errors\n",
+            all.size(), clientCount, seconds, all.size() / seconds,
+            all[all.size() / 2], all[(all.size() - 1) * 99 / 100], errorCount);
+
+        std::cout << SubdivisionClient(socketPath).queryStats();
+        return errorCount ? -1 : 0;
+    }
+
+    int run(int argc, char *argv[])
+    {
+        if(argc >= 3 && std::strcmp(argv[1], "serve") == 0)
+        {
+            return serve(argv[2], argc >= 4 ? std::stoul(argv[3]) : 0, argc >= 5 ? argv[4] : "");
+        }
+
+        if(argc == 3 && std::strcmp(argv[1], "stats") == 0)
+        {
+            std::cout << SubdivisionClient(argv[2]).queryStats();
+            return 0;
+        }
+
+        if(argc >= 6 && std::strcmp(argv[1], "bench") == 0)
+        {
+            return bench(argv[2], argv[3], std::stoi(argv[4]), std::stoul(argv[5]),
+                         argc >= 7 ? std::stoul(argv[6]) : 1, argc >= 8 && std::strcmp(argv[7], "shm") == 0);
+        }
+
+        printUsage(argv[0]);
+        return -1;
+    }
+
+} // namespace anonymous
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        return run(argc, argv);
+    }
+    catch(const std::exception &err)
+    {
+        std::cout << err.what() << std::endl;
+        return -1;
+    }
+}
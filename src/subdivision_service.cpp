@@ -0,0 +1,818 @@
+#if !defined(_WIN32)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <catmull_clark/shared_mesh.h>
+#include <catmull_clark/subdivision_service.h>
+
+namespace
+{
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr size_t LATENCY_SAMPLE_COUNT = 1024;
+
+#if defined(MSG_NOSIGNAL)
+    constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    constexpr int SEND_FLAGS = 0;
+#endif
+
+    bool readAll(int fd, void *data, size_t bytes)
+    {
+        auto p = static_cast<char*>(data);
+        while(bytes)
+        {
+            const ssize_t n = read(fd, p, bytes);
+            if(n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if(n <= 0)
+            {
+                return false;
+            }
+            p += n;
+            bytes -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 依次写出各段数据，处理部分写入。对方已关闭连接、套接字的写出超时或超过deadline时返回false，
+     *        不产生SIGPIPE
+     */
+    bool sendAll(int fd, iovec *iov, int count, Clock::time_point deadline = Clock::time_point::max())
+    {
+        while(count)
+        {
+            msghdr message = {};
+            message.msg_iov    = iov;
+            message.msg_iovlen = static_cast<decltype(message.msg_iovlen)>(count);
+
+            const ssize_t n = sendmsg(fd, &message, SEND_FLAGS);
+            if(n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if(n < 0)
+            {
+                return false;
+            }
+
+            auto remaining = static_cast<size_t>(n);
+            while(count && remaining >= iov->iov_len)
+            {
+                remaining -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+
+            if(count)
+            {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+                iov->iov_len -= remaining;
+
+                // 对方读得很慢时每次sendmsg都能写出少量数据，单次调用的超时不能限制总时间
+
+                if(Clock::now() >= deadline)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    sockaddr_un makeAddress(const std::string &socketPath)
+    {
+        sockaddr_un address = {};
+        if(socketPath.size() >= sizeof(address.sun_path))
+        {
+            throw std::runtime_error("socket path too long: " + socketPath);
+        }
+
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+        return address;
+    }
+
+    std::runtime_error makeSystemError(const std::string &what)
+    {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    /**
+     * @brief 估计请求的输出顶点数：第一次细分后每个角产生一个四边形，此后每次细分顶点数约变为4倍
+     */
+    size_t estimateOutputVertexCount(const ServiceRequestHeader &header)
+    {
+        const int shift = 2 * (std::min)(static_cast<int>(header.iterationCount) - 1, 20);
+        return static_cast<size_t>(header.indexCount) << (std::max)(shift, 0);
+    }
+
+    double getPercentile(std::vector<double> samples, double ratio)
+    {
+        if(samples.empty())
+        {
+            return 0;
+        }
+
+        const size_t k = static_cast<size_t>(ratio * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+        return samples[k];
+    }
+
+    double getMean(const std::vector<double> &samples)
+    {
+        double sum = 0;
+        for(double sample : samples)
+        {
+            sum += sample;
+        }
+        return samples.empty() ? 0 : sum / samples.size();
+    }
+
+} // namespace anonymous
+
+struct SubdivisionServer::Connection
+{
+    int fd;
+    uint64_t id;
+    std::chrono::milliseconds sendTimeout;
+    std::mutex writeMutex;
+
+    // 读取线程返回前置为false
+    std::atomic<bool> isReading = true;
+
+    // 写出失败或超时后置为true，此后的回复直接丢弃
+    std::atomic<bool> isBroken = false;
+
+    // 已读取、尚未回复的请求数，由SubdivisionServer::queueMutex_保护
+    size_t pendingRequests = 0;
+
+    // 设置了SERVICE_FLAG_SHARED_MEMORY的请求的结果写入此处，首次使用时创建，容量不足时以新名字重建
+    std::mutex sharedMeshMutex;
+    std::unique_ptr<SharedMeshWriter> sharedMesh;
+    uint64_t sharedMeshGeneration = 0;
+
+    Connection(int fd, uint64_t id, std::chrono::milliseconds sendTimeout)
+        : fd(fd), id(id), sendTimeout(sendTimeout)
+    {
+        // 套接字上的写出超时使阻塞的sendmsg返回，sendAll再以deadline限制整条回复的时间
+
+        timeval timeout;
+        timeout.tv_sec  = static_cast<time_t>(sendTimeout.count() / 1000);
+        timeout.tv_usec = static_cast<suseconds_t>(sendTimeout.count() % 1000 * 1000);
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    }
+
+    ~Connection() { close(fd); }
+
+    /**
+     * @brief 关闭连接的读写两端：读取线程与阻塞的写出立即返回，对方读到连接结束
+     */
+    void drop()
+    {
+        isBroken = true;
+        shutdown(fd, SHUT_RDWR);
+    }
+
+    /**
+     * @brief 写出一条回复，多个工作线程的回复不会交错。写出失败或超时时关闭连接，返回false
+     */
+    bool send(const ServiceResponseHeader &header, iovec *payload, int payloadCount)
+    {
+        iovec iov[4];
+        iov[0] = { const_cast<ServiceResponseHeader*>(&header), sizeof(header) };
+        std::copy(payload, payload + payloadCount, iov + 1);
+
+        std::lock_guard lock(writeMutex);
+        if(isBroken)
+        {
+            return false;
+        }
+
+        // 写出一部分后失败的连接上已无法继续正确地写出回复
+
+        if(!sendAll(fd, iov, payloadCount + 1, Clock::now() + sendTimeout))
+        {
+            drop();
+            return false;
+        }
+        return true;
+    }
+
+    bool sendMessage(ServiceStatus status, uint64_t requestId, const std::string &message)
+    {
+        ServiceResponseHeader header;
+        header.status       = static_cast<uint32_t>(status);
+        header.requestId    = requestId;
+        header.messageBytes = message.size();
+
+        iovec payload = { const_cast<char*>(message.data()), message.size() };
+        return send(header, &payload, 1);
+    }
+};
+
+struct SubdivisionServer::Job
+{
+    std::shared_ptr<Connection> connection;
+    ServiceRequestHeader header;
+
+    std::vector<float>    positions;
+    std::vector<uint8_t>  faceVertexCounts;
+    std::vector<uint32_t> indices;
+
+    size_t estimatedVertexCount = 0;
+    size_t bytes                = 0; // 请求的大小，计入SubdivisionServer::queuedBytes_
+    Clock::time_point receiveTime;
+};
+
+std::string SubdivisionServerMetrics::toString() const
+{
+    std::ostringstream out;
+    out << "received_requests "   << receivedRequests  << "\n"
+        << "completed_requests "  << completedRequests << "\n"
+        << "failed_requests "     << failedRequests    << "\n"
+        << "batches "             << batches           << "\n"
+        << "queue_depth "         << queueDepth        << "\n"
+        << "max_queue_depth "     << maxQueueDepth     << "\n"
+        << "queued_bytes "        << queuedBytes       << "\n"
+        << "connections "         << connectionCount   << "\n"
+        << "paused_reads "        << pausedReads       << "\n"
+        << "latency_mean_us "     << meanLatencyUs     << "\n"
+        << "latency_p50_us "      << p50LatencyUs      << "\n"
+        << "latency_p99_us "      << p99LatencyUs      << "\n"
+        << "queue_time_mean_us "  << meanQueueTimeUs   << "\n"
+        << "cache_hits "          << cache.hits        << "\n"
+        << "cache_misses "        << cache.misses      << "\n"
+        << "cache_evictions "     << cache.evictions   << "\n"
+        << "cache_entries "       << cache.entryCount  << "\n"
+        << "cache_bytes "         << cache.memoryBytes << "\n"
+        << "disk_cache_hits "     << diskCache.hits    << "\n"
+        << "disk_cache_misses "   << diskCache.misses  << "\n"
+        << "disk_cache_rejected " << diskCache.rejected << "\n"
+        << "disk_cache_write_failures " << diskCache.writeFailures << "\n";
+    return out.str();
+}
+
+SubdivisionServer::SubdivisionServer(const std::string &socketPath, const SubdivisionServerOptions &options)
+    : socketPath_(socketPath), options_(options),
+      diskCache_(options.cacheDirectory.empty() ? nullptr : std::make_shared<TopologyDiskCache>(options.cacheDirectory)),
+      cache_(options.cacheBytes, diskCache_)
+{
+    const sockaddr_un address = makeAddress(socketPath);
+
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listenFd_ < 0)
+    {
+        throw makeSystemError("SubdivisionServer: failed to create socket");
+    }
+
+    unlink(socketPath.c_str());
+    if(bind(listenFd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+       listen(listenFd_, SOMAXCONN) != 0)
+    {
+        const auto err = makeSystemError("SubdivisionServer: failed to listen on " + socketPath);
+        close(listenFd_);
+        throw err;
+    }
+}
+
+SubdivisionServer::~SubdivisionServer()
+{
+    close(listenFd_);
+    unlink(socketPath_.c_str());
+}
+
+void SubdivisionServer::run()
+{
+    size_t threadCount = options_.threadCount;
+    if(!threadCount)
+    {
+        threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<std::thread> workers;
+    for(size_t i = 0; i < threadCount; ++i)
+    {
+        workers.emplace_back([&] { processJobs(); });
+    }
+
+    // 定期检查stopping_，stop不需要唤醒accept；同时回收已断开的连接的读取线程
+
+    while(!stopping_)
+    {
+        reapReaders();
+
+        pollfd listenPoll = { listenFd_, POLLIN, 0 };
+        if(poll(&listenPoll, 1, 100) <= 0)
+        {
+            continue;
+        }
+
+        const int fd = accept(listenFd_, nullptr, nullptr);
+        if(fd < 0)
+        {
+            continue;
+        }
+
+        auto connection = std::make_shared<Connection>(
+            fd, nextConnectionId_++, std::chrono::milliseconds(options_.sendTimeoutMs));
+        readers_.push_back({ connection, std::thread([this, connection] { readRequests(connection); }) });
+
+        std::lock_guard lock(metricsMutex_);
+        metrics_.connectionCount = readers_.size();
+    }
+
+    // 先只关闭连接的读取端，使读取线程返回，仍可写出回复；写出的时间受sendTimeoutMs限制
+
+    std::vector<std::shared_ptr<Connection>> connections;
+    for(auto &reader : readers_)
+    {
+        shutdown(reader.connection->fd, SHUT_RD);
+        connections.push_back(reader.connection);
+    }
+    spaceCondition_.notify_all();
+
+    for(auto &reader : readers_)
+    {
+        reader.thread.join();
+    }
+    readers_.clear();
+
+    queueCondition_.notify_all();
+    for(auto &thread : workers)
+    {
+        thread.join();
+    }
+
+    // 工作线程处理完已取出的请求后返回，队列中其余的请求不再处理
+
+    std::deque<std::unique_ptr<Job>> remainingJobs;
+    {
+        std::lock_guard lock(queueMutex_);
+        remainingJobs.swap(queue_);
+    }
+
+    for(auto &job : remainingJobs)
+    {
+        job->connection->sendMessage(ServiceStatus::Failed, job->header.requestId, "server is stopping");
+        releaseJob(*job);
+        connections.push_back(job->connection);
+    }
+
+    // 关闭读写两端，即使连接仍被引用，对方也能立即读到连接结束
+
+    for(auto &connection : connections)
+    {
+        connection->drop();
+    }
+
+    std::lock_guard lock(metricsMutex_);
+    metrics_.failedRequests += remainingJobs.size();
+    metrics_.connectionCount = 0;
+}
+
+void SubdivisionServer::reapReaders()
+{
+    const size_t oldCount = readers_.size();
+
+    for(size_t i = 0; i < readers_.size();)
+    {
+        if(readers_[i].connection->isReading)
+        {
+            ++i;
+            continue;
+        }
+
+        readers_[i].thread.join();
+        readers_[i] = std::move(readers_.back());
+        readers_.pop_back();
+    }
+
+    if(readers_.size() != oldCount)
+    {
+        std::lock_guard lock(metricsMutex_);
+        metrics_.connectionCount = readers_.size();
+    }
+}
+
+void SubdivisionServer::stop()
+{
+    {
+        std::lock_guard lock(queueMutex_);
+        stopping_ = true;
+    }
+    queueCondition_.notify_all();
+    spaceCondition_.notify_all();
+}
+
+SubdivisionServerMetrics SubdivisionServer::getMetrics() const
+{
+    SubdivisionServerMetrics result;
+    std::vector<double> latencies, queueTimes;
+    {
+        std::lock_guard lock(metricsMutex_);
+        result     = metrics_;
+        latencies  = latencies_;
+        queueTimes = queueTimes_;
+    }
+
+    {
+        std::lock_guard lock(queueMutex_);
+        result.queueDepth  = queue_.size();
+        result.queuedBytes = queuedBytes_;
+    }
+
+    result.meanLatencyUs   = getMean(latencies);
+    result.p50LatencyUs    = getPercentile(latencies, 0.5);
+    result.p99LatencyUs    = getPercentile(latencies, 0.99);
+    result.meanQueueTimeUs = getMean(queueTimes);
+    result.cache           = cache_.getStats();
+    if(diskCache_)
+    {
+        result.diskCache = diskCache_->getStats();
+    }
+    return result;
+}
+
+void SubdivisionServer::readRequests(std::shared_ptr<Connection> connection)
+{
+    ServiceRequestHeader header;
+    while(waitForSpace(*connection) && readAll(connection->fd, &header, sizeof(header)))
+    {
+        if(header.magic != SERVICE_MAGIC)
+        {
+            break;
+        }
+
+        if(header.type == static_cast<uint32_t>(ServiceMessageType::Stats))
+        {
+            connection->sendMessage(ServiceStatus::Success, header.requestId, getMetrics().toString());
+            continue;
+        }
+
+        // 无法跳过的请求只能关闭连接
+
+        const uint64_t maxBytes = options_.maxRequestBytes;
+        if(header.type != static_cast<uint32_t>(ServiceMessageType::Subdivide) ||
+           header.vertexCount > maxBytes || header.faceCount > maxBytes || header.indexCount > maxBytes ||
+           12 * header.vertexCount + header.faceCount + 4 * header.indexCount > maxBytes)
+        {
+            connection->sendMessage(ServiceStatus::InvalidRequest, header.requestId, "request too large");
+            break;
+        }
+
+        auto job = std::make_unique<Job>();
+        job->connection = connection;
+        job->header     = header;
+        job->positions.resize(3 * header.vertexCount);
+        job->faceVertexCounts.resize(header.faceCount);
+        job->indices.resize(header.indexCount);
+
+        if(!readAll(connection->fd, job->positions.data(), job->positions.size() * sizeof(float)) ||
+           !readAll(connection->fd, job->faceVertexCounts.data(), job->faceVertexCounts.size()) ||
+           !readAll(connection->fd, job->indices.data(), job->indices.size() * sizeof(uint32_t)))
+        {
+            break;
+        }
+
+        job->receiveTime = Clock::now();
+
+        if(header.iterationCount < 1 || static_cast<int>(header.iterationCount) > options_.maxIterationCount)
+        {
+            connection->sendMessage(ServiceStatus::InvalidRequest, header.requestId, "invalid iteration count");
+            continue;
+        }
+
+        job->estimatedVertexCount = estimateOutputVertexCount(header);
+        job->bytes = sizeof(header) + 12 * header.vertexCount + header.faceCount + 4 * header.indexCount;
+
+        size_t queueDepth;
+        {
+            std::lock_guard lock(queueMutex_);
+            ++connection->pendingRequests;
+            queuedBytes_ += job->bytes;
+
+            queue_.push_back(std::move(job));
+            queueDepth = queue_.size();
+        }
+        queueCondition_.notify_one();
+
+        std::lock_guard lock(metricsMutex_);
+        ++metrics_.receivedRequests;
+        metrics_.maxQueueDepth = (std::max)(metrics_.maxQueueDepth, queueDepth);
+    }
+
+    // 所有退出循环的路径都到达这里
+    connection->isReading = false;
+}
+
+bool SubdivisionServer::waitForSpace(Connection &connection)
+{
+    const auto hasSpace = [&]
+    {
+        return connection.pendingRequests < options_.maxPendingRequestsPerConnection &&
+               queuedBytes_ < options_.maxQueuedBytes;
+    };
+
+    {
+        std::unique_lock lock(queueMutex_);
+        if(hasSpace())
+        {
+            return !stopping_ && !connection.isBroken;
+        }
+
+        // 暂停读取期间，客户端继续发送的请求积压在套接字的缓冲区中，缓冲区满后客户端的写出被阻塞
+
+        spaceCondition_.wait(lock, [&] { return stopping_ || connection.isBroken || hasSpace(); });
+    }
+
+    std::lock_guard lock(metricsMutex_);
+    ++metrics_.pausedReads;
+    return !stopping_ && !connection.isBroken;
+}
+
+void SubdivisionServer::releaseJob(const Job &job)
+{
+    {
+        std::lock_guard lock(queueMutex_);
+        --job.connection->pendingRequests;
+        queuedBytes_ -= job.bytes;
+    }
+    spaceCondition_.notify_all();
+}
+
+void SubdivisionServer::processJobs()
+{
+    std::vector<float> positions;
+    std::vector<std::byte> workspace;
+    std::vector<std::unique_ptr<Job>> batch;
+
+    for(;;)
+    {
+        {
+            std::unique_lock lock(queueMutex_);
+            queueCondition_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            if(stopping_)
+            {
+                return;
+            }
+
+            // 大请求单独处理，小请求按到达顺序合并，直到输出顶点数之和达到上限
+
+            const size_t budget = options_.batchVertexBudget;
+            size_t batchVertexCount = queue_.front()->estimatedVertexCount;
+
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+
+            while(batchVertexCount < budget && !queue_.empty() &&
+                  batchVertexCount + queue_.front()->estimatedVertexCount <= budget)
+            {
+                batchVertexCount += queue_.front()->estimatedVertexCount;
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+
+        {
+            std::lock_guard lock(metricsMutex_);
+            ++metrics_.batches;
+        }
+
+        for(auto &job : batch)
+        {
+            processJob(*job, positions, workspace);
+            releaseJob(*job);
+        }
+        batch.clear();
+    }
+}
+
+void SubdivisionServer::processJob(Job &job, std::vector<float> &positions, std::vector<std::byte> &workspace)
+{
+    const auto startTime = Clock::now();
+    const ServiceRequestHeader &request = job.header;
+
+    ServiceResponseHeader header;
+    header.requestId = request.requestId;
+
+    bool succeeded = false;
+    try
+    {
+        const IndexView faceVertexCounts = {
+            job.faceVertexCounts.data(), sizeof(uint8_t), job.faceVertexCounts.size(), IndexFormat::UInt8 };
+        const IndexView indices = {
+            job.indices.data(), sizeof(uint32_t), job.indices.size(), IndexFormat::UInt32 };
+
+        const auto topology = cache_.getOrCreate(
+            faceVertexCounts, indices, request.vertexCount, static_cast<int>(request.iterationCount));
+
+        const size_t vertexCount = topology->getOutputVertexCount();
+        if(workspace.size() < topology->getWorkspaceBytes())
+        {
+            workspace.resize(topology->getWorkspaceBytes());
+        }
+
+        header.status      = static_cast<uint32_t>(ServiceStatus::Success);
+        header.vertexCount = vertexCount;
+        header.faceCount   = topology->getOutputFaceCount();
+
+        // 并行由工作线程之间的请求提供，单个请求在一个线程上求值
+
+        const ConstPositionView controlPoints = { job.positions.data(), 3 * sizeof(float), request.vertexCount };
+
+        if(request.flags & SERVICE_FLAG_SHARED_MEMORY)
+        {
+            // 同一连接的请求可能由多个工作线程同时处理，而共享内存只能有一个写入方
+
+            std::string name;
+            {
+                auto &connection = *job.connection;
+                std::lock_guard lock(connection.sharedMeshMutex);
+
+                auto &writer = connection.sharedMesh;
+                if(!writer || writer->getMaxVertexCount() < vertexCount ||
+                   writer->getMaxFaceCount() < header.faceCount)
+                {
+                    writer.reset();
+                    writer = std::make_unique<SharedMeshWriter>(
+                        "/ccsd-" + std::to_string(getpid()) + "-" + std::to_string(connection.id) +
+                        "-" + std::to_string(connection.sharedMeshGeneration++),
+                        vertexCount, header.faceCount);
+                }
+
+                header.sequence = writer->publish(*topology, controlPoints, { workspace.data(), workspace.size() });
+                name = writer->getName();
+            }
+
+            header.messageBytes = name.size();
+
+            iovec payload = { name.data(), name.size() };
+            succeeded = job.connection->send(header, &payload, 1);
+        }
+        else
+        {
+            positions.resize(3 * vertexCount);
+            topology->evaluate(
+                controlPoints, { positions.data(), 3 * sizeof(float), vertexCount },
+                { workspace.data(), workspace.size() }, false);
+
+            const ArrayView<const uint32_t> outputIndices = topology->getOutputIndices();
+            const bool omitIndices = (request.flags & SERVICE_FLAG_OMIT_INDICES) != 0;
+            header.indexCount = omitIndices ? 0 : outputIndices.size;
+
+            iovec payload[2] = {
+                { positions.data(), positions.size() * sizeof(float) },
+                { const_cast<uint32_t*>(outputIndices.data), header.indexCount * sizeof(uint32_t) }
+            };
+            succeeded = job.connection->send(header, payload, 2);
+        }
+    }
+    catch(const std::exception &err)
+    {
+        job.connection->sendMessage(ServiceStatus::Failed, request.requestId, err.what());
+    }
+
+    const auto endTime = Clock::now();
+    const double latencyUs   = std::chrono::duration<double, std::micro>(endTime - job.receiveTime).count();
+    const double queueTimeUs = std::chrono::duration<double, std::micro>(startTime - job.receiveTime).count();
+
+    std::lock_guard lock(metricsMutex_);
+    ++(succeeded ? metrics_.completedRequests : metrics_.failedRequests);
+
+    if(latencies_.size() < LATENCY_SAMPLE_COUNT)
+    {
+        latencies_.push_back(latencyUs);
+        queueTimes_.push_back(queueTimeUs);
+    }
+    else
+    {
+        latencies_[nextSample_]  = latencyUs;
+        queueTimes_[nextSample_] = queueTimeUs;
+    }
+    nextSample_ = (nextSample_ + 1) % LATENCY_SAMPLE_COUNT;
+}
+
+SubdivisionClient::SubdivisionClient(const std::string &socketPath)
+{
+    const sockaddr_un address = makeAddress(socketPath);
+
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd_ < 0)
+    {
+        throw makeSystemError("SubdivisionClient: failed to create socket");
+    }
+
+    if(connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        const auto err = makeSystemError("SubdivisionClient: failed to connect to " + socketPath);
+        close(fd_);
+        throw err;
+    }
+}
+
+SubdivisionClient::~SubdivisionClient()
+{
+    close(fd_);
+}
+
+void SubdivisionClient::sendRequest(uint64_t requestId, const MeshView &mesh, int iterationCount, uint32_t flags)
+{
+    ServiceRequestHeader header;
+    header.requestId      = requestId;
+    header.iterationCount = static_cast<uint32_t>(iterationCount);
+    header.flags          = flags;
+    header.vertexCount    = mesh.positions.size;
+    header.faceCount      = mesh.faceVertexCounts.size;
+    header.indexCount     = mesh.indices.size;
+
+    // 协议中的位置是紧密排列的，带步长的输入需要先整理
+
+    const void *positions = mesh.positions.data;
+    if(mesh.positions.stride != 3 * sizeof(float))
+    {
+        packedPositions_.resize(3 * mesh.positions.size);
+        for(size_t v = 0; v < mesh.positions.size; ++v)
+        {
+            std::copy(mesh.positions.at(v), mesh.positions.at(v) + 3, &packedPositions_[3 * v]);
+        }
+        positions = packedPositions_.data();
+    }
+
+    iovec iov[4] = {
+        { &header, sizeof(header) },
+        { const_cast<void*>(positions), 3 * sizeof(float) * mesh.positions.size },
+        { const_cast<uint8_t*>(mesh.faceVertexCounts.data), mesh.faceVertexCounts.size },
+        { const_cast<uint32_t*>(mesh.indices.data), sizeof(uint32_t) * mesh.indices.size }
+    };
+
+    if(!sendAll(fd_, iov, 4))
+    {
+        throw makeSystemError("SubdivisionClient: failed to send request");
+    }
+}
+
+ServiceResponse SubdivisionClient::receiveResponse()
+{
+    ServiceResponseHeader header;
+    if(!readAll(fd_, &header, sizeof(header)) || header.magic != SERVICE_MAGIC)
+    {
+        throw std::runtime_error("SubdivisionClient: connection closed");
+    }
+
+    ServiceResponse response;
+    response.requestId = header.requestId;
+    response.status    = static_cast<ServiceStatus>(header.status);
+    response.sequence  = header.sequence;
+
+    bool received = true;
+    if(header.messageBytes)
+    {
+        response.message.resize(header.messageBytes);
+        received = readAll(fd_, response.message.data(), response.message.size());
+    }
+    else if(response.status == ServiceStatus::Success)
+    {
+        response.positions.resize(3 * header.vertexCount);
+        response.indices.resize(header.indexCount);
+        received = readAll(fd_, response.positions.data(), response.positions.size() * sizeof(float)) &&
+                   readAll(fd_, response.indices.data(), response.indices.size() * sizeof(uint32_t));
+    }
+
+    if(!received)
+    {
+        throw std::runtime_error("SubdivisionClient: connection closed");
+    }
+
+    return response;
+}
+
+std::string SubdivisionClient::queryStats()
+{
+    ServiceRequestHeader header;
+    header.type = static_cast<uint32_t>(ServiceMessageType::Stats);
+
+    iovec iov = { &header, sizeof(header) };
+    if(!sendAll(fd_, &iov, 1))
+    {
+        throw makeSystemError("SubdivisionClient: failed to send request");
+    }
+
+    return receiveResponse().message;
+}
+
+#endif // #if !defined(_WIN32)
@@ -0,0 +1,201 @@
+#include <cmath>
+#include <stdexcept>
+
+#include <catmull_clark/parallel.h>
+#include <catmull_clark/surface_sampler.h>
+
+namespace
+{
+
+    // [0, 1]上的3点Gauss-Legendre积分
+    const float GAUSS_NODES  [3] = { 0.5f - 0.3872983346f, 0.5f, 0.5f + 0.3872983346f };
+    const float GAUSS_WEIGHTS[3] = { 5.0f / 18, 8.0f / 18, 5.0f / 18 };
+
+    constexpr size_t BATCH_SIZE = 4096;
+
+    /**
+     * @brief splitmix64，足以满足采样的需要且每次只需几条整数指令
+     */
+    class Random
+    {
+    public:
+
+        Random(uint64_t seed, uint64_t stream)
+            : state_(seed)
+        {
+            state_ = next() ^ (stream * 0xd1342543de82ef95ull);
+        }
+
+        uint64_t next()
+        {
+            uint64_t z = (state_ += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+    private:
+
+        uint64_t state_;
+    };
+
+    float toUnitFloat(uint32_t bits24)
+    {
+        return static_cast<float>(bits24) * (1.0f / 16777216.0f);
+    }
+
+} // namespace anonymous
+
+LimitSurfaceSampler::LimitSurfaceSampler(const LimitPatchTable &table)
+    : table_(table), surfaceArea_(0)
+{
+    const size_t patchCount = table.getPatchCount();
+
+    std::vector<float> areas(patchCount);
+    maxJacobian_.resize(patchCount);
+
+    parallelForRange(patchCount, 256, [&](size_t begin, size_t end)
+    {
+        PatchDerivatives d;
+        for(size_t p = begin; p < end; ++p)
+        {
+            const auto patch = static_cast<uint32_t>(p);
+
+            float area = 0;
+            for(int i = 0; i < 3; ++i)
+            {
+                for(int j = 0; j < 3; ++j)
+                {
+                    table.evaluate(patch, Vec2(GAUSS_NODES[j], GAUSS_NODES[i]), d, false);
+                    area += GAUSS_WEIGHTS[i] * GAUSS_WEIGHTS[j] * cross(d.ds, d.dt).length();
+                }
+            }
+
+            areas[p]        = area;
+            maxJacobian_[p] = table.getJacobianBound(patch);
+        }
+    });
+
+    double totalArea = 0;
+    for(float area : areas)
+    {
+        totalArea += area;
+    }
+    surfaceArea_ = static_cast<float>(totalArea);
+
+    // 按|ds × dt|的上界（而非面积）选取曲面片，再以|ds × dt|与上界之比接受，
+    // 只要上界确实不小于|ds × dt|，两步合起来的概率密度就与面积元成正比，不依赖于面积估计的精度。
+    // 使用Vose的方法构造别名表
+
+    aliasProbability_.assign(patchCount, 1.0f);
+    aliasIndex_.resize(patchCount);
+    for(size_t i = 0; i < patchCount; ++i)
+    {
+        aliasIndex_[i] = static_cast<uint32_t>(i);
+    }
+
+    double totalEnvelope = 0;
+    for(float maxJacobian : maxJacobian_)
+    {
+        totalEnvelope += maxJacobian;
+    }
+
+    if(totalArea <= 0 || totalEnvelope <= 0)
+    {
+        return;
+    }
+
+    std::vector<double> scaled(patchCount);
+    std::vector<uint32_t> small, large;
+    for(size_t i = 0; i < patchCount; ++i)
+    {
+        scaled[i] = maxJacobian_[i] * patchCount / totalEnvelope;
+        (scaled[i] < 1 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+
+    while(!small.empty() && !large.empty())
+    {
+        const uint32_t s = small.back();
+        const uint32_t l = large.back();
+        small.pop_back();
+
+        aliasProbability_[s] = static_cast<float>(scaled[s]);
+        aliasIndex_[s]       = l;
+
+        scaled[l] -= 1 - scaled[s];
+        if(scaled[l] < 1)
+        {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+}
+
+float LimitSurfaceSampler::getSurfaceArea() const noexcept
+{
+    return surfaceArea_;
+}
+
+void LimitSurfaceSampler::sample(uint64_t seed, size_t count, SurfaceSample *samples) const
+{
+    if(!count)
+    {
+        return;
+    }
+
+    if(surfaceArea_ <= 0)
+    {
+        throw std::runtime_error("LimitSurfaceSampler: surface area is zero");
+    }
+
+    const auto patchCount = static_cast<uint64_t>(aliasProbability_.size());
+    const size_t batchCount = (count + BATCH_SIZE - 1) / BATCH_SIZE;
+
+    parallelForRange(batchCount, 1, [&](size_t batchBegin, size_t batchEnd)
+    {
+        PatchDerivatives d;
+
+        for(size_t batch = batchBegin; batch < batchEnd; ++batch)
+        {
+            Random random(seed, batch);
+
+            const size_t end = (std::min)(count, (batch + 1) * BATCH_SIZE);
+            for(size_t i = batch * BATCH_SIZE; i < end; ++i)
+            {
+                for(;;)
+                {
+                    // 高32位选取别名表中的一项及其内部的分界，低24位用于接受-拒绝
+
+                    const uint64_t r0 = random.next();
+                    const uint64_t scaled = (r0 >> 32) * patchCount;
+                    const auto column = static_cast<uint32_t>(scaled >> 32);
+                    const float split = static_cast<float>(scaled & 0xffffffff) * (1.0f / 4294967296.0f);
+                    const uint32_t patch = split < aliasProbability_[column] ? column : aliasIndex_[column];
+
+                    const uint64_t r1 = random.next();
+                    const Vec2 st(
+                        toUnitFloat(static_cast<uint32_t>(r1 >> 40)),
+                        toUnitFloat(static_cast<uint32_t>(r1 >> 16) & 0xffffff));
+
+                    table_.evaluate(patch, st, d, false);
+
+                    const Vec3 normal = cross(d.ds, d.dt);
+                    const float jacobian = normal.length();
+
+                    const float u = toUnitFloat(static_cast<uint32_t>(r0) & 0xffffff);
+                    if(u * maxJacobian_[patch] >= jacobian)
+                    {
+                        continue;
+                    }
+
+                    auto &p = table_.getPatch(patch);
+                    auto &result = samples[i];
+                    result.location = { p.baseFace, p.subFace, p.frame.apply(st) };
+                    result.position = d.position;
+                    result.normal   = normal / jacobian;
+                    break;
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <catmull_clark/topology_cache.h>
+
+namespace
+{
+
+    uint64_t mix(uint64_t hash, uint64_t value) noexcept
+    {
+        hash = (hash ^ value) * 0x9e3779b97f4a7c15ull;
+        return hash ^ (hash >> 32);
+    }
+
+    uint64_t makeKey(uint64_t topologyHash, int iterationCount) noexcept
+    {
+        return mix(topologyHash, static_cast<uint64_t>(iterationCount));
+    }
+
+    /**
+     * @brief 与meshToModel相同地按位置合并顶点，合并后的顶点按首次被面引用的顺序编号
+     */
+    void weldMesh(
+        const Mesh &mesh, std::vector<float> &positions, std::vector<uint8_t> &faceVertexCounts,
+        std::vector<uint32_t> &indices)
+    {
+        std::unordered_map<Vec3, uint32_t> positionToVertex;
+
+        for(auto &face : mesh.faces)
+        {
+            const int vertexCount = face.isQuad ? 4 : 3;
+            faceVertexCounts.push_back(static_cast<uint8_t>(vertexCount));
+
+            for(int i = 0; i < vertexCount; ++i)
+            {
+                const Vec3 &position = mesh.vertices[face.indices[i]].position;
+
+                const auto [it, isNew] = positionToVertex.insert(
+                    { position, static_cast<uint32_t>(positionToVertex.size()) });
+                if(isNew)
+                {
+                    positions.insert(positions.end(), { position.x, position.y, position.z });
+                }
+                indices.push_back(it->second);
+            }
+        }
+    }
+
+    template<typename GetTopology>
+    Mesh subdivideWithTopology(const Mesh &originalMesh, int iterationCount, const GetTopology &getTopology)
+    {
+        if(!iterationCount)
+        {
+            return originalMesh;
+        }
+
+        std::vector<float> positions;
+        std::vector<uint8_t> faceVertexCounts;
+        std::vector<uint32_t> indices;
+        weldMesh(originalMesh, positions, faceVertexCounts, indices);
+
+        const size_t vertexCount = positions.size() / 3;
+        const std::shared_ptr<const SubdivisionTopology> topology = getTopology(
+            IndexView{ faceVertexCounts.data(), sizeof(uint8_t), faceVertexCounts.size(), IndexFormat::UInt8 },
+            IndexView{ indices.data(), sizeof(uint32_t), indices.size(), IndexFormat::UInt32 },
+            vertexCount);
+
+        Mesh mesh;
+        mesh.vertices.resize(topology->getOutputVertexCount());
+
+        std::vector<std::byte> workspace(topology->getWorkspaceBytes());
+        topology->evaluate(
+            { positions.data(), 3 * sizeof(float), vertexCount },
+            { &mesh.vertices[0].position.x, sizeof(Vertex), mesh.vertices.size() },
+            { workspace.data(), workspace.size() });
+
+        const ArrayView<const uint32_t> outputIndices = topology->getOutputIndices();
+        mesh.faces.resize(topology->getOutputFaceCount());
+        for(size_t f = 0; f < mesh.faces.size(); ++f)
+        {
+            mesh.faces[f].isQuad = true;
+            std::copy(outputIndices.data + 4 * f, outputIndices.data + 4 * f + 4, mesh.faces[f].indices);
+        }
+
+        return mesh;
+    }
+
+} // namespace anonymous
+
+uint64_t hashTopology(const IndexView &faceVertexCounts, const IndexView &indices, size_t vertexCount)
+{
+    uint64_t hash = mix(0xcbf29ce484222325ull, vertexCount);
+
+    hash = mix(hash, faceVertexCounts.size);
+    for(size_t f = 0; f < faceVertexCounts.size; ++f)
+    {
+        hash = mix(hash, faceVertexCounts[f]);
+    }
+
+    hash = mix(hash, indices.size);
+    for(size_t c = 0; c < indices.size; ++c)
+    {
+        hash = mix(hash, indices[c]);
+    }
+
+    return hash;
+}
+
+TopologyDiskCache::TopologyDiskCache(std::string directory)
+    : directory_(std::move(directory))
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if(!std::filesystem::is_directory(directory_))
+    {
+        throw std::runtime_error("failed to create topology cache directory: " + directory_);
+    }
+}
+
+std::shared_ptr<const SubdivisionTopology> TopologyDiskCache::getOrCreate(
+    const IndexView &faceVertexCounts, const IndexView &indices, size_t vertexCount,
+    int iterationCount, bool multithreaded)
+{
+    return getOrCreate(
+        hashTopology(faceVertexCounts, indices, vertexCount),
+        faceVertexCounts, indices, vertexCount, iterationCount, multithreaded);
+}
+
+std::shared_ptr<const SubdivisionTopology> TopologyDiskCache::getOrCreate(
+    uint64_t topologyHash, const IndexView &faceVertexCounts, const IndexView &indices, size_t vertexCount,
+    int iterationCount, bool multithreaded)
+{
+    const std::string filename = getFilename(topologyHash, iterationCount);
+
+    std::error_code ec;
+    if(std::filesystem::exists(filename, ec))
+    {
+        try
+        {
+            std::shared_ptr<const SubdivisionTopology> topology = SubdivisionTopology::loadFromFile(filename);
+            if(topology->matches(faceVertexCounts, indices, vertexCount, iterationCount))
+            {
+                ++hits_;
+                return topology;
+            }
+        }
+        catch(const std::exception &)
+        {
+            // 无效的文件与哈希冲突一样处理，重新建立后覆盖
+        }
+        ++rejected_;
+    }
+    else
+    {
+        ++misses_;
+    }
+
+    auto topology = std::make_shared<const SubdivisionTopology>(
+        faceVertexCounts, indices, vertexCount, iterationCount, multithreaded);
+
+    // 写入失败时仍然返回建立的拓扑
+
+    try
+    {
+        topology->saveToFile(filename);
+    }
+    catch(const std::exception &)
+    {
+        ++writeFailures_;
+    }
+
+    return topology;
+}
+
+std::string TopologyDiskCache::getFilename(uint64_t topologyHash, int iterationCount) const
+{
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx-%d.cctopo",
+                  static_cast<unsigned long long>(topologyHash), iterationCount);
+    return (std::filesystem::path(directory_) / name).string();
+}
+
+TopologyDiskCacheStats TopologyDiskCache::getStats() const
+{
+    TopologyDiskCacheStats result;
+    result.hits          = hits_;
+    result.misses        = misses_;
+    result.rejected      = rejected_;
+    result.writeFailures = writeFailures_;
+    return result;
+}
+
+TopologyCache::TopologyCache(size_t maxMemoryBytes, std::shared_ptr<TopologyDiskCache> diskCache)
+    : maxMemoryBytes_(maxMemoryBytes), diskCache_(std::move(diskCache))
+{
+
+}
+
+std::shared_ptr<const SubdivisionTopology> TopologyCache::getOrCreate(
+    const IndexView &faceVertexCounts, const IndexView &indices, size_t vertexCount, int iterationCount)
+{
+    const uint64_t topologyHash = hashTopology(faceVertexCounts, indices, vertexCount);
+    const uint64_t key = makeKey(topologyHash, iterationCount);
+
+    {
+        std::lock_guard lock(mutex_);
+
+        auto it = find(key, faceVertexCounts, indices, vertexCount, iterationCount);
+        if(it != entries_.end())
+        {
+            ++stats_.hits;
+            entries_.splice(entries_.begin(), entries_, it);
+            return it->topology;
+        }
+
+        ++stats_.misses;
+    }
+
+    auto topology = diskCache_ ?
+        diskCache_->getOrCreate(topologyHash, faceVertexCounts, indices, vertexCount, iterationCount, false) :
+        std::make_shared<const SubdivisionTopology>(faceVertexCounts, indices, vertexCount, iterationCount, false);
+
+    Entry entry;
+    entry.key         = key;
+    entry.memoryBytes = topology->getMemoryBytes();
+    entry.topology    = topology;
+
+    std::lock_guard lock(mutex_);
+
+    // 其他线程可能已经建立了同一拓扑
+
+    auto it = find(key, faceVertexCounts, indices, vertexCount, iterationCount);
+    if(it != entries_.end())
+    {
+        return it->topology;
+    }
+
+    // 超过上限的拓扑不缓存
+
+    if(entry.memoryBytes > maxMemoryBytes_)
+    {
+        return topology;
+    }
+
+    while(stats_.memoryBytes + entry.memoryBytes > maxMemoryBytes_)
+    {
+        auto &last = entries_.back();
+
+        auto range = keyToEntry_.equal_range(last.key);
+        for(auto i = range.first; i != range.second; ++i)
+        {
+            if(i->second == std::prev(entries_.end()))
+            {
+                keyToEntry_.erase(i);
+                break;
+            }
+        }
+
+        stats_.memoryBytes -= last.memoryBytes;
+        ++stats_.evictions;
+        entries_.pop_back();
+    }
+
+    stats_.memoryBytes += entry.memoryBytes;
+    entries_.push_front(std::move(entry));
+    keyToEntry_.insert({ key, entries_.begin() });
+
+    return topology;
+}
+
+TopologyCacheStats TopologyCache::getStats() const
+{
+    std::lock_guard lock(mutex_);
+
+    TopologyCacheStats result = stats_;
+    result.entryCount = entries_.size();
+    return result;
+}
+
+TopologyCache::EntryList::iterator TopologyCache::find(
+    uint64_t key, const IndexView &faceVertexCounts, const IndexView &indices,
+    size_t vertexCount, int iterationCount)
+{
+    auto range = keyToEntry_.equal_range(key);
+    for(auto i = range.first; i != range.second; ++i)
+    {
+        if(i->second->topology->matches(faceVertexCounts, indices, vertexCount, iterationCount))
+        {
+            return i->second;
+        }
+    }
+    return entries_.end();
+}
+
+Mesh applyCatmullClarkSubdivision(const Mesh &originalMesh, int iterationCount, TopologyDiskCache &cache)
+{
+    return subdivideWithTopology(originalMesh, iterationCount,
+        [&](const IndexView &faceVertexCounts, const IndexView &indices, size_t vertexCount)
+    {
+        return cache.getOrCreate(faceVertexCounts, indices, vertexCount, iterationCount);
+    });
+}
+
+Mesh applyCatmullClarkSubdivision(const Mesh &originalMesh, int iterationCount, TopologyCache &cache)
+{
+    return subdivideWithTopology(originalMesh, iterationCount,
+        [&](const IndexView &faceVertexCounts, const IndexView &indices, size_t vertexCount)
+    {
+        return cache.getOrCreate(faceVertexCounts, indices, vertexCount, iterationCount);
+    });
+}
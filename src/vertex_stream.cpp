@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#include <catmull_clark/parallel.h>
+#include <catmull_clark/vertex_stream.h>
+
+namespace
+{
+
+    bool isSameFace(const Face &a, const Face &b)
+    {
+        if(a.isQuad != b.isQuad)
+        {
+            return false;
+        }
+
+        int vertexCount = a.isQuad ? 4 : 3;
+        return std::equal(a.indices, a.indices + vertexCount, b.indices);
+    }
+
+} // namespace anonymous
+
+void VertexStreamUpdater::reset(const Mesh &mesh, const RenderMesh &renderMesh, NormalWeighting weighting)
+{
+    if(renderMesh.isQuantized())
+    {
+        throw std::runtime_error("VertexStreamUpdater: quantized render mesh is not supported");
+    }
+
+    weighting_   = weighting;
+    faces_       = mesh.faces;
+    vertexRemap_ = renderMesh.vertexRemap;
+    vertices_    = renderMesh.vertices;
+
+    meshOrderVertices_.resize(mesh.vertices.size());
+}
+
+void VertexStreamUpdater::clear()
+{
+    faces_.clear();
+    vertexRemap_.clear();
+    meshOrderVertices_.clear();
+    vertices_.clear();
+}
+
+bool VertexStreamUpdater::isCompatible(const Mesh &mesh) const
+{
+    if(mesh.vertices.size() != meshOrderVertices_.size() || mesh.faces.size() != faces_.size())
+    {
+        return false;
+    }
+
+    return std::equal(faces_.begin(), faces_.end(), mesh.faces.begin(), isSameFace);
+}
+
+VertexRange VertexStreamUpdater::update(const Mesh &mesh)
+{
+    if(!isCompatible(mesh))
+    {
+        throw std::runtime_error("VertexStreamUpdater: topology mismatch");
+    }
+
+    parallelFor(mesh.vertices.size(), [&](size_t i)
+    {
+        meshOrderVertices_[i].position = mesh.vertices[i].position;
+    });
+
+    computeVertexNormals(mesh, weighting_, meshOrderVertices_.data());
+
+    // 与暂存数组逐顶点比较，各线程分别统计变化区间后合并
+
+    VertexRange dirty = { vertices_.size(), 0 };
+    std::mutex dirtyMutex;
+
+    parallelForRange(vertices_.size(), 4096, [&](size_t begin, size_t end)
+    {
+        VertexRange localDirty = { end, begin };
+
+        for(size_t i = begin; i < end; ++i)
+        {
+            auto &src = meshOrderVertices_[vertexRemap_.empty() ? i : vertexRemap_[i]];
+            auto &dst = vertices_[i];
+
+            if(std::memcmp(&src, &dst, sizeof(RenderVertex)) != 0)
+            {
+                dst = src;
+                localDirty.begin = (std::min)(localDirty.begin, i);
+                localDirty.end   = i + 1;
+            }
+        }
+
+        if(!localDirty.empty())
+        {
+            std::lock_guard lk(dirtyMutex);
+            dirty.begin = (std::min)(dirty.begin, localDirty.begin);
+            dirty.end   = (std::max)(dirty.end, localDirty.end);
+        }
+    });
+
+    return dirty.empty() ? VertexRange() : dirty;
+}
+
+const std::vector<RenderVertex> &VertexStreamUpdater::getVertices() const noexcept
+{
+    return vertices_;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include <catmull_clark/buffer_subdivision.h>
+#include <catmull_clark/bvh.h>
+#include <catmull_clark/common.h>
+
+/**
+ * @brief 记录失败的检查项，全部检查结束后由失败数决定返回值
+ */
+class Checker
+{
+public:
+
+    explicit Checker(std::string assetDirectory)
+        : assetDirectory_(std::move(assetDirectory)), failureCount_(0)
+    {
+
+    }
+
+    void expect(bool condition, const std::string &message)
+    {
+        if(!condition)
+        {
+            std::cout << "FAILED: " << message << std::endl;
+            ++failureCount_;
+        }
+    }
+
+    /**
+     * @brief func须抛出Exception
+     */
+    template<typename Exception, typename Func>
+    void expectThrow(const Func &func, const std::string &message)
+    {
+        bool thrown = false;
+        try
+        {
+            func();
+        }
+        catch(const Exception &)
+        {
+            thrown = true;
+        }
+        expect(thrown, message);
+    }
+
+    Mesh loadAsset(const std::string &name) const;
+
+    const std::string &getAssetDirectory() const noexcept
+    {
+        return assetDirectory_;
+    }
+
+    int getFailureCount() const noexcept
+    {
+        return failureCount_;
+    }
+
+private:
+
+    std::string assetDirectory_;
+    int failureCount_;
+};
+
+/**
+ * @brief 模型包围盒的最大边长
+ */
+float computeExtent(const Mesh &mesh);
+
+/**
+ * @brief 从包围盒外射向模型中心附近的随机射线，随机数种子固定
+ */
+std::vector<Ray> generateRays(const Mesh &mesh, size_t count);
+
+/**
+ * @brief 以counts与indices为存储，构造引用mesh的MeshView
+ */
+MeshView makeMeshView(const Mesh &mesh, std::vector<uint8_t> &counts, std::vector<uint32_t> &indices);
+
+/**
+ * @brief 每个点都能在reference中找到距离不超过tolerance的顶点
+ */
+bool matchPositions(const std::vector<Vec3> &points, const Mesh &reference, float tolerance);
+
+// 各项检查，每个文件检查一项功能
+
+void checkLodSelection(Checker &checker);
+
+void checkVertexStream(Checker &checker);
+
+void checkEdgeTable(Checker &checker);
+
+void checkOptimizer(Checker &checker);
+
+void checkQuantization(Checker &checker);
+
+void checkClusters(Checker &checker);
+
+void checkPicking(Checker &checker);
+
+void checkLimitIntersector(Checker &checker);
+
+void checkClosestPoint(Checker &checker);
+
+void checkSurfaceSampler(Checker &checker);
+
+void checkGregoryPatches(Checker &checker);
+
+void checkFaceGrids(Checker &checker);
+
+void checkHierarchy(Checker &checker);
+
+void checkFaceMask(Checker &checker);
+
+void checkToleranceSubdivision(Checker &checker);
+
+void checkMeshValidation(Checker &checker);
+
+void checkBufferSubdivision(Checker &checker);
+
+void checkCApi(Checker &checker);
+
+void checkSharedMesh(Checker &checker);
+
+void checkSubdivisionService(Checker &checker);
+
+void checkTopologyFile(Checker &checker);
+
+void checkTopologyCache(Checker &checker);
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <catmull_clark/buffer_subdivision.h>
+#include <catmull_clark/catmull_clark.h>
+
+#include "check.h"
+
+/**
+ * @brief 基于缓冲区的细分与applyCatmullClarkSubdivision在封闭流形上只有舍入误差，预先建立的拓扑给出相同的结果；
+ *        默认的单线程与多线程细分结果逐位相同
+ */
+void checkBufferSubdivision(Checker &checker)
+{
+    const int iterationCount = 3;
+
+    for(const char *name : { "cube.obj", "torus.obj" })
+    {
+        const std::string prefix = std::string("buffer subdivision (") + name + "): ";
+
+        const Mesh mesh = checker.loadAsset(name);
+        const Mesh reference = applyCatmullClarkSubdivision(mesh, iterationCount);
+
+        std::vector<uint8_t> counts;
+        std::vector<uint32_t> indices;
+        const MeshView input = makeMeshView(mesh, counts, indices);
+
+        const SubdivisionBufferSizes sizes = querySubdivisionBufferSizes(input, iterationCount);
+        checker.expect(sizes.vertexCount == reference.vertices.size(), prefix + "vertex count differs");
+        checker.expect(sizes.faceCount == reference.faces.size(), prefix + "face count differs");
+
+        std::vector<Vec3> positions(sizes.vertexCount);
+        std::vector<uint32_t> outputIndices(4 * sizes.faceCount);
+        std::vector<std::byte> workspace(sizes.workspaceBytes);
+
+        const SubdivisionOutput output = {
+            { &positions[0].x, sizeof(Vec3), positions.size() },
+            { outputIndices.data(), outputIndices.size() }
+        };
+        applyCatmullClarkSubdivision(input, iterationCount, output, { workspace.data(), workspace.size() });
+
+        checker.expect(
+            matchPositions(positions, reference, 1e-5f * computeExtent(mesh)),
+            prefix + "positions differ from applyCatmullClarkSubdivision");
+
+        std::vector<Vec3> parallelPositions(sizes.vertexCount);
+        std::vector<uint32_t> parallelIndices(4 * sizes.faceCount);
+        applyCatmullClarkSubdivision(
+            input, iterationCount,
+            { { &parallelPositions[0].x, sizeof(Vec3), parallelPositions.size() },
+              { parallelIndices.data(), parallelIndices.size() } },
+            { workspace.data(), workspace.size() }, true);
+        checker.expect(
+            parallelPositions == positions && parallelIndices == outputIndices,
+            prefix + "multithreaded result differs from the default");
+
+        // 预先建立的拓扑
+
+        const IndexView countView   = { counts.data(), sizeof(uint8_t), counts.size(), IndexFormat::UInt8 };
+        const IndexView indicesView = { indices.data(), sizeof(uint32_t), indices.size(), IndexFormat::UInt32 };
+        const SubdivisionTopology topology(countView, indicesView, mesh.vertices.size(), iterationCount);
+
+        std::vector<Vec3> evaluated(topology.getOutputVertexCount());
+        std::vector<std::byte> topologyWorkspace(topology.getWorkspaceBytes());
+        topology.evaluate(
+            input.positions, { &evaluated[0].x, sizeof(Vec3), evaluated.size() },
+            { topologyWorkspace.data(), topologyWorkspace.size() });
+
+        const ArrayView<const uint32_t> topologyIndices = topology.getOutputIndices();
+        checker.expect(
+            evaluated == positions &&
+            std::equal(topologyIndices.data, topologyIndices.data + topologyIndices.size,
+                       outputIndices.begin(), outputIndices.end()),
+            prefix + "SubdivisionTopology differs from applyCatmullClarkSubdivision");
+
+        // 未对齐的工作区须被拒绝
+
+        checker.expectThrow<std::runtime_error>([&]
+        {
+            applyCatmullClarkSubdivision(
+                input, iterationCount, output, { workspace.data() + 1, workspace.size() - 1 });
+        }, prefix + "misaligned workspace accepted");
+    }
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cstring>
+
+#include <catmull_clark/buffer_subdivision.h>
+#include <catmull_clark/c_api.h>
+
+#include "check.h"
+
+/**
+ * @brief C接口以任意步长与下标类型读取输入，结果与SubdivisionTopology逐位相同；错误以错误码与描述报告
+ */
+void checkCApi(Checker &checker)
+{
+    checker.expect(ccsGetApiVersion() == CCS_API_VERSION, "C API: version mismatch");
+
+    const int iterationCount = 3;
+    const Mesh mesh = checker.loadAsset("torus.obj");
+
+    std::vector<uint8_t> counts;
+    std::vector<uint32_t> indices;
+    const MeshView view = makeMeshView(mesh, counts, indices);
+
+    const IndexView countView   = { counts.data(), sizeof(uint8_t), counts.size(), IndexFormat::UInt8 };
+    const IndexView indicesView = { indices.data(), sizeof(uint32_t), indices.size(), IndexFormat::UInt32 };
+    const SubdivisionTopology reference(countView, indicesView, mesh.vertices.size(), iterationCount);
+
+    std::vector<Vec3> expected(reference.getOutputVertexCount());
+    std::vector<std::byte> workspace(reference.getWorkspaceBytes());
+    reference.evaluate(
+        view.positions, { &expected[0].x, sizeof(Vec3), expected.size() }, { workspace.data(), workspace.size() });
+
+    // 以16位下标、带步长的顶点数与交错排列的位置作为输入
+
+    std::vector<uint16_t> indices16(indices.begin(), indices.end());
+    std::vector<uint32_t> counts32(counts.begin(), counts.end());
+
+    const CcsConstIndexBuffer ccsCounts  = { counts32.data(), sizeof(uint32_t), counts32.size(), CCS_INDEX_TYPE_UINT32 };
+    const CcsConstIndexBuffer ccsIndices = { indices16.data(), 0, indices16.size(), CCS_INDEX_TYPE_UINT16 };
+
+    CcsTopology *topology = nullptr;
+    checker.expect(
+        ccsCreateTopology(&ccsCounts, &ccsIndices, mesh.vertices.size(), iterationCount, CCS_FLAG_NONE, &topology) == CCS_SUCCESS,
+        "C API: ccsCreateTopology failed");
+    if(!topology)
+    {
+        return;
+    }
+
+    checker.expect(
+        ccsGetInputVertexCount(topology) == mesh.vertices.size() &&
+        ccsGetOutputVertexCount(topology) == reference.getOutputVertexCount() &&
+        ccsGetOutputFaceCount(topology) == reference.getOutputFaceCount(),
+        "C API: counts differ from SubdivisionTopology");
+
+    std::vector<uint32_t> outputIndices(4 * ccsGetOutputFaceCount(topology));
+    const CcsIndexBuffer ccsOutputIndices = { outputIndices.data(), 0, outputIndices.size(), CCS_INDEX_TYPE_UINT32 };
+    checker.expect(ccsCopyOutputIndices(topology, &ccsOutputIndices) == CCS_SUCCESS, "C API: ccsCopyOutputIndices failed");
+
+    const ArrayView<const uint32_t> referenceIndices = reference.getOutputIndices();
+    checker.expect(
+        std::equal(outputIndices.begin(), outputIndices.end(), referenceIndices.data, referenceIndices.data + referenceIndices.size),
+        "C API: output indices differ from SubdivisionTopology");
+
+    CcsEvaluator *evaluator = nullptr;
+    checker.expect(
+        ccsCreateEvaluator(topology, CCS_FLAG_SINGLE_THREADED, &evaluator) == CCS_SUCCESS,
+        "C API: ccsCreateEvaluator failed");
+
+    // 求值器持有拓扑的引用，先销毁拓扑
+
+    const size_t outputVertexCount = ccsGetOutputVertexCount(topology);
+    ccsDestroyTopology(topology);
+    if(!evaluator)
+    {
+        return;
+    }
+
+    const size_t inputStride = 4;
+    std::vector<float> input(inputStride * mesh.vertices.size());
+    for(size_t v = 0; v < mesh.vertices.size(); ++v)
+    {
+        std::memcpy(&input[inputStride * v], &mesh.vertices[v].position.x, 3 * sizeof(float));
+    }
+
+    std::vector<float> output(3 * outputVertexCount);
+    const CcsConstPositionBuffer ccsInput = { input.data(), inputStride * sizeof(float), mesh.vertices.size() };
+    const CcsPositionBuffer ccsOutput = { output.data(), 0, outputVertexCount };
+    checker.expect(ccsEvaluate(evaluator, &ccsInput, &ccsOutput) == CCS_SUCCESS, "C API: ccsEvaluate failed");
+    checker.expect(
+        std::memcmp(output.data(), &expected[0].x, output.size() * sizeof(float)) == 0,
+        "C API: positions differ from SubdivisionTopology");
+
+    const CcsPositionBuffer smallOutput = { output.data(), 0, outputVertexCount - 1 };
+    checker.expect(
+        ccsEvaluate(evaluator, &ccsInput, &smallOutput) == CCS_ERROR_BUFFER_TOO_SMALL && *ccsGetLastError(),
+        "C API: small output buffer is not reported");
+
+    ccsDestroyEvaluator(evaluator);
+
+    // 无效的参数与拓扑
+
+    CcsTopology *invalid = nullptr;
+    checker.expect(
+        ccsCreateTopology(&ccsCounts, &ccsIndices, mesh.vertices.size(), 0, CCS_FLAG_NONE, &invalid) == CCS_ERROR_INVALID_ARGUMENT &&
+        !invalid,
+        "C API: zero iteration count is not reported");
+
+    const uint32_t finCounts[3] = { 4, 4, 4 };
+    const uint32_t finIndices[12] = { 0, 1, 3, 2, 1, 0, 4, 5, 0, 1, 7, 6 };
+    const CcsConstIndexBuffer finCountBuffer = { finCounts, 0, 3, CCS_INDEX_TYPE_UINT32 };
+    const CcsConstIndexBuffer finIndexBuffer = { finIndices, 0, 12, CCS_INDEX_TYPE_UINT32 };
+    checker.expect(
+        ccsCreateTopology(&finCountBuffer, &finIndexBuffer, 8, 1, CCS_FLAG_NONE, &invalid) == CCS_ERROR_INVALID_TOPOLOGY &&
+        *ccsGetLastError(),
+        "C API: non-manifold edge is not reported");
+}
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <random>
+
+#include <catmull_clark/closest_point.h>
+#include <catmull_clark/limit_patch.h>
+
+#include "check.h"
+
+/**
+ * @brief 沿法线偏离极限曲面的点投影回曲面，距离不超过偏移量，且不比任何曲面片上的采样点更远；
+ *        批量投影与逐点投影的结果相同
+ */
+void checkClosestPoint(Checker &checker)
+{
+    const Mesh baseMesh = checker.loadAsset("head.obj");
+    const float extent = computeExtent(baseMesh);
+
+    const LimitPatchTable table(baseMesh);
+    const LimitSurfaceProjector projector(table);
+
+    // 所有曲面片上的均匀网格采样，作为最近距离的上界
+
+    const int gridSize = 8;
+    std::vector<Vec3> samples;
+    for(uint32_t patch = 0; patch < table.getPatchCount(); ++patch)
+    {
+        for(int i = 0; i <= gridSize; ++i)
+        {
+            for(int j = 0; j <= gridSize; ++j)
+            {
+                Vec3 position, normal;
+                table.evaluate(patch, Vec2(float(i) / gridSize, float(j) / gridSize), position, normal);
+                samples.push_back(position);
+            }
+        }
+    }
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<uint32_t> patchDis(0, static_cast<uint32_t>(table.getPatchCount() - 1));
+    std::uniform_real_distribution<float> paramDis(0, 1);
+
+    const float offset = 3e-3f * extent;
+    const float tolerance = 1e-4f * extent;
+
+    // 邻近开放边界的双线性曲面片与相邻曲面片在公共边上不完全一致，
+    // 投影落在这样的公共边上时，由location重新求值可能落到另一侧的曲面片上
+    const float locationTolerance = 1e-3f * extent;
+
+    std::vector<Vec3> points;
+    for(int k = 0; k < 100; ++k)
+    {
+        Vec3 position, normal;
+        table.evaluate(patchDis(rng), Vec2(paramDis(rng), paramDis(rng)), position, normal);
+        points.push_back(position + offset * normal);
+    }
+
+    std::vector<SurfaceProjection> batch(points.size());
+    projector.project(points.data(), points.size(), batch.data());
+
+    bool withinOffset = true, notFartherThanSamples = true, consistent = true, batchMatches = true;
+    for(size_t k = 0; k < points.size(); ++k)
+    {
+        const SurfaceProjection result = projector.project(points[k]);
+
+        withinOffset &= result.distance <= offset + tolerance;
+        consistent &= std::abs((result.position - points[k]).length() - result.distance) <= tolerance;
+
+        float nearestSample = (std::numeric_limits<float>::max)();
+        for(auto &s : samples)
+        {
+            nearestSample = (std::min)(nearestSample, (s - points[k]).length());
+        }
+        notFartherThanSamples &= result.distance <= nearestSample + tolerance;
+
+        Vec3 position, normal;
+        table.evaluate(result.location, position, normal);
+        consistent &= (position - result.position).length() <= locationTolerance;
+
+        batchMatches &= (batch[k].position - result.position).length() <= tolerance;
+    }
+
+    checker.expect(withinOffset, "closest point: projection is farther than the normal offset");
+    checker.expect(notFartherThanSamples, "closest point: a surface sample is closer than the projection");
+    checker.expect(consistent, "closest point: location, position and distance disagree");
+    checker.expect(batchMatches, "closest point: batch projection differs from single projection");
+}
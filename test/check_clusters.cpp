@@ -0,0 +1,122 @@
+#include <cmath>
+#include <set>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/mesh_io.h>
+#include <catmull_clark/render_mesh.h>
+
+#include "check.h"
+
+namespace
+{
+
+    uint32_t getIndex(const RenderMesh &mesh, size_t i)
+    {
+        return mesh.isIndex16() ? mesh.indices16[i] : mesh.indices32[i];
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief 簇不超过顶点/三角形上限且连续覆盖整个索引缓冲，包围球包含簇内顶点；
+ *        裁剪不会剔除视锥内任何含正面三角形的簇
+ */
+void checkClusters(Checker &checker)
+{
+    const Mesh baseMesh = checker.loadAsset("head.obj");
+
+    std::vector<Edge> edges;
+    const Mesh mesh = applyCatmullClarkSubdivision(baseMesh, 3, edges);
+
+    RenderMeshOptions options;
+    options.buildClusters = true;
+    options.clusterLimits.maxVertices  = 64;
+    options.clusterLimits.maxTriangles = 124;
+    const RenderMesh renderMesh = buildRenderMesh(mesh, edges, options);
+
+    const auto &clusters = renderMesh.clusters;
+    checker.expect(!clusters.empty(), "clusters: no cluster built");
+
+    const float extent = computeExtent(mesh);
+
+    uint32_t nextIndex = 0;
+    bool withinLimits = true, contiguous = true, bounded = true, countsMatch = true;
+    for(auto &cluster : clusters)
+    {
+        contiguous &= cluster.indexOffset == nextIndex && cluster.indexCount % 3 == 0;
+        nextIndex = cluster.indexOffset + cluster.indexCount;
+
+        std::set<uint32_t> clusterVertices;
+        for(uint32_t i = cluster.indexOffset; i < nextIndex && i < renderMesh.getIndexCount(); ++i)
+        {
+            const uint32_t v = getIndex(renderMesh, i);
+            clusterVertices.insert(v);
+
+            const float distance = (renderMesh.vertices[v].position - cluster.center).length();
+            bounded &= distance <= cluster.radius + 1e-5f * extent;
+        }
+
+        withinLimits &= clusterVertices.size() <= options.clusterLimits.maxVertices &&
+                        cluster.indexCount / 3 <= options.clusterLimits.maxTriangles;
+        countsMatch &= clusterVertices.size() == cluster.vertexCount;
+    }
+    contiguous &= nextIndex == renderMesh.getIndexCount();
+
+    checker.expect(withinLimits, "clusters: vertex or triangle limit exceeded");
+    checker.expect(contiguous, "clusters: index ranges are not contiguous or do not cover all triangles");
+    checker.expect(bounded, "clusters: bounding sphere does not contain its vertices");
+    checker.expect(countsMatch, "clusters: vertexCount does not match the distinct vertices");
+
+    // 摄像机在单位立方体外环绕一周，视野足以容纳整个模型，
+    // 因此只有背面朝向的簇可以被剔除：被剔除的簇中不能有正面三角形
+
+    const Mat4 world = localToUnitCube(baseMesh);
+    const Mat4 proj = Trans4::perspective(agz::math::deg2rad(90.0f), 1.0f, 0.1f, 100.0f);
+
+    size_t totalVisible = 0, culledFrontFacing = 0;
+    const int cameraCount = 8;
+    for(int k = 0; k < cameraCount; ++k)
+    {
+        const float angle = 2 * agz::math::PI_f * k / cameraCount;
+        const Vec3 cameraPos = 4.0f * Vec3(std::cos(angle), 0.3f, std::sin(angle));
+        const Mat4 view = Trans4::look_at(cameraPos, { 0, 0, 0 }, { 0, 1, 0 });
+
+        std::vector<uint32_t> visibleClusters;
+        cullClusters(clusters, world, view * proj, cameraPos, visibleClusters);
+        totalVisible += visibleClusters.size();
+
+        std::vector<bool> isVisible(clusters.size(), false);
+        for(uint32_t c : visibleClusters)
+        {
+            isVisible[c] = true;
+        }
+
+        for(size_t c = 0; c < clusters.size(); ++c)
+        {
+            if(isVisible[c])
+            {
+                continue;
+            }
+
+            auto &cluster = clusters[c];
+            for(uint32_t i = cluster.indexOffset; i + 2 < cluster.indexOffset + cluster.indexCount; i += 3)
+            {
+                const Vec3 a = transformPoint(renderMesh.vertices[getIndex(renderMesh, i)].position, world);
+                const Vec3 b = transformPoint(renderMesh.vertices[getIndex(renderMesh, i + 1)].position, world);
+                const Vec3 c2 = transformPoint(renderMesh.vertices[getIndex(renderMesh, i + 2)].position, world);
+
+                const Vec3 nor = cross(b - a, c2 - a);
+                const float len = nor.length();
+                if(len > 0 && dot(nor / len, (cameraPos - a).normalize()) > 1e-4f)
+                {
+                    ++culledFrontFacing;
+                    break;
+                }
+            }
+        }
+    }
+
+    checker.expect(culledFrontFacing == 0, "clusters: " + std::to_string(culledFrontFacing) +
+                   " culled cluster(s) contain front-facing triangles");
+    checker.expect(totalVisible < cameraCount * clusters.size(), "clusters: cone culling never rejects a cluster");
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/render_mesh.h>
+
+#include "check.h"
+
+namespace
+{
+
+    using EdgeKey = std::pair<uint32_t, uint32_t>;
+
+    EdgeKey makeEdgeKey(uint32_t a, uint32_t b)
+    {
+        return { (std::min)(a, b), (std::max)(a, b) };
+    }
+
+    /**
+     * @brief 逐面收集并去重得到的边，即改用边表之前的做法
+     */
+    std::vector<EdgeKey> collectEdgesFromFaces(const Mesh &mesh)
+    {
+        std::vector<EdgeKey> result;
+        for(auto &f : mesh.faces)
+        {
+            const int n = f.isQuad ? 4 : 3;
+            for(int k = 0; k < n; ++k)
+            {
+                result.push_back(makeEdgeKey(f.indices[k], f.indices[(k + 1) % n]));
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief 细分同时给出的边表与逐面去重得到的边相同，且没有重复；线框索引与边表一一对应
+ */
+void checkEdgeTable(Checker &checker)
+{
+    for(const char *name : { "cube.obj", "bunny.obj", "head.obj" })
+    {
+        const std::string prefix = std::string("edge table (") + name + "): ";
+        const Mesh baseMesh = checker.loadAsset(name);
+
+        for(int level = 0; level <= 2; ++level)
+        {
+            std::vector<Edge> edges;
+            const Mesh mesh = applyCatmullClarkSubdivision(baseMesh, level, edges);
+
+            std::vector<EdgeKey> keys;
+            for(auto &e : edges)
+            {
+                keys.push_back(makeEdgeKey(e.vertices[0], e.vertices[1]));
+            }
+            std::sort(keys.begin(), keys.end());
+
+            checker.expect(
+                std::adjacent_find(keys.begin(), keys.end()) == keys.end(),
+                prefix + "duplicated edge at level " + std::to_string(level));
+            checker.expect(
+                keys == collectEdgesFromFaces(mesh),
+                prefix + "edges differ from the face edges at level " + std::to_string(level));
+
+            const RenderMesh renderMesh = buildRenderMesh(mesh, edges);
+            checker.expect(
+                renderMesh.getLineIndexCount() == 2 * edges.size(),
+                prefix + "line index count differs at level " + std::to_string(level));
+
+            std::vector<EdgeKey> lines;
+            for(size_t i = 0; i + 1 < renderMesh.getLineIndexCount(); i += 2)
+            {
+                lines.push_back(renderMesh.isIndex16() ?
+                    makeEdgeKey(renderMesh.lineIndices16[i], renderMesh.lineIndices16[i + 1]) :
+                    makeEdgeKey(renderMesh.lineIndices32[i], renderMesh.lineIndices32[i + 1]));
+            }
+            std::sort(lines.begin(), lines.end());
+            checker.expect(lines == keys, prefix + "line indices differ from the edge table at level " + std::to_string(level));
+        }
+    }
+}
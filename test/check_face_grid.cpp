@@ -0,0 +1,122 @@
+#include <cmath>
+#include <map>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/face_grid.h>
+#include <catmull_clark/hierarchy.h>
+
+#include "check.h"
+
+namespace
+{
+
+    /**
+     * @brief 含有开放边界顶点的原始面
+     *
+     * 边界顶点规则与顶点编号有关，局部细分在这些面上与整体细分不完全一致（见README）
+     */
+    std::vector<bool> findBoundaryFaces(const Mesh &mesh)
+    {
+        std::map<std::pair<uint32_t, uint32_t>, int> edgeUseCount;
+        for(auto &f : mesh.faces)
+        {
+            const int n = f.isQuad ? 4 : 3;
+            for(int k = 0; k < n; ++k)
+            {
+                const uint32_t a = f.indices[k], b = f.indices[(k + 1) % n];
+                ++edgeUseCount[{ (std::min)(a, b), (std::max)(a, b) }];
+            }
+        }
+
+        std::vector<bool> isBoundaryVertex(mesh.vertices.size(), false);
+        for(auto &[edge, count] : edgeUseCount)
+        {
+            if(count == 1)
+            {
+                isBoundaryVertex[edge.first] = isBoundaryVertex[edge.second] = true;
+            }
+        }
+
+        std::vector<bool> result(mesh.faces.size(), false);
+        for(size_t i = 0; i < mesh.faces.size(); ++i)
+        {
+            auto &f = mesh.faces[i];
+            for(int k = 0; k < (f.isQuad ? 4 : 3); ++k)
+            {
+                result[i] = result[i] || isBoundaryVertex[f.indices[k]];
+            }
+        }
+        return result;
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief 常量矩阵与局部细分给出的顶点网格在内部区域与applyCatmullClarkSubdivision的结果只有舍入误差
+ *
+ * 按SubdivisionHierarchy把细分结果中每个面的四个角点对应到网格中的顶点，逐个比较位置
+ */
+void checkFaceGrids(Checker &checker)
+{
+    for(const char *name : { "torus.obj", "head.obj" })
+    {
+        const Mesh baseMesh = checker.loadAsset(name);
+        const float extent = computeExtent(baseMesh);
+        const SubdivisionHierarchy hierarchy(baseMesh);
+        const std::vector<bool> isBoundaryFace = findBoundaryFaces(baseMesh);
+
+        for(int level : { 1, 3, 4 })
+        {
+            const std::string prefix = std::string("face grid (") + name + ", level " + std::to_string(level) + "): ";
+
+            const Mesh mesh = applyCatmullClarkSubdivision(baseMesh, level);
+            const FaceGridMesh gridMesh = subdivideToFaceGrids(baseMesh, level);
+
+            checker.expect(gridMesh.regularFaceCount > 0, prefix + "no face used the constant matrix");
+
+            std::map<std::pair<uint32_t, int>, const FaceGrid *> gridOf;
+            for(auto &grid : gridMesh.grids)
+            {
+                gridOf[{ grid.baseFace, grid.subFace }] = &grid;
+            }
+
+            const Vec2 corners[4] = { Vec2(0, 0), Vec2(1, 0), Vec2(1, 1), Vec2(0, 1) };
+
+            float maxError = 0;
+            bool located = true;
+            for(uint32_t f = 0; f < mesh.faces.size(); ++f)
+            {
+                for(int k = 0; k < 4; ++k)
+                {
+                    const SurfaceLocation location = hierarchy.locate(level, f, corners[k]);
+
+                    auto it = gridOf.find({ location.baseFace, location.subFace });
+                    if(it == gridOf.end())
+                    {
+                        located = false;
+                        continue;
+                    }
+
+                    if(isBoundaryFace[location.baseFace])
+                    {
+                        continue;
+                    }
+
+                    const FaceGrid &grid = *it->second;
+                    const int size = (1 << grid.level) + 1;
+                    const int i = static_cast<int>(std::lround(location.uv.y * (size - 1)));
+                    const int j = static_cast<int>(std::lround(location.uv.x * (size - 1)));
+
+                    const Vec3 &expected = mesh.vertices[mesh.faces[f].indices[k]].position;
+                    const Vec3 &actual = gridMesh.points[grid.firstPoint + i * size + j];
+                    maxError = (std::max)(maxError, (actual - expected).length());
+                }
+            }
+
+            checker.expect(located, prefix + "face has no grid");
+            checker.expect(
+                maxError <= 4e-7f * extent,
+                prefix + "grid differs from uniform subdivision by " + std::to_string(maxError / extent) + " of the extent");
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <map>
+#include <queue>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/hierarchy.h>
+#include <catmull_clark/mesh_io.h>
+
+#include "check.h"
+
+namespace
+{
+
+    /**
+     * @brief 每条有向边恰好出现一次且其反向边也出现一次：封闭、定向一致的流形
+     */
+    bool isClosedManifold(const Mesh &mesh)
+    {
+        std::map<std::pair<uint32_t, uint32_t>, int> directedEdgeCount;
+        for(auto &f : mesh.faces)
+        {
+            const int n = f.isQuad ? 4 : 3;
+            for(int k = 0; k < n; ++k)
+            {
+                ++directedEdgeCount[{ f.indices[k], f.indices[(k + 1) % n] }];
+            }
+        }
+
+        for(auto &[edge, count] : directedEdgeCount)
+        {
+            auto reverse = directedEdgeCount.find({ edge.second, edge.first });
+            if(count != 1 || reverse == directedEdgeCount.end() || reverse->second != 1)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief 只细分部分面时结果仍是封闭的流形，未选中的面的顶点不动，
+ *        与边界相隔iterationCount环以上的选中面与整体细分一致；掩码全为true时与整体细分完全相同
+ */
+void checkFaceMask(Checker &checker)
+{
+    const int iterationCount = 2;
+    const Mesh baseMesh = checker.loadAsset("torus.obj");
+    const float extent = computeExtent(baseMesh);
+
+    const Mesh uniform = applyCatmullClarkSubdivision(baseMesh, iterationCount);
+
+    const Mesh all = applyCatmullClarkSubdivision(
+        baseMesh, iterationCount, std::vector<bool>(baseMesh.faces.size(), true));
+
+    bool identical = all.vertices.size() == uniform.vertices.size() && all.faces.size() == uniform.faces.size();
+    for(size_t i = 0; identical && i < all.vertices.size(); ++i)
+    {
+        identical = all.vertices[i].position == uniform.vertices[i].position;
+    }
+    for(size_t i = 0; identical && i < all.faces.size(); ++i)
+    {
+        identical = std::equal(all.faces[i].indices, all.faces[i].indices + 4, uniform.faces[i].indices);
+    }
+    checker.expect(identical, "face mask: full mask differs from uniform subdivision");
+
+    // 选中x坐标大于中心的面
+
+    Vec3 low, high;
+    computeBoundingBox(baseMesh, low, high);
+    const float centerX = 0.5f * (low.x + high.x);
+
+    std::vector<bool> faceMask(baseMesh.faces.size());
+    for(size_t i = 0; i < baseMesh.faces.size(); ++i)
+    {
+        auto &f = baseMesh.faces[i];
+        Vec3 centroid;
+        for(int k = 0; k < 4; ++k)
+        {
+            centroid += baseMesh.vertices[f.indices[k]].position;
+        }
+        faceMask[i] = centroid.x / 4 > centerX;
+    }
+
+    const Mesh masked = applyCatmullClarkSubdivision(baseMesh, iterationCount, faceMask);
+
+    checker.expect(masked.faces.size() < uniform.faces.size(), "face mask: unselected faces were refined");
+    checker.expect(isClosedManifold(masked), "face mask: result is not a closed manifold");
+
+    // 边界顶点为同时属于选中与未选中的面的顶点，按顶点邻接关系求到边界的环数
+
+    std::vector<int> selectedCount(baseMesh.vertices.size(), 0), unselectedCount(baseMesh.vertices.size(), 0);
+    std::vector<std::vector<uint32_t>> neighbors(baseMesh.vertices.size());
+    for(size_t i = 0; i < baseMesh.faces.size(); ++i)
+    {
+        auto &f = baseMesh.faces[i];
+        for(int k = 0; k < 4; ++k)
+        {
+            ++(faceMask[i] ? selectedCount : unselectedCount)[f.indices[k]];
+            neighbors[f.indices[k]].push_back(f.indices[(k + 1) % 4]);
+            neighbors[f.indices[(k + 1) % 4]].push_back(f.indices[k]);
+        }
+    }
+
+    std::vector<int> ring(baseMesh.vertices.size(), -1);
+    std::queue<uint32_t> queue;
+    for(uint32_t v = 0; v < baseMesh.vertices.size(); ++v)
+    {
+        if(selectedCount[v] && unselectedCount[v])
+        {
+            ring[v] = 0;
+            queue.push(v);
+        }
+    }
+    while(!queue.empty())
+    {
+        const uint32_t v = queue.front();
+        queue.pop();
+        for(uint32_t n : neighbors[v])
+        {
+            if(ring[n] < 0)
+            {
+                ring[n] = ring[v] + 1;
+                queue.push(n);
+            }
+        }
+    }
+
+    std::vector<Vec3> unselectedPoints;
+    std::vector<bool> isDeep(baseMesh.faces.size(), false);
+    for(size_t i = 0; i < baseMesh.faces.size(); ++i)
+    {
+        auto &f = baseMesh.faces[i];
+        bool deep = faceMask[i];
+        for(int k = 0; k < 4; ++k)
+        {
+            deep &= ring[f.indices[k]] > iterationCount;
+            if(!faceMask[i])
+            {
+                unselectedPoints.push_back(baseMesh.vertices[f.indices[k]].position);
+            }
+        }
+        isDeep[i] = deep;
+    }
+
+    checker.expect(
+        matchPositions(unselectedPoints, masked, 1e-6f * extent), "face mask: vertex of an unselected face moved");
+
+    const SubdivisionHierarchy hierarchy(baseMesh);
+    std::vector<Vec3> deepPoints;
+    for(uint32_t f = 0; f < uniform.faces.size(); ++f)
+    {
+        if(isDeep[hierarchy.getBaseFace(iterationCount, f)])
+        {
+            for(int k = 0; k < 4; ++k)
+            {
+                deepPoints.push_back(uniform.vertices[uniform.faces[f].indices[k]].position);
+            }
+        }
+    }
+
+    checker.expect(!deepPoints.empty(), "face mask: no selected face is far from the border");
+    checker.expect(
+        matchPositions(deepPoints, masked, 1e-6f * extent),
+        "face mask: selected faces far from the border differ from uniform subdivision");
+}
@@ -0,0 +1,149 @@
+#include <cmath>
+#include <tuple>
+#include <unordered_map>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/limit_patch.h>
+#include <catmull_clark/patch_export.h>
+
+#include "check.h"
+
+namespace
+{
+
+    struct EdgeSample
+    {
+        Vec3     position;
+        uint32_t patch;
+    };
+
+    /**
+     * @brief 每个样本都能在另一个曲面片的边界上找到距离不超过tolerance的样本，返回最大的缝隙
+     */
+    float computeMaxGap(const std::vector<EdgeSample> &samples, float cellSize)
+    {
+        using Cell = std::tuple<int64_t, int64_t, int64_t>;
+
+        auto cellOf = [&](const Vec3 &p)
+        {
+            return Cell(
+                int64_t(std::floor(p.x / cellSize)),
+                int64_t(std::floor(p.y / cellSize)),
+                int64_t(std::floor(p.z / cellSize)));
+        };
+
+        struct CellHash
+        {
+            size_t operator()(const Cell &c) const noexcept
+            {
+                return std::hash<int64_t>()(std::get<0>(c) * 73856093 ^ std::get<1>(c) * 19349663 ^ std::get<2>(c) * 83492791);
+            }
+        };
+
+        std::unordered_map<Cell, std::vector<uint32_t>, CellHash> grid;
+        for(uint32_t i = 0; i < samples.size(); ++i)
+        {
+            grid[cellOf(samples[i].position)].push_back(i);
+        }
+
+        float maxGap = 0;
+        for(auto &s : samples)
+        {
+            const auto [x, y, z] = cellOf(s.position);
+
+            float nearest = (std::numeric_limits<float>::max)();
+            for(int dx = -1; dx <= 1; ++dx)
+            {
+                for(int dy = -1; dy <= 1; ++dy)
+                {
+                    for(int dz = -1; dz <= 1; ++dz)
+                    {
+                        auto it = grid.find({ x + dx, y + dy, z + dz });
+                        if(it == grid.end())
+                        {
+                            continue;
+                        }
+
+                        for(uint32_t j : it->second)
+                        {
+                            if(samples[j].patch != s.patch)
+                            {
+                                nearest = (std::min)(nearest, (samples[j].position - s.position).length());
+                            }
+                        }
+                    }
+                }
+            }
+
+            maxGap = (std::max)(maxGap, nearest);
+        }
+
+        return maxGap;
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief 封闭模型在隔离层级1上使用Gregory曲面片时，相邻曲面片的公共边完全一致
+ *
+ * 模型先细分一次，使每个面都是四边形且奇异顶点互不相邻，Regular与Gregory曲面片同时出现。
+ * 每个曲面片的边界按其所在层级加密采样，使不同层级的曲面片在公共边上的样本点重合；
+ * 每个样本点都须在另一个曲面片的边界上有对应的点，导出结果中的Gregory曲面片数量与曲面片表一致
+ */
+void checkGregoryPatches(Checker &checker)
+{
+    for(const char *name : { "cube.obj", "bunny.obj" })
+    {
+        const std::string prefix = std::string("gregory (") + name + "): ";
+
+        const Mesh baseMesh = applyCatmullClarkSubdivision(checker.loadAsset(name), 1);
+        const float extent = computeExtent(baseMesh);
+
+        LimitPatchOptions options;
+        options.isolationLevel = 1;
+        options.endCap = LimitEndCap::Gregory;
+        const LimitPatchTable table(baseMesh, options);
+
+        int maxLevel = 0;
+        size_t gregoryCount = 0;
+        for(auto &patch : table.getPatches())
+        {
+            maxLevel = (std::max)(maxLevel, patch.level);
+            gregoryCount += patch.type == LimitPatchType::Gregory;
+        }
+        checker.expect(gregoryCount > 0 && gregoryCount < table.getPatchCount(), prefix + "no mix of Regular and Gregory patches");
+
+        std::vector<EdgeSample> samples;
+        for(uint32_t patch = 0; patch < table.getPatchCount(); ++patch)
+        {
+            checker.expect(
+                table.getPatch(patch).type != LimitPatchType::Bilinear, prefix + "bilinear patch on a closed mesh");
+
+            const int n = 8 << (maxLevel - table.getPatch(patch).level);
+            for(int i = 0; i <= n; ++i)
+            {
+                const float t = float(i) / n;
+                for(const Vec2 &st : { Vec2(t, 0), Vec2(1, t), Vec2(t, 1), Vec2(0, t) })
+                {
+                    Vec3 position, normal;
+                    table.evaluate(patch, st, position, normal);
+                    samples.push_back({ position, patch });
+                }
+            }
+        }
+
+        const float maxGap = computeMaxGap(samples, 1e-4f * extent);
+        checker.expect(
+            maxGap <= 1e-6f * extent,
+            prefix + "gap between adjacent patches is " + std::to_string(maxGap / extent) + " of the extent");
+
+        PatchExportOptions exportOptions;
+        exportOptions.isolationLevel = 1;
+        const PatchExport exported = exportPatches(baseMesh, exportOptions);
+        checker.expect(exported.gregoryPatches.size() == gregoryCount, prefix + "exported Gregory patch count differs");
+        checker.expect(
+            exported.gregoryPoints.size() == 20 * exported.gregoryPatches.size() &&
+            exported.regularPoints.size() == 16 * exported.regularPatches.size(),
+            prefix + "exported control point count differs");
+    }
+}
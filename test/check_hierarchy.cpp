@@ -0,0 +1,79 @@
+#include <cmath>
+#include <stdexcept>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/hierarchy.h>
+
+#include "check.h"
+
+namespace
+{
+
+    bool sameLocation(const SurfaceLocation &a, const SurfaceLocation &b)
+    {
+        return a.baseFace == b.baseFace && a.subFace == b.subFace && (a.uv - b.uv).length() <= 1e-6f;
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief SubdivisionHierarchy的查询与applyCatmullClarkSubdivision的输出顺序一致，无效的层级与面下标抛出异常
+ *
+ * 父面p的四个子面4p + k共享face point，相邻子面共享边上的edge point；
+ * 子面的第1个顶点由父面的第k个顶点得到，两者在两层中的SurfaceLocation须相同
+ */
+void checkHierarchy(Checker &checker)
+{
+    const Mesh baseMesh = checker.loadAsset("head.obj");
+    const SubdivisionHierarchy hierarchy(baseMesh);
+
+    const Vec2 corners[4] = { Vec2(0, 0), Vec2(1, 0), Vec2(1, 1), Vec2(0, 1) };
+
+    Mesh parent = applyCatmullClarkSubdivision(baseMesh, 1);
+    for(int level = 1; level <= 3; ++level)
+    {
+        const std::string prefix = "hierarchy (level " + std::to_string(level) + "): ";
+        const Mesh child = applyCatmullClarkSubdivision(parent, 1);
+
+        checker.expect(hierarchy.getFaceCount(level) == parent.faces.size(), prefix + "face count differs");
+
+        bool sharedVertices = true, sameCorner = true, rangesMatch = true;
+        for(uint32_t p = 0; p < parent.faces.size(); ++p)
+        {
+            const FaceRange children = hierarchy.getChildren(level, p);
+            rangesMatch &= children.begin == 4 * p && children.end == 4 * p + 4;
+
+            const uint32_t baseFace = hierarchy.getBaseFace(level, p);
+            const FaceRange descendants = hierarchy.getFaceRange(level, baseFace);
+            rangesMatch &= descendants.begin <= p && p < descendants.end;
+
+            for(uint32_t k = 0; k < 4; ++k)
+            {
+                const uint32_t c = 4 * p + k;
+                rangesMatch &= hierarchy.getParent(level + 1, c) == p;
+
+                const uint32_t next = 4 * p + (k + 1) % 4;
+                sharedVertices &= child.faces[c].indices[3] == child.faces[4 * p].indices[3];
+                sharedVertices &= child.faces[c].indices[2] == child.faces[next].indices[0];
+                sameCorner &= sameLocation(
+                    hierarchy.locate(level + 1, c, corners[1]), hierarchy.locate(level, p, corners[k]));
+            }
+        }
+
+        checker.expect(rangesMatch, prefix + "parent, children or base face ranges disagree");
+        checker.expect(sharedVertices, prefix + "output order is not hierarchical");
+        checker.expect(sameCorner, prefix + "child corner location differs from the parent corner");
+
+        parent = child;
+    }
+
+    checker.expectThrow<std::runtime_error>(
+        [&] { hierarchy.getFaceCount(-1); }, "hierarchy: negative level is accepted");
+    checker.expectThrow<std::runtime_error>(
+        [&] { hierarchy.getFaceCount(20); }, "hierarchy: level beyond 32-bit face indices is accepted");
+    checker.expectThrow<std::runtime_error>(
+        [&] { hierarchy.getBaseFace(1, static_cast<uint32_t>(hierarchy.getFaceCount(1))); },
+        "hierarchy: face index out of range is accepted");
+    checker.expectThrow<std::runtime_error>(
+        [&] { hierarchy.getParent(0, 0); }, "hierarchy: base face has a parent");
+}
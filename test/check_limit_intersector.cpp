@@ -0,0 +1,48 @@
+#include <catmull_clark/closest_point.h>
+#include <catmull_clark/limit_intersector.h>
+#include <catmull_clark/limit_patch.h>
+
+#include "check.h"
+
+/**
+ * @brief 直接与极限曲面求交时，交点与交点处的参数都在文档给出的误差之内
+ *
+ * 圆环面的所有顶点都是正则的，曲面片表即为精确的极限曲面
+ */
+void checkLimitIntersector(Checker &checker)
+{
+    const Mesh baseMesh = checker.loadAsset("torus.obj");
+    const float extent = computeExtent(baseMesh);
+
+    LimitIntersectorOptions options;
+    options.tolerance = 1e-3f * extent;
+    LimitSurfaceIntersector intersector(baseMesh, options);
+
+    const LimitPatchTable table(baseMesh);
+    const LimitSurfaceProjector projector(table);
+
+    const float bound = 1.02f * options.tolerance + 1e-5f * extent;
+
+    size_t hitCount = 0;
+    for(auto &ray : generateRays(baseMesh, 200))
+    {
+        SurfaceHit hit;
+        if(!intersector.intersect(ray, hit))
+        {
+            continue;
+        }
+
+        ++hitCount;
+        checker.expect(
+            projector.project(hit.meshHit.position).distance <= bound,
+            "limit intersector: hit is farther than the error bound from the limit surface");
+
+        Vec3 position, normal;
+        table.evaluate(hit.location, position, normal);
+        checker.expect(
+            (position - hit.meshHit.position).length() <= bound,
+            "limit intersector: hit location does not evaluate to the hit position");
+    }
+
+    checker.expect(hitCount > 0, "limit intersector: no ray hit the surface");
+}
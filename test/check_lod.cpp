@@ -0,0 +1,42 @@
+#include <stdexcept>
+
+#include <catmull_clark/lod.h>
+
+#include "check.h"
+
+/**
+ * @brief 投影尺度在阈值附近波动时层级不来回切换，明显变小后才降低层级；越界的层级被拒绝
+ */
+void checkLodSelection(Checker &checker)
+{
+    LodChain chain(checker.loadAsset("cube.obj"), 4);
+    LodSelector selector;
+
+    int level = selector.select(chain, 1);
+    float switchScale = 0;
+    for(float scale = 1; scale < 1e4f; scale *= 1.01f)
+    {
+        const int next = selector.select(chain, scale);
+        checker.expect(next >= level, "lod: level decreased while zooming in");
+        if(next > level)
+        {
+            switchScale = scale;
+            level = next;
+            break;
+        }
+    }
+
+    checker.expect(switchScale > 0, "lod: level never increased");
+
+    for(int i = 0; i < 10; ++i)
+    {
+        selector.select(chain, switchScale * 0.9f);
+        checker.expect(selector.select(chain, switchScale) == level, "lod: level flips near the threshold");
+    }
+
+    checker.expect(selector.select(chain, switchScale * 0.6f) < level, "lod: level kept after zooming out");
+
+    checker.expectThrow<std::out_of_range>([&] { chain.getMesh(5); }, "lod: level above the max level accepted");
+    checker.expectThrow<std::out_of_range>([&] { chain.getEdges(-1); }, "lod: negative level accepted");
+    checker.expect(!chain.isLevelReady(5), "lod: level above the max level reported ready");
+}
@@ -0,0 +1,175 @@
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+#include <catmull_clark/mesh_io.h>
+
+#include "check.h"
+
+Mesh Checker::loadAsset(const std::string &name) const
+{
+    return loadMesh(assetDirectory_ + "/" + name);
+}
+
+float computeExtent(const Mesh &mesh)
+{
+    Vec3 low, high;
+    computeBoundingBox(mesh, low, high);
+    return (high - low).max_elem();
+}
+
+std::vector<Ray> generateRays(const Mesh &mesh, size_t count)
+{
+    Vec3 low, high;
+    computeBoundingBox(mesh, low, high);
+    const Vec3 center = 0.5f * (low + high);
+    const float extent = (high - low).max_elem();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dis(-1, 1);
+    auto randomVec = [&] { return Vec3(dis(rng), dis(rng), dis(rng)); };
+
+    std::vector<Ray> rays(count);
+    for(auto &ray : rays)
+    {
+        ray.origin = center + 3 * extent * randomVec();
+        const Vec3 target = center + 0.3f * extent * randomVec();
+        ray.direction = (target - ray.origin).normalize();
+    }
+    return rays;
+}
+
+MeshView makeMeshView(const Mesh &mesh, std::vector<uint8_t> &counts, std::vector<uint32_t> &indices)
+{
+    counts.clear();
+    indices.clear();
+    for(auto &f : mesh.faces)
+    {
+        const int n = f.isQuad ? 4 : 3;
+        counts.push_back(static_cast<uint8_t>(n));
+        indices.insert(indices.end(), f.indices, f.indices + n);
+    }
+
+    MeshView result;
+    result.positions        = { &mesh.vertices[0].position.x, sizeof(Vertex), mesh.vertices.size() };
+    result.faceVertexCounts = { counts.data(), counts.size() };
+    result.indices          = { indices.data(), indices.size() };
+    return result;
+}
+
+bool matchPositions(const std::vector<Vec3> &points, const Mesh &reference, float tolerance)
+{
+    auto cellOf = [&](const Vec3 &p)
+    {
+        return std::make_tuple(
+            int64_t(std::floor(p.x / tolerance)),
+            int64_t(std::floor(p.y / tolerance)),
+            int64_t(std::floor(p.z / tolerance)));
+    };
+
+    struct CellHash
+    {
+        size_t operator()(const std::tuple<int64_t, int64_t, int64_t> &c) const noexcept
+        {
+            return std::hash<int64_t>()(std::get<0>(c) * 73856093 ^ std::get<1>(c) * 19349663 ^ std::get<2>(c) * 83492791);
+        }
+    };
+
+    std::unordered_map<std::tuple<int64_t, int64_t, int64_t>, std::vector<Vec3>, CellHash> grid;
+    for(auto &v : reference.vertices)
+    {
+        grid[cellOf(v.position)].push_back(v.position);
+    }
+
+    for(auto &p : points)
+    {
+        const auto [x, y, z] = cellOf(p);
+
+        bool found = false;
+        for(int dx = -1; dx <= 1 && !found; ++dx)
+        {
+            for(int dy = -1; dy <= 1 && !found; ++dy)
+            {
+                for(int dz = -1; dz <= 1 && !found; ++dz)
+                {
+                    auto it = grid.find({ x + dx, y + dy, z + dz });
+                    if(it == grid.end())
+                    {
+                        continue;
+                    }
+
+                    for(auto &q : it->second)
+                    {
+                        if((p - q).length() <= tolerance)
+                        {
+                            found = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if(!found)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+namespace
+{
+
+    void run(int argc, char *argv[])
+    {
+        Checker checker(argc > 1 ? argv[1] : "./asset");
+
+        checkLodSelection(checker);
+        checkVertexStream(checker);
+        checkEdgeTable(checker);
+        checkOptimizer(checker);
+        checkQuantization(checker);
+        checkClusters(checker);
+        checkPicking(checker);
+        checkLimitIntersector(checker);
+        checkClosestPoint(checker);
+        checkSurfaceSampler(checker);
+        checkGregoryPatches(checker);
+        checkFaceGrids(checker);
+        checkHierarchy(checker);
+        checkFaceMask(checker);
+        checkToleranceSubdivision(checker);
+        checkMeshValidation(checker);
+        checkBufferSubdivision(checker);
+        checkCApi(checker);
+        checkSharedMesh(checker);
+        checkSubdivisionService(checker);
+        checkTopologyFile(checker);
+        checkTopologyCache(checker);
+
+        if(checker.getFailureCount())
+        {
+            throw std::runtime_error(std::to_string(checker.getFailureCount()) + " check(s) failed");
+        }
+
+        std::cout << "all checks passed" << std::endl;
+    }
+
+} // namespace anonymous
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        run(argc, argv);
+    }
+    catch(const std::exception &err)
+    {
+        std::cout << err.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <array>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/mesh_optimizer.h>
+
+#include "check.h"
+
+namespace
+{
+
+    uint32_t getIndex(const RenderMesh &mesh, size_t i, bool line)
+    {
+        if(line)
+        {
+            return mesh.isIndex16() ? mesh.lineIndices16[i] : mesh.lineIndices32[i];
+        }
+        return mesh.isIndex16() ? mesh.indices16[i] : mesh.indices32[i];
+    }
+
+    uint32_t toMeshVertex(const RenderMesh &mesh, uint32_t index)
+    {
+        return mesh.vertexRemap.empty() ? index : mesh.vertexRemap[index];
+    }
+
+    /**
+     * @brief 以网格顶点下标表示的三角形，旋转到最小下标在前，保持环绕方向
+     */
+    std::vector<std::array<uint32_t, 3>> collectTriangles(const RenderMesh &mesh)
+    {
+        std::vector<std::array<uint32_t, 3>> result;
+        for(size_t i = 0; i + 2 < mesh.getIndexCount(); i += 3)
+        {
+            std::array<uint32_t, 3> t = {
+                toMeshVertex(mesh, getIndex(mesh, i, false)),
+                toMeshVertex(mesh, getIndex(mesh, i + 1, false)),
+                toMeshVertex(mesh, getIndex(mesh, i + 2, false))
+            };
+            std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+            result.push_back(t);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> collectLines(const RenderMesh &mesh)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> result;
+        for(size_t i = 0; i + 1 < mesh.getLineIndexCount(); i += 2)
+        {
+            const uint32_t a = toMeshVertex(mesh, getIndex(mesh, i, true));
+            const uint32_t b = toMeshVertex(mesh, getIndex(mesh, i + 1, true));
+            result.push_back({ (std::min)(a, b), (std::max)(a, b) });
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief 优化只重排三角形与顶点：vertexRemap是一个排列，三角形（含环绕方向）与线段不变，ACMR不变差
+ */
+void checkOptimizer(Checker &checker)
+{
+    const Mesh baseMesh = checker.loadAsset("head.obj");
+
+    // 细分3次时使用16位索引，4次时使用32位索引
+
+    for(int level : { 3, 4 })
+    {
+        const std::string prefix = "optimizer (level " + std::to_string(level) + "): ";
+
+        std::vector<Edge> edges;
+        const Mesh mesh = applyCatmullClarkSubdivision(baseMesh, level, edges);
+
+        const RenderMesh original = buildRenderMesh(mesh, edges);
+        RenderMesh optimized = buildRenderMesh(mesh, edges);
+        optimizeRenderMesh(optimized);
+
+        std::vector<uint32_t> remap = optimized.vertexRemap;
+        std::sort(remap.begin(), remap.end());
+        bool isPermutation = remap.size() == mesh.vertices.size();
+        for(size_t i = 0; isPermutation && i < remap.size(); ++i)
+        {
+            isPermutation = remap[i] == i;
+        }
+        checker.expect(isPermutation, prefix + "vertexRemap is not a permutation");
+        if(!isPermutation)
+        {
+            continue;
+        }
+
+        bool sameVertices = true;
+        for(size_t i = 0; i < optimized.vertices.size(); ++i)
+        {
+            sameVertices &= optimized.vertices[i].position == original.vertices[optimized.vertexRemap[i]].position;
+        }
+        checker.expect(sameVertices, prefix + "vertices do not follow vertexRemap");
+
+        checker.expect(collectTriangles(optimized) == collectTriangles(original), prefix + "triangles changed");
+        checker.expect(collectLines(optimized) == collectLines(original), prefix + "lines changed");
+
+        checker.expect(
+            analyzeVertexCache(optimized).acmr <= analyzeVertexCache(original).acmr,
+            prefix + "ACMR got worse");
+    }
+}
@@ -0,0 +1,97 @@
+#include <cmath>
+
+#include <catmull_clark/bvh.h>
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/hierarchy.h>
+#include <catmull_clark/limit_patch.h>
+
+#include "check.h"
+
+namespace
+{
+
+    /**
+     * @brief 逐个三角形求最近交点，三角形的划分与MeshBVH相同
+     */
+    bool intersectBruteForce(const Mesh &mesh, const Ray &ray, float &t)
+    {
+        bool found = false;
+        t = ray.tMax;
+
+        for(auto &f : mesh.faces)
+        {
+            for(int h = 0; h < (f.isQuad ? 2 : 1); ++h)
+            {
+                const Vec3 &a = mesh.vertices[f.indices[0]].position;
+                const Vec3 ab = mesh.vertices[f.indices[h + 1]].position - a;
+                const Vec3 ac = mesh.vertices[f.indices[h + 2]].position - a;
+
+                const Vec3 p = cross(ray.direction, ac);
+                const float det = dot(ab, p);
+                if(std::abs(det) < 1e-20f)
+                {
+                    continue;
+                }
+
+                const Vec3 s = ray.origin - a;
+                const float b1 = dot(s, p) / det;
+                const Vec3 q = cross(s, ab);
+                const float b2 = dot(ray.direction, q) / det;
+                const float candidate = dot(ac, q) / det;
+                if(b1 >= 0 && b2 >= 0 && b1 + b2 <= 1 && candidate >= ray.tMin && candidate < t)
+                {
+                    t = candidate;
+                    found = true;
+                }
+            }
+        }
+
+        return found;
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief MeshBVH与逐个三角形求交的结果一致，intersectSurface给出的原始面参数对应交点附近的极限曲面
+ */
+void checkPicking(Checker &checker)
+{
+    const int level = 3;
+    const Mesh baseMesh = checker.loadAsset("torus.obj");
+    const Mesh mesh = applyCatmullClarkSubdivision(baseMesh, level);
+    const float extent = computeExtent(baseMesh);
+
+    const MeshBVH bvh(mesh);
+    const SubdivisionHierarchy hierarchy(baseMesh);
+    const LimitPatchTable table(baseMesh);
+
+    checker.expect(bvh.getTriangleCount() == 2 * mesh.faces.size(), "picking: BVH triangle count differs");
+
+    size_t hitCount = 0;
+    for(auto &ray : generateRays(baseMesh, 200))
+    {
+        float t;
+        const bool expected = intersectBruteForce(mesh, ray, t);
+
+        SurfaceHit hit;
+        const bool found = intersectSurface(bvh, hierarchy, level, ray, hit);
+
+        checker.expect(found == expected, "picking: BVH and brute force disagree on hit");
+        checker.expect(bvh.occluded(ray) == expected, "picking: occluded and brute force disagree");
+        if(!found || !expected)
+        {
+            continue;
+        }
+
+        ++hitCount;
+        checker.expect(std::abs(hit.meshHit.t - t) <= 1e-5f * extent, "picking: BVH hit distance differs");
+
+        Vec3 position, normal;
+        table.evaluate(hit.location, position, normal);
+        checker.expect(
+            (position - hit.meshHit.position).length() <= 1e-2f * extent,
+            "picking: base face location is far from the hit position");
+    }
+
+    checker.expect(hitCount > 0, "picking: no ray hit the mesh");
+}
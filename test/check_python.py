@@ -0,0 +1,145 @@
+"""
+检查Python接口：输出数量、带步长的输入输出、多线程与单线程的一致性及错误的报告方式。
+
+用法：python check_python.py <asset目录>；catmull_clark模块与动态库的查找方式见python/catmull_clark.py。
+未安装NumPy时返回77，CTest据此把检查标记为跳过
+"""
+
+import os
+import sys
+
+try:
+    import numpy as np
+except ImportError:
+    print('NumPy not found, skipping Python checks')
+    sys.exit(77)
+
+import catmull_clark as cc
+
+_failures = []
+
+
+def expect(condition, message):
+    if not condition:
+        _failures.append(message)
+        print('check failed: ' + message)
+
+
+def expect_raise(exception, func, message):
+    try:
+        func()
+    except exception:
+        return
+    except Exception as e:
+        expect(False, '%s (raised %s)' % (message, type(e).__name__))
+        return
+    expect(False, message)
+
+
+def load_obj(path):
+    """只读取顶点位置与各面的顶点下标"""
+    positions, counts, indices = [], [], []
+    with open(path) as file:
+        for line in file:
+            tokens = line.split()
+            if not tokens:
+                continue
+            if tokens[0] == 'v':
+                positions.append([float(x) for x in tokens[1:4]])
+            elif tokens[0] == 'f':
+                face = [int(t.split('/')[0]) - 1 for t in tokens[1:]]
+                counts.append(len(face))
+                indices += face
+    return np.array(positions, np.float32), np.array(counts, np.uint8), np.array(indices, np.int64)
+
+
+def check_cube(asset_directory):
+    """立方体细分一次：8个原顶点、12个边点与6个面点，面点即各面的中心"""
+    positions, counts, indices = load_obj(os.path.join(asset_directory, 'cube.obj'))
+
+    topology = cc.Topology(counts, indices, len(positions), 1)
+    expect(topology.input_vertex_count == 8, 'cube: input vertex count')
+    expect(topology.output_vertex_count == 26, 'cube: output vertex count')
+    expect(topology.output_face_count == 24, 'cube: output face count')
+
+    result, quads = cc.subdivide(positions, counts, indices, 1)
+    expect(result.shape == (26, 3) and result.dtype == np.float32, 'cube: result shape or dtype')
+    expect(quads.shape == (24, 4) and quads.max() < 26, 'cube: quads shape or range')
+
+    face_centers = positions[indices.reshape(-1, 4)].mean(axis=1)
+    distances = np.abs(result[None, :, :] - face_centers[:, None, :]).max(axis=2).min(axis=1)
+    expect(distances.max() < 1e-6, 'cube: face points are not the face centers')
+
+
+def check_model(asset_directory, name, iterations):
+    positions, counts, indices = load_obj(os.path.join(asset_directory, name))
+
+    topology = cc.Topology(counts, indices.astype(np.int32), len(positions), iterations)
+    expect(topology.output_face_count == int(counts.sum()) * 4 ** (iterations - 1),
+           '%s: output face count' % name)
+
+    reference, reference_quads = cc.subdivide(positions, counts, indices, iterations)
+
+    # 输入与输出都是交错顶点缓冲区中的3列，结果应写入给定的数组且与连续数组的结果相同
+    interleaved = np.zeros((len(positions), 8), np.float32)
+    interleaved[:, 2:5] = positions
+    output = np.zeros((topology.output_vertex_count, 6), np.float32)
+
+    result = topology.evaluator().evaluate(interleaved[:, 2:5], out=output[:, 0:3])
+    expect(np.shares_memory(result, output), '%s: result was not written into out' % name)
+    expect(np.array_equal(output[:, 0:3], reference), '%s: strided evaluation differs' % name)
+    expect(not output[:, 3:6].any(), '%s: evaluation wrote outside its columns' % name)
+
+    single = cc.Topology(counts, indices, len(positions), iterations, multithreaded=False)
+    expect(np.array_equal(single.quads(), reference_quads), '%s: single-threaded quads differ' % name)
+    expect(np.array_equal(single.evaluator(multithreaded=False).evaluate(positions), reference),
+           '%s: single-threaded evaluation differs' % name)
+
+    if topology.output_vertex_count <= 65536:
+        expect(np.array_equal(topology.quads(np.uint16), reference_quads), '%s: uint16 quads differ' % name)
+
+
+def check_errors():
+    counts = np.array([3], np.uint8)
+    positions = np.zeros((3, 3), np.float32)
+
+    expect_raise(cc.SubdivisionError, lambda: cc.Topology(counts, np.array([0, 1, 7]), 3, 1),
+                 'errors: out-of-range index accepted')
+    expect_raise(cc.SubdivisionError, lambda: cc.Topology(counts, np.array([0, 1, 2]), 3, 0),
+                 'errors: zero iterations accepted')
+
+    topology = cc.Topology(counts, np.array([0, 1, 2]), 3, 1)
+    evaluator = topology.evaluator()
+    expect_raise(ValueError, lambda: evaluator.evaluate(np.zeros((3, 4), np.float32)),
+                 'errors: positions of wrong shape accepted')
+    expect_raise(ValueError, lambda: evaluator.evaluate(positions, out=np.zeros((1, 3), np.float32)),
+                 'errors: too small out accepted')
+    expect_raise(ValueError, lambda: topology.quads(np.int8), 'errors: unsupported quad dtype accepted')
+
+    try:
+        cc.Topology(counts, np.array([0, 1, 7]), 3, 1)
+    except cc.SubdivisionError as e:
+        expect(e.code != 0 and str(e), 'errors: SubdivisionError without code or message')
+
+
+def main():
+    if len(sys.argv) != 2:
+        print('usage: check_python.py <asset directory>')
+        return 2
+
+    asset_directory = sys.argv[1]
+    check_cube(asset_directory)
+    check_model(asset_directory, 'torus.obj', 3)
+    check_model(asset_directory, 'bunny.obj', 2)
+    check_errors()
+
+    if _failures:
+        print('%d check(s) failed' % len(_failures))
+        return 1
+
+    print('all checks passed')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
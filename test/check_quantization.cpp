@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cmath>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/render_mesh.h>
+
+#include "check.h"
+
+namespace
+{
+
+    float fromSnorm16(int16_t v)
+    {
+        return (std::max)(v / 32767.0f, -1.0f);
+    }
+
+    /**
+     * @brief 与着色器相同的八面体解码
+     */
+    Vec3 decodeNormal(const int16_t q[2])
+    {
+        Vec3 n(fromSnorm16(q[0]), fromSnorm16(q[1]), 0);
+        n.z = 1 - std::abs(n.x) - std::abs(n.y);
+        const float t = (std::max)(-n.z, 0.0f);
+        n.x += n.x >= 0 ? -t : t;
+        n.y += n.y >= 0 ? -t : t;
+        return n.normalize();
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief 解码后的位置与法线误差不超过quantizationError，且在16位量化的理论误差之内
+ */
+void checkQuantization(Checker &checker)
+{
+    const Mesh mesh = applyCatmullClarkSubdivision(checker.loadAsset("head.obj"), 3);
+
+    RenderMeshOptions options;
+    options.normalWeighting = NormalWeighting::Limit;
+    const std::vector<RenderVertex> vertices = buildRenderMesh(mesh, options).vertices;
+
+    options.quantize = true;
+    const RenderMesh quantized = buildRenderMesh(mesh, options);
+
+    checker.expect(quantized.isQuantized() && quantized.vertices.empty(), "quantization: mesh not quantized");
+    checker.expect(quantized.quantizedVertices.size() == vertices.size(), "quantization: vertex count differs");
+    if(quantized.quantizedVertices.size() != vertices.size())
+    {
+        return;
+    }
+
+    // 量化空间以包围盒中心为原点、以最大半边长统一缩放
+
+    Vec3 low = vertices[0].position, high = vertices[0].position;
+    for(auto &v : vertices)
+    {
+        low  = Vec3((std::min)(low.x, v.position.x), (std::min)(low.y, v.position.y), (std::min)(low.z, v.position.z));
+        high = Vec3((std::max)(high.x, v.position.x), (std::max)(high.y, v.position.y), (std::max)(high.z, v.position.z));
+    }
+    const Vec3 center = 0.5f * (low + high);
+    const float halfExtent = 0.5f * (high - low).max_elem();
+
+    float maxPositionError = 0, maxNormalError = 0;
+    for(size_t i = 0; i < vertices.size(); ++i)
+    {
+        auto &q = quantized.quantizedVertices[i];
+        const Vec3 position = center + halfExtent * Vec3(
+            fromSnorm16(q.position[0]), fromSnorm16(q.position[1]), fromSnorm16(q.position[2]));
+
+        maxPositionError = (std::max)(maxPositionError, (position - vertices[i].position).length());
+
+        const Vec3 normal = decodeNormal(q.normal);
+        maxNormalError = (std::max)(maxNormalError, std::atan2(cross(normal, vertices[i].normal).length(), dot(normal, vertices[i].normal)));
+    }
+    const float maxNormalErrorDegrees = maxNormalError * 180 / agz::math::PI_f;
+
+    const QuantizationError &reported = quantized.quantizationError;
+
+    // 每个坐标的舍入误差不超过半个量化步长，另留出浮点运算的余量
+
+    const float positionBound = std::sqrt(3.0f) * 0.5f * halfExtent / 32767 * 1.01f + 1e-6f * halfExtent;
+
+    checker.expect(maxPositionError <= reported.maxPositionError * 1.001f + 1e-7f * halfExtent,
+                   "quantization: position error exceeds the reported error");
+    checker.expect(reported.maxPositionError <= positionBound, "quantization: position error above the 16-bit bound");
+    checker.expect(maxNormalErrorDegrees <= reported.maxNormalErrorDegrees * 1.001f + 1e-5f,
+                   "quantization: normal error exceeds the reported error");
+    checker.expect(reported.maxNormalErrorDegrees <= 0.01f, "quantization: normal error above 0.01 degrees");
+}
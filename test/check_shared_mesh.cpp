@@ -0,0 +1,77 @@
+#include <memory>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include <catmull_clark/shared_mesh.h>
+
+#include "check.h"
+
+/**
+ * @brief 读取方读到写入方发布的完整帧；被同名的新写入方替换的写入方析构时不删除新共享内存的名字
+ */
+void checkSharedMesh(Checker &checker)
+{
+#if !defined(_WIN32)
+    const Mesh mesh = checker.loadAsset("torus.obj");
+
+    std::vector<uint8_t> counts;
+    std::vector<uint32_t> indices;
+    const MeshView view = makeMeshView(mesh, counts, indices);
+
+    const SubdivisionTopology topology(
+        { counts.data(), sizeof(uint8_t), counts.size(), IndexFormat::UInt8 },
+        { indices.data(), sizeof(uint32_t), indices.size(), IndexFormat::UInt32 },
+        mesh.vertices.size(), 2);
+
+    std::vector<float> expected(3 * topology.getOutputVertexCount());
+    std::vector<std::byte> workspace(topology.getWorkspaceBytes());
+    topology.evaluate(
+        view.positions, { expected.data(), 3 * sizeof(float), topology.getOutputVertexCount() },
+        { workspace.data(), workspace.size() });
+
+    const std::string name = "/catmull_clark_check_" + std::to_string(getpid());
+
+    auto oldWriter = std::make_unique<SharedMeshWriter>(
+        name, topology.getOutputVertexCount(), topology.getOutputFaceCount());
+
+    {
+        SharedMeshReader reader(name);
+        checker.expect(reader.getLatestSequence() == 0, "shared mesh: sequence before the first frame");
+
+        const uint64_t sequence = oldWriter->publish(topology, view.positions, { workspace.data(), workspace.size() });
+
+        std::vector<float> positions;
+        std::vector<uint32_t> outputIndices;
+        const ArrayView<const uint32_t> referenceIndices = topology.getOutputIndices();
+
+        checker.expect(sequence == 1 && reader.copyLatest(positions, outputIndices) == sequence,
+                       "shared mesh: published frame not visible to the reader");
+        checker.expect(positions == expected, "shared mesh: positions differ from evaluate");
+        checker.expect(outputIndices == std::vector<uint32_t>(
+                           referenceIndices.data, referenceIndices.data + referenceIndices.size),
+                       "shared mesh: indices differ from the topology");
+    }
+
+    // 新的写入方替换同名的共享内存，旧的写入方析构后名字仍指向新共享内存
+
+    auto newWriter = std::make_unique<SharedMeshWriter>(name, 16, 16);
+    oldWriter.reset();
+
+    try
+    {
+        SharedMeshReader reader(name);
+        checker.expect(reader.getLatestSequence() == 0, "shared mesh: name refers to the replaced segment");
+    }
+    catch(const std::runtime_error &)
+    {
+        checker.expect(false, "shared mesh: replaced writer removed the name of its successor");
+    }
+
+    newWriter.reset();
+    checker.expectThrow<std::runtime_error>(
+        [&] { SharedMeshReader reader(name); }, "shared mesh: name not removed by its owner");
+#endif
+}
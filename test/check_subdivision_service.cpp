@@ -0,0 +1,185 @@
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include <catmull_clark/shared_mesh.h>
+#include <catmull_clark/subdivision_service.h>
+
+#include "check.h"
+
+#if !defined(_WIN32)
+
+namespace
+{
+
+    struct LocalResult
+    {
+        std::vector<float>    positions;
+        std::vector<uint32_t> indices;
+    };
+
+    LocalResult subdivideLocally(const MeshView &view, int iterationCount)
+    {
+        const SubdivisionTopology topology(
+            { view.faceVertexCounts.data, sizeof(uint8_t), view.faceVertexCounts.size, IndexFormat::UInt8 },
+            { view.indices.data, sizeof(uint32_t), view.indices.size, IndexFormat::UInt32 },
+            view.positions.size, iterationCount);
+
+        LocalResult result;
+        result.positions.resize(3 * topology.getOutputVertexCount());
+        std::vector<std::byte> workspace(topology.getWorkspaceBytes());
+        topology.evaluate(
+            view.positions, { result.positions.data(), 3 * sizeof(float), topology.getOutputVertexCount() },
+            { workspace.data(), workspace.size() });
+
+        const ArrayView<const uint32_t> indices = topology.getOutputIndices();
+        result.indices.assign(indices.data, indices.data + indices.size);
+        return result;
+    }
+
+} // namespace anonymous
+
+#endif
+
+/**
+ * @brief 细分服务的回复与本地细分相同，包括省略下标与经共享内存返回的请求；
+ *        不读取回复的客户端使服务端暂停读取并在写出超时后被断开，不影响其他客户端，stop随后及时返回
+ */
+void checkSubdivisionService(Checker &checker)
+{
+#if !defined(_WIN32)
+    const std::string socketPath = (std::filesystem::temp_directory_path() /
+        ("catmull_clark_check_" + std::to_string(getpid()) + ".sock")).string();
+
+    SubdivisionServerOptions options;
+    options.threadCount = 2;
+    options.maxPendingRequestsPerConnection = 4;
+    options.sendTimeoutMs = 200;
+
+    SubdivisionServer server(socketPath, options);
+    std::thread serverThread([&] { server.run(); });
+
+    const Mesh torus = checker.loadAsset("torus.obj");
+    std::vector<uint8_t> torusCounts;
+    std::vector<uint32_t> torusIndices;
+    const MeshView torusView = makeMeshView(torus, torusCounts, torusIndices);
+    const LocalResult expected = subdivideLocally(torusView, 2);
+
+    // 一个连接上连续发送多个请求，回复以requestId对应
+
+    try
+    {
+        SubdivisionClient client(socketPath);
+
+        const uint64_t requestCount = 12;
+        for(uint64_t id = 0; id < requestCount; ++id)
+        {
+            const uint32_t flags = id % 3 == 1 ? SERVICE_FLAG_OMIT_INDICES :
+                                   id % 3 == 2 ? SERVICE_FLAG_SHARED_MEMORY : 0;
+            client.sendRequest(id, torusView, 2, flags);
+        }
+
+        size_t mismatches = 0;
+        for(uint64_t i = 0; i < requestCount; ++i)
+        {
+            ServiceResponse response = client.receiveResponse();
+            if(response.status != ServiceStatus::Success)
+            {
+                ++mismatches;
+                continue;
+            }
+
+            // 控制点相同，共享内存中最新的帧即为该请求的结果
+
+            if(response.requestId % 3 == 2)
+            {
+                SharedMeshReader reader(response.message);
+                mismatches += reader.getLatestSequence() < response.sequence;
+                reader.copyLatest(response.positions, response.indices);
+            }
+
+            const bool omitIndices = response.requestId % 3 == 1;
+            mismatches += response.positions != expected.positions ||
+                          (omitIndices ? !response.indices.empty() : response.indices != expected.indices);
+        }
+        checker.expect(mismatches == 0, "service: " + std::to_string(mismatches) + " response(s) differ from local subdivision");
+
+        client.sendRequest(requestCount, torusView, options.maxIterationCount + 1);
+        checker.expect(client.receiveResponse().status == ServiceStatus::InvalidRequest,
+                       "service: invalid iteration count accepted");
+    }
+    catch(const std::runtime_error &err)
+    {
+        checker.expect(false, std::string("service: round trip failed: ") + err.what());
+    }
+
+    // 只发送不读取的客户端：服务端最多读取maxPendingRequestsPerConnection个请求，写出超时后断开该连接
+
+    const Mesh bunny = checker.loadAsset("bunny.obj");
+    std::vector<uint8_t> bunnyCounts;
+    std::vector<uint32_t> bunnyIndices;
+    const MeshView bunnyView = makeMeshView(bunny, bunnyCounts, bunnyIndices);
+
+    std::thread slowClient([&]
+    {
+        try
+        {
+            SubdivisionClient client(socketPath);
+            for(uint64_t id = 0; id < 64; ++id)
+            {
+                client.sendRequest(id, bunnyView, 3);
+            }
+        }
+        catch(const std::runtime_error &)
+        {
+            // 服务端断开连接后发送失败
+        }
+    });
+    slowClient.join();
+
+    // 客户端发送失败时，工作线程可能尚未记录写出失败的请求
+
+    SubdivisionServerMetrics metrics = server.getMetrics();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while(!metrics.failedRequests && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        metrics = server.getMetrics();
+    }
+
+    checker.expect(metrics.pausedReads > 0, "service: reading never paused for a client that does not read");
+    checker.expect(metrics.maxQueueDepth <= options.maxPendingRequestsPerConnection,
+                   "service: more requests queued than the per-connection limit");
+    checker.expect(metrics.failedRequests > 0, "service: replies to a client that does not read did not time out");
+
+    try
+    {
+        SubdivisionClient client(socketPath);
+        client.sendRequest(0, torusView, 2);
+        checker.expect(client.receiveResponse().positions == expected.positions,
+                       "service: server unusable after dropping a client");
+    }
+    catch(const std::runtime_error &err)
+    {
+        checker.expect(false, std::string("service: server unusable after dropping a client: ") + err.what());
+    }
+
+    // 连接仍打开、回复未读取时stop也应在写出超时内返回
+
+    SubdivisionClient idleClient(socketPath);
+    idleClient.sendRequest(0, bunnyView, 3);
+    idleClient.sendRequest(1, bunnyView, 3);
+
+    const auto stopTime = std::chrono::steady_clock::now();
+    server.stop();
+    serverThread.join();
+    const auto stopDuration = std::chrono::steady_clock::now() - stopTime;
+
+    checker.expect(stopDuration < std::chrono::seconds(2), "service: stop blocked by a client that does not read");
+#endif
+}
@@ -0,0 +1,119 @@
+#include <cmath>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/hierarchy.h>
+#include <catmull_clark/surface_sampler.h>
+
+#include "check.h"
+
+namespace
+{
+
+    float computeFaceArea(const Mesh &mesh, const Face &f)
+    {
+        const Vec3 &a = mesh.vertices[f.indices[0]].position;
+        const Vec3 &b = mesh.vertices[f.indices[1]].position;
+        const Vec3 &c = mesh.vertices[f.indices[2]].position;
+
+        float area = 0.5f * cross(b - a, c - a).length();
+        if(f.isQuad)
+        {
+            const Vec3 &d = mesh.vertices[f.indices[3]].position;
+            area += 0.5f * cross(c - a, d - a).length();
+        }
+        return area;
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief 面积元不超过getJacobianBound给出的上界；面积估计与样本在各原始面上的分布都与细分结果的面积一致；
+ *        相同的种子给出相同的样本
+ */
+void checkSurfaceSampler(Checker &checker)
+{
+    const Mesh baseMesh = checker.loadAsset("head.obj");
+    const LimitPatchTable table(baseMesh);
+
+    bool bounded = true;
+    const int gridSize = 8;
+    for(uint32_t patch = 0; patch < table.getPatchCount(); ++patch)
+    {
+        const float bound = table.getJacobianBound(patch);
+        for(int i = 0; i <= gridSize; ++i)
+        {
+            for(int j = 0; j <= gridSize; ++j)
+            {
+                PatchDerivatives d;
+                table.evaluate(patch, Vec2(float(i) / gridSize, float(j) / gridSize), d, false);
+                bounded &= cross(d.ds, d.dt).length() <= bound;
+            }
+        }
+    }
+    checker.expect(bounded, "surface sampler: area element exceeds the Jacobian bound");
+
+    // 以细分4次的结果作为参考，按原始面下标分为若干组比较面积占比
+
+    const int level = 4;
+    const Mesh mesh = applyCatmullClarkSubdivision(baseMesh, level);
+    const SubdivisionHierarchy hierarchy(baseMesh);
+
+    const int groupCount = 10;
+    auto groupOf = [&](uint32_t baseFace)
+    {
+        return static_cast<int>(uint64_t(baseFace) * groupCount / baseMesh.faces.size());
+    };
+
+    std::vector<double> groupArea(groupCount, 0);
+    double meshArea = 0;
+    for(uint32_t f = 0; f < mesh.faces.size(); ++f)
+    {
+        const float area = computeFaceArea(mesh, mesh.faces[f]);
+        groupArea[groupOf(hierarchy.getBaseFace(level, f))] += area;
+        meshArea += area;
+    }
+
+    const LimitSurfaceSampler sampler(table);
+    checker.expect(
+        std::abs(sampler.getSurfaceArea() - meshArea) <= 1e-2 * meshArea,
+        "surface sampler: surface area differs from the subdivided mesh");
+
+    const size_t sampleCount = 200000;
+    std::vector<SurfaceSample> samples(sampleCount);
+    sampler.sample(1234, sampleCount, samples.data());
+
+    std::vector<size_t> groupSamples(groupCount, 0);
+    bool onSurface = true;
+    for(size_t i = 0; i < sampleCount; ++i)
+    {
+        auto &s = samples[i];
+        ++groupSamples[groupOf(s.location.baseFace)];
+
+        if(i % 97 == 0)
+        {
+            Vec3 position, normal;
+            table.evaluate(s.location, position, normal);
+            onSurface &= (position - s.position).length() <= 1e-3f * computeExtent(baseMesh);
+        }
+    }
+    checker.expect(onSurface, "surface sampler: sample location does not evaluate to the sample position");
+
+    bool uniform = true;
+    for(int g = 0; g < groupCount; ++g)
+    {
+        const double expected = groupArea[g] / meshArea;
+        const double actual = double(groupSamples[g]) / sampleCount;
+        uniform &= std::abs(actual - expected) <= 0.03 * expected + 1e-3;
+    }
+    checker.expect(uniform, "surface sampler: samples are not distributed by area");
+
+    std::vector<SurfaceSample> again(sampleCount);
+    sampler.sample(1234, sampleCount, again.data());
+
+    bool deterministic = true;
+    for(size_t i = 0; i < sampleCount; ++i)
+    {
+        deterministic &= again[i].position == samples[i].position;
+    }
+    checker.expect(deterministic, "surface sampler: the same seed gives different samples");
+}
@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/closest_point.h>
+#include <catmull_clark/limit_patch.h>
+
+#include "check.h"
+
+/**
+ * @brief 按误差细分时在满足要求的最少次数处停止，估计值与正则曲面上顶点到极限曲面的实际距离相当；
+ *        faceTolerances只决定停止的时机
+ */
+void checkToleranceSubdivision(Checker &checker)
+{
+    // 圆环面的所有顶点都是正则的，曲面片表即为精确的极限曲面
+
+    const Mesh baseMesh = checker.loadAsset("torus.obj");
+    const float extent = computeExtent(baseMesh);
+
+    const LimitPatchTable table(baseMesh);
+    const LimitSurfaceProjector projector(table);
+
+    int previousIterationCount = -1;
+    for(float relativeTolerance : { 1e-2f, 1e-3f, 1e-4f })
+    {
+        const std::string prefix = "tolerance (" + std::to_string(relativeTolerance) + "): ";
+
+        ToleranceSubdivisionOptions options;
+        options.tolerance = relativeTolerance * extent;
+        const ToleranceSubdivisionResult result = applyCatmullClarkSubdivision(baseMesh, options);
+
+        checker.expect(
+            result.errorEstimate == *std::max_element(result.faceErrorEstimates.begin(), result.faceErrorEstimates.end()),
+            prefix + "errorEstimate is not the largest face estimate");
+        checker.expect(
+            result.iterationCount == *std::max_element(result.faceIterationCounts.begin(), result.faceIterationCounts.end()),
+            prefix + "iterationCount is not the largest face iteration count");
+        checker.expect(
+            result.iterationCount == options.maxIterationCount || result.errorEstimate <= options.tolerance,
+            prefix + "stopped before meeting the tolerance");
+        checker.expect(result.iterationCount >= previousIterationCount, prefix + "tighter tolerance refined less");
+        previousIterationCount = result.iterationCount;
+
+        float maxDistance = 0;
+        for(auto &v : result.mesh.vertices)
+        {
+            maxDistance = (std::max)(maxDistance, projector.project(v.position).distance);
+        }
+        checker.expect(
+            maxDistance <= 1.5f * result.errorEstimate && maxDistance >= 0.1f * result.errorEstimate,
+            prefix + "estimate " + std::to_string(result.errorEstimate) +
+            " is far from the measured distance " + std::to_string(maxDistance));
+    }
+
+    // 一半的面要求更严格：其余的面所需的次数更少，但整个模型按最严格的面细分
+
+    ToleranceSubdivisionOptions options;
+    options.faceTolerances.resize(baseMesh.faces.size(), 1e-2f * extent);
+    for(size_t i = 0; i < baseMesh.faces.size(); i += 2)
+    {
+        options.faceTolerances[i] = 1e-4f * extent;
+    }
+    const ToleranceSubdivisionResult result = applyCatmullClarkSubdivision(baseMesh, options);
+
+    checker.expect(
+        result.faceIterationCounts[1] < result.faceIterationCounts[0] &&
+        result.iterationCount == result.faceIterationCounts[0],
+        "tolerance: per-face iteration counts do not follow faceTolerances");
+
+    options.faceTolerances.pop_back();
+    checker.expectThrow<std::runtime_error>(
+        [&] { applyCatmullClarkSubdivision(baseMesh, options); }, "tolerance: face tolerance count mismatch is accepted");
+}
@@ -0,0 +1,108 @@
+#include <filesystem>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/topology_cache.h>
+
+#include "check.h"
+
+namespace
+{
+
+    std::vector<Vec3> getPositions(const Mesh &mesh)
+    {
+        std::vector<Vec3> positions;
+        for(auto &vertex : mesh.vertices)
+        {
+            positions.push_back(vertex.position);
+        }
+        return positions;
+    }
+
+    Vec3 getFaceCenter(const Mesh &mesh, const Face &face)
+    {
+        const int n = face.isQuad ? 4 : 3;
+
+        Vec3 sum;
+        for(int i = 0; i < n; ++i)
+        {
+            sum += mesh.vertices[face.indices[i]].position;
+        }
+        return sum / static_cast<float>(n);
+    }
+
+    /**
+     * @brief 两个网格的顶点位置一一对应（顺序可以不同），且对应的面位于同一位置
+     */
+    bool isSameShape(const Mesh &a, const Mesh &b, float tolerance)
+    {
+        if(a.vertices.size() != b.vertices.size() || a.faces.size() != b.faces.size() ||
+           !matchPositions(getPositions(a), b, tolerance) || !matchPositions(getPositions(b), a, tolerance))
+        {
+            return false;
+        }
+
+        for(size_t f = 0; f < a.faces.size(); ++f)
+        {
+            if((getFaceCenter(a, a.faces[f]) - getFaceCenter(b, b.faces[f])).length() > tolerance)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief 经拓扑缓存细分Mesh的结果与逐层建立Model的细分形状相同；
+ *        同一连接关系的后续模型（如平移后的下一帧）命中缓存
+ */
+void checkTopologyCache(Checker &checker)
+{
+    // 开放边界上Model的顶点规则依赖于顶点编号，只在封闭的模型上比较
+
+    const int iterationCount = 3;
+    const Mesh mesh = checker.loadAsset("torus.obj");
+    const float tolerance = 1e-5f * computeExtent(mesh);
+
+    Mesh movedMesh = mesh;
+    for(auto &vertex : movedMesh.vertices)
+    {
+        vertex.position += Vec3(0.5f, -0.25f, 1);
+    }
+
+    const Mesh expected      = applyCatmullClarkSubdivision(mesh, iterationCount);
+    const Mesh movedExpected = applyCatmullClarkSubdivision(movedMesh, iterationCount);
+
+    const std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / "catmull_clark_check_topology_cache";
+    std::filesystem::remove_all(directory);
+
+    {
+        TopologyDiskCache diskCache(directory.string());
+
+        const Mesh created = applyCatmullClarkSubdivision(mesh, iterationCount, diskCache);
+        const Mesh loaded  = applyCatmullClarkSubdivision(mesh, iterationCount, diskCache);
+        const Mesh moved   = applyCatmullClarkSubdivision(movedMesh, iterationCount, diskCache);
+
+        const TopologyDiskCacheStats stats = diskCache.getStats();
+        checker.expect(stats.misses == 1 && stats.hits == 2 && stats.rejected == 0,
+                       "topology cache: disk cache not reused for the same connectivity");
+
+        checker.expect(isSameShape(created, expected, tolerance), "topology cache: result differs from Model subdivision");
+        checker.expect(isSameShape(loaded, expected, tolerance), "topology cache: result from disk differs");
+        checker.expect(isSameShape(moved, movedExpected, tolerance), "topology cache: moved mesh differs");
+    }
+
+    std::filesystem::remove_all(directory);
+
+    TopologyCache cache(size_t(64) << 20);
+    applyCatmullClarkSubdivision(mesh, iterationCount, cache);
+    const Mesh moved = applyCatmullClarkSubdivision(movedMesh, iterationCount, cache);
+
+    checker.expect(cache.getStats().hits == 1, "topology cache: memory cache not reused for the same connectivity");
+    checker.expect(isSameShape(moved, movedExpected, tolerance), "topology cache: moved mesh differs with memory cache");
+
+    checker.expect(applyCatmullClarkSubdivision(mesh, 0, cache).vertices.size() == mesh.vertices.size(),
+                   "topology cache: zero iterations changed the mesh");
+}
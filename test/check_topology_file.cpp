@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "check.h"
+
+/**
+ * @brief SubdivisionTopology写入文件后再加载，拓扑与求值结果不变；被篡改的文件被拒绝
+ */
+void checkTopologyFile(Checker &checker)
+{
+    const int iterationCount = 3;
+    const Mesh mesh = checker.loadAsset("bunny.obj");
+
+    std::vector<uint8_t> counts;
+    std::vector<uint32_t> indices;
+    const MeshView input = makeMeshView(mesh, counts, indices);
+
+    const IndexView countView   = { counts.data(), sizeof(uint8_t), counts.size(), IndexFormat::UInt8 };
+    const IndexView indicesView = { indices.data(), sizeof(uint32_t), indices.size(), IndexFormat::UInt32 };
+    const SubdivisionTopology topology(countView, indicesView, mesh.vertices.size(), iterationCount);
+
+    const std::string filename = (std::filesystem::temp_directory_path() / "catmull_clark_check.cctopo").string();
+    topology.saveToFile(filename);
+
+    auto loaded = SubdivisionTopology::loadFromFile(filename);
+    checker.expect(
+        loaded->matches(countView, indicesView, mesh.vertices.size(), iterationCount),
+        "topology file: loaded topology does not match its faces");
+
+    const ArrayView<const uint32_t> a = topology.getOutputIndices(), b = loaded->getOutputIndices();
+    checker.expect(
+        std::equal(a.data, a.data + a.size, b.data, b.data + b.size),
+        "topology file: output indices differ after loading");
+
+    auto evaluate = [&](const SubdivisionTopology &t)
+    {
+        std::vector<Vec3> positions(t.getOutputVertexCount());
+        std::vector<std::byte> workspace(t.getWorkspaceBytes());
+        t.evaluate(
+            input.positions, { &positions[0].x, sizeof(Vec3), positions.size() },
+            { workspace.data(), workspace.size() });
+        return positions;
+    };
+    checker.expect(evaluate(topology) == evaluate(*loaded), "topology file: positions differ after loading");
+    loaded.reset();
+
+    // 篡改文件末尾的一个字节
+
+    {
+        std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(-1, std::ios::end);
+        const char byte = static_cast<char>(file.get() ^ 0x5a);
+        file.seekp(-1, std::ios::end);
+        file.put(byte);
+    }
+
+    checker.expectThrow<std::runtime_error>(
+        [&] { SubdivisionTopology::loadFromFile(filename); }, "topology file: corrupted file accepted");
+
+    std::filesystem::remove(filename);
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/mesh_validation.h>
+
+#include "check.h"
+
+namespace
+{
+
+    Face makeFace(std::initializer_list<Face::Index> indices)
+    {
+        Face face;
+        face.isQuad = indices.size() == 4;
+        std::copy(indices.begin(), indices.end(), face.indices);
+        return face;
+    }
+
+    Mesh makeMesh(std::initializer_list<Vec3> positions, std::initializer_list<Face> faces)
+    {
+        Mesh mesh;
+        for(auto &p : positions)
+        {
+            mesh.vertices.push_back({ p });
+        }
+        mesh.faces = faces;
+        return mesh;
+    }
+
+    bool containsEdge(const std::vector<Edge> &edges, Face::Index a, Face::Index b)
+    {
+        return std::any_of(edges.begin(), edges.end(), [&](const Edge &e)
+        {
+            return (std::min)(e.vertices[0], e.vertices[1]) == (std::min)(a, b) &&
+                   (std::max)(e.vertices[0], e.vertices[1]) == (std::max)(a, b);
+        });
+    }
+
+    /**
+     * @brief 按顶点下标（而不是位置）统计，每条边至多属于两个面
+     *
+     * 拆分得到的顶点副本与原顶点位于同一位置，validateMesh会把它们视为同一个顶点
+     */
+    bool isIndexManifold(const Mesh &mesh)
+    {
+        std::map<std::pair<Face::Index, Face::Index>, int> edgeUseCount;
+        for(auto &f : mesh.faces)
+        {
+            const int n = f.isQuad ? 4 : 3;
+            for(int k = 0; k < n; ++k)
+            {
+                const Face::Index a = f.indices[k], b = f.indices[(k + 1) % n];
+                if(++edgeUseCount[{ (std::min)(a, b), (std::max)(a, b) }] > 2)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief validateMesh报告各类拓扑问题；非流形的网格默认在细分前抛出异常，拆分后可以细分且结果是流形
+ */
+void checkMeshValidation(Checker &checker)
+{
+    checker.expect(validateMesh(checker.loadAsset("torus.obj")).isValid(), "validation: torus is reported invalid");
+
+    // 三个四边形共享边(0, 1)
+
+    const Mesh fin = makeMesh(
+        { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 1, 1, 0 }, { 0, -1, 0 }, { 1, -1, 0 }, { 0, 0, 1 }, { 1, 0, 1 } },
+        { makeFace({ 0, 1, 3, 2 }), makeFace({ 1, 0, 4, 5 }), makeFace({ 0, 1, 7, 6 }) });
+
+    const MeshValidationReport finReport = validateMesh(fin);
+    checker.expect(
+        finReport.nonManifoldEdges.size() == 1 && containsEdge(finReport.nonManifoldEdges, 0, 1),
+        "validation: non-manifold edge is not reported");
+
+    checker.expectThrow<std::runtime_error>(
+        [&] { applyCatmullClarkSubdivision(fin, 1, SubdivisionOptions()); },
+        "validation: non-manifold mesh is subdivided without splitting");
+
+    SubdivisionOptions splitOptions;
+    splitOptions.splitNonManifold = true;
+    const Mesh split = applyCatmullClarkSubdivision(fin, 2, splitOptions);
+    checker.expect(split.faces.size() == 3 * 16, "validation: split mesh has the wrong face count");
+    checker.expect(isIndexManifold(split), "validation: split mesh is not manifold");
+    checker.expect(isIndexManifold(splitNonManifold(fin)), "validation: splitNonManifold result is not manifold");
+    checker.expect(!isIndexManifold(fin), "validation: fin is manifold by index");
+
+    // 两个三角形只共享顶点0
+
+    const Mesh bowtie = makeMesh(
+        { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { -1, 0, 0 }, { -1, -1, 0 } },
+        { makeFace({ 0, 1, 2 }), makeFace({ 0, 3, 4 }) });
+
+    const MeshValidationReport bowtieReport = validateMesh(bowtie);
+    checker.expect(
+        bowtieReport.nonManifoldVertices.size() == 1 && bowtieReport.nonManifoldVertices[0] == 0,
+        "validation: non-manifold vertex is not reported");
+    checker.expect(bowtieReport.nonManifoldEdges.empty(), "validation: bowtie reports a non-manifold edge");
+
+    // 面1含有重复顶点，面2的三个顶点共线
+
+    const Mesh degenerate = makeMesh(
+        { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 2, 0, 0 } },
+        { makeFace({ 0, 1, 2 }), makeFace({ 1, 1, 2 }), makeFace({ 0, 3, 1 }) });
+
+    const MeshValidationReport degenerateReport = validateMesh(degenerate);
+    checker.expect(
+        degenerateReport.degenerateFaces == std::vector<uint32_t>({ 1, 2 }),
+        "validation: degenerate faces are not reported");
+
+    // 两个四边形以相同方向经过边(0, 1)
+
+    const Mesh flipped = makeMesh(
+        { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 1, -1, 0 } },
+        { makeFace({ 0, 1, 2, 3 }), makeFace({ 0, 1, 5, 4 }) });
+
+    const MeshValidationReport flippedReport = validateMesh(flipped);
+    checker.expect(
+        flippedReport.inconsistentEdges.size() == 1 && containsEdge(flippedReport.inconsistentEdges, 0, 1),
+        "validation: inconsistent winding is not reported");
+    checker.expect(flippedReport.isManifold() && !flippedReport.isValid(), "validation: flipped mesh has the wrong status");
+}
@@ -0,0 +1,55 @@
+#include <stdexcept>
+
+#include <catmull_clark/catmull_clark.h>
+#include <catmull_clark/vertex_stream.h>
+
+#include "check.h"
+
+namespace
+{
+
+    bool closeVertex(const RenderVertex &a, const RenderVertex &b)
+    {
+        return (a.position - b.position).length() <= 1e-6f && (a.normal - b.normal).length() <= 1e-5f;
+    }
+
+} // namespace anonymous
+
+/**
+ * @brief 只移动顶点时，暂存数组与重新构造的绘制顶点相同，发生变化的顶点都在返回的区间内
+ */
+void checkVertexStream(Checker &checker)
+{
+    Mesh mesh = applyCatmullClarkSubdivision(checker.loadAsset("cube.obj"), 2);
+
+    VertexStreamUpdater updater;
+    updater.reset(mesh, buildRenderMesh(mesh), NormalWeighting::Area);
+
+    checker.expect(updater.update(mesh).empty(), "vertex stream: unchanged mesh reported a change");
+
+    const std::vector<RenderVertex> before = updater.getVertices();
+
+    mesh.vertices[mesh.vertices.size() / 2].position += Vec3(0.1f, 0.2f, 0.3f);
+    const VertexRange range = updater.update(mesh);
+    const std::vector<RenderVertex> &after = updater.getVertices();
+    const RenderMesh expected = buildRenderMesh(mesh);
+
+    checker.expect(!range.empty(), "vertex stream: moved vertex not reported");
+    checker.expect(after.size() == expected.vertices.size(), "vertex stream: vertex count differs");
+
+    for(size_t i = 0; i < after.size() && i < expected.vertices.size(); ++i)
+    {
+        checker.expect(closeVertex(after[i], expected.vertices[i]), "vertex stream: staged vertex differs from a rebuild");
+        if(!closeVertex(after[i], before[i]))
+        {
+            checker.expect(range.begin <= i && i < range.end, "vertex stream: changed vertex outside the reported range");
+        }
+    }
+
+    // 拓扑不同的网格须被拒绝
+
+    const Mesh other = applyCatmullClarkSubdivision(checker.loadAsset("cube.obj"), 1);
+    checker.expect(!updater.isCompatible(other), "vertex stream: different topology reported compatible");
+    checker.expectThrow<std::runtime_error>(
+        [&] { updater.update(other); }, "vertex stream: update with a different topology accepted");
+}